@@ -0,0 +1,242 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncBufferPool
+ */
+#include "CcSyncBufferPool.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+#include "CcSyncSignal.h"
+#include "CcKernel.h"
+#include "CcMutex.h"
+#include "CcList.h"
+
+//! Smallest size class, following classes are 16 times larger
+#define CcSyncBufferPool_MinClass   (64 * 1024)
+//! Number of size classes: 64KiB, 1MiB, 16MiB
+#define CcSyncBufferPool_Classes    3
+
+uint64 CcSyncBufferPool::s_uiAllocated = 0;
+uint64 CcSyncBufferPool::s_uiWaits = 0;
+uint64 CcSyncBufferPool::s_uiFailed = 0;
+static CcMutex s_oPoolLock;
+//! Signalled on each release, waiting threads are checking pool again
+static CcSyncSignal s_oPoolSignal;
+static CcList<CcByteArray*> s_oFree[CcSyncBufferPool_Classes];
+
+CcSyncBuffer::CcSyncBuffer(size_t uiSize)
+{
+  acquire(uiSize);
+}
+
+CcSyncBuffer::~CcSyncBuffer(void)
+{
+  release();
+}
+
+bool CcSyncBuffer::acquire(size_t uiSize, uint64 uiWaitMs)
+{
+  release();
+  m_pData = CcSyncBufferPool::acquire(uiSize, m_uiClassSize, uiWaitMs);
+  return m_pData != nullptr;
+}
+
+void CcSyncBuffer::release()
+{
+  if (m_pData != nullptr)
+  {
+    CcSyncBufferPool::release(m_pData, m_uiClassSize);
+    m_pData = nullptr;
+  }
+}
+
+CcByteArray* CcSyncBufferPool::acquire(size_t uiSize, size_t& uiClassSize, uint64 uiWaitMs)
+{
+  CcByteArray* pBuffer = nullptr;
+  uiClassSize = getClassSize(uiSize);
+  if (uiClassSize > CcSyncGlobals::BufferPoolLimit)
+  {
+    s_oPoolLock.lock();
+    s_uiFailed++;
+    s_oPoolLock.unlock();
+    CcSyncLog::writeWarning("Buffer of " + CcString::fromNumber(uiSize) + " bytes exceeds buffer pool limit");
+    return nullptr;
+  }
+  CcDateTime oStart = CcKernel::getUpTime();
+  bool bWaiting = false;
+  bool bTimeout = false;
+  while (pBuffer == nullptr &&
+         bTimeout == false)
+  {
+    uint64 uiSignal = s_oPoolSignal.getCount();
+    s_oPoolLock.lock();
+    for (size_t uiClass = 0; uiClass < CcSyncBufferPool_Classes; uiClass++)
+    {
+      if ((static_cast<size_t>(CcSyncBufferPool_MinClass) << (4 * uiClass)) == uiClassSize &&
+          s_oFree[uiClass].size() > 0)
+      {
+        pBuffer = s_oFree[uiClass][s_oFree[uiClass].size() - 1];
+        s_oFree[uiClass].remove(s_oFree[uiClass].size() - 1);
+      }
+    }
+    if (pBuffer == nullptr)
+    {
+      if (s_uiAllocated + uiClassSize <= CcSyncGlobals::BufferPoolLimit ||
+          freeUnused(s_uiAllocated + uiClassSize - CcSyncGlobals::BufferPoolLimit))
+      {
+        CCNEW(pBuffer, CcByteArray, uiClassSize);
+        s_uiAllocated += uiClassSize;
+      }
+      else if (bWaiting == false)
+      {
+        bWaiting = true;
+        s_uiWaits++;
+      }
+    }
+    s_oPoolLock.unlock();
+    if (pBuffer == nullptr)
+    {
+      int64 iRemaining = static_cast<int64>(uiWaitMs) - (CcKernel::getUpTime() - oStart).getTimestampMs();
+      if (iRemaining > 0)
+      {
+        s_oPoolSignal.wait(uiSignal, static_cast<uint64>(iRemaining));
+      }
+      else
+      {
+        bTimeout = true;
+      }
+    }
+  }
+  if (pBuffer != nullptr)
+  {
+    // Size of class is kept as capacity
+    pBuffer->resize(uiSize);
+  }
+  else
+  {
+    s_oPoolLock.lock();
+    s_uiFailed++;
+    s_oPoolLock.unlock();
+    // Callers without wait time have a fallback and are not reported
+    if (uiWaitMs > 0)
+      CcSyncLog::writeWarning("No free buffer since " + CcString::fromNumber(uiWaitMs) + "ms, buffer pool limit reached");
+  }
+  return pBuffer;
+}
+
+void CcSyncBufferPool::release(CcByteArray* pBuffer, size_t uiClassSize)
+{
+  if (pBuffer != nullptr)
+  {
+    s_oPoolLock.lock();
+    bool bPooled = false;
+    for (size_t uiClass = 0; uiClass < CcSyncBufferPool_Classes; uiClass++)
+    {
+      if ((static_cast<size_t>(CcSyncBufferPool_MinClass) << (4 * uiClass)) == uiClassSize)
+      {
+        pBuffer->resize(uiClassSize);
+        s_oFree[uiClass].append(pBuffer);
+        bPooled = true;
+        break;
+      }
+    }
+    if (bPooled == false)
+    {
+      // Larger than largest class, it is not reused
+      s_uiAllocated -= uiClassSize;
+      CCDELETE(pBuffer);
+    }
+    // Over limit allocations are not kept
+    if (s_uiAllocated > CcSyncGlobals::BufferPoolLimit)
+    {
+      freeUnused(s_uiAllocated - CcSyncGlobals::BufferPoolLimit);
+    }
+    s_oPoolLock.unlock();
+    s_oPoolSignal.signalAll();
+  }
+}
+
+void CcSyncBufferPool::clear()
+{
+  s_oPoolLock.lock();
+  freeUnused(s_uiAllocated);
+  s_oPoolLock.unlock();
+}
+
+uint64 CcSyncBufferPool::getAllocated()
+{
+  s_oPoolLock.lock();
+  uint64 uiAllocated = s_uiAllocated;
+  s_oPoolLock.unlock();
+  return uiAllocated;
+}
+
+uint64 CcSyncBufferPool::getWaits()
+{
+  s_oPoolLock.lock();
+  uint64 uiWaits = s_uiWaits;
+  s_oPoolLock.unlock();
+  return uiWaits;
+}
+
+uint64 CcSyncBufferPool::getFailed()
+{
+  s_oPoolLock.lock();
+  uint64 uiFailed = s_uiFailed;
+  s_oPoolLock.unlock();
+  return uiFailed;
+}
+
+size_t CcSyncBufferPool::getClassSize(size_t uiSize)
+{
+  size_t uiClassSize = CcSyncBufferPool_MinClass;
+  for (size_t uiClass = 1; uiClass < CcSyncBufferPool_Classes && uiClassSize < uiSize; uiClass++)
+  {
+    uiClassSize <<= 4;
+  }
+  if (uiClassSize < uiSize)
+  {
+    uiClassSize = uiSize;
+  }
+  return uiClassSize;
+}
+
+bool CcSyncBufferPool::freeUnused(uint64 uiRequired)
+{
+  uint64 uiFreed = 0;
+  // Free largest buffers first, they are the reason for limit most times
+  for (size_t uiClass = CcSyncBufferPool_Classes; uiClass > 0 && uiFreed < uiRequired; uiClass--)
+  {
+    CcList<CcByteArray*>& rFree = s_oFree[uiClass - 1];
+    while (rFree.size() > 0 && uiFreed < uiRequired)
+    {
+      CcByteArray* pBuffer = rFree[rFree.size() - 1];
+      rFree.remove(rFree.size() - 1);
+      uiFreed += pBuffer->size();
+      s_uiAllocated -= pBuffer->size();
+      CCDELETE(pBuffer);
+    }
+  }
+  return uiFreed >= uiRequired;
+}
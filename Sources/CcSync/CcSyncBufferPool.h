@@ -0,0 +1,128 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncBufferPool
+ *
+ * @page      CcSyncBufferPool
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncBufferPool
+ *
+ *  Process wide pool of transfer buffers. Buffers are allocated in size
+ *  classes and reused after release. All allocated buffers together are
+ *  limited to BufferPoolLimit bytes, a thread requesting a buffer waits
+ *  until enough memory was released. If no buffer is available after
+ *  BufferPoolWait ms, or if the request is larger than limit, acquire
+ *  fails and the transfer has to be rejected or retried later by caller.
+ *  No user of pool holds more than one buffer at once.
+ **/
+#ifndef _CcSyncBufferPool_H_
+#define _CcSyncBufferPool_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcByteArray.h"
+#include "CcSyncGlobals.h"
+
+/**
+ * @brief Buffer of CcSyncBufferPool, it is returned to pool on destruction.
+ */
+class CcSyncSHARED CcSyncBuffer
+{
+public:
+  /**
+   * @brief Create empty buffer, get memory later by acquire.
+   */
+  CcSyncBuffer( void )
+    {}
+
+  /**
+   * @brief Get buffer from pool, check isValid before use.
+   * @param uiSize: Required size of buffer
+   */
+  CcSyncBuffer(size_t uiSize);
+  ~CcSyncBuffer( void );
+  CCDEFINE_COPY_DENIED(CcSyncBuffer)
+
+  /**
+   * @brief Get buffer from pool, a previous buffer is released before.
+   * @param uiSize:   Required size of buffer
+   * @param uiWaitMs: Time to wait for a released buffer if limit is reached
+   * @return false if pool had no buffer within uiWaitMs
+   */
+  bool acquire(size_t uiSize, uint64 uiWaitMs = CcSyncGlobals::BufferPoolWait);
+
+  /**
+   * @brief Return buffer to pool before end of scope.
+   */
+  void release();
+
+  bool isValid() const
+    { return m_pData != nullptr; }
+  //! Size of buffer can be increased up to this size without allocation
+  size_t getCapacity() const
+    { return m_uiClassSize; }
+  CcByteArray& data()
+    { return *m_pData; }
+
+private:
+  CcByteArray* m_pData = nullptr;
+  size_t       m_uiClassSize = 0;
+};
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncBufferPool
+{
+public:
+  /**
+   * @brief Get buffer with uiSize bytes, wait if limit is reached.
+   * @param uiSize:      Required size of buffer
+   * @param uiClassSize: Size class of buffer, required for release
+   * @param uiWaitMs:    Time to wait for a released buffer if limit is reached
+   * @return Buffer or nullptr if uiSize exceeds limit or no buffer was
+   *         released within uiWaitMs
+   */
+  static CcByteArray* acquire(size_t uiSize, size_t& uiClassSize, uint64 uiWaitMs);
+  static void release(CcByteArray* pBuffer, size_t uiClassSize);
+
+  /**
+   * @brief Free all unused buffers.
+   */
+  static void clear();
+
+  static uint64 getAllocated();
+  static uint64 getWaits();
+  static uint64 getFailed();
+
+private:
+  static size_t getClassSize(size_t uiSize);
+  static bool freeUnused(uint64 uiRequired);
+
+private:
+  static uint64 s_uiAllocated;
+  static uint64 s_uiWaits;
+  static uint64 s_uiFailed;
+};
+
+#endif /* _CcSyncBufferPool_H_ */
@@ -39,11 +39,13 @@
 #include "CcKernel.h"
 #include "CcSyncDbClient.h"
 #include "CcSyncLog.h"
+#include "CcSyncTrace.h"
 #include "CcGlobalStrings.h"
 #include "CcConsole.h"
 
 #include "private/CcSyncWorkerClientDownload.h"
 #include "private/CcSyncWorkerClientUpload.h"
+#include "private/CcSyncClientTransferSlot.h"
 
 CcSyncClient::CcSyncClient(const CcString& sConfigFilePath, bool bCreate)
 {
@@ -63,7 +65,7 @@ CcSyncClient::CcSyncClient(const CcString& sConfigFilePath, bool bCreate)
     }
     else
     {
-      CcSyncLog::writeDebug("No configuration file in config-directory", ESyncLogTarget::Client);
+      CCSYNC_DEBUG("No configuration file in config-directory", ESyncLogTarget::Client);
     }
   }
   else
@@ -115,15 +117,7 @@ bool CcSyncClient::login()
   m_bLogin = false;
   if (m_pAccount != nullptr)
   {
-    m_oCom.getRequest().setAccountLogin(m_pAccount->getName(), m_pAccount->getName(), m_pAccount->getPassword().getString());
-    if (m_oCom.sendRequestGetResponse())
-    {
-      if (!m_oCom.getResponse().hasError())
-      {
-        m_oCom.getSession() = m_oCom.getResponse().getSession();
-        m_bLogin = true;
-      }
-    }
+    m_bLogin = loginConnection(m_oCom);
   }
   if(m_bLogin == false)
   {
@@ -133,6 +127,45 @@ bool CcSyncClient::login()
   return m_bLogin;
 }
 
+bool CcSyncClient::loginConnection(CcSyncClientCom& oCom)
+{
+  bool bLogin = false;
+  oCom.getRequest().setAccountLogin(m_pAccount->getName(), m_pAccount->getName(), m_pAccount->getPassword().getString());
+  if (oCom.sendRequestGetResponse())
+  {
+    if (!oCom.getResponse().hasError())
+    {
+      oCom.getSession() = oCom.getResponse().getSession();
+      bLogin = true;
+    }
+  }
+  return bLogin;
+}
+
+bool CcSyncClient::loginTransferSlot(CcSync::CcSyncClientTransferSlot& oSlot)
+{
+  if (oSlot.isLoggedIn() &&
+      oSlot.getCom().getSession() != m_oCom.getSession())
+  {
+    // Main connection was logged in again, previous token is not valid anymore
+    oSlot.setLoggedIn(false);
+  }
+  if (oSlot.isLoggedIn() == false)
+  {
+    // Resume session of main connection instead of a full handshake
+    oSlot.getCom().resumeSslSessionOf(m_oCom);
+    // Login with token of main connection, a login with password would
+    // replace the token on server and invalidate all other connections.
+    oSlot.getCom().getSession() = m_oCom.getSession();
+    oSlot.setLoggedIn(oSlot.getCom().login());
+    if (oSlot.isLoggedIn() == false)
+    {
+      CcSyncLog::writeError("Login of transfer connection failed", ESyncLogTarget::Client);
+    }
+  }
+  return oSlot.isLoggedIn();
+}
+
 bool CcSyncClient::isLoggedIn()
 {
   return m_bLogin;
@@ -194,6 +227,65 @@ bool CcSyncClient::serverStop()
   return false;
 }
 
+bool CcSyncClient::serverGetStats(CcJsonObject& oStats)
+{
+  if (m_pAccount != nullptr)
+  {
+    m_oCom.getRequest().setServerGetStats();
+    if (m_oCom.sendRequestGetResponse())
+    {
+      oStats = m_oCom.getResponse().getServerStats();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CcSyncClient::serverSetTrace(bool bEnable)
+{
+  if (m_pAccount != nullptr)
+  {
+    m_oCom.getRequest().setServerSetTrace(bEnable);
+    if (m_oCom.sendRequestGetResponse())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CcSyncClient::serverSetProfiler(bool bEnable)
+{
+  if (m_pAccount != nullptr)
+  {
+    m_oCom.getRequest().setServerSetProfiler(bEnable);
+    if (m_oCom.sendRequestGetResponse())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CcSyncClient::setTrace(bool bEnable)
+{
+  bool bRet = true;
+  if (bEnable)
+  {
+    CcString sTraceFile = CcKernel::getUserDataDir();
+    if (m_sConfigPath.length() > 0)
+      sTraceFile = m_sConfigPath;
+    sTraceFile.appendPath(CcSyncGlobals::ConfigDirName);
+    sTraceFile.appendPath(CcSyncGlobals::Client::TraceFileName);
+    bRet = CcSyncTrace::start(sTraceFile, "CcSyncClient");
+  }
+  else
+  {
+    CcSyncTrace::stop();
+  }
+  return bRet;
+}
+
 void CcSyncClient::cleanDatabase()
 {
   for (CcSyncDirectory& oDirectory : m_oBackupDirectories)
@@ -221,12 +313,12 @@ void CcSyncClient::doRemoteSync(const CcString& sDirectoryName)
         }
         else if (serverDirectoryEqual(oDirectory, CcSyncGlobals::Database::RootDirId))
         {
-          CcSyncLog::writeDebug("Client is up to date", ESyncLogTarget::Client);
+          CCSYNC_DEBUG("Client is up to date", ESyncLogTarget::Client);
         }
         else
         {
           m_pDatabase->beginTransaction();
-          CcSyncLog::writeDebug("Client is not up to date with Server, start equalizing", ESyncLogTarget::Client);
+          CCSYNC_DEBUG("Client is not up to date with Server, start equalizing", ESyncLogTarget::Client);
           doRemoteSyncDir(oDirectory, CcSyncGlobals::Database::RootDirId);
           m_pDatabase->endTransaction();
         }
@@ -281,90 +373,215 @@ void CcSyncClient::doLocalSyncAll( bool bDeepScan)
 
 void CcSyncClient::doQueue(const CcString& sDirectoryName)
 {
+  CcList<CcSyncDirectory*> oDirectories;
   for (CcSyncDirectory& oDirectory : m_oBackupDirectories)
   {
     if (oDirectory.getName() == sDirectoryName)
     {
-      oDirectory.queueResetAttempts();
-      while (oDirectory.queueHasItems())
+      oDirectories.append(&oDirectory);
+    }
+  }
+  doQueueDirectories(oDirectories);
+}
+
+void CcSyncClient::doQueues()
+{
+  CcList<CcSyncDirectory*> oDirectories;
+  for (CcSyncDirectory& oDirectory : m_oBackupDirectories)
+  {
+    oDirectories.append(&oDirectory);
+  }
+  doQueueDirectories(oDirectories);
+}
+
+void CcSyncClient::doQueueDirectories(CcList<CcSyncDirectory*>& oDirectories)
+{
+  if (oDirectories.size() == 0)
+    return;
+  // Transfers are running on slots with own connections, all other items
+  // are done on main connection. Dependent items are released by queue if
+  // their parent is finalized, so every ready item can be started directly.
+  CcList<CcSync::CcSyncClientTransferSlot*> oSlots;
+  for (size_t uiSlot = 0; uiSlot < CcSyncGlobals::Client::TransferWorkers; uiSlot++)
+  {
+    CcSync::CcSyncClientTransferSlot* pSlot;
+    CCNEW(pSlot, CcSync::CcSyncClientTransferSlot, m_pAccount->getServer());
+    oSlots.append(pSlot);
+  }
+  // Credits for weighted round robin over directories
+  CcList<int64> oCredits;
+  for (CcSyncDirectory* pDirectory : oDirectories)
+  {
+    pDirectory->queueResetAttempts();
+    pDirectory->queueCoalesce();
+    oCredits.append(0);
+  }
+  m_pDatabase->lock();
+  // Keep transaction open over multiple items, items wich are changing
+  // the local filesystem are writing a journal row first.
+  m_pDatabase->beginGroupTransaction();
+  bool bProcess = true;
+  uint16 uiCounter = 0;
+  // Server rejected a transfer because it is busy, no new transfers until then
+  CcDateTime oBackoffEnd;
+  while (bProcess)
+  {
+    size_t uiRunning = 0;
+    CcSync::CcSyncClientTransferSlot* pFreeSlot = nullptr;
+    for (CcSync::CcSyncClientTransferSlot* pSlot : oSlots)
+    {
+      if (pSlot->isDone())
       {
-        if (m_oCom.connect(m_pAccount->getServer()) == false)
+        CcConsole::writeSameLine(CcGlobalStrings::Empty);
+        CcConsole::writeLine(pSlot->finish());
+        m_pDatabase->nextGroupTransaction();
+        if (pSlot->getRetryAfter() > 0)
         {
-          CcSyncLog::writeDebug("Connection Lost, stop process", ESyncLogTarget::Client);
-          break;
+          oBackoffEnd = CcKernel::getUpTime();
+          oBackoffEnd.addSeconds(static_cast<int32>(pSlot->getRetryAfter()));
         }
-        else if (m_bLogin == false)
+      }
+      if (pSlot->isFree())
+      {
+        if (pFreeSlot == nullptr)
+          pFreeSlot = pSlot;
+      }
+      else
+      {
+        uiRunning++;
+      }
+    }
+
+    bool bBackoff = (oBackoffEnd - CcKernel::getUpTime()).getTimestampMs() > 0;
+    // Items without file content are done on main connection, they are
+    // not waiting for a free slot or for end of backoff.
+    bool bTransfers = pFreeSlot != nullptr &&
+                      bBackoff == false;
+    CcSyncDirectory* pDirectory = nullptr;
+    // Select directory with highest credit, each directory with items
+    // earns its priority, selected one pays the sum of all.
+    int64 iTotal = 0;
+    size_t uiSelected = 0;
+    for (size_t uiPos = 0; uiPos < oDirectories.size(); uiPos++)
+    {
+      if (oDirectories[uiPos]->queueHasItems(bTransfers))
+      {
+        int64 iPriority = static_cast<int64>(oDirectories[uiPos]->getPriority());
+        oCredits[uiPos] += iPriority;
+        iTotal += iPriority;
+        if (pDirectory == nullptr ||
+            oCredits[uiPos] > oCredits[uiSelected])
         {
-          CcSyncLog::writeDebug("Login not yet done, stop process", ESyncLogTarget::Client);
-          break;
+          pDirectory = oDirectories[uiPos];
+          uiSelected = uiPos;
         }
-        else
+      }
+    }
+    if (pDirectory != nullptr)
+      oCredits[uiSelected] -= iTotal;
+
+    if (m_oCom.connect(m_pAccount->getServer()) == false)
+    {
+      CCSYNC_DEBUG("Connection Lost, stop process", ESyncLogTarget::Client);
+      bProcess = false;
+    }
+    else if (m_bLogin == false)
+    {
+      CCSYNC_DEBUG("Login not yet done, stop process", ESyncLogTarget::Client);
+      bProcess = false;
+    }
+    else if (pDirectory != nullptr)
+    {
+      CcSyncDirectory& oDirectory = *pDirectory;
+      CcSyncFileInfo oFileInfo;
+      uint64 uiQueueIndex = 0;
+      EBackupQueueType eQueueType = oDirectory.queueGetNext(oFileInfo, uiQueueIndex, bTransfers);
+      switch (eQueueType)
+      {
+        case EBackupQueueType::CreateDir:
+          doCreateDir(oDirectory, oFileInfo, uiQueueIndex);
+          break;
+        case EBackupQueueType::RemoveDir:
+          doRemoveDir(oDirectory, oFileInfo, uiQueueIndex);
+          break;
+        case EBackupQueueType::UpdateDir:
+          doUpdateDir(oDirectory, oFileInfo, uiQueueIndex);
+          break;
+        case EBackupQueueType::DownloadDir:
+          doDownloadDir(oDirectory, oFileInfo, uiQueueIndex);
+          break;
+        case EBackupQueueType::AddFile:
+          if (loginTransferSlot(*pFreeSlot))
+            pFreeSlot->startUpload(oDirectory, oFileInfo, uiQueueIndex);
+          else
+            oDirectory.queueIncrementItem(uiQueueIndex);
+          break;
+        case EBackupQueueType::RemoveFile:
+          doRemoveFile(oDirectory, oFileInfo, uiQueueIndex);
+          break;
+        case EBackupQueueType::DownloadFile:
+          if (loginTransferSlot(*pFreeSlot))
+            pFreeSlot->startDownload(oDirectory, oFileInfo, uiQueueIndex);
+          else
+            oDirectory.queueIncrementItem(uiQueueIndex);
+          break;
+        default:
+          oDirectory.queueIncrementItem(uiQueueIndex);
+      }
+      if (pFreeSlot == nullptr ||
+          pFreeSlot->isFree())
+      {
+        // Item is already done
+        m_pDatabase->nextGroupTransaction();
+      }
+    }
+    else if (uiRunning > 0 ||
+             bBackoff)
+    {
+      // Workers are finalizing their items with database lock
+      m_pDatabase->unlock();
+      if (uiCounter >= 10)
+      {
+        uiCounter = 0;
+        for (CcSync::CcSyncClientTransferSlot* pSlot : oSlots)
         {
-          CcSync::ISyncWorkerBase* pWorker = nullptr;
-          CcSyncFileInfo oFileInfo;
-          uint64 uiQueueIndex = 0;
-          m_pDatabase->beginTransaction();
-          EBackupQueueType eQueueType = oDirectory.queueGetNext(oFileInfo, uiQueueIndex);
-          switch (eQueueType)
+          if (pSlot->isFree() == false)
           {
-            case EBackupQueueType::CreateDir:
-              doCreateDir(oDirectory, oFileInfo, uiQueueIndex);
-              break;
-            case EBackupQueueType::RemoveDir:
-              doRemoveDir(oDirectory, oFileInfo, uiQueueIndex);
-              break;
-            case EBackupQueueType::UpdateDir:
-              doUpdateDir(oDirectory, oFileInfo, uiQueueIndex);
-              break;
-            case EBackupQueueType::DownloadDir:
-              doDownloadDir(oDirectory, oFileInfo, uiQueueIndex);
-              break;
-            case EBackupQueueType::AddFile:
-              CCNEW(pWorker, CcSync::CcSyncWorkerClientUpload, oDirectory, oFileInfo, uiQueueIndex, m_oCom);
-              break;
-            case EBackupQueueType::RemoveFile:
-              doRemoveFile(oDirectory, oFileInfo, uiQueueIndex);
-              break;
-            case EBackupQueueType::DownloadFile:
-              CCNEW(pWorker, CcSync::CcSyncWorkerClientDownload, oDirectory, oFileInfo, uiQueueIndex, m_oCom);
-              break;
-            default:
-              oDirectory.queueIncrementItem(uiQueueIndex);
+            CcConsole::writeSameLine(pSlot->getProgressMessage());
+            break;
           }
-          if(pWorker)
-          {
-            pWorker->start();
-            uint16 uiCounter = 0;
-            while(pWorker->isInProgress())
-            {
-              if(uiCounter >= 10)
-              {
-                uiCounter = 0;
-                CcConsole::writeSameLine(pWorker->getProgressMessage());
-              }
-              else
-              {
-                CcKernel::sleep(20);
-                uiCounter++;
-              }
-            }
-            CcConsole::writeSameLine(CcGlobalStrings::Empty);
-            CcConsole::writeLine(pWorker->getProgressMessage());
-            CCDELETE(pWorker);
-          }
-          m_pDatabase->endTransaction();
         }
       }
+      else
+      {
+        CcKernel::sleep(20);
+        uiCounter++;
+      }
+      m_pDatabase->lock();
+    }
+    else
+    {
+      bProcess = false;
     }
   }
-}
-
-void CcSyncClient::doQueues()
-{
-  for (CcSyncDirectory& oDirectory : m_oBackupDirectories)
+  // Running transfers are requiring the lock to finish
+  m_pDatabase->unlock();
+  size_t uiHandshakes = m_oCom.getHandshakeCount();
+  size_t uiResumed = m_oCom.getResumedCount();
+  for (CcSync::CcSyncClientTransferSlot* pSlot : oSlots)
+  {
+    uiHandshakes += pSlot->getCom().getHandshakeCount();
+    uiResumed += pSlot->getCom().getResumedCount();
+    CCDELETE(pSlot);
+  }
+  if (uiHandshakes > 0)
   {
-    doQueue(oDirectory.getName());
+    CCSYNC_INFO("TLS sessions resumed: " + CcString::fromNumber(uiResumed) + " of " + CcString::fromNumber(uiHandshakes) +
+                         " (" + CcString::fromNumber(uiResumed * 100 / uiHandshakes) + "%)", ESyncLogTarget::Client);
   }
+  m_pDatabase->lock();
+  m_pDatabase->endGroupTransaction();
+  m_pDatabase->unlock();
 }
 
 void CcSyncClient::doUpdateChanged()
@@ -399,7 +616,7 @@ bool CcSyncClient::doAccountCreateDirectory(const CcString sDirectoryName, const
     }
     else
     {
-      CcSyncLog::writeDebug("Directory create failed: " + sDirectoryPath, ESyncLogTarget::Client);
+      CCSYNC_DEBUG("Directory create failed: " + sDirectoryPath, ESyncLogTarget::Client);
     }
   }
   else
@@ -603,7 +820,7 @@ bool CcSyncClient::selectAccount(const CcString& sNewAccount)
     }
     else
     {
-      CcSyncLog::writeInfo("Client location not found " + sClientConfigDir, ESyncLogTarget::Client);
+      CCSYNC_INFO("Client location not found " + sClientConfigDir, ESyncLogTarget::Client);
       bRet = false;
     }
   }
@@ -638,7 +855,7 @@ bool CcSyncClient::createConfig(const CcString& sConfigDir)
   }
   else
   { 
-    CcSyncLog::writeDebug("Client config dir not found and not created.", ESyncLogTarget::Client);
+    CCSYNC_DEBUG("Client config dir not found and not created.", ESyncLogTarget::Client);
     return false;
   }
 }
@@ -811,7 +1028,7 @@ void CcSyncClient::init(const CcString& sConfigFile)
   m_bConfigAvailable = true;
   if (!m_oConfig.readConfig(sConfigFile))
   {
-    CcSyncLog::writeDebug("No configuration file in config-directory", ESyncLogTarget::Client);
+    CCSYNC_DEBUG("No configuration file in config-directory", ESyncLogTarget::Client);
   }
 }
 
@@ -843,7 +1060,7 @@ bool CcSyncClient::setupDatabase()
     {
       setupSqlTables();
     }
-    CcSyncLog::writeDebug("User Database connected: " + m_pAccount->getDatabaseFilePath(), ESyncLogTarget::Client);
+    CCSYNC_DEBUG("User Database connected: " + m_pAccount->getDatabaseFilePath(), ESyncLogTarget::Client);
     bRet = true;
   }
   else
@@ -874,6 +1091,8 @@ bool CcSyncClient::checkSqlTables()
       bRet = oDirectory.validate();
       if (bRet)
       {
+        // Complete changes wich were interrupted by last run
+        oDirectory.journalReconcile();
         m_oBackupDirectories.append(oDirectory);
       }
     }
@@ -1101,7 +1320,7 @@ bool CcSyncClient::doCreateDir(CcSyncDirectory& oDirectory, CcSyncFileInfo& oDir
       CcSyncFileInfo oResponseFileInfo = m_oCom.getResponse().getFileInfo();
       oDirectory.directoryListInsert(oResponseFileInfo, true);
       oDirectory.queueFinalizeDirectory(oResponseFileInfo, uiQueueIndex);
-      CcSyncLog::writeDebug("Directory successfully added: " + oDirInfo.getName());
+      CCSYNC_DEBUG("Directory successfully added: " + oDirInfo.getName());
     }
     else
     {
@@ -1294,7 +1513,7 @@ bool CcSyncClient::doUpdateDir(CcSyncDirectory& oDirectory, CcSyncFileInfo& oFil
   CCUNUSED(oDirectory);
   CCUNUSED(oFileInfo);
   CCUNUSED(uiQueueIndex);
-  CcSyncLog::writeDebug("@TODO Implementation", ESyncLogTarget::Client);
+  CCSYNC_DEBUG("@TODO Implementation", ESyncLogTarget::Client);
   oDirectory.queueIncrementItem(uiQueueIndex);
   return bRet;
 }
@@ -1323,7 +1542,7 @@ bool CcSyncClient::doDownloadDir(CcSyncDirectory& oDirectory, CcSyncFileInfo& oF
 #endif
       if (oDirectory.directoryListInsert(oDirInfo, true))
       {
-        CcSyncLog::writeDebug("Directory Added: " + oDirInfo.getName(), ESyncLogTarget::Client);
+        CCSYNC_DEBUG("Directory Added: " + oDirInfo.getName(), ESyncLogTarget::Client);
         bRet = true;
         oDirectory.queueFinalizeDirectory(oDirInfo, uiQueueIndex);
         doRemoteSyncDir(oDirectory, oDirInfo.id());
@@ -1363,7 +1582,7 @@ bool CcSyncClient::doRemoveFile(CcSyncDirectory& oDirectory, CcSyncFileInfo& oFi
       if(oDirectory.fileListRemove(oFileInfo, true, true))
       {
         oDirectory.queueFinalizeFile(uiQueueIndex);
-        CcSyncLog::writeDebug("File successfully removed: " + oFileInfo.getName(), ESyncLogTarget::Client);
+        CCSYNC_DEBUG("File successfully removed: " + oFileInfo.getName(), ESyncLogTarget::Client);
         bRet = true;
       }
       else
@@ -1380,7 +1599,7 @@ bool CcSyncClient::doRemoveFile(CcSyncDirectory& oDirectory, CcSyncFileInfo& oFi
         case EStatus::FSFileNotFound:
           oDirectory.fileListRemove(oFileInfo, true, false);
           oDirectory.queueFinalizeFile(uiQueueIndex);
-          CcSyncLog::writeDebug("File successfully removed: " + oFileInfo.getName(), ESyncLogTarget::Client);
+          CCSYNC_DEBUG("File successfully removed: " + oFileInfo.getName(), ESyncLogTarget::Client);
           bRet = true;
           break;
         default:
@@ -46,6 +46,10 @@ template class CcSyncSHARED CcSharedPointer<CcSslSocket>;
 
 // Forward Declarrations
 class CcFile;
+namespace CcSync
+{
+  class CcSyncClientTransferSlot;
+}
 
 /**
  * @brief Class impelmentation
@@ -71,6 +75,26 @@ public:
   bool isAdmin();
   bool serverRescan(bool bDeep=false);
   bool serverStop();
+  /**
+   * @brief Get statistics of server, requires admin rights.
+   * @param oStats: Counters of server, see CcSyncServerStats
+   * @return true if statistics were received
+   */
+  bool serverGetStats(CcJsonObject& oStats);
+  /**
+   * @brief Start or stop tracing on server, requires admin rights.
+   */
+  bool serverSetTrace(bool bEnable);
+  /**
+   * @brief Start or stop query profiler on server, requires admin rights.
+   *        Report is part of statistics, see serverGetStats.
+   */
+  bool serverSetProfiler(bool bEnable);
+  /**
+   * @brief Start or stop tracing of this client, trace is written to
+   *        Client::TraceFileName in config directory.
+   */
+  bool setTrace(bool bEnable);
   void cleanDatabase();
   void doRemoteSync(const CcString& sDirectoryName);
   void doRemoteSyncAll();
@@ -119,6 +143,9 @@ private: // Methods
   void init(const CcString& sConfigFile);
   void deinit();
   bool setupDatabase();
+  void doQueueDirectories(CcList<CcSyncDirectory*>& oDirectories);
+  bool loginConnection(CcSyncClientCom& oCom);
+  bool loginTransferSlot(CcSync::CcSyncClientTransferSlot& oSlot);
   bool checkSqlTables();
   bool setupSqlTables();
   void recursiveRemoveDirectory(CcSyncDirectory& oDirectory, CcSyncFileInfo& oFileInfo);
@@ -28,6 +28,8 @@
 #include "Json/CcJsonDocument.h"
 #include "Json/CcJsonObject.h"
 #include "CcDateTime.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncTrace.h"
 
 bool CcSyncClientCom::connect(const CcUrl& oConnect)
 {
@@ -40,12 +42,26 @@ bool CcSyncClientCom::connect(const CcUrl& oConnect)
   {
     CCNEWTYPE(pSocket, CcSslSocket);
     m_oSocket = pSocket;
-    if (static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->initClient())
+    if (pSocket->initClient())
     {
+#ifdef CCSYNC_SSL_SESSION
+      if (m_oSslSession.isValid())
+      {
+        pSocket->setSession(m_oSslSession);
+      }
+#endif
       if (m_oSocket.connect(oConnect.getHostname(), oConnect.getPortString()))
       {
         // reset counter;
         m_uiReconnections = 0;
+        m_uiHandshakes++;
+#ifdef CCSYNC_SSL_SESSION
+        if (pSocket->isSessionReused())
+        {
+          m_uiResumed++;
+        }
+        m_oSslSession = pSocket->getSession();
+#endif
         m_oSocket.setTimeout(CcDateTimeFromSeconds(30));
         bRet = true;
       }
@@ -100,17 +116,35 @@ bool CcSyncClientCom::login()
 bool CcSyncClientCom::sendRequestGetResponse()
 {
   bool bRet = false;
+  CcSyncTraceSpan oRequestSpan("Request", "Client");
+  if (oRequestSpan.isActive())
+    oRequestSpan.setDetail(CcString::fromNumber(static_cast<uint16>(m_oRequest.getCommandType())));
+  CcSyncTraceSpan oSerializeSpan("Serialize request", "Json");
   CcJsonDocument oJsonDoc(m_oRequest.getData());
-  if (connect())
+  CcByteArray oRequestData = oJsonDoc.getDocument();
+  oSerializeSpan.end();
+  // Buffer is required before request is sent, response could not be read without
+  CcSyncBuffer oBuffer;
+  if (m_oRequest.getCommandType() != ESyncCommandType::Close &&
+      oBuffer.acquire(static_cast<size_t>(CcSyncGlobals::MaxResponseSize)) == false)
+  {
+    m_oResponse.clear();
+    CcSyncLog::writeError("No buffer for response available, request not sent", ESyncLogTarget::Client);
+  }
+  else if (connect())
   {
     m_oResponse.clear();
-    if (m_oSocket.writeArray(oJsonDoc.getDocument()))
+    CcSyncTraceSpan oWriteSpan("Write request", "Socket");
+    bool bWritten = m_oSocket.writeArray(oRequestData);
+    oWriteSpan.end();
+    if (bWritten)
     {
       if (m_oRequest.getCommandType() != ESyncCommandType::Close)
       {
         CcString sRead;
         size_t uiReadSize = 0;
-        CcByteArray oLastRead(static_cast<size_t>(CcSyncGlobals::MaxResponseSize));
+        CcByteArray& oLastRead = oBuffer.data();
+        CcSyncTraceSpan oReadSpan("Read response", "Socket");
         do
         {
           uiReadSize = m_oSocket.readArray(oLastRead, false);
@@ -121,6 +155,7 @@ bool CcSyncClientCom::sendRequestGetResponse()
         } while (uiReadSize <= CcSyncGlobals::MaxResponseSize &&
           sRead.length() <= CcSyncGlobals::MaxResponseSize  &&
           CcJsonDocument::isValidData(sRead) == false);
+        oReadSpan.end();
 
         if (uiReadSize > CcSyncGlobals::MaxResponseSize)
         {
@@ -142,7 +177,9 @@ bool CcSyncClientCom::sendRequestGetResponse()
         }
         else
         {
+          CcSyncTraceSpan oParseSpan("Parse response", "Json");
           m_oResponse.parseData(sRead);
+          oParseSpan.end();
           if (m_oResponse.getCommandType() == m_oRequest.getCommandType())
           {
             if (m_oResponse.hasError() == false)
@@ -37,6 +37,9 @@
 #include "CcSyncRequest.h"
 #include "CcSyncResponse.h"
 #include "CcSslSocket.h"
+#ifdef CCSYNC_SSL_SESSION
+  #include "CcSslSession.h"
+#endif
 
 /**
  * @brief Class impelmentation
@@ -68,6 +71,25 @@ public:
   void setUrl(const CcUrl& oConnect)
   { m_oUrl = oConnect; }
 
+  /**
+   * @brief Offer TLS session of other connection on next connect, if this
+   *        connection has none, so server can resume it without full handshake.
+   *        Without CCSYNC_SSL_SESSION every connect is a full handshake.
+   */
+  void resumeSslSessionOf(const CcSyncClientCom& oCom)
+  {
+#ifdef CCSYNC_SSL_SESSION
+    if (m_oSslSession.isValid() == false)
+      m_oSslSession = oCom.m_oSslSession;
+#else
+    CCUNUSED(oCom);
+#endif
+  }
+  size_t getHandshakeCount() const
+  { return m_uiHandshakes; }
+  size_t getResumedCount() const
+  { return m_uiResumed; }
+
 private:
   CcUrl           m_oUrl;
   CcSocket        m_oSocket;
@@ -75,6 +97,11 @@ private:
   CcSyncResponse  m_oResponse;
   CcSyncRequest   m_oRequest;
   size_t          m_uiReconnections = 0;
+#ifdef CCSYNC_SSL_SESSION
+  CcSslSession    m_oSslSession;
+#endif
+  size_t          m_uiHandshakes = 0;
+  size_t          m_uiResumed = 0;
 };
 
 #endif /* _CcSyncClientCom_H_ */
@@ -35,6 +35,9 @@
 #include "Hash/CcMd5.h"
 #include "CcDirectory.h"
 #include "CcSyncLog.h"
+#include "CcSyncQueue.h"
+#include "CcSyncTrace.h"
+#include "CcSyncDbProfiler.h"
 
 CcSyncDbClient::CcSyncDbClient( const CcString& sPath )
 {
@@ -105,6 +108,23 @@ bool CcSyncDbClient::openDatabase(const CcString& sPath)
   return bRet;
 }
 
+bool CcSyncDbClient::enableWriteAheadLog()
+{
+  CcSqlResult oResult = query("PRAGMA journal_mode=WAL;");
+  if (oResult.error())
+  {
+    CcSyncLog::writeWarning("Unable to enable write ahead log for database");
+    return false;
+  }
+  return true;
+}
+
+bool CcSyncDbClient::setReadOnly()
+{
+  CcSqlResult oResult = query("PRAGMA query_only=ON;");
+  return oResult.error() == false;
+}
+
 bool CcSyncDbClient::setupDirectory(const CcString& sDirName)
 {
   bool bRet = true;
@@ -112,7 +132,7 @@ bool CcSyncDbClient::setupDirectory(const CcString& sDirName)
   if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::DirectoryListAppend))
   {
     CcString sSqlCreateTable = getDbCreateDirectoryList(sDirName);
-    oResult = m_pDatabase->query(sSqlCreateTable);
+    oResult = query(sSqlCreateTable);
     if (oResult.error())
     {
       CcSyncLog::writeError("Failed to create Table: " + sDirName + CcSyncGlobals::Database::DirectoryListAppend);
@@ -122,7 +142,7 @@ bool CcSyncDbClient::setupDirectory(const CcString& sDirName)
   if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::FileListAppend))
   {
     CcString sSqlCreateTable = getDbCreateFileList(sDirName);
-    oResult = m_pDatabase->query(sSqlCreateTable);
+    oResult = query(sSqlCreateTable);
     if (oResult.error())
     {
       bRet &= false;
@@ -133,18 +153,41 @@ bool CcSyncDbClient::setupDirectory(const CcString& sDirName)
   if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::QueueAppend))
   {
     CcString sSqlCreateTable = getDbCreateQueue(sDirName);
-    oResult = m_pDatabase->query(sSqlCreateTable);
+    oResult = query(sSqlCreateTable);
     if (oResult.error())
     {
       bRet &= false;
       CcSyncLog::writeError("Failed to create Table: " + sDirName + CcSyncGlobals::Database::QueueAppend);
     }
   }
+  else
+  {
+    // Size was added later, add it to existing tables
+    CcString sQuery = "SELECT `";
+    sQuery << CcSyncGlobals::Database::Queue::Size << "` FROM `" << sDirName + CcSyncGlobals::Database::QueueAppend << "` LIMIT 0";
+    oResult = query(sQuery);
+    if (oResult.error())
+    {
+      sQuery = "ALTER TABLE `";
+      sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` ADD COLUMN `" << CcSyncGlobals::Database::Queue::Size << "` INTEGER DEFAULT 0";
+      oResult = query(sQuery);
+      if (oResult.error())
+      {
+        CcSyncLog::writeError("Failed to update Table: " + sDirName + CcSyncGlobals::Database::QueueAppend);
+      }
+    }
+  }
+  // Indexes were added later, create them on existing tables too
+  oResult = query(getDbCreateQueueIndex(sDirName));
+  if (oResult.error())
+  {
+    CcSyncLog::writeError("Failed to create Index on: " + sDirName + CcSyncGlobals::Database::QueueAppend);
+  }
 
   if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::HistoryAppend))
   {
     CcString sSqlCreateTable = getDbCreateHistory(sDirName);
-    oResult = m_pDatabase->query(sSqlCreateTable);
+    oResult = query(sSqlCreateTable);
     if (oResult.error())
     {
       bRet &= false;
@@ -152,11 +195,22 @@ bool CcSyncDbClient::setupDirectory(const CcString& sDirName)
     }
   }
 
+  if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::JournalAppend))
+  {
+    CcString sSqlCreateTable = getDbCreateJournal(sDirName);
+    oResult = query(sSqlCreateTable);
+    if (oResult.error())
+    {
+      bRet &= false;
+      CcSyncLog::writeError("Failed to create Table: " + sDirName + CcSyncGlobals::Database::JournalAppend);
+    }
+  }
+
   CcString sQuery = "SELECT ";
   sQuery << CcSyncGlobals::Database::DirectoryList::Id +
             " FROM " << sDirName + CcSyncGlobals::Database::DirectoryListAppend +
             " WHERE `" << CcSyncGlobals::Database::DirectoryList::DirId << "` IS NULL AND Name = '.'";
-  oResult = m_pDatabase->query(sQuery);
+  oResult = query(sQuery);
   if (!oResult.error())
   {
     CcSyncFileInfo oFile;
@@ -182,7 +236,7 @@ bool CcSyncDbClient::removeDirectory(const CcString& sDirName)
     CcString sTableName = sDirName + CcSyncGlobals::Database::DirectoryListAppend;
     CcString sDropTable;
     sDropTable << CcSyncGlobals::Database::DropTable << sTableName << "`";
-    oResult = m_pDatabase->query(sDropTable);
+    oResult = query(sDropTable);
     if (oResult.error())
     {
       CcSyncLog::writeError("Failed to delete Table: " + sTableName);
@@ -194,7 +248,7 @@ bool CcSyncDbClient::removeDirectory(const CcString& sDirName)
     CcString sTableName = sDirName + CcSyncGlobals::Database::FileListAppend;
     CcString sDropTable;
     sDropTable << CcSyncGlobals::Database::DropTable << sTableName << "`";
-    oResult = m_pDatabase->query(sDropTable);
+    oResult = query(sDropTable);
     if (oResult.error())
     {
       CcSyncLog::writeError("Failed to delete Table: " + sTableName);
@@ -206,7 +260,7 @@ bool CcSyncDbClient::removeDirectory(const CcString& sDirName)
     CcString sTableName = sDirName + CcSyncGlobals::Database::QueueAppend;
     CcString sDropTable;
     sDropTable << CcSyncGlobals::Database::DropTable << sTableName << "`";
-    oResult = m_pDatabase->query(sDropTable);
+    oResult = query(sDropTable);
     if (oResult.error())
     {
       CcSyncLog::writeError("Failed to delete Table: " + sTableName);
@@ -218,7 +272,19 @@ bool CcSyncDbClient::removeDirectory(const CcString& sDirName)
     CcString sTableName = sDirName + CcSyncGlobals::Database::HistoryAppend;
     CcString sDropTable;
     sDropTable << CcSyncGlobals::Database::DropTable << sTableName << "`";
-    oResult = m_pDatabase->query(sDropTable);
+    oResult = query(sDropTable);
+    if (oResult.error())
+    {
+      CcSyncLog::writeError("Failed to delete Table: " + sTableName);
+    }
+  }
+
+  if (!m_pDatabase->tableExists(sDirName + CcSyncGlobals::Database::JournalAppend))
+  {
+    CcString sTableName = sDirName + CcSyncGlobals::Database::JournalAppend;
+    CcString sDropTable;
+    sDropTable << CcSyncGlobals::Database::DropTable << sTableName << "`";
+    oResult = query(sDropTable);
     if (oResult.error())
     {
       CcSyncLog::writeError("Failed to delete Table: " + sTableName);
@@ -233,13 +299,15 @@ void CcSyncDbClient::cleanDirectory(const CcString& sDirName)
   CcString sSql;
   m_pDatabase->beginTransaction();
   sSql << "DELETE FROM '" << sDirName << CcSyncGlobals::Database::DirectoryListAppend << "'";
-  m_pDatabase->query(sSql);
+  query(sSql);
   sSql << "DELETE FROM '" << sDirName << CcSyncGlobals::Database::FileListAppend << "'";
-  m_pDatabase->query(sSql);
+  query(sSql);
   sSql << "DELETE FROM '" << sDirName << CcSyncGlobals::Database::QueueAppend << "'";
-  m_pDatabase->query(sSql);
+  query(sSql);
   sSql << "DELETE FROM '" << sDirName << CcSyncGlobals::Database::HistoryAppend << "'";
-  m_pDatabase->query(sSql);
+  query(sSql);
+  sSql << "DELETE FROM '" << sDirName << CcSyncGlobals::Database::JournalAppend << "'";
+  query(sSql);
   setupDirectory(sDirName);
   m_pDatabase->endTransaction();
 }
@@ -261,8 +329,10 @@ void CcSyncDbClient::endTransaction()
 {
   if (m_uiTransactionCnt == 1)
   {
+    flushQueues();
     m_pDatabase->endTransaction();
     m_uiTransactionCnt--;
+    m_uiCommits++;
   }
   else if(m_uiTransactionCnt > 0)
   {
@@ -270,6 +340,57 @@ void CcSyncDbClient::endTransaction()
   }
 }
 
+void CcSyncDbClient::beginGroupTransaction()
+{
+  if (m_uiGroupCnt == 0)
+  {
+    beginTransaction();
+    m_uiGroupItems = 0;
+    m_oGroupStart = CcKernel::getUpTime();
+  }
+  m_uiGroupCnt++;
+}
+
+void CcSyncDbClient::nextGroupTransaction()
+{
+  if (m_uiGroupCnt > 0)
+  {
+    m_uiGroupItems++;
+    if (m_uiGroupItems >= CcSyncGlobals::Database::GroupCommitItems ||
+        (CcKernel::getUpTime() - m_oGroupStart).getTimestampMs() >= CcSyncGlobals::Database::GroupCommitTime)
+    {
+      commitGroupTransaction();
+    }
+    else
+    {
+      m_bGroupPending = true;
+    }
+  }
+}
+
+void CcSyncDbClient::commitPendingGroupTransaction()
+{
+  if (m_uiGroupCnt > 0 &&
+      m_uiGroupItems > 0)
+  {
+    commitGroupTransaction();
+  }
+}
+
+void CcSyncDbClient::endGroupTransaction()
+{
+  if (m_uiGroupCnt == 1)
+  {
+    m_uiGroupCnt--;
+    endTransaction();
+    m_bGroupPending = false;
+  }
+  else if (m_uiGroupCnt > 0)
+  {
+    m_uiGroupCnt--;
+  }
+}
+
 CcString CcSyncDbClient::getInnerPathById(const CcString& sDirName, uint64 uiDirId)
 {
   CcString sPath;
@@ -281,7 +402,7 @@ CcString CcSyncDbClient::getInnerPathById(const CcString& sDirName, uint64 uiDir
     sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Name << "` ";
     sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` ";
     sQuery << "WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "` = " << CcString::fromNumber(uiDirId);
-    CcSqlResult sResult = m_pDatabase->query(sQuery);
+    CcSqlResult sResult = query(sQuery);
     if (sResult.ok() && sResult.size() > 0)
     {
       uiDirId = sResult[0][0].getUint64();
@@ -311,7 +432,7 @@ CcSyncFileInfoList CcSyncDbClient::getDirectoryInfoListById(const CcString& sDir
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::ChangedMd5 << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::DirectoryList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' ORDER BY `Name`";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   for (CcTableRow& oRow : oSqlDirectoryList)
   {
     CcSyncFileInfo oDirectoryInfo;
@@ -340,7 +461,7 @@ CcSyncFileInfoList CcSyncDbClient::getFileInfoListById(const CcString& sDirName,
   sQuery << "`" << CcSyncGlobals::Database::FileList::Changed   << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::FileList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' ORDER BY `Name`";
-  CcSqlResult oSqlFileList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlFileList = query(sQuery);
   for (CcTableRow& oRow : oSqlFileList)
   {
     CcSyncFileInfo oFileInfo;
@@ -369,7 +490,7 @@ CcSyncFileInfo CcSyncDbClient::getDirectoryInfoById(const CcString& sDirName, ui
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::ChangedMd5 << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "`='" << CcString::fromNumber(uiDirId) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -390,7 +511,7 @@ CcSyncFileInfo CcSyncDbClient::getDirectoryInfoFromSubdir(const CcString& sDirNa
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::DirectoryList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' " <<
     "AND `" << CcSyncGlobals::Database::DirectoryList::Name << "`='" << CcSqlite::escapeString(sSubDirName) << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok() &&
     oResult.size() > 0)
   {
@@ -413,7 +534,7 @@ CcSyncFileInfo CcSyncDbClient::getFileInfoById(const CcString& sDirName, uint64
   sQuery << "`" << CcSyncGlobals::Database::FileList::Changed << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
             "WHERE `" << CcSyncGlobals::Database::FileList::Id << "`='" << CcString::fromNumber(uiFileId) << "' ORDER BY `Name`";
-  CcSqlResult oSqlResult = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlResult = query(sQuery);
   if (oSqlResult.ok() &&
       oSqlResult.size() > 0)
   {
@@ -437,7 +558,7 @@ CcSyncFileInfo CcSyncDbClient::getFileInfoByFilename(const CcString& sDirName, u
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::FileList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' "\
     "AND `" << CcSyncGlobals::Database::FileList::Name << "`='" << CcSqlite::escapeString(sFileName) << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok() &&
     oResult.size() > 0)
   {
@@ -452,9 +573,9 @@ bool CcSyncDbClient::queueHasItem(const CcString& sDirName)
   CcString sQuery = "SELECT COUNT(`";
   sQuery << CcSyncGlobals::Database::Queue::Id << "`) AS `count` FROM `" << sDirName + CcSyncGlobals::Database::QueueAppend << "` ";
   sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::QueueId << "` IS NULL ";
-  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Attempts << "` < 5 ";
+  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Attempts << "` < " << CcString::fromNumber(CcSyncGlobals::Database::QueueMaxAttempts) << " ";
   sQuery << "AND `" << CcSyncGlobals::Database::Queue::DirId << "` IS NOT NULL LIMIT 0,1";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok() &&
     oResult[0][0].getSize() > 0)
   {
@@ -475,9 +596,9 @@ EBackupQueueType CcSyncDbClient::queueGetNext(const CcString& sDirName, CcSyncFi
   sQuery << "`" << CcSyncGlobals::Database::Queue::Type << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::QueueAppend << "` ";
   sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::QueueId << "` IS NULL ";
-  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Attempts << "` < 5 ";
+  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Attempts << "` < " << CcString::fromNumber(CcSyncGlobals::Database::QueueMaxAttempts) << " ";
   sQuery << "AND `" << CcSyncGlobals::Database::Queue::DirId << "` IS NOT NULL LIMIT 0,1";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok() &&
     oResult.size() > 0)
   {
@@ -498,14 +619,14 @@ void CcSyncDbClient::queueFinalizeDirectory(const CcString& sDirName, CcSyncFile
   sQuery << " `" << CcSyncGlobals::Database::Queue::QueueId << "` = NULL ,";
   sQuery << " `" << CcSyncGlobals::Database::Queue::DirId << "` = " << CcString::fromNumber(oFileInfo.getId()) << " ";
   sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::QueueId << "` = " << CcString::fromNumber(uiQueueIndex);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     // Delete the Queue
     sQuery = "DELETE FROM `";
     sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "`"\
       "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` = '" << CcString::fromNumber(uiQueueIndex) << "'";
-    oResult = m_pDatabase->query(sQuery);
+    oResult = query(sQuery);
   }
 }
 
@@ -516,22 +637,22 @@ void CcSyncDbClient::queueFinalizeFile(const CcString& sDirName, uint64 uiQueueI
   sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` SET ";
   sQuery << " `" << CcSyncGlobals::Database::Queue::QueueId << "` = NULL ";
   sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::QueueId << "` = " << CcString::fromNumber(uiQueueIndex);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     // Delete the Queue
     sQuery = "DELETE FROM `";
     sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "`"\
       "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` = '" << CcString::fromNumber(uiQueueIndex) << "'";
-    oResult = m_pDatabase->query(sQuery);
+    oResult = query(sQuery);
     if(oResult.error())
     {
-      CcSyncLog::writeDebug("Finalizing queue failed (Remove).");
+      CCSYNC_DEBUG("Finalizing queue failed (Remove).");
     }
   }
   else
   {
-    CcSyncLog::writeDebug("Finalizing queue failed (Update).");
+    CCSYNC_DEBUG("Finalizing queue failed (Update).");
   }
 }
 
@@ -541,14 +662,14 @@ void CcSyncDbClient::queueIncrementItem(const CcString& sDirName, uint64 uiQueue
   sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` SET ";
   sQuery << "`" << CcSyncGlobals::Database::Queue::Attempts << "` = " << CcSyncGlobals::Database::Queue::Attempts << " + 1 ";
   sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` = " << CcString::fromNumber(uiQueueIndex);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
 }
 
 void CcSyncDbClient::queueReset(const CcString& sDirName)
 {
   CcString sQuery = "DELETE FROM  `";
   sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "`";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
 }
 
 void CcSyncDbClient::queueResetAttempts(const CcString& sDirName)
@@ -556,13 +677,13 @@ void CcSyncDbClient::queueResetAttempts(const CcString& sDirName)
   CcString sQuery = "UPDATE `";
   sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` SET ";
   sQuery << " " << CcSyncGlobals::Database::Queue::Attempts << " = 0 ";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
 }
 
 void CcSyncDbClient::queueDownloadDirectory(const CcString& sDirName, const CcSyncFileInfo& oFileInfo)
 {
-  CcString sQuery = getDbInsertQueue(sDirName, 0, EBackupQueueType::DownloadDir, oFileInfo.getId(), oFileInfo.getDirId(), oFileInfo.getName());
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcString sQuery = getDbInsertQueue(sDirName, 0, EBackupQueueType::DownloadDir, oFileInfo.getId(), oFileInfo.getDirId(), oFileInfo.getName(), 0);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.error())
   {
     CcSyncLog::writeError("Adding Download Directory to queue");
@@ -571,11 +692,141 @@ void CcSyncDbClient::queueDownloadDirectory(const CcString& sDirName, const CcSy
 
 void CcSyncDbClient::queueDownloadFile(const CcString& sDirName, const CcSyncFileInfo& oFileInfo)
 {
-  CcString sQuery = getDbInsertQueue(sDirName, 0, EBackupQueueType::DownloadFile, oFileInfo.getId(), oFileInfo.getDirId(), oFileInfo.getName());
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  // Insert with coalescing of other file operations on same path
+  queueInsert(sDirName, 0, EBackupQueueType::DownloadFile, oFileInfo.getId(), oFileInfo.getDirId(), oFileInfo.getName(), oFileInfo.getFileSize());
+}
+
+void CcSyncDbClient::queueCoalesce(const CcString& sDirName)
+{
+  // Remove all ready file operations wich have a newer ready operation on same path
+  CcString sTableName = sDirName + CcSyncGlobals::Database::QueueAppend;
+  CcString sQuery = "DELETE FROM `";
+  sQuery << sTableName << "` ";
+  sQuery << "WHERE " << getDbQueueCoalesceCondition(sTableName, sTableName) << " ";
+  sQuery << "AND EXISTS (SELECT 1 FROM `" << sTableName << "` AS `Newer` WHERE ";
+  sQuery << getDbQueueCoalesceCondition(sTableName, "Newer") << " ";
+  sQuery << "AND `Newer`.`" << CcSyncGlobals::Database::Queue::DirId << "` = `" << sTableName << "`.`" << CcSyncGlobals::Database::Queue::DirId << "` ";
+  sQuery << "AND `Newer`.`" << CcSyncGlobals::Database::Queue::Name << "` = `" << sTableName << "`.`" << CcSyncGlobals::Database::Queue::Name << "` ";
+  sQuery << "AND `Newer`.`" << CcSyncGlobals::Database::Queue::Id << "` > `" << sTableName << "`.`" << CcSyncGlobals::Database::Queue::Id << "`)";
+  CcSqlResult oResult = query(sQuery);
+  if (oResult.error())
+  {
+    CCSYNC_DEBUG("Coalescing queue failed.");
+  }
+}
+
+bool CcSyncDbClient::queueLoad(const CcString& sDirName, uint64 uiAfterId, size_t uiCount, CcList<CcSyncQueueItem>& oItems)
+{
+  CcString sQuery = "SELECT ";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Id << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::QueueId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Name << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::FileId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::DirId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Type << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Attempts << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Size << "`";
+  sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::QueueAppend << "` ";
+  sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` > " << CcString::fromNumber(uiAfterId) << " ";
+  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Attempts << "` < " << CcString::fromNumber(CcSyncGlobals::Database::QueueMaxAttempts) << " ";
+  sQuery << "ORDER BY `" << CcSyncGlobals::Database::Queue::Id << "` LIMIT 0," << CcString::fromSize(uiCount);
+  CcSqlResult oResult = query(sQuery);
+  if (oResult.ok())
+  {
+    for (CcTableRow& oRow : oResult)
+    {
+      CcSyncQueueItem oItem;
+      oItem.uiId = oRow[0].getUint64();
+      oItem.uiQueueId = oRow[1].getUint64();
+      oItem.sName = oRow[2].getString();
+      oItem.uiFileId = oRow[3].getUint64();
+      oItem.uiDirId = oRow[4].getUint64();
+      oItem.eType = (EBackupQueueType) oRow[5].getUint16();
+      oItem.uiAttempts = oRow[6].getUint16();
+      oItem.uiSize = oRow[7].getUint64();
+      oItems.append(oItem);
+    }
+  }
+  return oResult.ok();
+}
+
+void CcSyncDbClient::queueFinalizeList(const CcString& sDirName, const CcList<CcSyncQueueItem>& oItems)
+{
+  CcString sIdList;
+  CcString sDirIdCase;
+  for (const CcSyncQueueItem& oItem : oItems)
+  {
+    if (sIdList.length() > 0)
+      sIdList << ",";
+    sIdList << CcString::fromNumber(oItem.uiId);
+    if (oItem.uiReleaseDirId != 0)
+    {
+      sDirIdCase << " WHEN " << CcString::fromNumber(oItem.uiId) << " THEN " << CcString::fromNumber(oItem.uiReleaseDirId);
+    }
+  }
+  // Update Dependent Queues, DirId is only changed for finalized directories
+  CcString sQuery = "UPDATE `";
+  sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` SET ";
+  sQuery << " `" << CcSyncGlobals::Database::Queue::QueueId << "` = NULL ";
+  if (sDirIdCase.length() > 0)
+  {
+    sQuery << ", `" << CcSyncGlobals::Database::Queue::DirId << "` = CASE `" << CcSyncGlobals::Database::Queue::QueueId << "`";
+    sQuery << sDirIdCase << " ELSE `" << CcSyncGlobals::Database::Queue::DirId << "` END ";
+  }
+  sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::QueueId << "` IN (" << sIdList << ")";
+  CcSqlResult oResult = query(sQuery);
+  if (oResult.ok())
+  {
+    // Delete the Queue
+    sQuery = "DELETE FROM `";
+    sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` "\
+      "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` IN (" << sIdList << ")";
+    oResult = query(sQuery);
+    if(oResult.error())
+    {
+      CCSYNC_DEBUG("Finalizing queue failed (Remove).");
+    }
+  }
+  else
+  {
+    CCSYNC_DEBUG("Finalizing queue failed (Update).");
+  }
+}
+
+void CcSyncDbClient::queueUpdateAttempts(const CcString& sDirName, const CcList<CcSyncQueueItem>& oItems)
+{
+  CcString sIdList;
+  CcString sAttemptsCase;
+  for (const CcSyncQueueItem& oItem : oItems)
+  {
+    if (sIdList.length() > 0)
+      sIdList << ",";
+    sIdList << CcString::fromNumber(oItem.uiId);
+    sAttemptsCase << " WHEN " << CcString::fromNumber(oItem.uiId) << " THEN " << CcString::fromNumber(oItem.uiAttempts);
+  }
+  CcString sQuery = "UPDATE `";
+  sQuery << sDirName + CcSyncGlobals::Database::QueueAppend << "` SET ";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Attempts << "` = CASE `" << CcSyncGlobals::Database::Queue::Id << "`";
+  sQuery << sAttemptsCase << " ELSE `" << CcSyncGlobals::Database::Queue::Attempts << "` END ";
+  sQuery << "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` IN (" << sIdList << ")";
+  CcSqlResult oResult = query(sQuery);
   if (oResult.error())
   {
-    CcSyncLog::writeError("Adding Download File to queue");
+    CCSYNC_DEBUG("Updating queue attempts failed.");
+  }
+}
+
+void CcSyncDbClient::queueRegister(CcSyncQueue* pQueue)
+{
+  m_oQueues.append(pQueue);
+}
+
+void CcSyncDbClient::queueUnregister(CcSyncQueue* pQueue)
+{
+  size_t uiPos = m_oQueues.find(pQueue);
+  if (uiPos < m_oQueues.size())
+  {
+    m_oQueues.remove(uiPos);
   }
 }
 
@@ -628,7 +879,7 @@ void CcSyncDbClient::directoryListUpdateChanged(const CcString& sDirName, uint64
   CcString sQuery(CcSyncGlobals::Database::Update);
   sQuery << sTableName << "` SET `" << CcSyncGlobals::Database::DirectoryList::ChangedMd5 << "` = '" << oMd5.getValue().getHexString() << "'";
   sQuery << " WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "` = " << CcString::fromNumber(uiDirId);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     if (oDirInfo.getDirId() != 0)
@@ -662,7 +913,7 @@ void CcSyncDbClient::directoryListSearchDouble(const CcString& sDirName, uint64
       sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
                 "WHERE `" << CcSyncGlobals::Database::DirectoryList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' AND "
                 " `" << CcSyncGlobals::Database::DirectoryList::Name << "`='" << m_pDatabase->escapeString(oDirInfo.getName()) << "'";
-      CcSqlResult oResult = m_pDatabase->query(sQuery);
+      CcSqlResult oResult = query(sQuery);
       if (oResult.size() == 0)
       {
         CCDEBUG("Impossible situation oO");
@@ -694,7 +945,7 @@ void CcSyncDbClient::directoryListSearchTemporary(const CcString& sDirName)
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Id << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
             " WHERE `" << CcSyncGlobals::Database::DirectoryList::Name << "` LIKE '" << CcSyncGlobals::TemporaryExtension << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   for (CcTableRow& oRow : oResult)
   {
     directoryListRemove(sDirName, getDirectoryInfoById(sDirName, oRow[0].getUint64()), false);
@@ -709,7 +960,7 @@ bool CcSyncDbClient::fileListFileIdExists(const CcString& sDirName, uint64 uiDir
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::FileList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' "\
     "AND `" << CcSyncGlobals::Database::FileList::Id << "`='" << CcString::fromNumber(oFileInfo.getId()) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -727,7 +978,7 @@ bool CcSyncDbClient::fileListFileNameExists(const CcString& sDirName, uint64 uiD
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::FileList::DirId << "`='" << CcString::fromNumber(uiDirId) << "' "\
     "AND `" << CcSyncGlobals::Database::FileList::Name << "`='" << CcSqlite::escapeString(oFileInfo.getName()) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -742,7 +993,7 @@ void CcSyncDbClient::fileListSearchTemporary(const CcString& sDirName)
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Id << "`";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
             " WHERE `" << CcSyncGlobals::Database::FileList::Name << "` LIKE '" << CcSyncGlobals::TemporaryExtension << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   for (CcTableRow& oRow : oResult)
   {
     fileListRemove(sDirName, getFileInfoById(sDirName, oRow[0].getUint64()), true);
@@ -755,10 +1006,10 @@ bool CcSyncDbClient::historyInsert(const CcString& sDirName, EBackupQueueType eQ
   if (m_bEnableHistory)
   {
     CcString sQuery = getDbInsertHistory(sDirName, eQueueType, oFileInfo);
-    CcSqlResult oResult = m_pDatabase->query(sQuery);
+    CcSqlResult oResult = query(sQuery);
     if (oResult.error())
     {
-      CcSyncLog::writeDebug("Error on adding data to history.");
+      CCSYNC_DEBUG("Error on adding data to history.");
     }
     return oResult.ok();
   }
@@ -768,10 +1019,117 @@ bool CcSyncDbClient::historyInsert(const CcString& sDirName, EBackupQueueType eQ
   }
 }
 
-uint64 CcSyncDbClient::queueInsert(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName)
+bool CcSyncDbClient::journalInsert(const CcString& sDirName, CcSyncJournalEntry& oEntry)
+{
+  CcString sQuery(CcSyncGlobals::Database::Insert);
+  sQuery << sDirName + CcSyncGlobals::Database::JournalAppend << "` ( ";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Id << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Type << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::FileId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::DirId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Name << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Size << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Modified << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Attributes << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::CRC << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::MD5 << "`) ";
+  sQuery << "VALUES (NULL,";
+  sQuery << CcString::fromNumber((uint16) oEntry.eType) << ",";
+  sQuery << CcString::fromNumber(oEntry.oFileInfo.getId()) << ",";
+  sQuery << CcString::fromNumber(oEntry.oFileInfo.getDirId()) << ",";
+  sQuery << "'" << CcSqlite::escapeString(oEntry.oFileInfo.getName()) << "',";
+  sQuery << CcString::fromNumber(oEntry.oFileInfo.getFileSize()) << ",";
+  sQuery << CcString::fromNumber(oEntry.oFileInfo.getModified()) << ",";
+  sQuery << "'" << CcSqlite::escapeString(oEntry.oFileInfo.getAttributes()) << "',";
+  sQuery << CcString::fromNumber(oEntry.oFileInfo.getCrc()) << ",";
+  sQuery << "'" << oEntry.oFileInfo.getMd5().getHexString() << "')";
+  CcSqlResult oResult = query(sQuery);
+  oEntry.uiCommit = m_uiCommits;
+  if (m_uiTransactionCnt == 0)
+  {
+    // Written without transaction, it is already committed
+    m_uiCommits++;
+  }
+  if (oResult.ok())
+  {
+    oEntry.uiId = oResult.getLastInsertId();
+  }
+  else
+  {
+    CcSyncLog::writeError("Failed to write journal of: " + oEntry.oFileInfo.getName());
+  }
+  return oResult.ok();
+}
+
+void CcSyncDbClient::journalSync(const CcSyncJournalEntry& oEntry)
+{
+  if (m_uiTransactionCnt > 0 &&
+      m_uiCommits == oEntry.uiCommit)
+  {
+    commitGroupTransaction();
+  }
+}
+
+bool CcSyncDbClient::journalRemove(const CcString& sDirName, const CcSyncJournalEntry& oEntry)
+{
+  CcString sQuery = "DELETE FROM `";
+  sQuery << sDirName + CcSyncGlobals::Database::JournalAppend << "` ";
+  sQuery << "WHERE `" << CcSyncGlobals::Database::Journal::Id << "` = " << CcString::fromNumber(oEntry.uiId);
+  CcSqlResult oResult = query(sQuery);
+  return oResult.ok();
+}
+
+CcList<CcSyncJournalEntry> CcSyncDbClient::journalLoad(const CcString& sDirName)
+{
+  CcList<CcSyncJournalEntry> oEntries;
+  CcString sQuery = "SELECT ";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Id << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Type << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::FileId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::DirId << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Name << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Size << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Modified << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::Attributes << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::CRC << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Journal::MD5 << "`";
+  sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::JournalAppend << "` ";
+  sQuery << "ORDER BY `" << CcSyncGlobals::Database::Journal::Id << "`";
+  CcSqlResult oResult = query(sQuery);
+  if (oResult.ok())
+  {
+    for (CcTableRow& oRow : oResult)
+    {
+      CcSyncJournalEntry oEntry;
+      oEntry.uiId = oRow[0].getUint64();
+      oEntry.eType = (EBackupQueueType) oRow[1].getUint16();
+      oEntry.oFileInfo.id() = oRow[2].getUint64();
+      oEntry.oFileInfo.dirId() = oRow[3].getUint64();
+      oEntry.oFileInfo.name() = oRow[4].getString();
+      oEntry.oFileInfo.fileSize() = oRow[5].getUint64();
+      oEntry.oFileInfo.modified() = oRow[6].getInt64();
+      oEntry.oFileInfo.attributes() = oRow[7].getString();
+      oEntry.oFileInfo.crc() = oRow[8].getUint32();
+      oEntry.oFileInfo.md5().setHexString(oRow[9].getString());
+      oEntries.append(oEntry);
+    }
+  }
+  return oEntries;
+}
+
+uint64 CcSyncDbClient::queueInsert(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName, uint64 uiSize)
 {
-  CcString sQuery = getDbInsertQueue(sDirName, uiParentId, eQueueType, uiFileId, uiDirectoryId, sName);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  if (uiParentId == 0 &&
+      isQueueFileOperation(eQueueType))
+  {
+    uint64 uiExistingId = queueCoalesceInsert(sDirName, eQueueType, uiFileId, uiDirectoryId, sName);
+    if (uiExistingId != 0)
+    {
+      return uiExistingId;
+    }
+  }
+  CcString sQuery = getDbInsertQueue(sDirName, uiParentId, eQueueType, uiFileId, uiDirectoryId, sName, uiSize);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     return oResult.getLastInsertId();
@@ -786,7 +1144,7 @@ bool CcSyncDbClient::directoryListRemove(const CcString& sDirName, const CcSyncF
   CcString sQuery;
   sQuery << "DELETE FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "`"\
             "WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "` = '" << CcString::fromNumber(oFileInfo.getId()) << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     bRet = true;
@@ -810,7 +1168,7 @@ bool CcSyncDbClient::directoryListExists(const CcString& sDirName, uint64 uiDirI
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Id << "` ";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "`='" << CcString::fromNumber(uiDirId) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -828,7 +1186,7 @@ bool CcSyncDbClient::directoryListSubDirExists(const CcString& sDirName, uint64
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::DirectoryListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::DirectoryList::DirId << "`='" << CcString::fromNumber(uiParentDirId) << "' " <<
     "AND `" << CcSyncGlobals::Database::DirectoryList::Name << "`='" << CcSqlite::escapeString(sName) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -856,7 +1214,7 @@ bool CcSyncDbClient::directoryListInsert(const CcString& sDirName, CcSyncFileInf
 {
   bool bRet = false;
   CcString sQuery = getDbInsertDirectoryList(sDirName, oFileInfo);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     oFileInfo.id() = oResult.getLastInsertId();
@@ -881,7 +1239,7 @@ bool CcSyncDbClient::directoryListUpdate(const CcString& sDirName, const CcSyncF
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Name << "` = '" << CcSqlite::escapeString(oFileInfo.getName()) << "', ";
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Modified << "` = '" << CcString::fromNumber(oFileInfo.getModified()) << "'";
   sQuery << " WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "` = " << CcString::fromNumber(oFileInfo.getId());
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   directoryListUpdateChanged(sDirName, oFileInfo.getId());
   return oResult.ok();
 }
@@ -896,7 +1254,7 @@ bool CcSyncDbClient::directoryListUpdateId(const CcString& sDirName, uint64 uiDi
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Name << "` = '" << CcSqlite::escapeString(oFileInfo.getName()) << "', ";
   sQuery << "`" << CcSyncGlobals::Database::DirectoryList::Modified << "` = '" << CcString::fromNumber(oFileInfo.getModified()) << "'";
   sQuery << " WHERE `" << CcSyncGlobals::Database::DirectoryList::Id << "` = " << CcString::fromNumber(uiDirectoryId);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   directoryListUpdateChanged(sDirName, oFileInfo.getId());
   return oResult.ok();
 }
@@ -905,7 +1263,7 @@ bool CcSyncDbClient::fileListInsert(const CcString& sDirName, CcSyncFileInfo& oF
 {
   bool bRet = false;
   CcString sQuery = getDbInsertFileList(sDirName, oFileInfo);
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     oFileInfo.id() = oResult.getLastInsertId();
@@ -934,7 +1292,7 @@ bool CcSyncDbClient::fileListRemove(const CcString& sDirName, const CcSyncFileIn
   CcString sQuery = "DELETE FROM `";
   sQuery << sDirName + CcSyncGlobals::Database::FileListAppend << "`"\
             "WHERE `" << CcSyncGlobals::Database::FileList::Id << "` = '" << CcString::fromNumber(oFileInfo.getId()) << "'";
-  CcSqlResult oResult = m_pDatabase->query(sQuery);
+  CcSqlResult oResult = query(sQuery);
   if (oResult.ok())
   {
     bRet = true;
@@ -958,7 +1316,7 @@ bool CcSyncDbClient::fileListExists(const CcString& sDirName, uint64 uiFileId)
   sQuery << "`" << CcSyncGlobals::Database::FileList::Id << "` ";
   sQuery << " FROM `" << sDirName + CcSyncGlobals::Database::FileListAppend << "` "\
     "WHERE `" << CcSyncGlobals::Database::FileList::Id << "`='" << CcString::fromNumber(uiFileId) << "'";
-  CcSqlResult oSqlDirectoryList = m_pDatabase->query(sQuery);
+  CcSqlResult oSqlDirectoryList = query(sQuery);
   if (oSqlDirectoryList.ok() &&
     oSqlDirectoryList.size() > 0)
   {
@@ -1018,6 +1376,7 @@ CcString CcSyncDbClient::getDbCreateQueue(const CcString& sDirName)
   sRet << "`" << CcSyncGlobals::Database::Queue::DirId     << "` INTEGER NULL,";
   sRet << "`" << CcSyncGlobals::Database::Queue::Name      << "` TEXT NULL,";
   sRet << "`" << CcSyncGlobals::Database::Queue::Attempts  << "` INTEGER DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Queue::Size      << "` INTEGER DEFAULT 0,";
   sRet << "FOREIGN KEY(`" << CcSyncGlobals::Database::Queue::QueueId << "`) REFERENCES `" << sDirName + CcSyncGlobals::Database::QueueAppend + 
           "`(`" << CcSyncGlobals::Database::Queue::Id << "`) ON UPDATE CASCADE ON DELETE CASCADE);\r\n";
   sRet << "CREATE INDEX Index_" << sTableName << "_" << CcSyncGlobals::Database::Queue::QueueId +
@@ -1025,6 +1384,23 @@ CcString CcSyncDbClient::getDbCreateQueue(const CcString& sDirName)
   return sRet;
 }
 
+CcString CcSyncDbClient::getDbCreateQueueIndex(const CcString& sDirName)
+{
+  // Ready items are selected by QueueId IS NULL and Attempts, dependents by QueueId
+  CcString sTableName = sDirName + CcSyncGlobals::Database::QueueAppend;
+  CcString sRet("CREATE INDEX IF NOT EXISTS `Index_");
+  sRet << sTableName << "_Ready` ON `" << sTableName << "`(";
+  sRet << "`" << CcSyncGlobals::Database::Queue::QueueId << "`,";
+  sRet << "`" << CcSyncGlobals::Database::Queue::Attempts << "`,";
+  sRet << "`" << CcSyncGlobals::Database::Queue::DirId << "`);\r\n";
+  // Coalescing is looking up pending operations by path
+  sRet << "CREATE INDEX IF NOT EXISTS `Index_";
+  sRet << sTableName << "_Path` ON `" << sTableName << "`(";
+  sRet << "`" << CcSyncGlobals::Database::Queue::DirId << "`,";
+  sRet << "`" << CcSyncGlobals::Database::Queue::Name << "`);";
+  return sRet;
+}
+
 CcString CcSyncDbClient::getDbCreateHistory(const CcString& sDirName)
 {
   CcString sRet(CcSyncGlobals::Database::CreateTable);
@@ -1042,6 +1418,23 @@ CcString CcSyncDbClient::getDbCreateHistory(const CcString& sDirName)
   return sRet;
 }
 
+CcString CcSyncDbClient::getDbCreateJournal(const CcString& sDirName)
+{
+  CcString sRet(CcSyncGlobals::Database::CreateTable);
+  sRet << sDirName + CcSyncGlobals::Database::JournalAppend << "` (";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Id        << "` INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Type      << "` INTEGER,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::FileId    << "` INTEGER DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::DirId     << "` INTEGER DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Name      << "` TEXT NOT NULL,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Size      << "` UNSIGNED BIG INT DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Modified  << "` TIMESTAMP DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::Attributes<< "` VARCHAR(10) NOT NULL,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::CRC       << "` UNSIGNED INT DEFAULT 0,";
+  sRet << "`" << CcSyncGlobals::Database::Journal::MD5       << "` VARCHAR(32) NULL);";
+  return sRet;
+}
+
 CcString CcSyncDbClient::getDbInsertDirectoryList(const CcString& sDirName, const CcSyncFileInfo& oInfo)
 {
   CcString sId, sDirId;
@@ -1115,7 +1508,7 @@ CcString CcSyncDbClient::getDbInsertFileList(const CcString& sDirName, const CcS
   return sRet;
 }
 
-CcString CcSyncDbClient::getDbInsertQueue(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirId, const CcString& sName)
+CcString CcSyncDbClient::getDbInsertQueue(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirId, const CcString& sName, uint64 uiSize)
 {
   CcString sParentId;
   CcString sDirId;
@@ -1153,7 +1546,8 @@ CcString CcSyncDbClient::getDbInsertQueue(const CcString& sDirName, uint64 uiPar
   sRet << "`" << CcSyncGlobals::Database::Queue::FileId << "`,";
   sRet << "`" << CcSyncGlobals::Database::Queue::DirId << "`,";
   sRet << "`" << CcSyncGlobals::Database::Queue::Name << "`,";
-  sRet << "`" << CcSyncGlobals::Database::Queue::Attempts << "`";
+  sRet << "`" << CcSyncGlobals::Database::Queue::Attempts << "`,";
+  sRet << "`" << CcSyncGlobals::Database::Queue::Size << "`";
   sRet << ") ";
 
   sRet << "VALUES (";
@@ -1163,7 +1557,8 @@ CcString CcSyncDbClient::getDbInsertQueue(const CcString& sDirName, uint64 uiPar
   sRet << sFileId    << ",";
   sRet << sDirId  << ",";
   sRet << "'" << CcSqlite::escapeString(sName) << "',";
-  sRet << "0";
+  sRet << "0,";
+  sRet << CcString::fromNumber(uiSize);
   sRet << ")";
   return sRet;
 }
@@ -1212,3 +1607,131 @@ CcString CcSyncDbClient::getDbInsertHistory(const CcString& sDirName, EBackupQue
   sRet << ")";
   return sRet;
 }
+
+void CcSyncDbClient::commitGroupTransaction()
+{
+  // Commit outer transaction and reopen it, inner counter keeps unchanged
+  if (m_uiTransactionCnt > 0)
+  {
+    flushQueues();
+    CcSyncTraceSpan oSpan("Commit", "Database");
+    m_pDatabase->endTransaction();
+    m_pDatabase->beginTransaction();
+    m_uiCommits++;
+  }
+  m_uiGroupItems = 0;
+  m_bGroupPending = false;
+  m_oGroupStart = CcKernel::getUpTime();
+}
+
+CcSqlResult CcSyncDbClient::query(const CcString& sQuery)
+{
+  CcSyncTraceSpan oSpan("Query", "Database");
+  if (oSpan.isActive())
+    oSpan.setDetail(sQuery.substr(0, 120));
+  return CcSyncDbProfiler::query(*m_pDatabase, sQuery);
+}
+
+void CcSyncDbClient::flushQueues()
+{
+  for (CcSyncQueue* pQueue : m_oQueues)
+  {
+    pQueue->flush();
+  }
+}
+
+bool CcSyncDbClient::isQueueFileOperation(EBackupQueueType eQueueType)
+{
+  return eQueueType == EBackupQueueType::AddFile ||
+         eQueueType == EBackupQueueType::RemoveFile ||
+         eQueueType == EBackupQueueType::DownloadFile;
+}
+
+CcString CcSyncDbClient::getDbQueueCoalesceCondition(const CcString& sTableName, const CcString& sAlias)
+{
+  // Only ready file operations without dependents can be replaced, dependents
+  // would be removed by cascade.
+  CcString sRet;
+  sRet << "`" << sAlias << "`.`" << CcSyncGlobals::Database::Queue::QueueId << "` IS NULL ";
+  sRet << "AND `" << sAlias << "`.`" << CcSyncGlobals::Database::Queue::Attempts << "` < " << CcString::fromNumber(CcSyncGlobals::Database::QueueMaxAttempts) << " ";
+  sRet << "AND `" << sAlias << "`.`" << CcSyncGlobals::Database::Queue::Type << "` IN (";
+  sRet << CcString::fromNumber(static_cast<uint16>(EBackupQueueType::AddFile)) << ",";
+  sRet << CcString::fromNumber(static_cast<uint16>(EBackupQueueType::RemoveFile)) << ",";
+  sRet << CcString::fromNumber(static_cast<uint16>(EBackupQueueType::DownloadFile)) << ") ";
+  sRet << "AND NOT EXISTS (SELECT 1 FROM `" << sTableName << "` AS `Dependent` WHERE ";
+  sRet << "`Dependent`.`" << CcSyncGlobals::Database::Queue::QueueId << "` = `" << sAlias << "`.`" << CcSyncGlobals::Database::Queue::Id << "`)";
+  return sRet;
+}
+
+uint64 CcSyncDbClient::queueCoalesceInsert(const CcString& sDirName, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirId, const CcString& sName)
+{
+  uint64 uiExistingId = 0;
+  CcSyncQueue* pQueue = queueGetLoaded(sDirName);
+  CcString sTableName = sDirName + CcSyncGlobals::Database::QueueAppend;
+  CcString sQuery = "SELECT ";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Id << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::Type << "`,";
+  sQuery << "`" << CcSyncGlobals::Database::Queue::FileId << "`";
+  sQuery << " FROM `" << sTableName << "` ";
+  sQuery << "WHERE " << getDbQueueCoalesceCondition(sTableName, sTableName) << " ";
+  sQuery << "AND `" << CcSyncGlobals::Database::Queue::DirId << "` = " << CcString::fromNumber(uiDirId) << " ";
+  sQuery << "AND `" << CcSyncGlobals::Database::Queue::Name << "` = '" << CcSqlite::escapeString(sName) << "' ";
+  sQuery << "ORDER BY `" << CcSyncGlobals::Database::Queue::Id << "`";
+  CcSqlResult oResult = query(sQuery);
+  if (oResult.ok())
+  {
+    CcString sIdList;
+    for (CcTableRow& oRow : oResult)
+    {
+      uint64 uiId = oRow[0].getUint64();
+      bool bSame = (EBackupQueueType) oRow[1].getUint16() == eQueueType &&
+                   oRow[2].getUint64() == uiFileId;
+      if (pQueue != nullptr &&
+          pQueue->isFinished(uiId))
+      {
+        // Finalized but not yet flushed, it will be removed and must not be reused
+      }
+      else if (pQueue != nullptr &&
+               pQueue->isRunning(uiId))
+      {
+        // Transfer is already in progress with old state, new operation is required
+      }
+      else if (bSame && uiExistingId == 0)
+      {
+        // Reuse first equal operation
+        uiExistingId = uiId;
+      }
+      else
+      {
+        if (pQueue != nullptr)
+          pQueue->drop(uiId);
+        if (sIdList.length() > 0)
+          sIdList << ",";
+        sIdList << CcString::fromNumber(uiId);
+      }
+    }
+    if (sIdList.length() > 0)
+    {
+      // Superseded by new operation on same path
+      CcString sDeleteQuery = "DELETE FROM `";
+      sDeleteQuery << sTableName << "` ";
+      sDeleteQuery << "WHERE `" << CcSyncGlobals::Database::Queue::Id << "` IN (" << sIdList << ")";
+      CcSqlResult oDeleteResult = query(sDeleteQuery);
+      if (oDeleteResult.error())
+      {
+        CCSYNC_DEBUG("Removing superseded queue items failed.");
+      }
+    }
+  }
+  return uiExistingId;
+}
+
+CcSyncQueue* CcSyncDbClient::queueGetLoaded(const CcString& sDirName)
+{
+  for (CcSyncQueue* pQueue : m_oQueues)
+  {
+    if (pQueue->getDirName() == sDirName)
+      return pQueue;
+  }
+  return nullptr;
+}
@@ -34,12 +34,18 @@
 #include "CcSync.h"
 #include "CcSharedPointer.h"
 #include "CcSqlite.h"
+#include "CcDateTime.h"
+#include "CcList.h"
+#include "CcMutex.h"
 #include "CcSharedPointer.h"
+#include "CcSyncFileInfo.h"
+#include <atomic>
 
 class CcString;
-class CcSyncFileInfo;
 class CcSyncFileInfoList;
 class CcSyncDbClient;
+class CcSyncQueue;
+class CcSyncQueueItem;
 
 #ifdef _MSC_VER
 template class CcSyncSHARED CcSharedPointer<CcSqlite>;
@@ -61,6 +67,26 @@ enum class EBackupQueueType : uint16
   RemoveErrorFile,
 };
 
+/**
+ * @brief One row of Journal table, it is written before a file or directory
+ *        is changed on disk and removed together with update of lists.
+ *        Rows left after a crash are reconciled on next start.
+ */
+class CcSyncSHARED CcSyncJournalEntry
+{
+public:
+  uint64            uiId    = 0;
+  EBackupQueueType  eType   = EBackupQueueType::Unknown;
+  //! Target state of file or directory
+  CcSyncFileInfo    oFileInfo;
+  //! Number of commits when row was written, see CcSyncDbClient::journalSync
+  uint64            uiCommit = 0;
+};
+
+#ifdef _MSC_VER
+template class CcSyncSHARED CcList<CcSyncJournalEntry>;
+#endif
+
 /**
  * @brief Class impelmentation
  */
@@ -99,6 +125,15 @@ public:
   bool operator!=(const CcSyncDbClient& oToCompare) const;
 
   bool openDatabase(const CcString& sPath);
+  /**
+   * @brief Switch journal to write ahead log, so readers on other
+   *        connections are not blocked by a running write transaction.
+   */
+  bool enableWriteAheadLog();
+  /**
+   * @brief Reject all writes on this connection, used for readers.
+   */
+  bool setReadOnly();
   bool setupDirectory(const CcString& sDirName);
   bool removeDirectory(const CcString& sDirName);
 
@@ -106,6 +141,36 @@ public:
 
   void beginTransaction();
   void endTransaction();
+  /**
+   * @brief Open a transaction wich is kept open over multiple items.
+   *        Call nextGroupTransaction after each item, it commits if
+   *        GroupCommitItems or GroupCommitTime is reached.
+   *        Items wich are changing the filesystem are writing a journal
+   *        row first, so they can be recovered if group is lost.
+   */
+  void beginGroupTransaction();
+  void nextGroupTransaction();
+  /**
+   * @brief Commit current group if items were processed since last commit,
+   *        so they are visible to readers on other connections.
+   */
+  void commitPendingGroupTransaction();
+  void endGroupTransaction();
+  /**
+   * @brief Check if processed items are not yet committed, it can be called
+   *        without lock, readers are not seeing these items until commit.
+   */
+  bool hasPendingGroupTransaction() const
+    { return m_bGroupPending; }
+
+  /**
+   * @brief Lock database for current thread, required if items of queue are
+   *        processed by multiple threads.
+   */
+  void lock()
+    { m_oLock.lock(); }
+  void unlock()
+    { m_oLock.unlock(); }
 
   CcString getInnerPathById(const CcString& sDirName, uint64 uiDirId);
   CcSyncFileInfoList getDirectoryInfoListById(const CcString& sDirName, uint64 uiDirId);
@@ -124,7 +189,23 @@ public:
   void queueResetAttempts(const CcString& sDirName);
   void queueDownloadDirectory(const CcString& sDirName, const CcSyncFileInfo& oFileInfo);
   void queueDownloadFile(const CcString& sDirName, const CcSyncFileInfo& oFileInfo);
-  uint64 queueInsert(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName);
+  /**
+   * @brief Remove all ready file operations wich are superseded by a newer
+   *        operation on same path, so only the net operation will be executed.
+   *        Queue of directory must not be in progress.
+   */
+  void queueCoalesce(const CcString& sDirName);
+  /**
+   * @brief Insert item to queue, file operations without parent are
+   *        coalesced with pending operations on same path.
+   * @return Id of new item, or of existing equal item.
+   */
+  uint64 queueInsert(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName, uint64 uiSize = 0);
+  bool queueLoad(const CcString& sDirName, uint64 uiAfterId, size_t uiCount, CcList<CcSyncQueueItem>& oItems);
+  void queueFinalizeList(const CcString& sDirName, const CcList<CcSyncQueueItem>& oItems);
+  void queueUpdateAttempts(const CcString& sDirName, const CcList<CcSyncQueueItem>& oItems);
+  void queueRegister(CcSyncQueue* pQueue);
+  void queueUnregister(CcSyncQueue* pQueue);
 
   bool directoryListRemove(const CcString& sDirName, const CcSyncFileInfo& oFileInfo, bool bDoUpdateParents);
   bool directoryListUpdate(const CcString& sDirName, const CcSyncFileInfo& oFileInfo);
@@ -146,6 +227,23 @@ public:
   void fileListSearchTemporary(const CcString& sDirName);
 
   bool historyInsert(const CcString& sDirName, EBackupQueueType eQueueType, const CcSyncFileInfo& oFileInfo);
+
+  /**
+   * @brief Write intent of a change on disk to journal, Id of row and
+   *        current number of commits are stored in oEntry.
+   */
+  bool journalInsert(const CcString& sDirName, CcSyncJournalEntry& oEntry);
+  /**
+   * @brief Make sure that journal row is committed, call it directly before
+   *        disk is changed. Commit is skipped if group was committed since
+   *        row was written, so items of one group are sharing commits.
+   */
+  void journalSync(const CcSyncJournalEntry& oEntry);
+  /**
+   * @brief Remove journal row, call it with same transaction as update of lists.
+   */
+  bool journalRemove(const CcString& sDirName, const CcSyncJournalEntry& oEntry);
+  CcList<CcSyncJournalEntry> journalLoad(const CcString& sDirName);
   inline void historyEnable()
     { m_bEnableHistory = true;}
   inline void historyDisable()
@@ -157,14 +255,35 @@ private: // Methods
   CcString getDbCreateDirectoryList(const CcString& sDirName);
   CcString getDbCreateFileList(const CcString& sDirName);
   CcString getDbCreateQueue(const CcString& sDirName);
+  CcString getDbCreateQueueIndex(const CcString& sDirName);
   CcString getDbCreateHistory(const CcString& sDirName);
+  CcString getDbCreateJournal(const CcString& sDirName);
   CcString getDbInsertDirectoryList(const CcString& sDirName, const CcSyncFileInfo& oInfo);
   CcString getDbInsertFileList(const CcString& sDirName, const CcSyncFileInfo& oInfo);
-  CcString getDbInsertQueue(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName);
+  CcString getDbInsertQueue(const CcString& sDirName, uint64 uiParentId, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirectoryId, const CcString& sName, uint64 uiSize);
   CcString getDbInsertHistory(const CcString& sDirName, EBackupQueueType eQueueType, const CcSyncFileInfo& oFileInfo);
+  CcString getDbQueueCoalesceCondition(const CcString& sTableName, const CcString& sAlias);
+  uint64 queueCoalesceInsert(const CcString& sDirName, EBackupQueueType eQueueType, uint64 uiFileId, uint64 uiDirId, const CcString& sName);
+  CcSyncQueue* queueGetLoaded(const CcString& sDirName);
+  static bool isQueueFileOperation(EBackupQueueType eQueueType);
+  void commitGroupTransaction();
+  void flushQueues();
+  /**
+   * @brief Execute query on database, all queries of this class are
+   *        passing it, so they can be traced and profiled.
+   */
+  CcSqlResult query(const CcString& sQuery);
 private:
   CcSharedPointer<CcSqlite> m_pDatabase;
   size_t m_uiTransactionCnt = 0;
+  size_t m_uiGroupCnt = 0;
+  size_t m_uiGroupItems = 0;
+  std::atomic<bool> m_bGroupPending{false};
+  //! Number of commits on this connection, used to skip journalSync
+  uint64 m_uiCommits = 0;
+  CcDateTime m_oGroupStart;
+  CcList<CcSyncQueue*> m_oQueues;
+  CcMutex m_oLock;
   bool m_bEnableHistory = true;
 };
 
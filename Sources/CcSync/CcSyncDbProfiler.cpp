@@ -0,0 +1,261 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncDbProfiler
+ */
+#include "CcSyncDbProfiler.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncConsole.h"
+#include "CcKernel.h"
+#include "Json/CcJsonArray.h"
+
+std::atomic<bool> CcSyncDbProfiler::s_bEnabled(false);
+CcMutex CcSyncDbProfiler::s_oLock;
+CcMap<CcString, CcSyncDbProfilerStatement> CcSyncDbProfiler::s_oStatements;
+
+static bool isNamePart(char cSign)
+{
+  return (cSign >= 'a' && cSign <= 'z') ||
+         (cSign >= 'A' && cSign <= 'Z') ||
+         (cSign >= '0' && cSign <= '9') ||
+         cSign == '_';
+}
+
+static bool isExplainable(const CcString& sQuery)
+{
+  CcString sCommand = sQuery.substr(0, 7).getLower();
+  return sCommand.startsWith("select") ||
+         sCommand.startsWith("insert") ||
+         sCommand.startsWith("update") ||
+         sCommand.startsWith("delete") ||
+         sCommand.startsWith("replace") ||
+         sCommand.startsWith("with");
+}
+
+static uint64 getProfileValue(CcJsonObject& oObject, const CcString& sName)
+{
+  uint64 uiValue = 0;
+  if (oObject.contains(sName, EJsonDataType::Value))
+    uiValue = oObject[sName].getValue().getUint64();
+  return uiValue;
+}
+
+void CcSyncDbProfiler::setEnabled(bool bEnable)
+{
+  s_oLock.lock();
+  if (bEnable &&
+      s_bEnabled == false)
+  {
+    s_oStatements.clear();
+  }
+  s_bEnabled = bEnable;
+  s_oLock.unlock();
+}
+
+CcSqlResult CcSyncDbProfiler::query(CcSqlite& oDatabase, const CcString& sQuery)
+{
+  if (isEnabled())
+  {
+    int64 iStart = CcKernel::getUpTime().getTimestampUs();
+    CcSqlResult oResult = oDatabase.query(sQuery);
+    uint64 uiTime = static_cast<uint64>(CcKernel::getUpTime().getTimestampUs() - iStart);
+    record(oDatabase, sQuery, uiTime, oResult.size());
+    return oResult;
+  }
+  return oDatabase.query(sQuery);
+}
+
+void CcSyncDbProfiler::getJson(CcJsonObject& oProfile)
+{
+  s_oLock.lock();
+  CcMap<CcString, CcSyncDbProfilerStatement> oStatements = s_oStatements;
+  s_oLock.unlock();
+  if (oStatements.size() > 0)
+  {
+    CcJsonNode oQueryList(EJsonDataType::Array);
+    oQueryList.setName(CcSyncGlobals::Commands::ServerGetStats::QueryList);
+    for (size_t uiCount = 0; uiCount < CcSyncGlobals::ProfilerReportSize && oStatements.size() > 0; uiCount++)
+    {
+      size_t uiSelected = 0;
+      for (size_t uiPos = 1; uiPos < oStatements.size(); uiPos++)
+      {
+        if (oStatements.at(uiPos).getValue().uiTime > oStatements.at(uiSelected).getValue().uiTime)
+          uiSelected = uiPos;
+      }
+      const CcSyncDbProfilerStatement& rStatement = oStatements.at(uiSelected).getValue();
+      CcJsonObject oQuery;
+      oQuery.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Statement, oStatements.at(uiSelected).getKey()));
+      oQuery.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Requests, rStatement.uiCount));
+      oQuery.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Time, rStatement.uiTime));
+      oQuery.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::MaxTime, rStatement.uiMaxTime));
+      oQuery.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Rows, rStatement.uiRows));
+      if (rStatement.slPlan.size() > 0)
+      {
+        CcJsonNode oPlan(EJsonDataType::Array);
+        oPlan.setName(CcSyncGlobals::Commands::ServerGetStats::Plan);
+        for (const CcString& sLine : rStatement.slPlan)
+        {
+          oPlan.array().add(CcJsonNode("", sLine));
+        }
+        oQuery.append(std::move(oPlan));
+      }
+      oQueryList.array().add(CcJsonNode(oQuery, ""));
+      oStatements.remove(uiSelected);
+    }
+    oProfile.append(std::move(oQueryList));
+  }
+}
+
+void CcSyncDbProfiler::printReport(CcJsonObject& oProfile)
+{
+  if (oProfile.contains(CcSyncGlobals::Commands::ServerGetStats::QueryList, EJsonDataType::Array))
+  {
+    CcSyncConsole::writeLine("");
+    CcSyncConsole::writeLine("Query: requests, total ms, avg us, max ms, rows");
+    for (CcJsonNode& oNode : oProfile[CcSyncGlobals::Commands::ServerGetStats::QueryList].array())
+    {
+      CcJsonObject& oQuery = oNode.object();
+      uint64 uiRequests = getProfileValue(oQuery, CcSyncGlobals::Commands::ServerGetStats::Requests);
+      uint64 uiTime = getProfileValue(oQuery, CcSyncGlobals::Commands::ServerGetStats::Time);
+      uint64 uiAverage = 0;
+      if (uiRequests > 0)
+        uiAverage = uiTime / uiRequests;
+      CcSyncConsole::writeLine("  " + oQuery[CcSyncGlobals::Commands::ServerGetStats::Statement].getValue().getString());
+      CcSyncConsole::writeLine("    " + CcString::fromNumber(uiRequests) + ", " +
+                               CcString::fromNumber(uiTime / 1000) + ", " +
+                               CcString::fromNumber(uiAverage) + ", " +
+                               CcString::fromNumber(getProfileValue(oQuery, CcSyncGlobals::Commands::ServerGetStats::MaxTime) / 1000) + ", " +
+                               CcString::fromNumber(getProfileValue(oQuery, CcSyncGlobals::Commands::ServerGetStats::Rows)));
+      if (oQuery.contains(CcSyncGlobals::Commands::ServerGetStats::Plan, EJsonDataType::Array))
+      {
+        for (CcJsonNode& oLine : oQuery[CcSyncGlobals::Commands::ServerGetStats::Plan].array())
+        {
+          CcSyncConsole::writeLine("    plan: " + oLine.getValue().getString());
+        }
+      }
+    }
+  }
+  else
+  {
+    CcSyncConsole::writeLine("No queries profiled");
+  }
+}
+
+CcString CcSyncDbProfiler::normalize(const CcString& sQuery)
+{
+  CcString sNormalized;
+  size_t uiPos = 0;
+  while (uiPos < sQuery.length())
+  {
+    char cSign = sQuery[uiPos];
+    bool bValue = false;
+    if (cSign == '\'')
+    {
+      // Skip literal, quotes within are escaped by doubling them
+      uiPos++;
+      while (uiPos < sQuery.length())
+      {
+        if (sQuery[uiPos] == '\'')
+        {
+          if (uiPos + 1 < sQuery.length() &&
+              sQuery[uiPos + 1] == '\'')
+            uiPos++;
+          else
+            break;
+        }
+        uiPos++;
+      }
+      uiPos++;
+      bValue = true;
+    }
+    else if (cSign >= '0' && cSign <= '9' &&
+             (uiPos == 0 || isNamePart(sQuery[uiPos - 1]) == false))
+    {
+      while (uiPos < sQuery.length() &&
+             ((sQuery[uiPos] >= '0' && sQuery[uiPos] <= '9') || sQuery[uiPos] == '.'))
+      {
+        uiPos++;
+      }
+      bValue = true;
+    }
+    else
+    {
+      sNormalized.append(cSign);
+      uiPos++;
+    }
+    if (bValue)
+    {
+      // Lists of values like in IN (1,2,3) are getting one ?, independent of their length
+      if (sNormalized.endsWith("?,"))
+        sNormalized = sNormalized.substr(0, sNormalized.length() - 1);
+      else if (sNormalized.endsWith("?, "))
+        sNormalized = sNormalized.substr(0, sNormalized.length() - 2);
+      else
+        sNormalized.append('?');
+    }
+  }
+  return sNormalized;
+}
+
+void CcSyncDbProfiler::record(CcSqlite& oDatabase, const CcString& sQuery, uint64 uiTime, uint64 uiRows)
+{
+  CcString sStatement = normalize(sQuery);
+  bool bPlan = false;
+  s_oLock.lock();
+  if (s_oStatements.containsKey(sStatement) == false)
+    s_oStatements.append(sStatement, CcSyncDbProfilerStatement());
+  CcSyncDbProfilerStatement& rStatement = s_oStatements.getValue(sStatement);
+  rStatement.uiCount++;
+  rStatement.uiTime += uiTime;
+  rStatement.uiRows += uiRows;
+  if (uiTime > rStatement.uiMaxTime)
+    rStatement.uiMaxTime = uiTime;
+  if (rStatement.bPlan == false &&
+      uiTime >= CcSyncGlobals::ProfilerPlanTime &&
+      isExplainable(sQuery))
+  {
+    // Mark it before unlock, so plan is captured only once
+    rStatement.bPlan = true;
+    bPlan = true;
+  }
+  s_oLock.unlock();
+  if (bPlan)
+  {
+    // Caller is still owner of connection, so plan is read with same tables and indexes
+    CcStringList slPlan;
+    CcSqlResult oPlan = oDatabase.query("EXPLAIN QUERY PLAN " + sQuery);
+    if (oPlan.ok())
+    {
+      for (size_t uiRow = 0; uiRow < oPlan.size(); uiRow++)
+      {
+        // Detail is the last column
+        slPlan.append(oPlan[uiRow][oPlan[uiRow].size() - 1].getString());
+      }
+    }
+    s_oLock.lock();
+    if (s_oStatements.containsKey(sStatement))
+      s_oStatements.getValue(sStatement).slPlan = slPlan;
+    s_oLock.unlock();
+  }
+}
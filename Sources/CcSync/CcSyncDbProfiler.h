@@ -0,0 +1,110 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncDbProfiler
+ *
+ * @page      CcSyncDbProfiler
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncDbProfiler
+ *
+ *  Optional profiling of all queries of CcSyncDbClient and CcSyncDbServer.
+ *  Queries are grouped by statement with literals and numbers replaced by ?,
+ *  so each statement is counted once independent of its values.
+ *  The query plan of a statement is captured with EXPLAIN QUERY PLAN on the
+ *  same connection, the first time one execution takes ProfilerPlanTime or
+ *  longer. While profiling is disabled a query only checks one flag.
+ **/
+#ifndef _CcSyncDbProfiler_H_
+#define _CcSyncDbProfiler_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcStringList.h"
+#include "CcMutex.h"
+#include "CcMap.h"
+#include "CcSqlite.h"
+#include "Json/CcJsonObject.h"
+#include <atomic>
+
+/**
+ * @brief Measured values of one normalized statement
+ */
+class CcSyncDbProfilerStatement
+{
+public:
+  uint64    uiCount   = 0;
+  uint64    uiTime    = 0;
+  uint64    uiMaxTime = 0;
+  uint64    uiRows    = 0;
+  bool      bPlan     = false;
+  CcStringList slPlan;
+};
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncDbProfiler
+{
+public:
+  /**
+   * @brief Start or stop profiling, values of last profile are dropped on start.
+   */
+  static void setEnabled(bool bEnable);
+  static bool isEnabled()
+    { return s_bEnabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Execute query on database and record time and rows if enabled.
+   * @param oDatabase: Connection to execute query on
+   * @param sQuery:    Query to execute
+   * @return Result of query
+   */
+  static CcSqlResult query(CcSqlite& oDatabase, const CcString& sQuery);
+
+  /**
+   * @brief Get statements with highest total time, at most ProfilerReportSize.
+   * @param oProfile: Target for list of statements
+   */
+  static void getJson(CcJsonObject& oProfile);
+
+  /**
+   * @brief Write report of statements from getJson to console.
+   */
+  static void printReport(CcJsonObject& oProfile);
+
+  /**
+   * @brief Replace string literals and numbers in query by ?
+   */
+  static CcString normalize(const CcString& sQuery);
+
+private:
+  static void record(CcSqlite& oDatabase, const CcString& sQuery, uint64 uiTime, uint64 uiRows);
+
+private:
+  static std::atomic<bool> s_bEnabled;
+  static CcMutex s_oLock;
+  static CcMap<CcString, CcSyncDbProfilerStatement> s_oStatements;
+};
+
+#endif /* _CcSyncDbProfiler_H_ */
@@ -31,6 +31,7 @@
 #include "CcKernel.h"
 #include "CcDateTime.h"
 #include "CcSyncLog.h"
+#include "CcSyncDbProfiler.h"
 
 CcSyncDbServer::CcSyncDbServer( const CcString& sPath )
 {
@@ -90,7 +91,7 @@ bool CcSyncDbServer::openDatabase(const CcString& sPath)
   {
     if (!m_pDatabase->tableExists(CcSyncGlobals::Server::Database::TableNameUser))
     {
-      if (m_pDatabase->query(getDbCreateUser()).ok())
+      if (query(getDbCreateUser()).ok())
       {
         bRet = true;
       }
@@ -120,7 +121,7 @@ bool CcSyncDbServer::userExistsInDatabase(const CcString& sAccountName, const Cc
   sRequest << "` WHERE ";
   sRequest << "`" << CcSyncGlobals::Database::User::Account << "` = '" << CcSqlite::escapeString(sAccountName) << "' ";
   sRequest << "AND `" << CcSyncGlobals::Database::User::Username << "` = '" << CcSqlite::escapeString(sUsername) << "'";
-  CcSqlResult sResult = m_pDatabase->query(sRequest);
+  CcSqlResult sResult = query(sRequest);
   if (sResult.ok() &&
     sResult.size() > 0)
   {
@@ -132,7 +133,7 @@ bool CcSyncDbServer::userExistsInDatabase(const CcString& sAccountName, const Cc
 bool CcSyncDbServer::updateUser(const CcString& sAccountName, const CcString& sUsername, const CcString& sToken)
 {
   CcString sUpdateString = getDbUpdateUser(sAccountName, sUsername, sToken);
-  CcSqlResult oResult = m_pDatabase->query(sUpdateString);
+  CcSqlResult oResult = query(sUpdateString);
   if (oResult.ok())
   {
     return true;
@@ -144,7 +145,7 @@ bool CcSyncDbServer::updateUser(const CcString& sAccountName, const CcString& sU
 bool CcSyncDbServer::insertUser(const CcString& sAccountName, const CcString& sUsername, const CcString& sToken)
 {
   CcString sRequest = getDbInsertUser(sAccountName, sUsername, sToken);
-  CcSqlResult oResult = m_pDatabase->query(sRequest);
+  CcSqlResult oResult = query(sRequest);
   if (oResult.ok())
   {
     return true;
@@ -159,7 +160,7 @@ bool CcSyncDbServer::getUserByToken(const CcString& sToken, CcString& sAccountNa
   sSqlQuery << CcSyncGlobals::Database::User::Account << "`, `" << CcSyncGlobals::Database::User::Username << "` FROM ";
   sSqlQuery << "`" << CcSyncGlobals::Server::Database::TableNameUser << "` ";
   sSqlQuery << "WHERE `" << CcSyncGlobals::Database::User::Session << "`='" << CcSqlite::escapeString(sToken) << "'";
-  CcSqlResult oResult = m_pDatabase->query(sSqlQuery);
+  CcSqlResult oResult = query(sSqlQuery);
   if (oResult.ok() &&
       oResult.size() > 0)
   {
@@ -215,3 +216,8 @@ CcString CcSyncDbServer::getDbUpdateUser(const CcString& sAccountName, const CcS
        << "AND `" << CcSyncGlobals::Database::User::Username << "` = '" << CcSqlite::escapeString(sUsername) << "'";
   return sRet;
 }
+
+CcSqlResult CcSyncDbServer::query(const CcString& sQuery)
+{
+  return CcSyncDbProfiler::query(*m_pDatabase, sQuery);
+}
@@ -87,6 +87,11 @@ private: //Methods
   CcString getDbCreateUser();
   CcString getDbInsertUser(const CcString& sAccountName, const CcString& sUsername, const CcString& sToken);
   CcString getDbUpdateUser(const CcString& sAccountName, const CcString& sUsername, const CcString& sToken);
+  /**
+   * @brief Execute query on database, all queries of this class are
+   *        passing it, so they can be profiled.
+   */
+  CcSqlResult query(const CcString& sQuery);
 private:
   CcSharedPointer<CcSqlite> m_pDatabase;
 };
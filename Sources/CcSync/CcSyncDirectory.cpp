@@ -44,6 +44,9 @@
 
 CcSyncDirectory::CcSyncDirectory(const CcSyncDirectory& oToCopy) :
   m_pDatabase(oToCopy.m_pDatabase),
+  m_pQueue(oToCopy.m_pQueue),
+  m_pUploadLimit(oToCopy.m_pUploadLimit),
+  m_pDownloadLimit(oToCopy.m_pDownloadLimit),
   m_pConfig(oToCopy.m_pConfig)
 {
 }
@@ -56,6 +59,9 @@ CcSyncDirectory& CcSyncDirectory::operator=(const CcSyncDirectory& oToCopy)
 {
   m_pConfig = oToCopy.m_pConfig;
   m_pDatabase = oToCopy.m_pDatabase;
+  m_pQueue = oToCopy.m_pQueue;
+  m_pUploadLimit = oToCopy.m_pUploadLimit;
+  m_pDownloadLimit = oToCopy.m_pDownloadLimit;
   m_uiRootId = oToCopy.m_uiRootId;
   return *this;
 }
@@ -64,8 +70,23 @@ void CcSyncDirectory::init(CcSyncDbClientPointer& pDatabase, CcSyncDirectoryConf
 {
   m_pDatabase = pDatabase;
   m_pConfig = pConfig;
+  if (m_pConfig != nullptr)
+  {
+    CCNEW(m_pUploadLimit, CcSyncTokenBucket, m_pConfig->getUploadRate());
+    CCNEW(m_pDownloadLimit, CcSyncTokenBucket, m_pConfig->getDownloadRate());
+  }
+  else
+  {
+    CCNEW(m_pUploadLimit, CcSyncTokenBucket);
+    CCNEW(m_pDownloadLimit, CcSyncTokenBucket);
+  }
   if (pDatabase != nullptr)
+  {
     pDatabase->setupDirectory(getName());
+    CCNEW(m_pQueue, CcSyncQueue, pDatabase, getName());
+    if (m_pConfig != nullptr)
+      m_pQueue->setSchedule(m_pConfig->getSchedule(), m_pConfig->getStarvationTime());
+  }
 }
 
 void CcSyncDirectory::scan( bool bDeepSearch)
@@ -75,6 +96,7 @@ void CcSyncDirectory::scan( bool bDeepSearch)
     m_pDatabase->beginTransaction();
     scanSubDir(m_uiRootId, m_pConfig->getLocation(), bDeepSearch);
     m_pDatabase->endTransaction();
+    m_pQueue->itemsAdded();
   }
 }
 
@@ -88,36 +110,43 @@ bool CcSyncDirectory::validate()
   return bRet;
 }
 
-bool CcSyncDirectory::queueHasItems()
+bool CcSyncDirectory::queueHasItems(bool bTransfers)
 {
-  return m_pDatabase->queueHasItem(m_pConfig->getName());
+  return m_pQueue->hasItems(bTransfers);
 }
 
-EBackupQueueType CcSyncDirectory::queueGetNext(CcSyncFileInfo& oFileInfo, uint64 &uiQueueIndex)
+EBackupQueueType CcSyncDirectory::queueGetNext(CcSyncFileInfo& oFileInfo, uint64 &uiQueueIndex, bool bTransfers)
 {
-  return m_pDatabase->queueGetNext(getName(), oFileInfo, uiQueueIndex);
+  return m_pQueue->getNext(oFileInfo, uiQueueIndex, bTransfers);
 }
 
 void CcSyncDirectory::queueFinalizeDirectory(CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex)
 {
-  m_pDatabase->queueFinalizeDirectory(getName(), oFileInfo, uiQueueIndex);
+  m_pQueue->finalizeDirectory(oFileInfo, uiQueueIndex);
 }
 
 void CcSyncDirectory::queueFinalizeFile(uint64 uiQueueIndex)
 {
   if(uiQueueIndex != 0)
-    m_pDatabase->queueFinalizeFile(getName(), uiQueueIndex);
+    m_pQueue->finalizeFile(uiQueueIndex);
 }
 
 void CcSyncDirectory::queueIncrementItem(uint64 uiQueueIndex)
 {
   if(uiQueueIndex != 0)
-    m_pDatabase->queueIncrementItem(getName(), uiQueueIndex);
+    m_pQueue->incrementItem(uiQueueIndex);
+}
+
+void CcSyncDirectory::queueRetryItem(uint64 uiQueueIndex)
+{
+  if(uiQueueIndex != 0)
+    m_pQueue->retryItem(uiQueueIndex);
 }
 
 void CcSyncDirectory::queueReset()
 {
   m_pDatabase->beginTransaction();
+  m_pQueue->reset();
   m_pDatabase->queueReset(getName());
   m_pDatabase->endTransaction();
 }
@@ -125,18 +154,29 @@ void CcSyncDirectory::queueReset()
 void CcSyncDirectory::queueResetAttempts()
 {
   m_pDatabase->beginTransaction();
+  m_pQueue->reset();
   m_pDatabase->queueResetAttempts(getName());
   m_pDatabase->endTransaction();
 }
 
+void CcSyncDirectory::queueCoalesce()
+{
+  m_pDatabase->beginTransaction();
+  m_pQueue->reset();
+  m_pDatabase->queueCoalesce(getName());
+  m_pDatabase->endTransaction();
+}
+
 void CcSyncDirectory::queueDownloadDirectory(const CcSyncFileInfo& oFileInfo)
 {
   m_pDatabase->queueDownloadDirectory(getName(), oFileInfo);
+  m_pQueue->itemsAdded();
 }
 
 void CcSyncDirectory::queueDownloadFile(const CcSyncFileInfo& oFileInfo)
 {
   m_pDatabase->queueDownloadFile(getName(), oFileInfo);
+  m_pQueue->itemsAdded();
 }
 
 const CcString& CcSyncDirectory::getName() const
@@ -147,6 +187,14 @@ const CcString& CcSyncDirectory::getName() const
     return CcGlobalStrings::Empty;
 }
 
+uint32 CcSyncDirectory::getPriority() const
+{
+  if (m_pConfig != nullptr)
+    return m_pConfig->getPriority();
+  else
+    return 1;
+}
+
 bool CcSyncDirectory::getInnerPathById(CcSyncFileInfo& oFileInfo)
 {
   oFileInfo.dirPath() = m_pDatabase->getInnerPathById(getName(), oFileInfo.getDirId());
@@ -165,6 +213,51 @@ bool CcSyncDirectory::fileListInsert(CcSyncFileInfo& oFileInfo, bool bDoUpdatePa
   return m_pDatabase->fileListInsert(getName(), oFileInfo, bDoUpdateParents);
 }
 
+bool CcSyncDirectory::journalInsert(EBackupQueueType eType, const CcSyncFileInfo& oFileInfo, CcSyncJournalEntry& oEntry)
+{
+  oEntry.eType = eType;
+  oEntry.oFileInfo = oFileInfo;
+  return m_pDatabase->journalInsert(getName(), oEntry);
+}
+
+void CcSyncDirectory::journalSync(const CcSyncJournalEntry& oEntry)
+{
+  m_pDatabase->journalSync(oEntry);
+}
+
+bool CcSyncDirectory::journalRemove(const CcSyncJournalEntry& oEntry)
+{
+  return m_pDatabase->journalRemove(getName(), oEntry);
+}
+
+void CcSyncDirectory::journalReconcile()
+{
+  CcList<CcSyncJournalEntry> oEntries = m_pDatabase->journalLoad(getName());
+  if (oEntries.size() > 0)
+  {
+    m_pDatabase->beginTransaction();
+    for (CcSyncJournalEntry& oEntry : oEntries)
+    {
+      getFullDirPathById(oEntry.oFileInfo);
+      switch (oEntry.eType)
+      {
+        case EBackupQueueType::AddFile:
+        case EBackupQueueType::DownloadFile:
+          journalReconcileFile(oEntry.oFileInfo);
+          break;
+        case EBackupQueueType::CreateDir:
+          journalReconcileDirectory(oEntry.oFileInfo);
+          break;
+        default:
+          break;
+      }
+      m_pDatabase->journalRemove(getName(), oEntry);
+    }
+    m_pDatabase->endTransaction();
+    CcSyncLog::writeInfo("Journal reconciled: " + getName() + " " + CcString::fromSize(oEntries.size()) + " entries");
+  }
+}
+
 bool CcSyncDirectory::fileListRemove(CcSyncFileInfo& oFileInfo, bool bDoUpdateParents, bool bKeepFile)
 {
   bool bRet = false;
@@ -207,9 +300,10 @@ bool CcSyncDirectory::fileListRemove(CcSyncFileInfo& oFileInfo, bool bDoUpdatePa
   else
   {
     getFullDirPathById(oFileInfo);
+    // Removal is repeated if list update gets lost, so a missing file is accepted
     if ( bKeepFile == true ||
-         (CcFile::exists(oFileInfo.getSystemFullPath()) &&
-          CcFile::remove(oFileInfo.getSystemFullPath())))
+         CcFile::exists(oFileInfo.getSystemFullPath()) == false ||
+         CcFile::remove(oFileInfo.getSystemFullPath()))
     {
       if (m_pDatabase->fileListRemove(getName(), oFileInfo, bDoUpdateParents))
       {
@@ -252,6 +346,64 @@ bool CcSyncDirectory::fileListCreate(CcSyncFileInfo& oFileInfo, bool bDoUpdatePa
   return bRet;
 }
 
+void CcSyncDirectory::journalReconcileFile(CcSyncFileInfo& oFileInfo)
+{
+  // Queue item was not finalized, it will be transferred again
+  CcString sTempFilePath = oFileInfo.getSystemFullPath();
+  sTempFilePath.append(CcSyncGlobals::TemporaryExtension);
+  if (CcFile::exists(sTempFilePath))
+  {
+    CcFile::remove(sTempFilePath);
+  }
+  CcSyncFileInfo oListed = m_pDatabase->getFileInfoByFilename(getName(), oFileInfo.getDirId(), oFileInfo.getName());
+  CcSyncFileInfo oOnDisk = oFileInfo;
+  if (oOnDisk.fromSystemFile(true) == false)
+  {
+    // Old file was removed before crash
+    if (oListed.getId() != 0)
+    {
+      m_pDatabase->fileListRemove(getName(), oListed, true);
+    }
+  }
+  else if (oListed.getId() == 0 ||
+           oListed.getFileSize() != oOnDisk.getFileSize() ||
+           oListed.getCrc() != oOnDisk.getCrc())
+  {
+    // New file was moved in place before crash, keep it
+    if (oListed.getId() != 0)
+    {
+      m_pDatabase->fileListRemove(getName(), oListed, true);
+    }
+    if (oFileInfo.getId() != 0 &&
+        fileListExists(oFileInfo.getId()))
+    {
+      m_pDatabase->fileListRemove(getName(), getFileInfoById(oFileInfo.getId()), true);
+    }
+    CcFile oFile(oFileInfo.getSystemFullPath());
+    if (oFile.open(EOpenFlags::Write | EOpenFlags::Attributes))
+    {
+      oFile.setModified(CcDateTimeFromSeconds(oFileInfo.getModified()));
+      oFile.close();
+    }
+    oFileInfo.fileSize() = oOnDisk.getFileSize();
+    oFileInfo.crc() = oOnDisk.getCrc();
+    oFileInfo.changed() = CcKernel::getDateTime().getTimestampS();
+    m_pDatabase->fileListInsert(getName(), oFileInfo, true);
+  }
+}
+
+void CcSyncDirectory::journalReconcileDirectory(CcSyncFileInfo& oFileInfo)
+{
+  if (CcDirectory::exists(oFileInfo.getSystemFullPath()) &&
+      m_pDatabase->directoryListSubDirExists(getName(), oFileInfo.getDirId(), oFileInfo.getName()) == false)
+  {
+    // Directory was created before crash, keep it
+    oFileInfo.fromSystemDirectory();
+    oFileInfo.changed() = CcKernel::getDateTime().getTimestampS();
+    m_pDatabase->directoryListInsert(getName(), oFileInfo, true);
+  }
+}
+
 CcSyncFileInfoList CcSyncDirectory::getDirectoryInfoListById(uint64 uiDirId)
 {
   return m_pDatabase->getDirectoryInfoListById(getName(), uiDirId);
@@ -327,7 +479,7 @@ void CcSyncDirectory::scanSubDir(uint64 uiDbIndex, const CcString& sPath, bool b
         sPathToFile.appendPath(oSystemFileInfo.getName());
         if (CcFile::remove(sPathToFile))
         {
-          CcSyncLog::writeDebug("Temporary file found and removed: " + sPathToFile);
+          CCSYNC_DEBUG("Temporary file found and removed: " + sPathToFile);
         }
         else
         {
@@ -463,7 +615,7 @@ uint64 CcSyncDirectory::queueRemoveFile(uint64 uiDependent, const CcSyncFileInfo
 
 void CcSyncDirectory::queueUploadFile(uint64 uiDependent, uint64 uiDirId, const CcFileInfo& oFileInfo)
 {
-  uint64 uiId = m_pDatabase->queueInsert(getName(), uiDependent, EBackupQueueType::AddFile, 0, uiDirId, oFileInfo.getName());
+  uint64 uiId = m_pDatabase->queueInsert(getName(), uiDependent, EBackupQueueType::AddFile, 0, uiDirId, oFileInfo.getName(), oFileInfo.getFileSize());
   if (uiId == 0)
   {
     CcSyncLog::writeError("Adding file to queue");
@@ -474,6 +626,9 @@ bool CcSyncDirectory::directoryListCreate(CcSyncFileInfo& oFileInfo, bool bDoUpd
 {
   getFullDirPathById(oFileInfo);
   CcDirectory oNewDirectory(oFileInfo.getSystemFullPath());
+  CcSyncJournalEntry oJournal;
+  journalInsert(EBackupQueueType::CreateDir, oFileInfo, oJournal);
+  journalSync(oJournal);
   if (oNewDirectory.create(oFileInfo.getSystemFullPath(), true))
   {
     CcFile oTempFile(oFileInfo.getSystemFullPath());
@@ -484,24 +639,26 @@ bool CcSyncDirectory::directoryListCreate(CcSyncFileInfo& oFileInfo, bool bDoUpd
       oFileInfo.changed() = CcKernel::getDateTime().getTimestampS();
       if (m_pDatabase->directoryListInsert(getName(), oFileInfo, bDoUpdateParents))
       {
+        journalRemove(oJournal);
         return true;
       }
       else
       {
-        CcSyncLog::writeDebug("Adding new Directory to Database failed: " + oFileInfo.getSystemFullPath());
+        CCSYNC_DEBUG("Adding new Directory to Database failed: " + oFileInfo.getSystemFullPath());
         oNewDirectory.remove();
       }
     }
     else
     {
-      CcSyncLog::writeDebug("Reading directory information failed: " + oFileInfo.getSystemFullPath());
+      CCSYNC_DEBUG("Reading directory information failed: " + oFileInfo.getSystemFullPath());
       oNewDirectory.remove();
     }
   }
   else
   {
-    CcSyncLog::writeDebug("Creating new Directory failed: " + oFileInfo.getSystemFullPath());
+    CCSYNC_DEBUG("Creating new Directory failed: " + oFileInfo.getSystemFullPath());
   }
+  journalRemove(oJournal);
   return false;
 }
 
@@ -514,7 +671,7 @@ bool CcSyncDirectory::directoryListUpdate(const CcSyncFileInfo& oFileInfo)
   }
   else
   {
-    CcSyncLog::writeDebug("Updating Directory in Database failed: " + oFileInfo.getName());
+    CCSYNC_DEBUG("Updating Directory in Database failed: " + oFileInfo.getName());
   }
   return bRet;
 }
@@ -528,7 +685,7 @@ bool CcSyncDirectory::directoryListUpdateId(uint64 uiDirectoryId, const CcSyncFi
   }
   else
   {
-    CcSyncLog::writeDebug("Updating Directory in Database failed: " + oFileInfo.getName() + " Id: " + CcString::fromNumber(oFileInfo.getId()));
+    CCSYNC_DEBUG("Updating Directory in Database failed: " + oFileInfo.getName() + " Id: " + CcString::fromNumber(oFileInfo.getId()));
   }
   return bRet;
 }
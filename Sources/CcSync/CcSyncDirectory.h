@@ -34,6 +34,8 @@
 #include "CcSync.h"
 #include "CcSyncDirectoryConfig.h"
 #include "CcSyncDbClient.h"
+#include "CcSyncQueue.h"
+#include "CcSyncTokenBucket.h"
 
 // forward declarations
 class CcDateTime;
@@ -89,21 +91,48 @@ public:
   void scan(bool bDeepSearch);
   bool validate();
 
-  bool queueHasItems();
-  EBackupQueueType queueGetNext(CcSyncFileInfo& oFileInfo, uint64& uiQueueIndex);
+  bool queueHasItems(bool bTransfers = true);
+  EBackupQueueType queueGetNext(CcSyncFileInfo& oFileInfo, uint64& uiQueueIndex, bool bTransfers = true);
   void queueFinalizeDirectory(CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex);
   void queueFinalizeFile(uint64 uiQueueIndex);
   void queueIncrementItem(uint64 uiQueueIndex);
+  void queueRetryItem(uint64 uiQueueIndex);
   void queueReset();
   void queueResetAttempts();
+  void queueCoalesce();
   void queueDownloadDirectory(const CcSyncFileInfo& oFileInfo);
   void queueDownloadFile(const CcSyncFileInfo& oFileInfo);
 
   const CcString& getName() const;
+  /**
+   * @brief Get weight of this directory if queues of multiple directories
+   *        are processed together.
+   */
+  uint32 getPriority() const;
+  /**
+   * @brief Rate limits shared by all transfers of this directory,
+   *        see CcSyncDirectoryConfig::getUploadRate.
+   */
+  CcSyncTokenBucket& uploadLimit()
+    { return *m_pUploadLimit; }
+  CcSyncTokenBucket& downloadLimit()
+    { return *m_pDownloadLimit; }
   bool getInnerPathById(CcSyncFileInfo& oFileInfo);
   bool getFullDirPathById(CcSyncFileInfo& oFileInfo);
 
   bool fileListInsert(CcSyncFileInfo& oFileInfo, bool bDoUpdateParents);
+  bool journalInsert(EBackupQueueType eType, const CcSyncFileInfo& oFileInfo, CcSyncJournalEntry& oEntry);
+  void journalSync(const CcSyncJournalEntry& oEntry);
+  bool journalRemove(const CcSyncJournalEntry& oEntry);
+  /**
+   * @brief Bring lists in line with disk for all changes wich were
+   *        interrupted, call it on start before queue is processed.
+   */
+  void journalReconcile();
+  void lock()
+    { m_pDatabase->lock(); }
+  void unlock()
+    { m_pDatabase->unlock(); }
   bool fileListRemove(CcSyncFileInfo& oFileInfo, bool bDoUpdateParents, bool bKeepFile);
   bool fileListCreate(CcSyncFileInfo& oFileInfo, bool bDoUpdateParents);
   bool fileListExists(uint64 uiFileId);
@@ -142,9 +171,14 @@ private: // methods
   uint64 queueRemoveFile(uint64 uiDependent, const CcSyncFileInfo& oFileInfo);
   void queueUploadFile(uint64 uiDependent, uint64 uiDirectoryId, const CcFileInfo& oDirectoryInfo);
   bool historyInsert(EBackupQueueType eQueueType, const CcSyncFileInfo& oFileInfo);
+  void journalReconcileFile(CcSyncFileInfo& oFileInfo);
+  void journalReconcileDirectory(CcSyncFileInfo& oFileInfo);
 
 private:
   CcSyncDbClientPointer   m_pDatabase;
+  CcSharedPointer<CcSyncQueue> m_pQueue;
+  CcSharedPointer<CcSyncTokenBucket> m_pUploadLimit;
+  CcSharedPointer<CcSyncTokenBucket> m_pDownloadLimit;
   CcSyncDirectoryConfig*  m_pConfig   = nullptr;
   uint64 m_uiRootId = 1;
 };
@@ -36,6 +36,7 @@
 #include "CcUserList.h"
 
 CcSyncDirectoryConfig::CcSyncDirectoryConfig(CcSyncAccountConfig* pAccountConfig) :
+  m_uiStarvationTime(CcSyncGlobals::Database::QueueStarvationTime),
   m_pAccountConfig(pAccountConfig)
 {
 }
@@ -43,12 +44,14 @@ CcSyncDirectoryConfig::CcSyncDirectoryConfig(CcSyncAccountConfig* pAccountConfig
 CcSyncDirectoryConfig::CcSyncDirectoryConfig(const CcString& sName, const CcString& sLocation, CcSyncAccountConfig *pAccountNode):
   m_sName(sName),
   m_sLocation(sLocation),
+  m_uiStarvationTime(CcSyncGlobals::Database::QueueStarvationTime),
   m_pAccountConfig(pAccountNode)
 {
 
 }
 
-CcSyncDirectoryConfig::CcSyncDirectoryConfig(const CcJsonObject& pJsonNode)
+CcSyncDirectoryConfig::CcSyncDirectoryConfig(const CcJsonObject& pJsonNode) :
+  m_uiStarvationTime(CcSyncGlobals::Database::QueueStarvationTime)
 {
   parseJsonNode(pJsonNode);
 }
@@ -75,6 +78,11 @@ CcSyncDirectoryConfig& CcSyncDirectoryConfig::operator=(const CcSyncDirectoryCon
   m_sRestoreCommand = oToCopy.m_sRestoreCommand;
   m_uiUser = oToCopy.m_uiUser;
   m_uiGroup = oToCopy.m_uiGroup;
+  m_eSchedule = oToCopy.m_eSchedule;
+  m_uiPriority = oToCopy.m_uiPriority;
+  m_uiStarvationTime = oToCopy.m_uiStarvationTime;
+  m_uiUploadRate = oToCopy.m_uiUploadRate;
+  m_uiDownloadRate = oToCopy.m_uiDownloadRate;
   m_pAccountConfig = oToCopy.m_pAccountConfig;
   m_pDirectoryNode = oToCopy.m_pDirectoryNode;
   return *this;
@@ -90,6 +98,11 @@ CcSyncDirectoryConfig& CcSyncDirectoryConfig::operator=(CcSyncDirectoryConfig&&
     m_sRestoreCommand = std::move(oToMove.m_sRestoreCommand);
     m_uiUser  = oToMove.m_uiUser;
     m_uiGroup = oToMove.m_uiGroup;
+    m_eSchedule = oToMove.m_eSchedule;
+    m_uiPriority = oToMove.m_uiPriority;
+    m_uiStarvationTime = oToMove.m_uiStarvationTime;
+    m_uiUploadRate = oToMove.m_uiUploadRate;
+    m_uiDownloadRate = oToMove.m_uiDownloadRate;
     m_pAccountConfig = oToMove.m_pAccountConfig;
     m_pDirectoryNode = oToMove.m_pDirectoryNode;
   }
@@ -129,6 +142,21 @@ void CcSyncDirectoryConfig::parseXmlNode(CcXmlNode& pXmlNode)
   CcXmlNode& rGroupNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectoryGroup];
   if (rGroupNode.isNotNull())
     m_uiGroup = this->groupIdFromString(rGroupNode.innerText());
+  CcXmlNode& rScheduleNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectorySchedule];
+  if (rScheduleNode.isNotNull())
+    parseSchedule(rScheduleNode.innerText());
+  CcXmlNode& rPriorityNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectoryPriority];
+  if (rPriorityNode.isNotNull())
+    parsePriority(rPriorityNode.innerText());
+  CcXmlNode& rStarvationNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectoryStarvationTime];
+  if (rStarvationNode.isNotNull())
+    parseStarvationTime(rStarvationNode.innerText());
+  CcXmlNode& rUploadRateNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectoryUploadRate];
+  if (rUploadRateNode.isNotNull())
+    m_uiUploadRate = parseRate(rUploadRateNode.innerText());
+  CcXmlNode& rDownloadRateNode = pXmlNode[CcSyncGlobals::Client::ConfigTags::DirectoryDownloadRate];
+  if (rDownloadRateNode.isNotNull())
+    m_uiDownloadRate = parseRate(rDownloadRateNode.innerText());
 }
 
 void CcSyncDirectoryConfig::parseJsonNode(const CcJsonObject& rJsonNode)
@@ -147,6 +175,21 @@ void CcSyncDirectoryConfig::parseJsonNode(const CcJsonObject& rJsonNode)
   const CcJsonNode& pRCNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectoryRestoreCommand];
   if (pRCNode.isValue())
     m_sRestoreCommand = pRCNode.getValue().getString();
+  const CcJsonNode& pScheduleNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectorySchedule];
+  if (pScheduleNode.isValue())
+    parseSchedule(pScheduleNode.getValue().getString());
+  const CcJsonNode& pPriorityNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectoryPriority];
+  if (pPriorityNode.isValue())
+    parsePriority(pPriorityNode.getValue().getString());
+  const CcJsonNode& pStarvationNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectoryStarvationTime];
+  if (pStarvationNode.isValue())
+    parseStarvationTime(pStarvationNode.getValue().getString());
+  const CcJsonNode& pUploadRateNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectoryUploadRate];
+  if (pUploadRateNode.isValue())
+    m_uiUploadRate = parseRate(pUploadRateNode.getValue().getString());
+  const CcJsonNode& pDownloadRateNode = rJsonNode[CcSyncGlobals::Client::ConfigTags::DirectoryDownloadRate];
+  if (pDownloadRateNode.isValue())
+    m_uiDownloadRate = parseRate(pDownloadRateNode.getValue().getString());
 }
 
 bool CcSyncDirectoryConfig::writeConfig(CcXmlNode& pXmlNode)
@@ -170,6 +213,30 @@ bool CcSyncDirectoryConfig::writeConfig(CcXmlNode& pXmlNode)
   oDirectoryNode.append(std::move(oRestoreNode));
   oDirectoryNode.append(std::move(oUserNode));
   oDirectoryNode.append(std::move(oGroupNode));
+  CcXmlNode oScheduleNode(CcSyncGlobals::Client::ConfigTags::DirectorySchedule);
+  if (m_eSchedule == ESyncSchedule::SmallFirst)
+    oScheduleNode.setInnerText(CcSyncGlobals::Client::ConfigTags::DirectoryScheduleSmallFirst);
+  else
+    oScheduleNode.setInnerText(CcSyncGlobals::Client::ConfigTags::DirectoryScheduleOldestFirst);
+  CcXmlNode oPriorityNode(CcSyncGlobals::Client::ConfigTags::DirectoryPriority);
+  oPriorityNode.setInnerText(CcString::fromNumber(m_uiPriority));
+  CcXmlNode oStarvationNode(CcSyncGlobals::Client::ConfigTags::DirectoryStarvationTime);
+  oStarvationNode.setInnerText(CcString::fromNumber(m_uiStarvationTime));
+  oDirectoryNode.append(std::move(oScheduleNode));
+  oDirectoryNode.append(std::move(oPriorityNode));
+  oDirectoryNode.append(std::move(oStarvationNode));
+  if (m_uiUploadRate > 0)
+  {
+    CcXmlNode oUploadRateNode(CcSyncGlobals::Client::ConfigTags::DirectoryUploadRate);
+    oUploadRateNode.setInnerText(CcString::fromNumber(m_uiUploadRate));
+    oDirectoryNode.append(std::move(oUploadRateNode));
+  }
+  if (m_uiDownloadRate > 0)
+  {
+    CcXmlNode oDownloadRateNode(CcSyncGlobals::Client::ConfigTags::DirectoryDownloadRate);
+    oDownloadRateNode.setInnerText(CcString::fromNumber(m_uiDownloadRate));
+    oDirectoryNode.append(std::move(oDownloadRateNode));
+  }
   pXmlNode.append(std::move(oDirectoryNode));
   m_pDirectoryNode = &pXmlNode.getLastAddedNode();
   return writeConfigFile();
@@ -337,3 +404,36 @@ uint32 CcSyncDirectoryConfig::groupIdFromString(const CcString& sGroup)
   }
   return uiGroupId;
 }
+
+void CcSyncDirectoryConfig::parseSchedule(const CcString& sSchedule)
+{
+  if (sSchedule.compareInsensitve(CcSyncGlobals::Client::ConfigTags::DirectoryScheduleSmallFirst))
+    m_eSchedule = ESyncSchedule::SmallFirst;
+  else
+    m_eSchedule = ESyncSchedule::OldestFirst;
+}
+
+void CcSyncDirectoryConfig::parsePriority(const CcString& sPriority)
+{
+  bool bOk = false;
+  uint32 uiPriority = sPriority.toUint32(&bOk);
+  if (bOk && uiPriority > 0)
+    m_uiPriority = uiPriority;
+}
+
+void CcSyncDirectoryConfig::parseStarvationTime(const CcString& sStarvationTime)
+{
+  bool bOk = false;
+  uint32 uiStarvationTime = sStarvationTime.toUint32(&bOk);
+  if (bOk)
+    m_uiStarvationTime = uiStarvationTime;
+}
+
+uint64 CcSyncDirectoryConfig::parseRate(const CcString& sRate)
+{
+  bool bOk = false;
+  uint64 uiRate = sRate.toUint64(&bOk);
+  if (bOk == false)
+    uiRate = 0;
+  return uiRate;
+}
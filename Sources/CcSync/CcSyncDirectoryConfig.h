@@ -38,6 +38,15 @@ class CcXmlNode;
 class CcJsonObject;
 class CcSyncAccountConfig;
 
+/**
+ * @brief Order of items in queue of a directory
+ */
+enum class ESyncSchedule
+{
+  OldestFirst = 0,  //!< Process items in order they were queued
+  SmallFirst,       //!< Process smallest ready item first
+};
+
 /**
  * @brief Class impelmentation
  */
@@ -122,6 +131,34 @@ public:
    */
   uint32 getGroupId() const
     { return m_uiGroup; }
+  ESyncSchedule getSchedule() const
+    { return m_eSchedule; }
+  /**
+   * @brief Get weight of directory if queues of multiple directories are
+   *        processed together. Higher values get more transfers.
+   * @return Weight, at least 1
+   */
+  uint32 getPriority() const
+    { return m_uiPriority; }
+  /**
+   * @brief Get time in seconds an item can be deferred by schedule, items
+   *        wich are waiting longer will be processed next.
+   * @return Time in seconds
+   */
+  uint32 getStarvationTime() const
+    { return m_uiStarvationTime; }
+  /**
+   * @brief Get maximum rate of all uploads of this directory.
+   * @return Bytes per second, 0 if unlimited
+   */
+  uint64 getUploadRate() const
+    { return m_uiUploadRate; }
+  /**
+   * @brief Get maximum rate of all downloads of this directory.
+   * @return Bytes per second, 0 if unlimited
+   */
+  uint64 getDownloadRate() const
+    { return m_uiDownloadRate; }
   
   bool setLocation(const CcString& sLocation);
   bool setBackupCommand(const CcString& sBackupCommand);
@@ -134,6 +171,10 @@ public:
 private:
   uint32 userIdFromString(const CcString& sUser);
   uint32 groupIdFromString(const CcString& sGroup);
+  void parseSchedule(const CcString& sSchedule);
+  void parsePriority(const CcString& sPriority);
+  void parseStarvationTime(const CcString& sStarvationTime);
+  static uint64 parseRate(const CcString& sRate);
 
 private:
   CcString m_sName;
@@ -142,6 +183,11 @@ private:
   CcString m_sRestoreCommand;
   uint32 m_uiUser = UINT32_MAX;
   uint32 m_uiGroup = UINT32_MAX;
+  ESyncSchedule m_eSchedule = ESyncSchedule::OldestFirst;
+  uint32 m_uiPriority = 1;
+  uint32 m_uiStarvationTime;
+  uint64 m_uiUploadRate = 0;
+  uint64 m_uiDownloadRate = 0;
   CcXmlNode*            m_pDirectoryNode = nullptr;
   CcSyncAccountConfig*  m_pAccountConfig = nullptr;
 };
@@ -37,6 +37,14 @@ namespace CcSyncGlobals
   const uint64 TransferSize      = 1024 * 1024 * 16; // 1MB Buffer size
   const uint64 MaxRequestSize    = TransferSize;
   const uint64 MaxResponseSize   = MaxRequestSize;
+  const uint64 BufferPoolLimit   = 1024 * 1024 * 256;
+  const uint64 BufferPoolWait    = 5000; // ms until a waiting buffer request fails
+  const size_t TraceBufferSize   = 64 * 1024; // Bytes of events until trace file is written
+  const uint64 LogFlushTime      = 100; // ms until queued log messages are written
+  const uint64 LogFileMaxSize    = 1024 * 1024 * 8; // Bytes until log file gets rotated
+  const size_t LogFileCount      = 4; // Rotated log files kept besides current one
+  const size_t ProfilerReportSize = 20; // Statements with highest time in report
+  const uint64 ProfilerPlanTime  = 10000; // us of one execution until query plan is captured
   const CcString DefaultCertFile ("SslCertificate.pem");
   const CcString DefaultKeyFile  ("SslPrivateKey.pem");
   const CcString SqliteExtension (".sqlite");
@@ -72,11 +80,17 @@ namespace CcSyncGlobals
     const CcString DropTable      ("DROP TABLE `");
     const CcString Insert         ("INSERT INTO `");
     const CcString Update         ("UPDATE `");
+    const size_t GroupCommitItems = 256;
+    const uint64 GroupCommitTime  = 2000; // 2s in ms
+    const size_t QueueBatchSize   = 512;
+    const uint16 QueueMaxAttempts = 5;
+    const uint32 QueueStarvationTime = 300;
 
     const CcString DirectoryListAppend ("_DirList");
     const CcString FileListAppend   ("_FileList");
     const CcString QueueAppend      ("_Queue");
     const CcString HistoryAppend    ("_History");
+    const CcString JournalAppend    ("_Journal");
 
     namespace FileList
     {
@@ -101,6 +115,7 @@ namespace CcSyncGlobals
       const CcString Name     ("Name");
       const CcString& Attributes = FileInfo::Attributes;
       const CcString Attempts ("Attempts");
+      const CcString& Size    = FileInfo::Size;
     }
 
     namespace DirectoryList
@@ -127,6 +142,20 @@ namespace CcSyncGlobals
       const CcString  Stamp    ("Stamp");
     }
 
+    namespace Journal
+    {
+      const CcString& Id       = IndexName;
+      const CcString& Type     = Queue::Type;
+      const CcString& FileId   = Queue::FileId;
+      const CcString& DirId    = FileInfo::DirId;
+      const CcString& Name     = FileList::Name;
+      const CcString& Size     = FileList::Size;
+      const CcString& Modified = FileList::Modified;
+      const CcString& Attributes = FileInfo::Attributes;
+      const CcString& MD5      = FileList::MD5;
+      const CcString& CRC      = FileList::CRC;
+    }
+
     namespace User
     {
       const CcString& Id      = IndexName;
@@ -141,7 +170,26 @@ namespace CcSyncGlobals
   {
     const CcString ConfigFileName ("Server.xml");
     const CcString DatabaseFileName ("Server.sqlite");
+    const CcString TraceFileName ("ServerTrace.json");
     const CcString RootAccountName("Root");
+    const size_t DefaultWorkers         = 16;
+    const size_t DefaultConnectionQueue = 1024;
+    const uint64 RequestTimeout         = 30;
+    const uint64 HandshakeTimeout       = 10;
+    const uint64 ReactorReadTimeout     = 1;
+    const size_t ReactorReadSize        = 64 * 1024;
+    const size_t SslSessionCacheSize    = 4096;
+    const uint64 SslSessionTimeout      = 3600;
+    const uint64 SessionCacheTime       = 60;
+    const size_t DatabaseReaders        = 4;
+    const size_t AccountCacheSize       = 1024;
+    const uint64 AccountIdleTime        = 600;
+    const size_t MaxTransfers           = 32;
+    const size_t MaxAccountTransfers    = 4;
+    const uint64 TransferRetryAfter     = 5;
+    const uint64 TransferRetryAfterMax  = 60;
+    const size_t SchedulerMetadataBurst = 8;
+    const uint64 WorkerIdleWait         = 1000; // ms, idle threads are woken by signal
     namespace Database
     {
       const CcString TableNameUser ("User");
@@ -161,6 +209,11 @@ namespace CcSyncGlobals
       const CcString Location ("Location");
       const CcString LocationPath ("Path");
       const CcString LocationType ("Type");
+      const CcString Workers ("Workers");
+      const CcString ConnectionQueue ("ConnectionQueue");
+      const CcString Bandwidth ("Bandwidth");
+      const CcString& AccountBandwidth = Bandwidth;
+      const CcString AccountWeight ("Weight");
     }
     namespace Output
     {
@@ -172,6 +225,9 @@ namespace CcSyncGlobals
   {
     const CcString ConfigFileName   ("Client.xml");
     const CcString DatabaseFileName ("Client.sqlite");
+    const CcString TraceFileName    ("ClientTrace.json");
+    const size_t TransferWorkers    = 4;
+    const uint64 BufferRetryAfter   = 5; // s until a transfer without buffer is retried
     namespace ConfigTags
     {
       const CcString Root ("CcSyncClient");
@@ -190,6 +246,13 @@ namespace CcSyncGlobals
       const CcString DirectoryRestoreCommand("RestoreCommand");
       const CcString DirectoryUser("User");
       const CcString DirectoryGroup("Group");
+      const CcString DirectorySchedule("Schedule");
+      const CcString DirectoryScheduleOldestFirst("OldestFirst");
+      const CcString DirectoryScheduleSmallFirst("SmallFirst");
+      const CcString DirectoryPriority("Priority");
+      const CcString DirectoryStarvationTime("StarvationTime");
+      const CcString DirectoryUploadRate("UploadRate");
+      const CcString DirectoryDownloadRate("DownloadRate");
 
       const CcString Command ("Command");
       const CcString CommandExecutable ("Executable");
@@ -311,10 +374,55 @@ namespace CcSyncGlobals
     const CcString Deep("Deep");
     }
 
+    namespace ServerSetTrace
+    {
+      const CcString Enable("Enable");
+    }
+
+    namespace ServerSetProfiler
+    {
+      const CcString& Enable = ServerSetTrace::Enable;
+    }
+
+    namespace ServerGetStats
+    {
+      const CcString Stats              ("Stats");
+      const CcString Uptime             ("Uptime");
+      const CcString Requests           ("Requests");
+      const CcString Time               ("Time");
+      const CcString MaxTime            ("MaxTime");
+      const CcString Histogram          ("Histogram");
+      const CcString HistogramBounds    ("HistogramBounds");
+      const CcString BytesSent          ("BytesSent");
+      const CcString BytesReceived      ("BytesReceived");
+      const CcString DatabaseTime       ("DatabaseTime");
+      const CcString CommandList        ("Commands");
+      const CcString AccountList        ("Accounts");
+      const CcString& Id                = FileInfo::Id;
+      const CcString& Name              = Client::ConfigTags::Name;
+      const CcString ConnectionsActive  ("ConnectionsActive");
+      const CcString ConnectionsIdle    ("ConnectionsIdle");
+      const CcString ConnectionsWaiting ("ConnectionsWaiting");
+      const CcString RequestsScheduled  ("RequestsScheduled");
+      const CcString TransfersRunning   ("TransfersRunning");
+      const CcString TransfersRejected  ("TransfersRejected");
+      const CcString Handshakes         ("Handshakes");
+      const CcString HandshakesResumed  ("HandshakesResumed");
+      const CcString AccountsLoaded     ("AccountsLoaded");
+      const CcString AccountCacheHits   ("AccountCacheHits");
+      const CcString AccountCacheMisses ("AccountCacheMisses");
+      const CcString AccountCacheEvictions("AccountCacheEvictions");
+      const CcString QueryList          ("Queries");
+      const CcString Statement          ("Statement");
+      const CcString Rows               ("Rows");
+      const CcString Plan               ("Plan");
+    }
+
     const CcString Command    ("Command");
     const CcString Session    ("Session");
     const CcString Result     ("Result");
     const CcString ErrorCode  ("Error");
     const CcString ErrorMsg   ("ErrorMsg");
+    const CcString RetryAfter ("RetryAfter");
   }
 }
@@ -56,6 +56,14 @@ namespace CcSyncGlobals
   extern const CcSyncSHARED uint64 TransferSize;
   extern const CcSyncSHARED uint64 MaxRequestSize;
   extern const CcSyncSHARED uint64 MaxResponseSize;
+  extern const CcSyncSHARED uint64 BufferPoolLimit;
+  extern const CcSyncSHARED uint64 BufferPoolWait;
+  extern const CcSyncSHARED size_t TraceBufferSize;
+  extern const CcSyncSHARED uint64 LogFlushTime;
+  extern const CcSyncSHARED uint64 LogFileMaxSize;
+  extern const CcSyncSHARED size_t LogFileCount;
+  extern const CcSyncSHARED size_t ProfilerReportSize;
+  extern const CcSyncSHARED uint64 ProfilerPlanTime;
   extern const CcSyncSHARED CcString DefaultCertFile;
   extern const CcSyncSHARED CcString DefaultKeyFile;
   extern const CcSyncSHARED CcString SqliteExtension;
@@ -91,11 +99,17 @@ namespace CcSyncGlobals
     extern const CcSyncSHARED CcString DropTable;
     extern const CcSyncSHARED CcString Insert;
     extern const CcSyncSHARED CcString Update;
+    extern const CcSyncSHARED size_t GroupCommitItems;
+    extern const CcSyncSHARED uint64 GroupCommitTime;
+    extern const CcSyncSHARED size_t QueueBatchSize;
+    extern const CcSyncSHARED uint16 QueueMaxAttempts;
+    extern const CcSyncSHARED uint32 QueueStarvationTime;
 
     extern const CcSyncSHARED CcString DirectoryListAppend;
     extern const CcSyncSHARED CcString FileListAppend;
     extern const CcSyncSHARED CcString QueueAppend;
     extern const CcSyncSHARED CcString HistoryAppend;
+    extern const CcSyncSHARED CcString JournalAppend;
 
     namespace FileList
     {
@@ -120,6 +134,7 @@ namespace CcSyncGlobals
       extern const CcSyncSHARED CcString Name;
       extern const CcSyncSHARED CcString& Attributes;
       extern const CcSyncSHARED CcString Attempts;
+      extern const CcSyncSHARED CcString& Size;
     }
 
     namespace DirectoryList
@@ -146,6 +161,20 @@ namespace CcSyncGlobals
       extern const CcSyncSHARED CcString  Stamp;
     }
 
+    namespace Journal
+    {
+      extern const CcSyncSHARED CcString& Id;
+      extern const CcSyncSHARED CcString& Type;
+      extern const CcSyncSHARED CcString& FileId;
+      extern const CcSyncSHARED CcString& DirId;
+      extern const CcSyncSHARED CcString& Name;
+      extern const CcSyncSHARED CcString& Size;
+      extern const CcSyncSHARED CcString& Modified;
+      extern const CcSyncSHARED CcString& Attributes;
+      extern const CcSyncSHARED CcString& MD5;
+      extern const CcSyncSHARED CcString& CRC;
+    }
+
     namespace User
     {
       extern const CcSyncSHARED CcString& Id;
@@ -160,7 +189,26 @@ namespace CcSyncGlobals
   {
     extern const CcSyncSHARED CcString ConfigFileName;
     extern const CcSyncSHARED CcString DatabaseFileName;
+    extern const CcSyncSHARED CcString TraceFileName;
     extern const CcSyncSHARED CcString RootAccountName;
+    extern const CcSyncSHARED size_t DefaultWorkers;
+    extern const CcSyncSHARED size_t DefaultConnectionQueue;
+    extern const CcSyncSHARED uint64 RequestTimeout;
+    extern const CcSyncSHARED uint64 HandshakeTimeout;
+    extern const CcSyncSHARED uint64 ReactorReadTimeout;
+    extern const CcSyncSHARED size_t ReactorReadSize;
+    extern const CcSyncSHARED size_t SslSessionCacheSize;
+    extern const CcSyncSHARED uint64 SslSessionTimeout;
+    extern const CcSyncSHARED uint64 SessionCacheTime;
+    extern const CcSyncSHARED size_t DatabaseReaders;
+    extern const CcSyncSHARED size_t AccountCacheSize;
+    extern const CcSyncSHARED uint64 AccountIdleTime;
+    extern const CcSyncSHARED size_t MaxTransfers;
+    extern const CcSyncSHARED size_t MaxAccountTransfers;
+    extern const CcSyncSHARED uint64 TransferRetryAfter;
+    extern const CcSyncSHARED uint64 TransferRetryAfterMax;
+    extern const CcSyncSHARED size_t SchedulerMetadataBurst;
+    extern const CcSyncSHARED uint64 WorkerIdleWait;
 
     namespace Database
     {
@@ -181,6 +229,11 @@ namespace CcSyncGlobals
       extern const CcSyncSHARED CcString Location;
       extern const CcSyncSHARED CcString LocationPath;
       extern const CcSyncSHARED CcString LocationType;
+      extern const CcSyncSHARED CcString Workers;
+      extern const CcSyncSHARED CcString ConnectionQueue;
+      extern const CcSyncSHARED CcString Bandwidth;
+      extern const CcSyncSHARED CcString& AccountBandwidth;
+      extern const CcSyncSHARED CcString AccountWeight;
     }
     namespace Output
     {
@@ -192,6 +245,9 @@ namespace CcSyncGlobals
   {
     extern const CcSyncSHARED CcString ConfigFileName;
     extern const CcSyncSHARED CcString DatabaseFileName;
+    extern const CcSyncSHARED CcString TraceFileName;
+    extern const CcSyncSHARED size_t TransferWorkers;
+    extern const CcSyncSHARED uint64 BufferRetryAfter;
     namespace ConfigTags
     {
       extern const CcSyncSHARED CcString Root;
@@ -210,6 +266,13 @@ namespace CcSyncGlobals
       extern const CcSyncSHARED CcString DirectoryRestoreCommand;
       extern const CcSyncSHARED CcString DirectoryUser;
       extern const CcSyncSHARED CcString DirectoryGroup;
+      extern const CcSyncSHARED CcString DirectorySchedule;
+      extern const CcSyncSHARED CcString DirectoryScheduleOldestFirst;
+      extern const CcSyncSHARED CcString DirectoryScheduleSmallFirst;
+      extern const CcSyncSHARED CcString DirectoryPriority;
+      extern const CcSyncSHARED CcString DirectoryStarvationTime;
+      extern const CcSyncSHARED CcString DirectoryUploadRate;
+      extern const CcSyncSHARED CcString DirectoryDownloadRate;
 
       extern const CcSyncSHARED CcString Command;
       extern const CcSyncSHARED CcString CommandExecutable;
@@ -331,11 +394,56 @@ namespace CcSyncGlobals
     extern const CcSyncSHARED CcString Deep;
     }
 
+    namespace ServerSetTrace
+    {
+      extern const CcSyncSHARED CcString Enable;
+    }
+
+    namespace ServerSetProfiler
+    {
+      extern const CcSyncSHARED CcString& Enable;
+    }
+
+    namespace ServerGetStats
+    {
+      extern const CcSyncSHARED CcString Stats;
+      extern const CcSyncSHARED CcString Uptime;
+      extern const CcSyncSHARED CcString Requests;
+      extern const CcSyncSHARED CcString Time;
+      extern const CcSyncSHARED CcString MaxTime;
+      extern const CcSyncSHARED CcString Histogram;
+      extern const CcSyncSHARED CcString HistogramBounds;
+      extern const CcSyncSHARED CcString BytesSent;
+      extern const CcSyncSHARED CcString BytesReceived;
+      extern const CcSyncSHARED CcString DatabaseTime;
+      extern const CcSyncSHARED CcString CommandList;
+      extern const CcSyncSHARED CcString AccountList;
+      extern const CcSyncSHARED CcString& Id;
+      extern const CcSyncSHARED CcString& Name;
+      extern const CcSyncSHARED CcString ConnectionsActive;
+      extern const CcSyncSHARED CcString ConnectionsIdle;
+      extern const CcSyncSHARED CcString ConnectionsWaiting;
+      extern const CcSyncSHARED CcString RequestsScheduled;
+      extern const CcSyncSHARED CcString TransfersRunning;
+      extern const CcSyncSHARED CcString TransfersRejected;
+      extern const CcSyncSHARED CcString Handshakes;
+      extern const CcSyncSHARED CcString HandshakesResumed;
+      extern const CcSyncSHARED CcString AccountsLoaded;
+      extern const CcSyncSHARED CcString AccountCacheHits;
+      extern const CcSyncSHARED CcString AccountCacheMisses;
+      extern const CcSyncSHARED CcString AccountCacheEvictions;
+      extern const CcSyncSHARED CcString QueryList;
+      extern const CcSyncSHARED CcString Statement;
+      extern const CcSyncSHARED CcString Rows;
+      extern const CcSyncSHARED CcString Plan;
+    }
+
     extern const CcSyncSHARED CcString Command;
     extern const CcSyncSHARED CcString Session;
     extern const CcSyncSHARED CcString Result;
     extern const CcSyncSHARED CcString ErrorCode;
     extern const CcSyncSHARED CcString ErrorMsg;
+    extern const CcSyncSHARED CcString RetryAfter;
   }
 }
 
@@ -0,0 +1,260 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncHashMap
+ *
+ * @page      CcSyncHashMap
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncHashMap
+ *
+ *  Map with constant lookup time, CcMap is searching linear.
+ *  Keys are distributed by CcSyncHash::get to buckets, the number of
+ *  buckets is doubled if they are holding more than 2 items in average.
+ *  Pointers to values are valid until the next insert or remove.
+ *  The map is not locked, owners have to lock it if it is shared.
+ **/
+#ifndef _CcSyncHashMap_H_
+#define _CcSyncHashMap_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+
+//! Number of buckets on start
+#define CcSyncHashMap_Buckets 64
+
+namespace CcSyncHash
+{
+  /**
+   * @brief FNV-1a hash of string
+   */
+  inline size_t get(const CcString& sKey)
+  {
+    uint32 uiHash = 2166136261u;
+    for (size_t uiPos = 0; uiPos < sKey.length(); uiPos++)
+    {
+      uiHash ^= static_cast<uint8>(sKey[uiPos]);
+      uiHash *= 16777619u;
+    }
+    return static_cast<size_t>(uiHash);
+  }
+
+  /**
+   * @brief Mix bits of number, ids are often increasing by a fixed step
+   */
+  inline size_t get(uint64 uiKey)
+  {
+    uiKey ^= uiKey >> 33;
+    uiKey *= 0xff51afd7ed558ccdULL;
+    uiKey ^= uiKey >> 33;
+    return static_cast<size_t>(uiKey);
+  }
+}
+
+/**
+ * @brief Class impelmentation
+ */
+template <typename KEY, typename VALUE>
+class CcSyncHashMap
+{
+public:
+  /**
+   * @brief Key with value in bucket
+   */
+  class CItem
+  {
+  public:
+    KEY   oKey;
+    //! Value initialized, so numbers are 0 on insert by get
+    VALUE oValue = VALUE();
+  };
+
+  /**
+   * @brief Constructor
+   */
+  CcSyncHashMap( void )
+    { rehash(CcSyncHashMap_Buckets); }
+
+  /**
+   * @brief Get value of key.
+   * @return Pointer to value or nullptr if key is not available
+   */
+  VALUE* find(const KEY& oKey)
+  {
+    CcList<CItem>& rBucket = m_oBuckets[getBucket(oKey)];
+    for (CItem& rItem : rBucket)
+    {
+      if (rItem.oKey == oKey)
+        return &rItem.oValue;
+    }
+    return nullptr;
+  }
+
+  const VALUE* find(const KEY& oKey) const
+    { return const_cast<CcSyncHashMap*>(this)->find(oKey); }
+
+  bool contains(const KEY& oKey) const
+    { return find(oKey) != nullptr; }
+
+  /**
+   * @brief Get value of key, a default value is inserted if key is not available.
+   */
+  VALUE& get(const KEY& oKey)
+  {
+    VALUE* pValue = find(oKey);
+    if (pValue == nullptr)
+    {
+      if (m_uiSize + 1 > m_oBuckets.size() * 2)
+      {
+        rehash(m_oBuckets.size() * 2);
+      }
+      CcList<CItem>& rBucket = m_oBuckets[getBucket(oKey)];
+      CItem oItem;
+      oItem.oKey = oKey;
+      rBucket.append(oItem);
+      m_uiSize++;
+      pValue = &rBucket[rBucket.size() - 1].oValue;
+    }
+    return *pValue;
+  }
+
+  /**
+   * @brief Insert value or replace value of existing key.
+   */
+  void set(const KEY& oKey, const VALUE& oValue)
+    { get(oKey) = oValue; }
+
+  /**
+   * @brief Remove key and get its value.
+   * @return false if key was not available
+   */
+  bool take(const KEY& oKey, VALUE& oValue)
+  {
+    CcList<CItem>& rBucket = m_oBuckets[getBucket(oKey)];
+    for (size_t uiPos = 0; uiPos < rBucket.size(); uiPos++)
+    {
+      if (rBucket[uiPos].oKey == oKey)
+      {
+        oValue = std::move(rBucket[uiPos].oValue);
+        rBucket.remove(uiPos);
+        m_uiSize--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Remove key.
+   * @return false if key was not available
+   */
+  bool remove(const KEY& oKey)
+  {
+    VALUE oValue;
+    return take(oKey, oValue);
+  }
+
+  /**
+   * @brief Remove all items wich are matching a condition.
+   * @param oCondition: Called with key and value, returns true to remove
+   * @return Number of removed items
+   */
+  template <typename CONDITION>
+  size_t removeIf(CONDITION oCondition)
+  {
+    size_t uiRemoved = 0;
+    for (CcList<CItem>& rBucket : m_oBuckets)
+    {
+      size_t uiPos = 0;
+      while (uiPos < rBucket.size())
+      {
+        if (oCondition(rBucket[uiPos].oKey, rBucket[uiPos].oValue))
+        {
+          rBucket.remove(uiPos);
+          uiRemoved++;
+        }
+        else
+        {
+          uiPos++;
+        }
+      }
+    }
+    m_uiSize -= uiRemoved;
+    return uiRemoved;
+  }
+
+  /**
+   * @brief Call function for each key and value, order is not defined.
+   */
+  template <typename FUNCTION>
+  void forEach(FUNCTION oFunction)
+  {
+    for (CcList<CItem>& rBucket : m_oBuckets)
+    {
+      for (CItem& rItem : rBucket)
+      {
+        oFunction(rItem.oKey, rItem.oValue);
+      }
+    }
+  }
+
+  size_t size() const
+    { return m_uiSize; }
+  size_t getBucketCount() const
+    { return m_oBuckets.size(); }
+
+  void clear()
+  {
+    m_oBuckets.clear();
+    m_uiSize = 0;
+    rehash(CcSyncHashMap_Buckets);
+  }
+
+private:
+  size_t getBucket(const KEY& oKey) const
+    { return CcSyncHash::get(oKey) % m_oBuckets.size(); }
+
+  void rehash(size_t uiBucketCount)
+  {
+    CcList<CcList<CItem>> oOld = std::move(m_oBuckets);
+    m_oBuckets.clear();
+    for (size_t uiBucket = 0; uiBucket < uiBucketCount; uiBucket++)
+    {
+      m_oBuckets.append(CcList<CItem>());
+    }
+    for (CcList<CItem>& rBucket : oOld)
+    {
+      for (CItem& rItem : rBucket)
+      {
+        m_oBuckets[getBucket(rItem.oKey)].append(std::move(rItem));
+      }
+    }
+  }
+
+private:
+  CcList<CcList<CItem>> m_oBuckets;
+  size_t                m_uiSize = 0;
+};
+
+#endif /* _CcSyncHashMap_H_ */
@@ -31,6 +31,8 @@
 #include "CcFile.h"
 #include "CcDirectory.h"
 #include "CcSyncConsole.h"
+#include "private/CcSyncLogWriter.h"
+#include <atomic>
 
 bool CcSyncLog::s_bLogsAvailable = false;
 bool CcSyncLog::s_bConsoleOutput = true;
@@ -38,6 +40,10 @@ CcString CcSyncLog::s_sLocation;
 CcString CcSyncLog::s_sLocationClient;
 CcString CcSyncLog::s_sLocationServer;
 CcString CcSyncLog::s_sLocationCommon;
+//! Files are written by background thread from start until stop, see CcSyncLogWriter.
+//! It is not deleted, so it is never joined on static destruction and threads
+//! wich are logging after stop are still using a valid, closed writer.
+static std::atomic<CcSync::CcSyncLogWriter*> s_pWriter(nullptr);
 #ifdef DEBUG
 ESyncLogLevel CcSyncLog::s_eLogLevel = ESyncLogLevel::Debug;
 #else
@@ -64,7 +70,10 @@ bool CcSyncLog::initPaths()
 
 void CcSyncLog::writeMessage(const CcString& sMessage, ESyncLogTarget eTarget)
 {
-  if (initPaths())
+  CcSync::CcSyncLogWriter* pWriter = s_pWriter;
+  if (initPaths() &&
+      (pWriter == nullptr ||
+       pWriter->append(eTarget, sMessage) == false))
   {
     switch (eTarget)
     {
@@ -87,6 +96,38 @@ void CcSyncLog::writeMessage(const CcString& sMessage, ESyncLogTarget eTarget)
   }
 }
 
+void CcSyncLog::start()
+{
+  if (s_pWriter == nullptr &&
+      initPaths())
+  {
+    CCNEWTYPE(pWriter, CcSync::CcSyncLogWriter);
+    pWriter->setPaths(s_sLocation, s_sLocationClient, s_sLocationServer, s_sLocationCommon);
+    pWriter->open();
+    s_pWriter = pWriter;
+  }
+}
+
+void CcSyncLog::stop()
+{
+  CcSync::CcSyncLogWriter* pWriter = s_pWriter;
+  if (pWriter != nullptr)
+  {
+    pWriter->close();
+  }
+}
+
+uint64 CcSyncLog::getOverflows()
+{
+  uint64 uiOverflows = 0;
+  CcSync::CcSyncLogWriter* pWriter = s_pWriter;
+  if (pWriter != nullptr)
+  {
+    uiOverflows = pWriter->getOverflows();
+  }
+  return uiOverflows;
+}
+
 void CcSyncLog::writeDebug(const CcString& sMessage, ESyncLogTarget eTarget)
 {
   if (s_eLogLevel <= ESyncLogLevel::Debug)
@@ -99,7 +140,7 @@ void CcSyncLog::writeDebug(const CcString& sMessage, ESyncLogTarget eTarget)
 
 void CcSyncLog::writeInfo(const CcString& sMessage, ESyncLogTarget eTarget)
 {
-  if (s_eLogLevel <= ESyncLogLevel::Debug)
+  if (s_eLogLevel <= ESyncLogLevel::Info)
   {
     CcString sMessageWrite;
     sMessageWrite << "[info] " << sMessage;
@@ -68,8 +68,26 @@ public:
   static void writeError(const CcString& sMessage, ESyncLogTarget eTarget = ESyncLogTarget::Common);
   static void setLogLevel(ESyncLogLevel eNewLevel)
     {s_eLogLevel = eNewLevel;}
+  static bool isEnabled(ESyncLogLevel eLevel)
+    {return s_eLogLevel <= eLevel;}
   static void disableConsoleOutput()
     {s_bConsoleOutput = false;}
+  /**
+   * @brief Start background writer, messages before are written
+   *        directly to file. Call it once at start of application.
+   */
+  static void start();
+  /**
+   * @brief Write queued messages and stop background writer,
+   *        following messages are written directly to file.
+   *        Call it before end of application.
+   */
+  static void stop();
+  /**
+   * @brief Get number of messages wich were written directly to file
+   *        because queue of background writer was full.
+   */
+  static uint64 getOverflows();
 
 private:
   static bool initPaths();
@@ -84,4 +102,19 @@ private:
   static ESyncLogLevel s_eLogLevel;
 };
 
+/**
+ * Debug and info macros are checking the level before arguments are evaluated,
+ * so the message is not built if it would be discarded anyway.
+ * Arguments are the same as for CcSyncLog::writeDebug and writeInfo.
+ * With CCSYNC_LOG_NO_DEBUG defined, debug messages are removed at compile time.
+ */
+#ifdef CCSYNC_LOG_NO_DEBUG
+#  define CCSYNC_DEBUG(...) do { } while (0)
+#else
+#  define CCSYNC_DEBUG(...) \
+     do { if (CcSyncLog::isEnabled(ESyncLogLevel::Debug)) CcSyncLog::writeDebug(__VA_ARGS__); } while (0)
+#endif
+#define CCSYNC_INFO(...) \
+   do { if (CcSyncLog::isEnabled(ESyncLogLevel::Info)) CcSyncLog::writeInfo(__VA_ARGS__); } while (0)
+
 #endif /* _CcSyncLog_H_ */
@@ -0,0 +1,547 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncQueue
+ */
+#include "CcSyncQueue.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncFileInfo.h"
+#include "CcSyncLog.h"
+#include "CcKernel.h"
+
+CcSyncQueue::CcSyncQueue(CcSyncDbClientPointer& pDatabase, const CcString& sDirName) :
+  m_pDatabase(pDatabase),
+  m_sDirName(sDirName)
+{
+  m_pDatabase->queueRegister(this);
+}
+
+CcSyncQueue::~CcSyncQueue( void )
+{
+  flush();
+  m_pDatabase->queueUnregister(this);
+}
+
+void CcSyncQueue::setSchedule(ESyncSchedule eSchedule, uint32 uiStarvationTime)
+{
+  m_eSchedule = eSchedule;
+  m_uiStarvationTime = uiStarvationTime;
+}
+
+bool CcSyncQueue::hasItems(bool bTransfers)
+{
+  uint64 uiId = 0;
+  while (m_oItems.size() == 0 &&
+         m_bLoadedAll == false)
+  {
+    // All remaining entries of ready lists are outdated
+    m_oReadyOrder.clear();
+    m_oReadyOther.clear();
+    for (CReadyList& rList : m_oReadySizes)
+      rList.clear();
+    loadNext();
+  }
+  return selectNext(uiId, bTransfers);
+}
+
+EBackupQueueType CcSyncQueue::getNext(CcSyncFileInfo& oFileInfo, uint64& uiQueueIndex, bool bTransfers)
+{
+  EBackupQueueType eQueueType = EBackupQueueType::Unknown;
+  uint64 uiId = 0;
+  CcSyncQueueItem oItem;
+  if (hasItems(bTransfers) &&
+      selectNext(uiId, bTransfers) &&
+      m_oItems.take(uiId, oItem))
+  {
+    // Entries in ready lists are outdated now and skipped later
+    oItem.uiReadySeq = 0;
+    uiQueueIndex = oItem.uiId;
+    oFileInfo.id() = oItem.uiFileId;
+    oFileInfo.dirId() = oItem.uiDirId;
+    oFileInfo.name() = oItem.sName;
+    eQueueType = oItem.eType;
+    startRunning(oItem);
+    m_oRunning.set(oItem.uiId, oItem);
+  }
+  return eQueueType;
+}
+
+void CcSyncQueue::finalizeDirectory(CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex)
+{
+  CcSyncQueueItem oItem;
+  oItem.uiId = uiQueueIndex;
+  if (m_oRunning.take(uiQueueIndex, oItem))
+  {
+    stopRunning(oItem);
+  }
+  oItem.uiReleaseDirId = oFileInfo.getId();
+  m_oDone.append(oItem);
+  m_oDoneIds.set(oItem.uiId, true);
+  releasePath(oItem);
+  release(oItem);
+  if (m_oDone.size() >= CcSyncGlobals::Database::QueueBatchSize)
+  {
+    flush();
+  }
+}
+
+void CcSyncQueue::finalizeFile(uint64 uiQueueIndex)
+{
+  CcSyncQueueItem oItem;
+  oItem.uiId = uiQueueIndex;
+  if (m_oRunning.take(uiQueueIndex, oItem))
+  {
+    stopRunning(oItem);
+  }
+  oItem.uiReleaseDirId = 0;
+  m_oDone.append(oItem);
+  m_oDoneIds.set(oItem.uiId, true);
+  releasePath(oItem);
+  release(oItem);
+  if (m_oDone.size() >= CcSyncGlobals::Database::QueueBatchSize)
+  {
+    flush();
+  }
+}
+
+void CcSyncQueue::incrementItem(uint64 uiQueueIndex)
+{
+  CcSyncQueueItem oItem;
+  if (m_oRunning.take(uiQueueIndex, oItem))
+  {
+    stopRunning(oItem);
+    oItem.uiAttempts++;
+    m_oFailed.set(oItem.uiId, oItem);
+    // Retry later in this run, like the database query would return it again
+    if (oItem.uiAttempts < CcSyncGlobals::Database::QueueMaxAttempts)
+    {
+      makeReady(oItem);
+    }
+    else
+    {
+      releasePath(oItem);
+    }
+    if (m_oFailed.size() >= CcSyncGlobals::Database::QueueBatchSize)
+    {
+      flush();
+    }
+  }
+  else
+  {
+    // Item was not loaded by this queue, write it directly
+    m_pDatabase->queueIncrementItem(m_sDirName, uiQueueIndex);
+  }
+}
+
+void CcSyncQueue::retryItem(uint64 uiQueueIndex)
+{
+  CcSyncQueueItem oItem;
+  if (m_oRunning.take(uiQueueIndex, oItem))
+  {
+    stopRunning(oItem);
+    // Item keeps its path, newer items of path stay parked
+    makeReady(oItem);
+  }
+}
+
+void CcSyncQueue::reset()
+{
+  flush();
+  m_oItems.clear();
+  m_oReadyOrder.clear();
+  for (CReadyList& rList : m_oReadySizes)
+    rList.clear();
+  m_oPathParked.clear();
+  m_oRunParked.clear();
+  m_oPathOwner.clear();
+  m_oRunningPaths.clear();
+  m_oRunningParents.clear();
+  m_oDirPaths.clear();
+  m_oWaiting.clear();
+  m_oRunning.clear();
+  m_uiLoadedId = 0;
+  m_bLoadedAll = false;
+}
+
+void CcSyncQueue::itemsAdded()
+{
+  m_bLoadedAll = false;
+}
+
+void CcSyncQueue::flush()
+{
+  if (m_oDone.size() > 0)
+  {
+    m_pDatabase->queueFinalizeList(m_sDirName, m_oDone);
+    m_oDone.clear();
+    m_oDoneIds.clear();
+  }
+  if (m_oFailed.size() > 0)
+  {
+    CcSyncQueueItemList oFailed;
+    m_oFailed.forEach([&oFailed](const uint64&, CcSyncQueueItem& rItem) { oFailed.append(rItem); });
+    m_pDatabase->queueUpdateAttempts(m_sDirName, oFailed);
+    m_oFailed.clear();
+  }
+}
+
+bool CcSyncQueue::isFinished(uint64 uiQueueIndex) const
+{
+  return m_oDoneIds.contains(uiQueueIndex);
+}
+
+void CcSyncQueue::drop(uint64 uiQueueIndex)
+{
+  // Ready or parked item, entries in lists are skipped later
+  CcSyncQueueItem oItem;
+  if (m_oItems.take(uiQueueIndex, oItem))
+  {
+    releasePath(oItem);
+  }
+}
+
+void CcSyncQueue::loadNext()
+{
+  // Write back before reading, so released items are read with current values
+  flush();
+  CcSyncQueueItemList oItems;
+  if (m_pDatabase->queueLoad(m_sDirName, m_uiLoadedId, CcSyncGlobals::Database::QueueBatchSize, oItems))
+  {
+    if (oItems.size() < CcSyncGlobals::Database::QueueBatchSize)
+    {
+      m_bLoadedAll = true;
+    }
+    for (CcSyncQueueItem& oItem : oItems)
+    {
+      m_uiLoadedId = oItem.uiId;
+      enqueue(oItem);
+    }
+  }
+  else
+  {
+    CcSyncLog::writeError("Loading queue failed: " + m_sDirName);
+    m_bLoadedAll = true;
+  }
+}
+
+bool CcSyncQueue::selectNext(uint64& uiId, bool bTransfers)
+{
+  bool bFound = false;
+  CcDateTime oNow = CcKernel::getUpTime();
+  while (bFound == false)
+  {
+    CReadyList* pList = nullptr;
+    if (bTransfers == false)
+    {
+      if (cleanFront(m_oReadyOther))
+        pList = &m_oReadyOther;
+    }
+    else if (cleanFront(m_oReadyOrder))
+    {
+      const CcSyncQueueItem* pFirst = m_oItems.find(m_oReadyOrder.front().uiId);
+      // Ready items are appended in order of time, first one is starving first
+      if (m_eSchedule != ESyncSchedule::SmallFirst ||
+          (oNow - pFirst->oReadyTime).getTimestampS() >= static_cast<int64>(m_uiStarvationTime))
+      {
+        pList = &m_oReadyOrder;
+      }
+      else
+      {
+        for (size_t uiClass = 0; uiClass < CcSyncQueue_SizeClasses && pList == nullptr; uiClass++)
+        {
+          if (cleanFront(m_oReadySizes[uiClass]))
+            pList = &m_oReadySizes[uiClass];
+        }
+      }
+    }
+    if (pList == nullptr)
+    {
+      break;
+    }
+    uint64 uiBlockingId = 0;
+    CcSyncQueueItem* pItem = m_oItems.find(pList->front().uiId);
+    if (isPathBlocked(*pItem, uiBlockingId))
+    {
+      // Wait for item on parent or child path
+      pList->pop();
+      park(*pItem, uiBlockingId, m_oRunParked);
+    }
+    else
+    {
+      uiId = pItem->uiId;
+      bFound = true;
+    }
+  }
+  return bFound;
+}
+
+bool CcSyncQueue::cleanFront(CReadyList& oList)
+{
+  while (oList.isEmpty() == false)
+  {
+    const CcSyncQueueItem* pItem = m_oItems.find(oList.front().uiId);
+    if (pItem != nullptr &&
+        pItem->uiReadySeq == oList.front().uiSeq)
+    {
+      return true;
+    }
+    oList.pop();
+  }
+  return false;
+}
+
+bool CcSyncQueue::isPathBlocked(const CcSyncQueueItem& oItem, uint64& uiBlockingId)
+{
+  // Running item on this path or on a parent directory
+  for (size_t uiPos = 0; uiPos <= oItem.sPath.length(); uiPos++)
+  {
+    if (uiPos == oItem.sPath.length() ||
+        oItem.sPath[uiPos] == '/')
+    {
+      const uint64* pRunning = m_oRunningPaths.find(oItem.sPath.substr(0, uiPos));
+      if (pRunning != nullptr &&
+          *pRunning != oItem.uiId)
+      {
+        uiBlockingId = *pRunning;
+        return true;
+      }
+    }
+  }
+  // Running item below this path
+  const CcList<uint64>* pBelow = m_oRunningParents.find(oItem.sPath);
+  if (pBelow != nullptr &&
+      pBelow->size() > 0)
+  {
+    uiBlockingId = (*pBelow)[0];
+    return true;
+  }
+  return false;
+}
+
+void CcSyncQueue::enqueue(CcSyncQueueItem& oItem)
+{
+  if (oItem.uiQueueId == 0)
+  {
+    oItem.oReadyTime = CcKernel::getUpTime();
+    makeReady(oItem);
+  }
+  else
+  {
+    m_oWaiting.get(oItem.uiQueueId).append(oItem);
+  }
+}
+
+void CcSyncQueue::release(const CcSyncQueueItem& oItem)
+{
+  CcSyncQueueItemList oDependents;
+  if (m_oWaiting.take(oItem.uiId, oDependents))
+  {
+    for (CcSyncQueueItem& oDependent : oDependents)
+    {
+      oDependent.uiQueueId = 0;
+      if (oItem.uiReleaseDirId != 0)
+        oDependent.uiDirId = oItem.uiReleaseDirId;
+      enqueue(oDependent);
+    }
+  }
+}
+
+void CcSyncQueue::makeReady(CcSyncQueueItem& oItem)
+{
+  if (oItem.sPath.length() == 0)
+  {
+    oItem.sPath = getPath(oItem);
+  }
+  uint64& rOwner = m_oPathOwner.get(oItem.sPath);
+  if (rOwner == 0)
+  {
+    rOwner = oItem.uiId;
+  }
+  if (rOwner != oItem.uiId)
+  {
+    // Older item of same path has to be finished first
+    park(oItem, rOwner, m_oPathParked);
+  }
+  else
+  {
+    m_uiReadySeq++;
+    oItem.uiReadySeq = m_uiReadySeq;
+    CReadyRef oRef;
+    oRef.uiId = oItem.uiId;
+    oRef.uiSeq = m_uiReadySeq;
+    m_oReadyOrder.append(oRef);
+    m_oReadySizes[getSizeClass(oItem.uiSize)].append(oRef);
+    if (isTransfer(oItem.eType) == false)
+      m_oReadyOther.append(oRef);
+    m_oItems.set(oItem.uiId, oItem);
+  }
+}
+
+void CcSyncQueue::park(CcSyncQueueItem& oItem, uint64 uiBlockingId, CcSyncHashMap<uint64, CcList<uint64>>& oParked)
+{
+  oItem.uiReadySeq = 0;
+  m_oItems.set(oItem.uiId, oItem);
+  oParked.get(uiBlockingId).append(oItem.uiId);
+}
+
+void CcSyncQueue::unpark(uint64 uiBlockingId, CcSyncHashMap<uint64, CcList<uint64>>& oParked)
+{
+  CcList<uint64> oIds;
+  if (oParked.take(uiBlockingId, oIds))
+  {
+    for (uint64 uiId : oIds)
+    {
+      // Dropped items are not available anymore
+      CcSyncQueueItem oItem;
+      if (m_oItems.take(uiId, oItem))
+      {
+        makeReady(oItem);
+      }
+    }
+  }
+}
+
+void CcSyncQueue::releasePath(const CcSyncQueueItem& oItem)
+{
+  const uint64* pOwner = m_oPathOwner.find(oItem.sPath);
+  if (pOwner != nullptr &&
+      *pOwner == oItem.uiId)
+  {
+    m_oPathOwner.remove(oItem.sPath);
+    // Next item in order of Id becomes owner
+    unpark(oItem.uiId, m_oPathParked);
+  }
+}
+
+void CcSyncQueue::startRunning(const CcSyncQueueItem& oItem)
+{
+  m_oRunningPaths.set(oItem.sPath, oItem.uiId);
+  // Empty path is root, it is parent of all other paths
+  for (size_t uiPos = 0; uiPos < oItem.sPath.length(); uiPos++)
+  {
+    if (uiPos == 0 ||
+        oItem.sPath[uiPos] == '/')
+    {
+      m_oRunningParents.get(oItem.sPath.substr(0, uiPos)).append(oItem.uiId);
+    }
+  }
+}
+
+void CcSyncQueue::stopRunning(const CcSyncQueueItem& oItem)
+{
+  const uint64* pRunning = m_oRunningPaths.find(oItem.sPath);
+  if (pRunning != nullptr &&
+      *pRunning == oItem.uiId)
+  {
+    m_oRunningPaths.remove(oItem.sPath);
+  }
+  for (size_t uiPos = 0; uiPos < oItem.sPath.length(); uiPos++)
+  {
+    if (uiPos == 0 ||
+        oItem.sPath[uiPos] == '/')
+    {
+      CcString sParent = oItem.sPath.substr(0, uiPos);
+      CcList<uint64>* pBelow = m_oRunningParents.find(sParent);
+      if (pBelow != nullptr)
+      {
+        pBelow->removeItem(oItem.uiId);
+        if (pBelow->size() == 0)
+          m_oRunningParents.remove(sParent);
+      }
+    }
+  }
+  unpark(oItem.uiId, m_oRunParked);
+}
+
+CcString CcSyncQueue::getPath(const CcSyncQueueItem& oItem)
+{
+  CcString sPath = getDirPath(oItem.uiDirId);
+  if (sPath.length() > 0)
+    sPath.append("/");
+  sPath.append(oItem.sName);
+  return sPath;
+}
+
+CcString CcSyncQueue::getDirPath(uint64 uiDirId)
+{
+  CcString sPath;
+  // Id 1 is root of directory
+  if (uiDirId > 1)
+  {
+    const CcString* pPath = m_oDirPaths.find(uiDirId);
+    if (pPath != nullptr)
+    {
+      sPath = *pPath;
+    }
+    else
+    {
+      CcSyncFileInfo oDirInfo = m_pDatabase->getDirectoryInfoById(m_sDirName, uiDirId);
+      if (oDirInfo.getId() == uiDirId &&
+          oDirInfo.getDirId() != uiDirId)
+      {
+        sPath = getDirPath(oDirInfo.getDirId());
+        if (sPath.length() > 0)
+          sPath.append("/");
+        sPath.append(oDirInfo.getName());
+        m_oDirPaths.set(uiDirId, sPath);
+      }
+      else
+      {
+        // Unknown directory, it can only block items with same DirId
+        sPath = "#" + CcString::fromNumber(uiDirId);
+      }
+    }
+  }
+  return sPath;
+}
+
+size_t CcSyncQueue::getSizeClass(uint64 uiSize)
+{
+  size_t uiClass = 0;
+  while (uiSize > 0)
+  {
+    uiClass++;
+    uiSize >>= 1;
+  }
+  return uiClass;
+}
+
+void CcSyncQueue::CReadyList::pop()
+{
+  m_uiFront++;
+  if (isEmpty())
+  {
+    clear();
+  }
+  else if (m_uiFront >= CcSyncGlobals::Database::QueueBatchSize &&
+           m_uiFront * 2 >= m_oRefs.size())
+  {
+    // Drop taken entries, each entry is copied only once in average
+    CcList<CReadyRef> oRemaining;
+    for (size_t uiPos = m_uiFront; uiPos < m_oRefs.size(); uiPos++)
+      oRemaining.append(m_oRefs[uiPos]);
+    m_oRefs = std::move(oRemaining);
+    m_uiFront = 0;
+  }
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncQueue
+ *
+ * @page      CcSyncQueue
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncQueue
+ *
+ *  In-memory view of the Queue table of one directory.
+ *  Items are loaded in batches of QueueBatchSize ordered by Id, items wich
+ *  are waiting for a parent are kept in a dependency map until the parent
+ *  gets finalized. Finalized and failed items are written back in batches,
+ *  at latest before the next commit of the database or the next load.
+ *  The next item is selected from the loaded ready items by the schedule
+ *  of the directory, see ESyncSchedule. Ready items are kept in order of
+ *  time and in lists by size class, entries of items wich were taken
+ *  meanwhile are skipped, so selection does not depend on number of items.
+ *  Items of the same path are handed out one after another in order of Id,
+ *  the oldest loaded item owns the path until it is finalized or failed,
+ *  newer items are parked until then.
+ *  An item is also parked while an item of a parent directory or below its
+ *  own path is running on a transfer slot or on the main connection.
+ **/
+#ifndef _CcSyncQueue_H_
+#define _CcSyncQueue_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcDateTime.h"
+#include "CcSyncHashMap.h"
+#include "CcSyncDbClient.h"
+#include "CcSyncDirectoryConfig.h"
+
+class CcSyncFileInfo;
+
+//! Ready lists by number of bits of size, used for SmallFirst
+#define CcSyncQueue_SizeClasses 65
+
+/**
+ * @brief One row of Queue table
+ */
+class CcSyncSHARED CcSyncQueueItem
+{
+public:
+  uint64            uiId        = 0;
+  uint64            uiQueueId   = 0;
+  EBackupQueueType  eType       = EBackupQueueType::Unknown;
+  uint64            uiFileId    = 0;
+  uint64            uiDirId     = 0;
+  CcString          sName;
+  uint16            uiAttempts  = 0;
+  uint64            uiSize      = 0;
+  //! Uptime when item became ready, used to avoid starvation
+  CcDateTime        oReadyTime;
+  //! DirId for dependent items after finalize, 0 keeps their DirId
+  uint64            uiReleaseDirId = 0;
+  //! Path within directory, resolved by queue if item becomes ready
+  CcString          sPath;
+  //! Current entry in ready lists, 0 if item is not ready
+  uint64            uiReadySeq  = 0;
+
+  bool operator==(const CcSyncQueueItem& oToCompare) const
+    { return uiId == oToCompare.uiId; }
+};
+
+#ifdef _MSC_VER
+template class CcSyncSHARED CcList<CcSyncQueueItem>;
+#endif
+
+typedef CcList<CcSyncQueueItem> CcSyncQueueItemList;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncQueue
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncQueue(CcSyncDbClientPointer& pDatabase, const CcString& sDirName);
+
+  /**
+   * @brief Destructor, pending items will be written to database
+   */
+  ~CcSyncQueue( void );
+  CCDEFINE_COPY_DENIED(CcSyncQueue)
+
+  /**
+   * @brief Set order of processing.
+   * @param eSchedule:        Order of ready items
+   * @param uiStarvationTime: Seconds until a deferred item is processed next
+   */
+  void setSchedule(ESyncSchedule eSchedule, uint32 uiStarvationTime);
+
+  /**
+   * @brief Check if an item can be started now.
+   *        Items wich are waiting for a running item of same path are not
+   *        counted, so false does not mean that queue is finished.
+   * @param bTransfers: false to check only items wich are not transferring
+   *                    file content, they can be done while transfers are
+   *                    deferred.
+   */
+  bool hasItems(bool bTransfers = true);
+  EBackupQueueType getNext(CcSyncFileInfo& oFileInfo, uint64& uiQueueIndex, bool bTransfers = true);
+  void finalizeDirectory(CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex);
+  void finalizeFile(uint64 uiQueueIndex);
+  void incrementItem(uint64 uiQueueIndex);
+  /**
+   * @brief Make running item ready again without counting an attempt,
+   *        used if server rejected item because it is busy.
+   */
+  void retryItem(uint64 uiQueueIndex);
+
+  /**
+   * @brief Drop all loaded items, next call of hasItems will start
+   *        loading from beginning of table.
+   */
+  void reset();
+
+  /**
+   * @brief Items were inserted to database, they will be loaded on next hasItems
+   */
+  void itemsAdded();
+
+  /**
+   * @brief Write finalized and failed items to database.
+   */
+  void flush();
+
+  /**
+   * @brief Remove a loaded item wich was superseded by a newer item.
+   *        Items in progress are not removed.
+   */
+  void drop(uint64 uiQueueIndex);
+  bool isRunning(uint64 uiQueueIndex) const
+    { return m_oRunning.contains(uiQueueIndex); }
+  /**
+   * @brief Check if item is finalized but not yet removed from database by flush.
+   */
+  bool isFinished(uint64 uiQueueIndex) const;
+
+  const CcString& getDirName() const
+    { return m_sDirName; }
+
+  /**
+   * @brief Check if type of item is transferring file content.
+   */
+  static bool isTransfer(EBackupQueueType eType)
+    { return eType == EBackupQueueType::AddFile || eType == EBackupQueueType::DownloadFile; }
+
+private:
+  /**
+   * @brief Entry of ready lists, it is outdated if uiSeq does not match
+   *        CcSyncQueueItem::uiReadySeq of item anymore.
+   */
+  class CReadyRef
+  {
+  public:
+    uint64 uiId  = 0;
+    uint64 uiSeq = 0;
+  };
+
+  /**
+   * @brief Ready entries in order of append, taken from front.
+   */
+  class CReadyList
+  {
+  public:
+    void append(const CReadyRef& oRef)
+      { m_oRefs.append(oRef); }
+    bool isEmpty() const
+      { return m_uiFront >= m_oRefs.size(); }
+    const CReadyRef& front() const
+      { return m_oRefs[m_uiFront]; }
+    void pop();
+    void clear()
+      { m_oRefs.clear(); m_uiFront = 0; }
+  private:
+    CcList<CReadyRef> m_oRefs;
+    size_t            m_uiFront = 0;
+  };
+
+  void loadNext();
+  bool selectNext(uint64& uiId, bool bTransfers);
+  bool cleanFront(CReadyList& oList);
+  bool isPathBlocked(const CcSyncQueueItem& oItem, uint64& uiBlockingId);
+  void enqueue(CcSyncQueueItem& oItem);
+  void release(const CcSyncQueueItem& oItem);
+  void makeReady(CcSyncQueueItem& oItem);
+  void park(CcSyncQueueItem& oItem, uint64 uiBlockingId, CcSyncHashMap<uint64, CcList<uint64>>& oParked);
+  void unpark(uint64 uiBlockingId, CcSyncHashMap<uint64, CcList<uint64>>& oParked);
+  void releasePath(const CcSyncQueueItem& oItem);
+  void startRunning(const CcSyncQueueItem& oItem);
+  void stopRunning(const CcSyncQueueItem& oItem);
+  CcString getPath(const CcSyncQueueItem& oItem);
+  CcString getDirPath(uint64 uiDirId);
+  static size_t getSizeClass(uint64 uiSize);
+
+private:
+  CcSyncDbClientPointer m_pDatabase;
+  CcString              m_sDirName;
+  //! Loaded items wich are ready or parked
+  CcSyncHashMap<uint64, CcSyncQueueItem>    m_oItems;
+  CReadyList            m_oReadyOrder;
+  CReadyList            m_oReadySizes[CcSyncQueue_SizeClasses];
+  //! Ready items without transfer of file content
+  CReadyList            m_oReadyOther;
+  uint64                m_uiReadySeq = 0;
+  //! Parked items by Id of item wich owns their path
+  CcSyncHashMap<uint64, CcList<uint64>>     m_oPathParked;
+  //! Parked items by Id of running item on a parent or child path
+  CcSyncHashMap<uint64, CcList<uint64>>     m_oRunParked;
+  CcSyncHashMap<CcString, uint64>           m_oPathOwner;
+  CcSyncHashMap<CcString, uint64>           m_oRunningPaths;
+  //! Running items below a directory path
+  CcSyncHashMap<CcString, CcList<uint64>>   m_oRunningParents;
+  CcSyncHashMap<uint64, CcString>           m_oDirPaths;
+  CcSyncHashMap<uint64, CcSyncQueueItemList> m_oWaiting;
+  CcSyncHashMap<uint64, CcSyncQueueItem>    m_oRunning;
+  CcSyncQueueItemList   m_oDone;
+  CcSyncHashMap<uint64, bool>               m_oDoneIds;
+  CcSyncHashMap<uint64, CcSyncQueueItem>    m_oFailed;
+  uint64                m_uiLoadedId = 0;
+  bool                  m_bLoadedAll = false;
+  ESyncSchedule         m_eSchedule = ESyncSchedule::OldestFirst;
+  uint32                m_uiStarvationTime = 0;
+};
+
+#endif /* _CcSyncQueue_H_ */
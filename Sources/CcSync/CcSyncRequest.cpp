@@ -146,6 +146,22 @@ bool CcSyncRequest::getServerRescan()
   return  bDeep;
 }
 
+bool CcSyncRequest::getServerSetTrace()
+{
+  bool bEnable = false;
+  if (m_oData.contains(CcSyncGlobals::Commands::ServerSetTrace::Enable, EJsonDataType::Value))
+    bEnable = m_oData[CcSyncGlobals::Commands::ServerSetTrace::Enable].getValue().getBool();
+  return bEnable;
+}
+
+bool CcSyncRequest::getServerSetProfiler()
+{
+  bool bEnable = false;
+  if (m_oData.contains(CcSyncGlobals::Commands::ServerSetProfiler::Enable, EJsonDataType::Value))
+    bEnable = m_oData[CcSyncGlobals::Commands::ServerSetProfiler::Enable].getValue().getBool();
+  return bEnable;
+}
+
 bool CcSyncRequest::hasFileInfo()
 {
   return false;
@@ -301,6 +317,23 @@ void CcSyncRequest::setServerStop()
   init(ESyncCommandType::ServerStop);
 }
 
+void CcSyncRequest::setServerGetStats()
+{
+  init(ESyncCommandType::ServerGetStats);
+}
+
+void CcSyncRequest::setServerSetTrace(bool bEnable)
+{
+  init(ESyncCommandType::ServerSetTrace);
+  m_oData.add(CcJsonNode(CcSyncGlobals::Commands::ServerSetTrace::Enable, bEnable));
+}
+
+void CcSyncRequest::setServerSetProfiler(bool bEnable)
+{
+  init(ESyncCommandType::ServerSetProfiler);
+  m_oData.add(CcJsonNode(CcSyncGlobals::Commands::ServerSetProfiler::Enable, bEnable));
+}
+
 bool CcSyncRequest::getTypeFromData()
 {
   CcJsonNode& oValue = m_oData[CcSyncGlobals::Commands::Command];
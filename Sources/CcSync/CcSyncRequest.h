@@ -101,6 +101,8 @@ public:
   CcCrc32 getCrc();
 
   bool getServerRescan();
+  bool getServerSetTrace();
+  bool getServerSetProfiler();
   
   inline CcJsonObject& data()
     { return m_oData; }
@@ -133,6 +135,9 @@ public:
   void setDirectoryGetFileList(const CcString& sDirectoryName, uint64 uiDirId);
   void setServerRescan(bool bDeep);
   void setServerStop();
+  void setServerGetStats();
+  void setServerSetTrace(bool bEnable);
+  void setServerSetProfiler(bool bEnable);
 private:
   bool getTypeFromData();
 private:
@@ -131,6 +131,20 @@ CcString CcSyncResponse::getErrorMsg()
   return sError;
 }
 
+bool CcSyncResponse::isBusy()
+{
+  return m_oData.contains(CcSyncGlobals::Commands::RetryAfter, EJsonDataType::Value);
+}
+
+uint64 CcSyncResponse::getRetryAfter()
+{
+  uint64 uiRetryAfter = 0;
+  CcJsonNode& rRetryAfter = m_oData[CcSyncGlobals::Commands::RetryAfter];
+  if (rRetryAfter.isValue())
+    uiRetryAfter = rRetryAfter.getValue().getUint64();
+  return uiRetryAfter;
+}
+
 CcByteArray CcSyncResponse::getBinary()
 {
   CcJsonDocument oJsonDoc(m_oData);
@@ -171,6 +185,13 @@ void CcSyncResponse::setError(CcStatus uiErrorCode, const CcString& sErrorMsg)
   m_oData.add(CcJsonNode(CcSyncGlobals::Commands::ErrorMsg, sErrorMsg));
 }
 
+void CcSyncResponse::setBusy(uint64 uiRetryAfter)
+{
+  setResult(false);
+  setError(EStatus::Error, "Server busy, retry in " + CcString::fromNumber(uiRetryAfter) + "s");
+  m_oData.add(CcJsonNode(CcSyncGlobals::Commands::RetryAfter, uiRetryAfter));
+}
+
 void CcSyncResponse::addAccountInfo(const CcSyncAccountConfig& oAccountConfig)
 {
   m_oData.add(CcJsonNode(oAccountConfig.getJsonNode(), CcSyncGlobals::Commands::AccountGetData::Account));
@@ -187,6 +208,22 @@ CcSyncAccountConfig CcSyncResponse::getAccountConfig()
   return oAccountConfig;
 }
 
+void CcSyncResponse::setServerStats(const CcJsonObject& oStats)
+{
+  m_oData.add(CcJsonNode(oStats, CcSyncGlobals::Commands::ServerGetStats::Stats));
+}
+
+CcJsonObject CcSyncResponse::getServerStats()
+{
+  CcJsonObject oStats;
+  CcJsonNode& rStatsNode = m_oData[CcSyncGlobals::Commands::ServerGetStats::Stats];
+  if (rStatsNode.isObject())
+  {
+    oStats = rStatsNode.getJsonObject();
+  }
+  return oStats;
+}
+
 CcString CcSyncResponse::getSession()
 {
   CcString sSession;
@@ -100,14 +100,28 @@ public:
   bool hasError();
   CcStatus getError();
   CcString getErrorMsg();
+  /**
+   * @brief Check if server rejected request because of too many transfers.
+   */
+  bool isBusy();
+  /**
+   * @brief Get seconds to wait before request should be sent again.
+   */
+  uint64 getRetryAfter();
 
   void setLogin(const CcString& sUserToken);
   void setAccountRight(ESyncRights eRights);
   ESyncRights getAccountRight() const;
   void setResult(bool uiResult);
   void setError(CcStatus uiErrorCode, const CcString& sErrorMsg);
+  /**
+   * @brief Reject request, client has to retry after uiRetryAfter seconds.
+   */
+  void setBusy(uint64 uiRetryAfter);
   void addAccountInfo(const CcSyncAccountConfig& oAccountConfig);
   CcSyncAccountConfig getAccountConfig();
+  void setServerStats(const CcJsonObject& oStats);
+  CcJsonObject getServerStats();
 
   CcString getSession();
 
@@ -0,0 +1,89 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncSignal
+ *
+ * @page      CcSyncSignal
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncSignal
+ *
+ *  Wakes up threads wich are waiting for work or resources instead of
+ *  polling with sleep. Each signal increments a counter, a waiter reads the
+ *  counter before it checks its condition and waits only while the counter
+ *  is unchanged, so signals between check and wait are not lost.
+ **/
+#ifndef _CcSyncSignal_H_
+#define _CcSyncSignal_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncSignal
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncSignal();
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncSignal( void );
+  CCDEFINE_COPY_DENIED(CcSyncSignal)
+
+  /**
+   * @brief Get current counter, has to be read before condition is checked.
+   */
+  uint64 getCount();
+
+  /**
+   * @brief Wake one waiting thread
+   */
+  void signal();
+
+  /**
+   * @brief Wake all waiting threads
+   */
+  void signalAll();
+
+  /**
+   * @brief Wait until a signal after getCount was sent.
+   * @param uiCount:     Value of getCount before condition was checked
+   * @param uiTimeoutMs: Maximum time to wait
+   * @return true if signalled, false on timeout
+   */
+  bool wait(uint64 uiCount, uint64 uiTimeoutMs);
+
+private:
+  std::mutex              m_oMutex;
+  std::condition_variable m_oCondition;
+  uint64                  m_uiCount = 0;
+};
+
+#endif /* _CcSyncSignal_H_ */
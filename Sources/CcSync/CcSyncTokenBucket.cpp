@@ -0,0 +1,94 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncTokenBucket
+ */
+#include "CcSyncTokenBucket.h"
+#include "CcKernel.h"
+
+CcSyncTokenBucket::CcSyncTokenBucket(uint64 uiRate) :
+  m_uiRate(uiRate),
+  m_iTokens(static_cast<int64>(uiRate)),
+  m_oLastRefill(CcKernel::getUpTime())
+{
+}
+
+CcSyncTokenBucket::~CcSyncTokenBucket(void)
+{
+}
+
+void CcSyncTokenBucket::setRate(uint64 uiRate)
+{
+  m_oLock.lock();
+  refill();
+  m_uiRate = uiRate;
+  if (m_iTokens > static_cast<int64>(m_uiRate))
+    m_iTokens = static_cast<int64>(m_uiRate);
+  m_oLock.unlock();
+}
+
+uint64 CcSyncTokenBucket::getRate()
+{
+  m_oLock.lock();
+  uint64 uiRate = m_uiRate;
+  m_oLock.unlock();
+  return uiRate;
+}
+
+void CcSyncTokenBucket::consume(size_t uiBytes)
+{
+  int64 iWaitMs = 0;
+  m_oLock.lock();
+  if (m_uiRate > 0)
+  {
+    refill();
+    // Take bytes in advance, following callers are waiting behind them
+    m_iTokens -= static_cast<int64>(uiBytes);
+    if (m_iTokens < 0)
+    {
+      iWaitMs = (-m_iTokens * 1000) / static_cast<int64>(m_uiRate);
+    }
+  }
+  m_oLock.unlock();
+  if (iWaitMs > 0)
+  {
+    CcKernel::sleep(static_cast<uint32>(iWaitMs));
+  }
+}
+
+void CcSyncTokenBucket::refill()
+{
+  CcDateTime oNow = CcKernel::getUpTime();
+  int64 iElapsedMs = (oNow - m_oLastRefill).getTimestampMs();
+  int64 iAdd = (static_cast<int64>(m_uiRate) * iElapsedMs) / 1000;
+  // Keep time if nothing was added, so low rates are not rounded to 0
+  if (iAdd > 0)
+  {
+    m_oLastRefill = oNow;
+    m_iTokens += iAdd;
+    // Burst is limited to one second of data
+    if (m_iTokens > static_cast<int64>(m_uiRate))
+      m_iTokens = static_cast<int64>(m_uiRate);
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncTokenBucket
+ *
+ * @page      CcSyncTokenBucket
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncTokenBucket
+ *
+ *  Rate limit for transfers. The bucket is filled with the rate in bytes
+ *  per second up to one second of data. Each transfered block takes its
+ *  size from bucket, if it is not available the caller sleeps until it is.
+ *  The bucket can be shared by multiple transfers, they share the rate.
+ **/
+#ifndef _CcSyncTokenBucket_H_
+#define _CcSyncTokenBucket_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcDateTime.h"
+#include "CcMutex.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncTokenBucket
+{
+public:
+  /**
+   * @brief Constructor
+   * @param uiRate: Bytes per second, 0 for unlimited
+   */
+  CcSyncTokenBucket(uint64 uiRate = 0);
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncTokenBucket( void );
+  CCDEFINE_COPY_DENIED(CcSyncTokenBucket)
+
+  /**
+   * @brief Change rate, running transfers are using it with next block.
+   * @param uiRate: Bytes per second, 0 for unlimited
+   */
+  void setRate(uint64 uiRate);
+  uint64 getRate();
+
+  /**
+   * @brief Take bytes from bucket, wait until they are available.
+   * @param uiBytes: Number of bytes to transfer next
+   */
+  void consume(size_t uiBytes);
+
+private:
+  void refill();
+
+private:
+  uint64      m_uiRate = 0;
+  int64       m_iTokens = 0;
+  CcDateTime  m_oLastRefill;
+  CcMutex     m_oLock;
+};
+
+#endif /* _CcSyncTokenBucket_H_ */
@@ -0,0 +1,191 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncTrace
+ */
+#include "CcSyncTrace.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+#include "CcKernel.h"
+#include "CcFile.h"
+
+std::atomic<bool> CcSyncTrace::s_bEnabled(false);
+CcMutex  CcSyncTrace::s_oLock;
+CcFile*  CcSyncTrace::s_pFile = nullptr;
+CcString CcSyncTrace::s_sBuffer;
+bool     CcSyncTrace::s_bFirstEvent = true;
+uint32   CcSyncTrace::s_uiThreadCount = 0;
+
+//! Id of current thread in trace, 0 if not yet assigned
+static thread_local uint32 s_uiThreadId = 0;
+
+bool CcSyncTrace::start(const CcString& sPath, const CcString& sProcessName)
+{
+  bool bRet = false;
+  stop();
+  s_oLock.lock();
+  CCNEW(s_pFile, CcFile, sPath);
+  if (s_pFile->open(EOpenFlags::Write))
+  {
+    // Events are written as JSON array, viewers are accepting a missing end
+    s_sBuffer = "[\n";
+    s_sBuffer << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":";
+    appendString(sProcessName);
+    s_sBuffer << "}}";
+    s_bFirstEvent = false;
+    writeBuffer();
+    s_bEnabled = true;
+    bRet = true;
+  }
+  else
+  {
+    CCDELETE(s_pFile);
+  }
+  s_oLock.unlock();
+  if (bRet)
+    CCSYNC_DEBUG("Tracing started: " + sPath);
+  else
+    CcSyncLog::writeError("Unable to open trace file: " + sPath);
+  return bRet;
+}
+
+void CcSyncTrace::stop()
+{
+  s_oLock.lock();
+  if (s_pFile != nullptr)
+  {
+    s_bEnabled = false;
+    s_sBuffer << "\n]\n";
+    writeBuffer();
+    s_pFile->close();
+    CCDELETE(s_pFile);
+    s_bFirstEvent = true;
+  }
+  s_oLock.unlock();
+}
+
+int64 CcSyncTrace::getTime()
+{
+  return CcKernel::getUpTime().getTimestampUs();
+}
+
+void CcSyncTrace::writeSpan(const char* pName, const char* pCategory, int64 iStart, int64 iDuration, const CcString* pDetail)
+{
+  uint32 uiThreadId = getThreadId();
+  s_oLock.lock();
+  // Tracing may have been stopped while span was running
+  if (s_pFile != nullptr)
+  {
+    if (s_bFirstEvent == false)
+      s_sBuffer << ",\n";
+    s_bFirstEvent = false;
+    s_sBuffer << "{\"name\":\"" << pName << "\",\"cat\":\"" << pCategory << "\",\"ph\":\"X\"" <<
+                 ",\"ts\":" << CcString::fromNumber(iStart) << ",\"dur\":" << CcString::fromNumber(iDuration) <<
+                 ",\"pid\":1,\"tid\":" << CcString::fromNumber(uiThreadId);
+    if (pDetail != nullptr)
+    {
+      s_sBuffer << ",\"args\":{\"detail\":";
+      appendString(*pDetail);
+      s_sBuffer << "}";
+    }
+    s_sBuffer << "}";
+    if (s_sBuffer.length() >= CcSyncGlobals::TraceBufferSize)
+    {
+      writeBuffer();
+    }
+  }
+  s_oLock.unlock();
+}
+
+uint32 CcSyncTrace::getThreadId()
+{
+  if (s_uiThreadId == 0)
+  {
+    s_oLock.lock();
+    s_uiThreadId = ++s_uiThreadCount;
+    s_oLock.unlock();
+  }
+  return s_uiThreadId;
+}
+
+void CcSyncTrace::appendString(const CcString& sValue)
+{
+  s_sBuffer << "\"";
+  for (size_t uiPos = 0; uiPos < sValue.length(); uiPos++)
+  {
+    char cSign = sValue[uiPos];
+    if (cSign == '"' || cSign == '\\')
+    {
+      s_sBuffer << "\\";
+      s_sBuffer.append(cSign);
+    }
+    else if (static_cast<unsigned char>(cSign) < 0x20)
+    {
+      s_sBuffer << " ";
+    }
+    else
+    {
+      s_sBuffer.append(cSign);
+    }
+  }
+  s_sBuffer << "\"";
+}
+
+void CcSyncTrace::writeBuffer()
+{
+  if (s_pFile != nullptr &&
+      s_sBuffer.length() > 0)
+  {
+    s_pFile->write(s_sBuffer.getCharString(), s_sBuffer.length());
+    s_sBuffer.clear();
+  }
+}
+
+void CcSyncTraceSpan::setDetail(const CcString& sDetail)
+{
+  if (isActive())
+  {
+    if (m_pDetail == nullptr)
+    {
+      CCNEW(m_pDetail, CcString, sDetail);
+    }
+    else
+    {
+      *m_pDetail = sDetail;
+    }
+  }
+}
+
+void CcSyncTraceSpan::end()
+{
+  if (m_iStart >= 0)
+  {
+    CcSyncTrace::writeSpan(m_pName, m_pCategory, m_iStart, CcSyncTrace::getTime() - m_iStart, m_pDetail);
+    m_iStart = -1;
+  }
+  if (m_pDetail != nullptr)
+  {
+    CCDELETE(m_pDetail);
+  }
+}
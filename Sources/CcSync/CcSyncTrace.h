@@ -0,0 +1,146 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncTrace
+ *
+ * @page      CcSyncTrace
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncTrace
+ *
+ *  Optional tracing of time spent in parsing, handlers, database, file and
+ *  socket operations. Spans are written as complete events of the Chrome
+ *  trace event format, the file can be opened with chrome://tracing or
+ *  ui.perfetto.dev. Tracing can be started and stopped at runtime, while it
+ *  is stopped a CcSyncTraceSpan only checks one flag.
+ **/
+#ifndef _CcSyncTrace_H_
+#define _CcSyncTrace_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcMutex.h"
+#include <atomic>
+
+class CcFile;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncTrace
+{
+public:
+  /**
+   * @brief Start writing spans to file, an existing file is overwritten.
+   * @param sPath:        Path of trace file
+   * @param sProcessName: Name of process shown in trace viewer
+   * @return true if file was opened
+   */
+  static bool start(const CcString& sPath, const CcString& sProcessName);
+
+  /**
+   * @brief Write pending spans and close trace file.
+   */
+  static void stop();
+
+  static bool isEnabled()
+    { return s_bEnabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Get current time in us for spans.
+   */
+  static int64 getTime();
+
+  /**
+   * @brief Add a finished span to trace file.
+   * @param pName:     Name of span
+   * @param pCategory: Category, for example Socket or Database
+   * @param iStart:    Start time from getTime
+   * @param iDuration: Duration in us
+   * @param pDetail:   Additional text shown in arguments of span, or nullptr
+   */
+  static void writeSpan(const char* pName, const char* pCategory, int64 iStart, int64 iDuration, const CcString* pDetail);
+
+private:
+  static uint32 getThreadId();
+  static void appendString(const CcString& sValue);
+  static void writeBuffer();
+
+private:
+  static std::atomic<bool> s_bEnabled;
+  static CcMutex  s_oLock;
+  static CcFile*  s_pFile;
+  static CcString s_sBuffer;
+  static bool     s_bFirstEvent;
+  static uint32   s_uiThreadCount;
+};
+
+/**
+ * @brief Measures time from construction to destruction or end and writes
+ *        it as span if tracing is enabled.
+ */
+class CcSyncSHARED CcSyncTraceSpan
+{
+public:
+  /**
+   * @brief Start span, name and category have to be string literals.
+   */
+  CcSyncTraceSpan(const char* pName, const char* pCategory) :
+    m_pName(pName),
+    m_pCategory(pCategory)
+  {
+    if (CcSyncTrace::isEnabled())
+      m_iStart = CcSyncTrace::getTime();
+  }
+
+  /**
+   * @brief Destructor, ends span if it is still running.
+   */
+  ~CcSyncTraceSpan( void )
+    { end(); }
+  CCDEFINE_COPY_DENIED(CcSyncTraceSpan)
+
+  /**
+   * @brief Check if span is recorded, use it before building details.
+   */
+  bool isActive() const
+    { return m_iStart >= 0; }
+
+  /**
+   * @brief Add text to arguments of span, ignored if span is not active.
+   */
+  void setDetail(const CcString& sDetail);
+
+  /**
+   * @brief End span before end of scope.
+   */
+  void end();
+
+private:
+  const char* m_pName;
+  const char* m_pCategory;
+  int64       m_iStart = -1;
+  CcString*   m_pDetail = nullptr;
+};
+
+#endif /* _CcSyncTrace_H_ */
@@ -46,6 +46,9 @@ enum class ESyncCommandType : uint16
   ServerAccountRescan             ,
   ServerAccountRemove             ,
   ServerStop                      ,
+  ServerGetStats                  ,
+  ServerSetTrace                  ,
+  ServerSetProfiler               ,
   AccountCreate          = 0x0200 ,
   AccountLogin                    ,
   AccountGetData                  ,
@@ -0,0 +1,106 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncClientTransferSlot
+ */
+#include "CcSyncClientTransferSlot.h"
+#include "CcSyncWorkerClientUpload.h"
+#include "CcSyncWorkerClientDownload.h"
+#include "CcSyncDirectory.h"
+#include "CcKernel.h"
+
+namespace CcSync
+{
+
+CcSyncClientTransferSlot::CcSyncClientTransferSlot(const CcUrl& oServer)
+{
+  m_oCom.setUrl(oServer);
+}
+
+CcSyncClientTransferSlot::~CcSyncClientTransferSlot()
+{
+  if (m_pWorker != nullptr)
+  {
+    while (m_pWorker->isInProgress())
+      CcKernel::sleep(20);
+    CCDELETE(m_pWorker);
+  }
+  m_oCom.getRequest().init(ESyncCommandType::Close);
+  m_oCom.sendRequestGetResponse();
+  m_oCom.close();
+}
+
+bool CcSyncClientTransferSlot::startUpload(CcSyncDirectory& oDirectory, const CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex)
+{
+  bool bRet = false;
+  if (isFree())
+  {
+    m_oFileInfo = oFileInfo;
+    CCNEW(m_pWorker, CcSyncWorkerClientUpload, oDirectory, m_oFileInfo, uiQueueIndex, m_oCom);
+    m_pWorker->start();
+    bRet = true;
+  }
+  return bRet;
+}
+
+bool CcSyncClientTransferSlot::startDownload(CcSyncDirectory& oDirectory, const CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex)
+{
+  bool bRet = false;
+  if (isFree())
+  {
+    m_oFileInfo = oFileInfo;
+    CCNEW(m_pWorker, CcSyncWorkerClientDownload, oDirectory, m_oFileInfo, uiQueueIndex, m_oCom);
+    m_pWorker->start();
+    bRet = true;
+  }
+  return bRet;
+}
+
+CcString CcSyncClientTransferSlot::finish()
+{
+  CcString sMessage;
+  if (m_pWorker != nullptr)
+  {
+    while (m_pWorker->isInProgress())
+      CcKernel::sleep(20);
+    sMessage = m_pWorker->getProgressMessage();
+    m_uiRetryAfter = m_pWorker->getRetryAfter();
+    CCDELETE(m_pWorker);
+  }
+  return sMessage;
+}
+
+bool CcSyncClientTransferSlot::isDone()
+{
+  return m_pWorker != nullptr && m_pWorker->isInProgress() == false;
+}
+
+CcString CcSyncClientTransferSlot::getProgressMessage()
+{
+  if (m_pWorker != nullptr)
+    return m_pWorker->getProgressMessage();
+  return CcString();
+}
+
+}
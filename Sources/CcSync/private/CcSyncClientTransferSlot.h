@@ -0,0 +1,97 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncClientTransferSlot
+ *
+ * @page      CcSyncClientTransferSlot
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncClientTransferSlot
+ *
+ *  One place in the transfer pool of CcSyncClient::doQueue.
+ *  Each slot has it's own connection to server, so transfers can run
+ *  parallel to each other and to the requests on the main connection.
+ **/
+#ifndef _CcSyncClientTransferSlot_H_
+#define _CcSyncClientTransferSlot_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcSyncClientCom.h"
+#include "CcSyncFileInfo.h"
+#include "ISyncWorkerBase.h"
+
+class CcSyncDirectory;
+
+namespace CcSync
+{
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncClientTransferSlot
+{
+public:
+  CcSyncClientTransferSlot(const CcUrl& oServer);
+  /**
+   * @brief Destructor, waits for running worker, database must not be locked
+   *        by caller.
+   */
+  ~CcSyncClientTransferSlot();
+  CCDEFINE_COPY_DENIED(CcSyncClientTransferSlot)
+
+  bool startUpload(CcSyncDirectory& oDirectory, const CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex);
+  bool startDownload(CcSyncDirectory& oDirectory, const CcSyncFileInfo& oFileInfo, uint64 uiQueueIndex);
+
+  /**
+   * @brief Delete finished worker and make slot available again.
+   * @return Last progress message of worker
+   */
+  CcString finish();
+
+  bool isFree() const
+    { return m_pWorker == nullptr; }
+  bool isDone();
+  /**
+   * @brief Get retry hint of last finished worker, see ISyncWorkerBase::getRetryAfter
+   */
+  uint64 getRetryAfter() const
+    { return m_uiRetryAfter; }
+  CcString getProgressMessage();
+
+  CcSyncClientCom& getCom()
+    { return m_oCom; }
+  bool isLoggedIn() const
+    { return m_bLogin; }
+  void setLoggedIn(bool bLogin)
+    { m_bLogin = bLogin; }
+
+private:
+  CcSyncClientCom   m_oCom;
+  CcSyncFileInfo    m_oFileInfo;
+  ISyncWorkerBase*  m_pWorker = nullptr;
+  bool              m_bLogin = false;
+  uint64            m_uiRetryAfter = 0;
+};
+
+}
+#endif /* _CcSyncClientTransferSlot_H_ */
@@ -0,0 +1,275 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncLogWriter
+ */
+#include "CcSyncLogWriter.h"
+#include "CcSyncGlobals.h"
+#include "CcKernel.h"
+#include "CcFile.h"
+#include "CcDirectory.h"
+#include "CcGlobalStrings.h"
+
+namespace CcSync
+{
+
+CcSyncLogWriter::CcSyncLogWriter(void) :
+  m_uiWritePos(0),
+  m_uiOverflows(0),
+  m_eState(EState::Idle),
+  m_uiAppending(0)
+{
+  for (size_t uiPos = 0; uiPos < CcSyncLogWriter_QueueSize; uiPos++)
+  {
+    m_aSlots[uiPos].uiSequence.store(uiPos, std::memory_order_relaxed);
+  }
+}
+
+CcSyncLogWriter::~CcSyncLogWriter(void)
+{
+}
+
+bool CcSyncLogWriter::append(ESyncLogTarget eTarget, const CcString& sMessage)
+{
+  // Count before state is checked, close sets state first and waits for count
+  m_uiAppending++;
+  if (m_eState != EState::Running)
+  {
+    m_uiAppending--;
+    return false;
+  }
+  size_t uiPos = m_uiWritePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    CSlot& rSlot = m_aSlots[uiPos & (CcSyncLogWriter_QueueSize - 1)];
+    size_t uiSequence = rSlot.uiSequence.load(std::memory_order_acquire);
+    if (uiSequence == uiPos)
+    {
+      if (m_uiWritePos.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed))
+      {
+        rSlot.eTarget = eTarget;
+        rSlot.sMessage = sMessage;
+        rSlot.uiSequence.store(uiPos + 1, std::memory_order_release);
+        break;
+      }
+    }
+    else if (uiSequence < uiPos)
+    {
+      // Slot was not yet read since last round, buffer is full.
+      // Caller writes message directly, so nothing is lost.
+      m_uiOverflows++;
+      m_uiAppending--;
+      return false;
+    }
+    else
+    {
+      // Another thread has taken this position
+      uiPos = m_uiWritePos.load(std::memory_order_relaxed);
+    }
+  }
+  m_uiAppending--;
+  return true;
+}
+
+void CcSyncLogWriter::setPaths(const CcString& sDirectory, const CcString& sClient, const CcString& sServer, const CcString& sCommon)
+{
+  m_oStateLock.lock();
+  m_sDirectory = sDirectory;
+  m_aTargets[static_cast<size_t>(ESyncLogTarget::Client)].sPath = sClient;
+  m_aTargets[static_cast<size_t>(ESyncLogTarget::Server)].sPath = sServer;
+  m_aTargets[static_cast<size_t>(ESyncLogTarget::Common)].sPath = sCommon;
+  m_oStateLock.unlock();
+}
+
+void CcSyncLogWriter::open()
+{
+  m_oStateLock.lock();
+  if (m_eState == EState::Idle)
+  {
+    m_eState = EState::Running;
+    start();
+  }
+  m_oStateLock.unlock();
+}
+
+void CcSyncLogWriter::close()
+{
+  m_oStateLock.lock();
+  EState eState = m_eState;
+  m_eState = EState::Closed;
+  m_oStateLock.unlock();
+  if (eState == EState::Running)
+  {
+    stop();
+    while (isInProgress())
+    {
+      CcKernel::sleep(10);
+    }
+    // Messages wich passed state check before close are published now
+    while (m_uiAppending != 0)
+    {
+      CcKernel::sleep(1);
+    }
+    // Thread is down, take the rest from here
+    flush();
+    for (CTarget& rTarget : m_aTargets)
+    {
+      if (rTarget.pFile != nullptr)
+      {
+        rTarget.pFile->close();
+        CCDELETE(rTarget.pFile);
+      }
+    }
+  }
+}
+
+void CcSyncLogWriter::run()
+{
+  while (getThreadState() == EThreadState::Running)
+  {
+    // Continue without waiting if buffer was filled more than half
+    if (flush() < CcSyncLogWriter_QueueSize / 2)
+    {
+      CcKernel::sleep(CcSyncGlobals::LogFlushTime);
+    }
+  }
+}
+
+size_t CcSyncLogWriter::flush()
+{
+  size_t uiCount = 0;
+  ESyncLogTarget eTarget;
+  CcString sMessage;
+  while (pop(eTarget, sMessage))
+  {
+    m_aTargets[static_cast<size_t>(eTarget)].sBuffer << sMessage << CcGlobalStrings::EolOs;
+    uiCount++;
+  }
+  uint64 uiOverflows = m_uiOverflows;
+  if (uiOverflows != m_uiOverflowsReported)
+  {
+    m_aTargets[static_cast<size_t>(ESyncLogTarget::Common)].sBuffer <<
+      "[warn] Log buffer full, messages written directly: " << CcString::fromNumber(uiOverflows - m_uiOverflowsReported) << CcGlobalStrings::EolOs;
+    m_uiOverflowsReported = uiOverflows;
+  }
+  for (size_t uiTarget = 0; uiTarget < 3; uiTarget++)
+  {
+    writeTarget(uiTarget);
+  }
+  return uiCount;
+}
+
+bool CcSyncLogWriter::pop(ESyncLogTarget& eTarget, CcString& sMessage)
+{
+  CSlot& rSlot = m_aSlots[m_uiReadPos & (CcSyncLogWriter_QueueSize - 1)];
+  if (rSlot.uiSequence.load(std::memory_order_acquire) == m_uiReadPos + 1)
+  {
+    eTarget = rSlot.eTarget;
+    sMessage = std::move(rSlot.sMessage);
+    rSlot.sMessage.clear();
+    // Release slot for next round
+    rSlot.uiSequence.store(m_uiReadPos + CcSyncLogWriter_QueueSize, std::memory_order_release);
+    m_uiReadPos++;
+    return true;
+  }
+  return false;
+}
+
+void CcSyncLogWriter::writeTarget(size_t uiTarget)
+{
+  CTarget& rTarget = m_aTargets[uiTarget];
+  if (rTarget.sBuffer.length() > 0)
+  {
+    if (rTarget.pFile != nullptr &&
+        rTarget.uiSize > 0 &&
+        rTarget.uiSize + rTarget.sBuffer.length() > CcSyncGlobals::LogFileMaxSize)
+    {
+      rotateTarget(uiTarget);
+    }
+    if (rTarget.pFile != nullptr ||
+        openTarget(uiTarget))
+    {
+      rTarget.pFile->write(rTarget.sBuffer.getCharString(), rTarget.sBuffer.length());
+      rTarget.uiSize += rTarget.sBuffer.length();
+    }
+    // Messages are not kept if file is not available, like before
+    rTarget.sBuffer.clear();
+  }
+}
+
+bool CcSyncLogWriter::openTarget(size_t uiTarget)
+{
+  CTarget& rTarget = m_aTargets[uiTarget];
+  bool bSuccess = false;
+  CCNEW(rTarget.pFile, CcFile, rTarget.sPath);
+  if (rTarget.pFile->exists())
+  {
+    rTarget.uiSize = CcFile::getInfo(rTarget.sPath).getFileSize();
+    bSuccess = rTarget.pFile->open(EOpenFlags::Append);
+  }
+  else
+  {
+    rTarget.uiSize = 0;
+    if (CcDirectory::exists(m_sDirectory) ||
+        CcDirectory::create(m_sDirectory, true))
+    {
+      bSuccess = rTarget.pFile->open(EOpenFlags::Write);
+    }
+  }
+  if (bSuccess == false)
+  {
+    CCDELETE(rTarget.pFile);
+  }
+  return bSuccess;
+}
+
+void CcSyncLogWriter::rotateTarget(size_t uiTarget)
+{
+  CTarget& rTarget = m_aTargets[uiTarget];
+  rTarget.pFile->close();
+  CCDELETE(rTarget.pFile);
+  CcString sOldest = rTarget.sPath + "." + CcString::fromNumber(CcSyncGlobals::LogFileCount);
+  if (CcFile::exists(sOldest))
+  {
+    CcFile::remove(sOldest);
+  }
+  for (size_t uiIndex = CcSyncGlobals::LogFileCount; uiIndex > 1; uiIndex--)
+  {
+    CcString sFrom = rTarget.sPath + "." + CcString::fromNumber(uiIndex - 1);
+    if (CcFile::exists(sFrom))
+    {
+      CcFile::move(sFrom, rTarget.sPath + "." + CcString::fromNumber(uiIndex));
+    }
+  }
+  if (CcSyncGlobals::LogFileCount > 0)
+  {
+    CcFile::move(rTarget.sPath, rTarget.sPath + ".1");
+  }
+  else
+  {
+    CcFile::remove(rTarget.sPath);
+  }
+}
+
+}
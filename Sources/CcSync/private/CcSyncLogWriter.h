@@ -0,0 +1,161 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncLogWriter
+ *
+ * @page      CcSyncLogWriter
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncLogWriter
+ *
+ *  Background writer of CcSyncLog.
+ *  Messages are put to a bounded ring buffer without locking, the slots are
+ *  reserved by an atomic write index and published by a sequence number per
+ *  slot. A single thread is taking them out every LogFlushTime, collects them
+ *  per target and writes them to log files wich are kept open.
+ *  If a file exceeds LogFileMaxSize it is rotated to <name>.1 up to
+ *  <name>.<LogFileCount>. If the buffer is full, append fails and the message
+ *  is written directly by CcSyncLog, so no message is dropped.
+ *  Thread is started by open and stopped by close, appending threads are
+ *  counted, so close waits for messages wich are published meanwhile.
+ **/
+#ifndef _CcSyncLogWriter_H_
+#define _CcSyncLogWriter_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcMutex.h"
+#include "IThread.h"
+#include "CcSyncLog.h"
+#include <atomic>
+
+class CcFile;
+
+//! Slots in ring buffer, must be a power of 2
+#define CcSyncLogWriter_QueueSize 4096
+
+namespace CcSync
+{
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncSHARED CcSyncLogWriter : public IThread
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncLogWriter( void );
+
+  /**
+   * @brief Destructor, close has to be called before if writer was opened.
+   */
+  virtual ~CcSyncLogWriter( void );
+  CCDEFINE_COPY_DENIED(CcSyncLogWriter)
+
+  /**
+   * @brief Put message to ring buffer.
+   * @param eTarget:  Log file to write to
+   * @param sMessage: Message without line ending
+   * @return false if writer is not opened, closed or buffer is full,
+   *         message has to be written directly.
+   */
+  bool append(ESyncLogTarget eTarget, const CcString& sMessage);
+
+  /**
+   * @brief Set location of log files, required before first append.
+   */
+  void setPaths(const CcString& sDirectory, const CcString& sClient, const CcString& sServer, const CcString& sCommon);
+
+  /**
+   * @brief Start thread, following messages are accepted by append.
+   */
+  void open();
+
+  /**
+   * @brief Stop thread, write all queued messages and close files.
+   *        Following messages are rejected by append.
+   */
+  void close();
+
+  //! Number of messages wich were rejected because buffer was full
+  uint64 getOverflows() const
+    { return m_uiOverflows; }
+
+private:
+  void run() override;
+  size_t flush();
+  bool pop(ESyncLogTarget& eTarget, CcString& sMessage);
+  void writeTarget(size_t uiTarget);
+  bool openTarget(size_t uiTarget);
+  void rotateTarget(size_t uiTarget);
+
+private:
+  enum class EState
+  {
+    Idle = 0,
+    Running,
+    Closed
+  };
+
+  /**
+   * @brief Slot in ring buffer, sequence is equal to write position
+   *        if slot is free and one more if message is ready to read.
+   */
+  class CSlot
+  {
+  public:
+    std::atomic<size_t> uiSequence;
+    ESyncLogTarget      eTarget = ESyncLogTarget::Common;
+    CcString            sMessage;
+  };
+
+  /**
+   * @brief Opened log file with messages wich are not yet written
+   */
+  class CTarget
+  {
+  public:
+    CcString  sPath;
+    CcFile*   pFile = nullptr;
+    uint64    uiSize = 0;
+    CcString  sBuffer;
+  };
+
+  CSlot               m_aSlots[CcSyncLogWriter_QueueSize];
+  std::atomic<size_t> m_uiWritePos;
+  size_t              m_uiReadPos = 0;
+  std::atomic<uint64> m_uiOverflows;
+  uint64              m_uiOverflowsReported = 0;
+  std::atomic<EState> m_eState;
+  //! Threads wich are in append, close waits for them before last flush
+  std::atomic<size_t> m_uiAppending;
+  CcMutex             m_oStateLock;
+  CcString            m_sDirectory;
+  CTarget             m_aTargets[3];
+};
+
+}
+
+#endif /* _CcSyncLogWriter_H_ */
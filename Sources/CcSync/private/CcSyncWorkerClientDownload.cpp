@@ -26,6 +26,8 @@
  */
 #include "CcSyncWorkerClientDownload.h"
 #include "CcSyncLog.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncTrace.h"
 #include "CcDirectory.h"
 #include "CcFile.h"
 #include "Hash/CcCrc32.h"
@@ -45,7 +47,36 @@ void CcSyncWorkerClientDownload::run()
 {
   bool bRet = false;
   m_oCom.getRequest().setDirectoryDownloadFile(m_oDirectory.getName(), m_oFileInfo.getId());
-  if (m_oCom.sendRequestGetResponse())
+  bool bRequest = m_oCom.sendRequestGetResponse();
+  CcSyncBuffer oBuffer;
+  bool bBuffer = true;
+  if (bRequest &&
+      m_oCom.getResponse().isBusy() == false)
+  {
+    // Wait for buffer before directory is locked
+    size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
+    uint64 uiFileSize = m_oCom.getResponse().getFileInfo().getFileSize();
+    if (uiFileSize < CcSyncGlobals::TransferSize)
+      uiBufferSize = static_cast<size_t>(uiFileSize);
+    bBuffer = oBuffer.acquire(uiBufferSize);
+  }
+  m_oDirectory.lock();
+  if (m_oCom.getResponse().isBusy())
+  {
+    // Not an error of this item, try again after server is ready
+    m_uiRetryAfter = m_oCom.getResponse().getRetryAfter();
+    m_oDirectory.queueRetryItem(m_uiQueueIndex);
+    CCSYNC_DEBUG("Download deferred, server busy: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+  }
+  else if (bBuffer == false)
+  {
+    // Server is already sending file, stream can only be dropped with connection
+    m_oCom.reconnect();
+    m_uiRetryAfter = CcSyncGlobals::Client::BufferRetryAfter;
+    m_oDirectory.queueRetryItem(m_uiQueueIndex);
+    CcSyncLog::writeWarning("Download deferred, no transfer buffer: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+  }
+  else if (bRequest)
   {
     m_oFileInfo = m_oCom.getResponse().getFileInfo();
     m_oDirectory.getFullDirPathById(m_oFileInfo);
@@ -57,9 +88,17 @@ void CcSyncWorkerClientDownload::run()
       CcFile oFile(sTempFilePath);
       if (oFile.open(EOpenFlags::Overwrite))
       {
-        if (receiveFile(&oFile))
+        // Intent is written before transfer, commits of other items meanwhile are making it durable
+        CcSyncJournalEntry oJournal;
+        m_oDirectory.journalInsert(EBackupQueueType::DownloadFile, m_oFileInfo, oJournal);
+        // Transfer without database lock, other workers can finish their items meanwhile
+        m_oDirectory.unlock();
+        bool bReceived = receiveFile(&oFile, oBuffer);
+        m_oDirectory.lock();
+        if (bReceived)
         {
           oFile.close();
+          m_oDirectory.journalSync(oJournal);
           if (m_oDirectory.fileNameInDirExists(m_oFileInfo.getDirId(), m_oFileInfo))
           {
             CcSyncFileInfo oFileToDelete = m_oDirectory.getFileInfoByFilename(m_oFileInfo.getDirId(), m_oFileInfo.getName());
@@ -72,7 +111,7 @@ void CcSyncWorkerClientDownload::run()
             {
               bSuccess = false;
               CcFile::remove(sTempFilePath);
-              CcSyncLog::writeDebug("Failed to remove original File: " + m_oFileInfo.getSystemFullPath(), ESyncLogTarget::Client);
+              CCSYNC_DEBUG("Failed to remove original File: " + m_oFileInfo.getSystemFullPath(), ESyncLogTarget::Client);
             }
           }
           if (bSuccess)
@@ -81,8 +120,8 @@ void CcSyncWorkerClientDownload::run()
             if (bSuccess == false)
             {
               CcFile::remove(sTempFilePath);
-              CcSyncLog::writeDebug("Failed to move temporary File: ", ESyncLogTarget::Client);
-              CcSyncLog::writeDebug("  " + sTempFilePath + " -> " + m_oFileInfo.getSystemFullPath(), ESyncLogTarget::Client);
+              CCSYNC_DEBUG("Failed to move temporary File: ", ESyncLogTarget::Client);
+              CCSYNC_DEBUG("  " + sTempFilePath + " -> " + m_oFileInfo.getSystemFullPath(), ESyncLogTarget::Client);
             }
           }
           if (bSuccess)
@@ -90,7 +129,7 @@ void CcSyncWorkerClientDownload::run()
             setFileInfo(m_oFileInfo.getSystemFullPath(), m_oDirectory.getUserId(), m_oDirectory.getGroupId(), m_oFileInfo.getModified());
             if (m_oDirectory.fileListInsert(m_oFileInfo, true))
             {
-              CcSyncLog::writeDebug("File downloaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+              CCSYNC_DEBUG("File downloaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
               bRet = true;
               m_oDirectory.queueFinalizeFile(m_uiQueueIndex);
             }
@@ -110,6 +149,8 @@ void CcSyncWorkerClientDownload::run()
           CcSyncLog::writeError("    ErrorMsg: " + m_oCom.getResponse().getErrorMsg(), ESyncLogTarget::Client);
           m_oDirectory.queueIncrementItem(m_uiQueueIndex);
         }
+        // Removed with list update, both are committed together
+        m_oDirectory.journalRemove(oJournal);
       }
       else
       {
@@ -130,6 +171,7 @@ void CcSyncWorkerClientDownload::run()
     CcSyncLog::writeError("    ErrorMsg: " + m_oCom.getResponse().getErrorMsg(), ESyncLogTarget::Client);
     m_oDirectory.queueIncrementItem(m_uiQueueIndex);
   }
+  m_oDirectory.unlock();
   if(bRet)
   {
     setExitCode(0);
@@ -172,26 +214,27 @@ void CcSyncWorkerClientDownload::setFileInfo(const CcString& sPathToFile, uint32
   CcFile::setModified(sPathToFile, CcDateTimeFromSeconds(iModified));
 }
 
-bool CcSyncWorkerClientDownload::receiveFile(CcFile* pFile)
+bool CcSyncWorkerClientDownload::receiveFile(CcFile* pFile, CcSyncBuffer& oBuffer)
 {
   bool bRet = false;
   bool bTransfer = true;
   CcCrc32 oCrc;
-  size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
-  if (m_oFileInfo.getFileSize() < CcSyncGlobals::TransferSize)
-  {
-    uiBufferSize = static_cast<size_t>(m_oFileInfo.getFileSize());
-  }
-  CcByteArray oByteArray(uiBufferSize);
+  CcByteArray& oByteArray = oBuffer.data();
+  size_t uiBufferSize = oByteArray.size();
   while (bTransfer)
   {
     if (m_uiReceived < m_oFileInfo.getFileSize())
     {
+      CcSyncTraceSpan oReadSpan("Read block", "Socket");
       size_t uiReadSize = m_oCom.getSocket().readArray(oByteArray, false);
+      oReadSpan.end();
       if (uiReadSize <= uiBufferSize)
       {
         oCrc.append(oByteArray.getArray(), uiReadSize);
         m_uiReceived += uiReadSize;
+        // Delay next read, so server is slowed down by flow control
+        m_oDirectory.downloadLimit().consume(uiReadSize);
+        CcSyncTraceSpan oWriteSpan("Write block", "File");
         if (pFile->write(oByteArray.getArray(), uiReadSize) != uiReadSize)
         {
           bTransfer = false;
@@ -207,6 +250,8 @@ bool CcSyncWorkerClientDownload::receiveFile(CcFile* pFile)
     else
     {
       bTransfer = false;
+      // Response requires an own buffer
+      oBuffer.release();
       m_oFileInfo.crc() = oCrc.getValueUint32();
       m_oCom.getRequest().setCrc(oCrc);
       if (m_oCom.sendRequestGetResponse())
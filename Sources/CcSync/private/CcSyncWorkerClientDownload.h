@@ -39,6 +39,7 @@
 
 // forward declarations
 class CcString;
+class CcSyncBuffer;
 
 namespace CcSync
 {
@@ -56,7 +57,7 @@ public:
   static void setFileInfo(const CcString& sPathToFile, uint32 uiUserId, uint32 uiGroupId, int64 iModified);
 
 private:
-  bool receiveFile(CcFile* pFile);
+  bool receiveFile(CcFile* pFile, CcSyncBuffer& oBuffer);
 
 private: // Member
   uint64 m_uiReceived = 0;
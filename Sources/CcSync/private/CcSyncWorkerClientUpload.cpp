@@ -26,6 +26,8 @@
  */
 #include "CcSyncWorkerClientUpload.h"
 #include "CcSyncLog.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncTrace.h"
 #include "CcDirectory.h"
 #include "CcFile.h"
 #include "Hash/CcCrc32.h"
@@ -43,15 +45,38 @@ CcSyncWorkerClientUpload::CcSyncWorkerClientUpload(CcSyncDirectory& oDirectory,
 
 void CcSyncWorkerClientUpload::run()
 {
+  // Wait for buffer before directory is locked and request is sent
+  CcSyncBuffer oBuffer;
+  bool bBuffer = oBuffer.acquire(static_cast<size_t>(CcSyncGlobals::TransferSize));
+  m_oDirectory.lock();
   m_oDirectory.getFullDirPathById(m_oFileInfo);
-  if (m_oFileInfo.fromSystemFile(false))
+  if (bBuffer == false)
+  {
+    m_uiRetryAfter = CcSyncGlobals::Client::BufferRetryAfter;
+    m_oDirectory.queueRetryItem(m_uiQueueIndex);
+    CcSyncLog::writeWarning("Upload deferred, no transfer buffer: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+  }
+  else if (m_oFileInfo.fromSystemFile(false))
   {
     m_oCom.getRequest().setDirectoryUploadFile(m_oDirectory.getName(), m_oFileInfo);
-    if (m_oCom.sendRequestGetResponse())
+    // Transfer without database lock, other workers can finish their items meanwhile
+    m_oDirectory.unlock();
+    bool bRequest = m_oCom.sendRequestGetResponse();
+    bool bAccepted = bRequest && m_oCom.getResponse().hasError() == false;
+    bool bSent = bAccepted && sendFile(oBuffer);
+    m_oDirectory.lock();
+    if (m_oCom.getResponse().isBusy())
     {
-      if (m_oCom.getResponse().hasError() == false)
+      // Not an error of this item, try again after server is ready
+      m_uiRetryAfter = m_oCom.getResponse().getRetryAfter();
+      m_oDirectory.queueRetryItem(m_uiQueueIndex);
+      CCSYNC_DEBUG("Upload deferred, server busy: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+    }
+    else if (bRequest)
+    {
+      if (bAccepted)
       {
-        if (sendFile())
+        if (bSent)
         {
           CcSyncFileInfo oResponseFileInfo = m_oCom.getResponse().getFileInfo();
           if (m_oDirectory.fileNameInDirExists(m_oFileInfo.getDirId(), m_oFileInfo))
@@ -62,7 +87,7 @@ void CcSyncWorkerClientUpload::run()
           if (m_oDirectory.fileListInsert(oResponseFileInfo, true))
           {
             m_oDirectory.queueFinalizeFile(m_uiQueueIndex);
-            CcSyncLog::writeDebug("File Successfully uploaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+            CCSYNC_DEBUG("File Successfully uploaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
           }
           else
           {
@@ -87,7 +112,7 @@ void CcSyncWorkerClientUpload::run()
               CcSyncFileInfo oResponseFileInfo = m_oCom.getResponse().getFileInfo();
               m_oDirectory.fileListInsert(oResponseFileInfo, true);
               m_oDirectory.queueFinalizeFile(m_uiQueueIndex);
-              CcSyncLog::writeDebug("File Successfully uploaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+              CCSYNC_DEBUG("File Successfully uploaded: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
             }
             // fall through
           default:
@@ -104,12 +129,20 @@ void CcSyncWorkerClientUpload::run()
       m_oDirectory.queueIncrementItem(m_uiQueueIndex);
     }
   }
+  else if (CcDirectory::exists(m_oFileInfo.getSystemDirPath()) &&
+           m_oDirectory.fileNameInDirExists(m_oFileInfo.getDirId(), m_oFileInfo) == false)
+  {
+    // Never synced file was removed again before upload, nothing left to do
+    m_oDirectory.queueFinalizeFile(m_uiQueueIndex);
+    CCSYNC_DEBUG("File removed before upload: " + m_oFileInfo.getName(), ESyncLogTarget::Client);
+  }
   else
   {
     m_oDirectory.queueIncrementItem(m_uiQueueIndex);
     CcSyncLog::writeError("Queued Directory not found: " + m_oFileInfo.getDirPath(), ESyncLogTarget::Client);
     CcSyncLog::writeError("    ErrorMsg: " + m_oCom.getResponse().getErrorMsg(), ESyncLogTarget::Client);
   }
+  m_oDirectory.unlock();
 }
 
 
@@ -149,7 +182,7 @@ void CcSyncWorkerClientUpload::setFileInfo(const CcString& sPathToFile, uint32 u
   CcFile::setModified(sPathToFile, CcDateTimeFromSeconds(iModified));
 }
 
-bool CcSyncWorkerClientUpload::sendFile()
+bool CcSyncWorkerClientUpload::sendFile(CcSyncBuffer& oPoolBuffer)
 {
   bool bRet = false;
   CcFile oFile(m_oFileInfo.getSystemFullPath());
@@ -157,15 +190,20 @@ bool CcSyncWorkerClientUpload::sendFile()
   if (oFile.open(EOpenFlags::Read | EOpenFlags::ShareRead))
   {
     bool bTransfer = true;
-    CcByteArray oBuffer(static_cast<size_t>(CcSyncGlobals::TransferSize));
+    CcByteArray& oBuffer = oPoolBuffer.data();
     size_t uiLastTransferSize;
     while (bTransfer)
     {
+      CcSyncTraceSpan oReadSpan("Read block", "File");
       uiLastTransferSize = oFile.readArray(oBuffer, false);
+      oReadSpan.end();
       if (uiLastTransferSize != 0 && uiLastTransferSize <= oBuffer.size())
       {
         oCrc.append(oBuffer.getArray(), uiLastTransferSize);
+        m_oDirectory.uploadLimit().consume(uiLastTransferSize);
+        CcSyncTraceSpan oWriteSpan("Write block", "Socket");
         size_t uiTransfered = m_oCom.getSocket().write(oBuffer.getArray(), uiLastTransferSize);
+        oWriteSpan.end();
         if (uiTransfered != uiLastTransferSize)
         {
           bTransfer = false;
@@ -185,6 +223,8 @@ bool CcSyncWorkerClientUpload::sendFile()
     }
     oFile.close();
   }
+  // Response requires an own buffer
+  oPoolBuffer.release();
   if (bRet == true)
   {
     m_oFileInfo.crc() = oCrc.getValueUint32();
@@ -54,11 +54,19 @@ public:
   virtual double getProgress() = 0;
   virtual CcString getProgressMessage() = 0;
 
+  /**
+   * @brief Get seconds server requested to wait, if it rejected the
+   *        transfer because it was busy, otherwise 0.
+   */
+  uint64 getRetryAfter() const
+    { return m_uiRetryAfter; }
+
 protected:
   CcSyncClientCom&  m_oCom;
   CcSyncDirectory&  m_oDirectory;
   CcSyncFileInfo&   m_oFileInfo;
   uint64            m_uiQueueIndex;
+  uint64            m_uiRetryAfter = 0;
 };
 
 }
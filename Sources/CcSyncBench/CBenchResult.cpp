@@ -0,0 +1,46 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CBenchResult
+ */
+#include "CBenchResult.h"
+#include "CcConsole.h"
+#include "CcFile.h"
+#include "Json/CcJsonDocument.h"
+
+bool CBenchResult::write(const CcString& sPath, CcJsonObject& oResult)
+{
+  bool bSuccess = false;
+  CcJsonDocument oDocument(oResult);
+  CcString sDocument = oDocument.getDocument();
+  CcFile oFile(sPath);
+  if (oFile.open(EOpenFlags::Write))
+  {
+    bSuccess = oFile.writeString(sDocument);
+    oFile.close();
+  }
+  if (bSuccess)
+    CcConsole::writeLine("Result written to " + sPath);
+  else
+    CcConsole::writeLine("Failed to write result to " + sPath);
+  return bSuccess;
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncBench
+ * @subpage   CBenchResult
+ *
+ * @page      CBenchResult
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CBenchResult
+ *
+ *  Result file of benchmarks, shared by CcSyncBench and CcSyncMicroBench.
+ **/
+#ifndef _CBenchResult_H_
+#define _CBenchResult_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "Json/CcJsonObject.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CBenchResult
+{
+public:
+  /**
+   * @brief Write result as JSON document and report target on console.
+   * @param sPath:   Path of result file
+   * @param oResult: Result to write
+   * @return true if file was written
+   */
+  static bool write(const CcString& sPath, CcJsonObject& oResult);
+};
+
+#endif /* _CBenchResult_H_ */
@@ -0,0 +1,661 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CSyncBench
+ */
+#include "CSyncBench.h"
+#include "CBenchResult.h"
+#include "CcKernel.h"
+#include "CcConsole.h"
+#include "CcFile.h"
+#include "CcDirectory.h"
+#include "CcArguments.h"
+#include "CcStringUtil.h"
+#include "Hash/CcCrc32.h"
+#include "Json/CcJsonArray.h"
+#include "CTestServer.h"
+#include "CTestClient.h"
+#include "CcSslSocket.h"
+#include "IThread.h"
+
+//! Name of sync directory on server and clients
+#define CSyncBench_DirectoryName  "BenchDir"
+//! Every n-th file is changed and one file per n files is added for incremental sync
+#define CSyncBench_ChangeInterval 10
+//! Bytes written at once to generated files
+#define CSyncBench_ChunkSize      (1024 * 1024)
+//! Default port of first scenario, each scenario is using next port
+#define CSyncBench_DefaultPort    27599
+//! Default timeout of one sync in seconds
+#define CSyncBench_DefaultTimeout 3600
+//! Default number of clients connecting in parallel for accept benchmark
+#define CSyncBench_AcceptClients  8
+//! Default duration of accept benchmark in seconds
+#define CSyncBench_AcceptTime     5
+
+static const CcString c_sAdminName("BenchAdmin");
+static const CcString c_sAdminPW("BenchPW$123");
+static const CcString c_sServerName("127.0.0.1");
+
+/**
+ * @brief Connects and closes TLS connections until time is over.
+ */
+class CSyncBenchConnector : public IThread
+{
+public:
+  CSyncBenchConnector(const CcString& sPort, const CcDateTime& oEnd) :
+    m_sPort(sPort),
+    m_oEnd(oEnd)
+  { }
+
+  size_t getConnections() const
+    { return m_uiConnections; }
+
+private:
+  void run() override
+  {
+    while (CcKernel::getUpTime() < m_oEnd)
+    {
+      CCNEWTYPE(pSocket, CcSslSocket);
+      CcSocket oSocket(pSocket);
+      if (pSocket->initClient() &&
+          oSocket.connect(c_sServerName, m_sPort))
+      {
+        m_uiConnections++;
+      }
+      oSocket.close();
+    }
+  }
+
+private:
+  CcString   m_sPort;
+  CcDateTime m_oEnd;
+  size_t     m_uiConnections = 0;
+};
+
+CSyncBench::CSyncBench( void ) :
+  m_sOutput("CcSyncBench.json"),
+  m_uiPort(CSyncBench_DefaultPort),
+  m_oTimeout(CcDateTimeFromSeconds(CSyncBench_DefaultTimeout)),
+  m_uiAcceptTime(CSyncBench_AcceptTime),
+  m_uiAcceptClients(CSyncBench_AcceptClients)
+{
+  m_sWorkingDir = CcKernel::getUserDataDir();
+  m_sWorkingDir.appendPath("CcSyncBench");
+}
+
+CSyncBench::~CSyncBench( void )
+{
+}
+
+bool CSyncBench::parseArguments(int argc, char **argv)
+{
+  bool bSuccess = true;
+  CcArguments oArguments;
+  oArguments.parse(argc, argv);
+  if (oArguments.size() > 0)
+  {
+    m_sBinaryDir = CcStringUtil::getDirectoryFromPath(oArguments[0]);
+  }
+  // Values of -1 are keeping defaults of scenario
+  int64 iFiles = -1;
+  int64 iSize = -1;
+  int64 iDepth = -1;
+  int64 iDirs = -1;
+  CcStringList slScenarios;
+  for (size_t uiArg = 1; uiArg < oArguments.size() && bSuccess; uiArg++)
+  {
+    const CcString& sArgument = oArguments[uiArg];
+    if (sArgument == "--keep")
+    {
+      m_bKeep = true;
+    }
+    else if (uiArg + 1 >= oArguments.size())
+    {
+      CcConsole::writeLine("Unknown or incomplete option: " + sArgument);
+      bSuccess = false;
+    }
+    else
+    {
+      const CcString& sValue = oArguments[++uiArg];
+      bool bOk = true;
+      if (sArgument == "--dir")
+        m_sWorkingDir = sValue;
+      else if (sArgument == "--output")
+        m_sOutput = sValue;
+      else if (sArgument == "--scenario")
+        slScenarios.append(sValue);
+      else if (sArgument == "--port")
+        m_uiPort = sValue.toUint16(&bOk);
+      else if (sArgument == "--timeout")
+        m_oTimeout = CcDateTimeFromSeconds(sValue.toUint32(&bOk));
+      else if (sArgument == "--files")
+        iFiles = static_cast<int64>(sValue.toUint32(&bOk));
+      else if (sArgument == "--size")
+        iSize = static_cast<int64>(sValue.toUint64(&bOk));
+      else if (sArgument == "--depth")
+        iDepth = static_cast<int64>(sValue.toUint32(&bOk));
+      else if (sArgument == "--dirs")
+        iDirs = static_cast<int64>(sValue.toUint32(&bOk));
+      else if (sArgument == "--accept-time")
+        m_uiAcceptTime = sValue.toUint32(&bOk);
+      else if (sArgument == "--accept-clients")
+        m_uiAcceptClients = sValue.toUint32(&bOk);
+      else
+        bOk = false;
+      if (bOk == false)
+      {
+        CcConsole::writeLine("Unknown option or invalid value: " + sArgument + " " + sValue);
+        bSuccess = false;
+      }
+    }
+  }
+
+  // Predefined trees, each is stressing another part of sync
+  CcList<CSyncBenchScenario> oPresets;
+  CSyncBenchScenario oTiny;
+  oTiny.sName = "tiny";
+  oTiny.uiDepth = 2;
+  oTiny.uiDirs = 10;
+  oTiny.uiFiles = 20;
+  oTiny.uiFileSize = 1024;
+  oPresets.append(oTiny);
+  CSyncBenchScenario oHuge;
+  oHuge.sName = "huge";
+  oHuge.uiFiles = 3;
+  oHuge.uiFileSize = 64 * 1024 * 1024;
+  oPresets.append(oHuge);
+  CSyncBenchScenario oDeep;
+  oDeep.sName = "deep";
+  oDeep.uiDepth = 32;
+  oDeep.uiDirs = 1;
+  oDeep.uiFiles = 2;
+  oDeep.uiFileSize = 4096;
+  oPresets.append(oDeep);
+  CSyncBenchScenario oWide;
+  oWide.sName = "wide";
+  oWide.uiFiles = 5000;
+  oWide.uiFileSize = 256;
+  oPresets.append(oWide);
+
+  for (CSyncBenchScenario& oScenario : oPresets)
+  {
+    if (slScenarios.size() == 0 ||
+        slScenarios.contains(oScenario.sName))
+    {
+      if (iFiles >= 0) oScenario.uiFiles = static_cast<size_t>(iFiles);
+      if (iSize >= 0)  oScenario.uiFileSize = static_cast<uint64>(iSize);
+      if (iDepth >= 0) oScenario.uiDepth = static_cast<size_t>(iDepth);
+      if (iDirs >= 0)  oScenario.uiDirs = static_cast<size_t>(iDirs);
+      m_oScenarios.append(oScenario);
+    }
+  }
+  if (bSuccess &&
+      m_oScenarios.size() == 0)
+  {
+    CcConsole::writeLine("No known scenario selected");
+    bSuccess = false;
+  }
+  return bSuccess;
+}
+
+void CSyncBench::printHelp()
+{
+  CcConsole::writeLine("Usage: CcSyncBench [options]");
+  CcConsole::writeLine("  --scenario NAME  tiny, huge, deep or wide, can be repeated, default all");
+  CcConsole::writeLine("  --files N        files in each directory of selected scenarios");
+  CcConsole::writeLine("  --size BYTES     size of each file of selected scenarios");
+  CcConsole::writeLine("  --depth N        levels of subdirectories of selected scenarios");
+  CcConsole::writeLine("  --dirs N         subdirectories in each directory of selected scenarios");
+  CcConsole::writeLine("  --dir PATH       working directory, default CcSyncBench in user data");
+  CcConsole::writeLine("  --output FILE    result file, default CcSyncBench.json");
+  CcConsole::writeLine("  --port N         port of first scenario, default " + CcString::fromNumber(CSyncBench_DefaultPort));
+  CcConsole::writeLine("  --timeout S      timeout of one sync in seconds, default " + CcString::fromNumber(CSyncBench_DefaultTimeout));
+  CcConsole::writeLine("  --accept-time S  duration of accept benchmark, 0 to skip, default " + CcString::fromNumber(CSyncBench_AcceptTime));
+  CcConsole::writeLine("  --accept-clients N  parallel clients of accept benchmark, default " + CcString::fromNumber(CSyncBench_AcceptClients));
+  CcConsole::writeLine("  --keep           keep generated trees after run");
+}
+
+bool CSyncBench::run()
+{
+  bool bSuccess = true;
+  m_sServerAppPath = m_sBinaryDir;
+  m_sClientAppPath = m_sBinaryDir;
+  m_sServerAppPath.appendPath("CcSyncServer" CC_DEBUG_EXTENSION);
+  m_sClientAppPath.appendPath("CcSyncClient" CC_DEBUG_EXTENSION);
+#ifdef WINDOWS
+  m_sServerAppPath.append(".exe");
+  m_sClientAppPath.append(".exe");
+#endif
+  if (CcFile::exists(m_sServerAppPath) == false ||
+      CcFile::exists(m_sClientAppPath) == false)
+  {
+    CcConsole::writeLine("CcSyncServer or CcSyncClient not found in " + m_sBinaryDir);
+    bSuccess = false;
+  }
+  else
+  {
+    CcJsonObject oResult;
+    oResult.add(CcJsonNode("Benchmark", CcString("CcSyncBench")));
+    CcJsonNode oScenarios(EJsonDataType::Array);
+    oScenarios.setName("Scenarios");
+    for (size_t uiIndex = 0; uiIndex < m_oScenarios.size(); uiIndex++)
+    {
+      CcJsonObject oScenarioResult;
+      if (runScenario(m_oScenarios[uiIndex], uiIndex, oScenarioResult) == false)
+      {
+        bSuccess = false;
+      }
+      oScenarios.array().add(CcJsonNode(oScenarioResult, ""));
+    }
+    oResult.append(std::move(oScenarios));
+    if (m_uiAcceptTime > 0)
+    {
+      CcJsonObject oAcceptResult;
+      if (runAccept(oAcceptResult) == false)
+      {
+        bSuccess = false;
+      }
+      oResult.add(CcJsonNode(oAcceptResult, "Accept"));
+    }
+    oResult.add(CcJsonNode("Success", bSuccess));
+    if (CBenchResult::write(m_sOutput, oResult) == false)
+    {
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+bool CSyncBench::runScenario(const CSyncBenchScenario& oScenario, size_t uiIndex, CcJsonObject& oResult)
+{
+  bool bSuccess = false;
+  CcConsole::writeLine("Scenario: " + oScenario.sName);
+  oResult.add(CcJsonNode("Name", oScenario.sName));
+  oResult.add(CcJsonNode("Depth", static_cast<uint64>(oScenario.uiDepth)));
+  oResult.add(CcJsonNode("DirsPerDir", static_cast<uint64>(oScenario.uiDirs)));
+  oResult.add(CcJsonNode("FilesPerDir", static_cast<uint64>(oScenario.uiFiles)));
+  oResult.add(CcJsonNode("FileSize", oScenario.uiFileSize));
+  CcJsonNode oPhases(EJsonDataType::Array);
+  oPhases.setName("Phases");
+
+  CcString sScenarioDir = m_sWorkingDir;
+  sScenarioDir.appendPath(oScenario.sName);
+  CcString sServerDir = sScenarioDir;
+  sServerDir.appendPath("Server");
+  CcString sClient1Dir = sScenarioDir;
+  sClient1Dir.appendPath("Client1");
+  CcString sClient2Dir = sScenarioDir;
+  sClient2Dir.appendPath("Client2");
+  CcString sPort = CcString::fromNumber(m_uiPort + uiIndex);
+  if (CcDirectory::exists(sScenarioDir))
+  {
+    // Start from empty directories, remains of an earlier run would be synced too
+    CcDirectory::remove(sScenarioDir, true);
+  }
+  if (CcDirectory::create(sServerDir, true) &&
+      CcDirectory::create(sClient1Dir, true) &&
+      CcDirectory::create(sClient2Dir, true))
+  {
+    CTestServer oServer(m_sServerAppPath, sServerDir);
+    CTestClient oClient1(m_sClientAppPath, sClient1Dir);
+    CTestClient oClient2(m_sClientAppPath, sClient2Dir);
+    if (oServer.createConfiguration(sPort, c_sAdminName, c_sAdminPW, sServerDir) &&
+        oServer.start())
+    {
+      CSyncBenchTree oTree;
+      CSyncBenchTree oChanged;
+      CSyncBenchTree oRestored;
+      if (oClient1.addNewServer(c_sServerName, sPort, c_sAdminName, c_sAdminPW) &&
+          oClient1.login(c_sServerName, c_sAdminName) &&
+          oClient1.createSyncDirectory(CSyncBench_DirectoryName) &&
+          createTree(oClient1.getSyncDir(), 0, oScenario, oTree))
+      {
+        oResult.add(CcJsonNode("Files", oTree.uiFiles));
+        oResult.add(CcJsonNode("Directories", oTree.uiDirs));
+        oResult.add(CcJsonNode("Bytes", oTree.uiBytes));
+        bSuccess = measureSync(oClient1, "Seed", oTree.uiFiles, oTree.uiBytes, oPhases);
+        // Nothing changed, all files are only compared
+        bSuccess &= measureSync(oClient1, "NoOp", oTree.uiFiles, 0, oPhases);
+        if (changeTree(oClient1.getSyncDir(), oScenario, oTree, oChanged))
+        {
+          bSuccess &= measureSync(oClient1, "Incremental", oChanged.uiFiles, oChanged.uiBytes, oPhases);
+        }
+        else
+        {
+          bSuccess = false;
+        }
+        if (oClient2.addNewServer(c_sServerName, sPort, c_sAdminName, c_sAdminPW) &&
+            oClient2.login(c_sServerName, c_sAdminName) &&
+            oClient2.createSyncDirectory(CSyncBench_DirectoryName))
+        {
+          bSuccess &= measureSync(oClient2, "Restore", oTree.uiFiles, oTree.uiBytes, oPhases);
+          scanTree(oClient2.getSyncDir(), "", oRestored);
+          oClient2.logout();
+        }
+        else
+        {
+          bSuccess = false;
+        }
+        // Compare content too, equal sizes are not proving a correct restore
+        CSyncBenchTree oSource;
+        scanTree(oClient1.getSyncDir(), "", oSource);
+        bool bVerified = oRestored.uiFiles == oTree.uiFiles &&
+                         oRestored.uiBytes == oTree.uiBytes &&
+                         compareTree(oSource, oRestored);
+        if (bVerified == false)
+        {
+          CcConsole::writeLine("  Restored tree differs: " + CcString::fromNumber(oRestored.uiFiles) + " files, " +
+                               CcString::fromNumber(oRestored.uiBytes) + " bytes");
+          bSuccess = false;
+        }
+        oResult.add(CcJsonNode("RestoreVerified", bVerified));
+        oClient1.serverShutdown();
+        oClient1.logout();
+      }
+      else
+      {
+        CcConsole::writeLine("  Failed to setup client or to generate tree");
+      }
+      oServer.stop();
+    }
+    else
+    {
+      CcConsole::writeLine("  Failed to setup server");
+    }
+  }
+  else
+  {
+    CcConsole::writeLine("  Failed to create directories in " + sScenarioDir);
+  }
+  oResult.append(std::move(oPhases));
+  oResult.add(CcJsonNode("Success", bSuccess));
+  if (m_bKeep == false)
+  {
+    CcDirectory::remove(sScenarioDir, true);
+  }
+  return bSuccess;
+}
+
+bool CSyncBench::runAccept(CcJsonObject& oResult)
+{
+  uint64 uiConnections = 0;
+  uint64 uiTime = 0;
+  CcConsole::writeLine("Accept: " + CcString::fromNumber(m_uiAcceptClients) + " clients");
+  oResult.add(CcJsonNode("Clients", static_cast<uint64>(m_uiAcceptClients)));
+  CcString sServerDir = m_sWorkingDir;
+  sServerDir.appendPath("Accept");
+  // Next port after all scenarios
+  CcString sPort = CcString::fromNumber(m_uiPort + m_oScenarios.size());
+  if (CcDirectory::exists(sServerDir))
+  {
+    CcDirectory::remove(sServerDir, true);
+  }
+  if (CcDirectory::create(sServerDir, true))
+  {
+    CTestServer oServer(m_sServerAppPath, sServerDir);
+    if (oServer.createConfiguration(sPort, c_sAdminName, c_sAdminPW, sServerDir) &&
+        oServer.start())
+    {
+      CcDateTime oStart = CcKernel::getUpTime();
+      CcDateTime oEnd = oStart;
+      oEnd.addSeconds(static_cast<int32>(m_uiAcceptTime));
+      CcList<CSyncBenchConnector*> oConnectors;
+      for (uint32 uiIndex = 0; uiIndex < m_uiAcceptClients; uiIndex++)
+      {
+        CCNEWTYPE(pConnector, CSyncBenchConnector, sPort, oEnd);
+        oConnectors.append(pConnector);
+        pConnector->start();
+      }
+      for (CSyncBenchConnector* pConnector : oConnectors)
+      {
+        while (pConnector->isInProgress())
+        {
+          CcKernel::sleep(10);
+        }
+        uiConnections += pConnector->getConnections();
+        CCDELETE(pConnector);
+      }
+      uiTime = static_cast<uint64>((CcKernel::getUpTime() - oStart).getTimestampMs());
+      oServer.stop();
+    }
+    else
+    {
+      CcConsole::writeLine("  Failed to setup server");
+    }
+  }
+  else
+  {
+    CcConsole::writeLine("  Failed to create directory " + sServerDir);
+  }
+  uint64 uiPerSecond = 0;
+  if (uiTime > 0)
+  {
+    uiPerSecond = uiConnections * 1000 / uiTime;
+  }
+  CcConsole::writeLine("  Accepted connections per second: " + CcString::fromNumber(uiPerSecond));
+  oResult.add(CcJsonNode("Connections", uiConnections));
+  oResult.add(CcJsonNode("TimeMs", uiTime));
+  oResult.add(CcJsonNode("ConnectionsPerSecond", uiPerSecond));
+  if (m_bKeep == false)
+  {
+    CcDirectory::remove(sServerDir, true);
+  }
+  return uiConnections > 0;
+}
+
+bool CSyncBench::measureSync(CTestClient& oClient, const CcString& sPhase, uint64 uiFiles, uint64 uiBytes, CcJsonNode& oPhases)
+{
+  CcDateTime oStart = CcKernel::getUpTime();
+  bool bSuccess = oClient.sync(m_oTimeout);
+  uint64 uiTime = static_cast<uint64>((CcKernel::getUpTime() - oStart).getTimestampMs());
+  uint64 uiFilesPerSecond = 0;
+  uint64 uiBytesPerSecond = 0;
+  if (uiTime > 0)
+  {
+    uiFilesPerSecond = uiFiles * 1000 / uiTime;
+    uiBytesPerSecond = uiBytes * 1000 / uiTime;
+  }
+  CcJsonObject oPhase;
+  oPhase.add(CcJsonNode("Name", sPhase));
+  oPhase.add(CcJsonNode("Success", bSuccess));
+  oPhase.add(CcJsonNode("TimeMs", uiTime));
+  oPhase.add(CcJsonNode("Files", uiFiles));
+  oPhase.add(CcJsonNode("Bytes", uiBytes));
+  oPhase.add(CcJsonNode("FilesPerSecond", uiFilesPerSecond));
+  oPhase.add(CcJsonNode("BytesPerSecond", uiBytesPerSecond));
+  oPhases.array().add(CcJsonNode(oPhase, ""));
+  CcConsole::writeLine("  " + sPhase + ": " + CcString::fromNumber(uiTime) + "ms, " +
+                       CcString::fromNumber(uiFilesPerSecond) + " files/s, " +
+                       CcString::fromNumber(uiBytesPerSecond / 1024) + " KiB/s" +
+                       (bSuccess ? "" : " (failed)"));
+  return bSuccess;
+}
+
+bool CSyncBench::createTree(const CcString& sPath, size_t uiLevel, const CSyncBenchScenario& oScenario, CSyncBenchTree& oTree)
+{
+  bool bSuccess = true;
+  for (size_t uiFile = 0; uiFile < oScenario.uiFiles && bSuccess; uiFile++)
+  {
+    CcString sFile = sPath;
+    sFile.appendPath("File_" + CcString::fromNumber(uiFile) + ".bin");
+    bSuccess = writeFile(sFile, oScenario.uiFileSize, oTree.uiFiles);
+    oTree.slFiles.append(sFile);
+    oTree.uiFiles++;
+    oTree.uiBytes += oScenario.uiFileSize;
+  }
+  if (uiLevel < oScenario.uiDepth)
+  {
+    for (size_t uiDir = 0; uiDir < oScenario.uiDirs && bSuccess; uiDir++)
+    {
+      CcString sDir = sPath;
+      sDir.appendPath("Dir_" + CcString::fromNumber(uiDir));
+      bSuccess = CcDirectory::create(sDir, true) &&
+                 createTree(sDir, uiLevel + 1, oScenario, oTree);
+      oTree.uiDirs++;
+    }
+  }
+  return bSuccess;
+}
+
+bool CSyncBench::changeTree(const CcString& sPath, const CSyncBenchScenario& oScenario, CSyncBenchTree& oTree, CSyncBenchTree& oChanged)
+{
+  bool bSuccess = true;
+  size_t uiExisting = oTree.slFiles.size();
+  for (size_t uiFile = 0; uiFile < uiExisting && bSuccess; uiFile += CSyncBench_ChangeInterval)
+  {
+    // Other seed, so content and CRC are changing with same size
+    bSuccess = writeFile(oTree.slFiles[uiFile], oScenario.uiFileSize, uiExisting + uiFile);
+    oChanged.uiFiles++;
+    oChanged.uiBytes += oScenario.uiFileSize;
+  }
+  size_t uiAdd = uiExisting / CSyncBench_ChangeInterval;
+  if (uiAdd == 0)
+    uiAdd = 1;
+  for (size_t uiFile = 0; uiFile < uiAdd && bSuccess; uiFile++)
+  {
+    CcString sFile = sPath;
+    sFile.appendPath("Added_" + CcString::fromNumber(uiFile) + ".bin");
+    bSuccess = writeFile(sFile, oScenario.uiFileSize, 2 * uiExisting + uiFile);
+    oTree.slFiles.append(sFile);
+    oTree.uiFiles++;
+    oTree.uiBytes += oScenario.uiFileSize;
+    oChanged.uiFiles++;
+    oChanged.uiBytes += oScenario.uiFileSize;
+  }
+  return bSuccess;
+}
+
+void CSyncBench::scanTree(const CcString& sPath, const CcString& sRelative, CSyncBenchTree& oTree)
+{
+  CcFileInfoList oFileList = CcDirectory::getFileList(sPath);
+  for (CcFileInfo& oFileInfo : oFileList)
+  {
+    // Skip lock and temporary files of client
+    if (oFileInfo.getName().length() == 0 ||
+        oFileInfo.getName().startsWith(".~CcSync"))
+    {
+      continue;
+    }
+    CcString sSubPath = sPath;
+    sSubPath.appendPath(oFileInfo.getName());
+    CcString sSubRelative = sRelative;
+    sSubRelative.appendPath(oFileInfo.getName());
+    if (oFileInfo.isDir())
+    {
+      oTree.uiDirs++;
+      scanTree(sSubPath, sSubRelative, oTree);
+    }
+    else
+    {
+      oTree.uiFiles++;
+      oTree.uiBytes += oFileInfo.getFileSize();
+      oTree.oCrcs.append(sSubRelative, getFileCrc(sSubPath));
+    }
+  }
+}
+
+bool CSyncBench::compareTree(CSyncBenchTree& oExpected, CSyncBenchTree& oRestored)
+{
+  bool bSuccess = oExpected.oCrcs.size() == oRestored.oCrcs.size();
+  if (bSuccess == false)
+  {
+    CcConsole::writeLine("  Restored files: " + CcString::fromNumber(oRestored.oCrcs.size()) +
+                         ", expected: " + CcString::fromNumber(oExpected.oCrcs.size()));
+  }
+  for (size_t uiPos = 0; uiPos < oExpected.oCrcs.size(); uiPos++)
+  {
+    CcPair<CcString, uint32>& rFile = oExpected.oCrcs.at(uiPos);
+    // Both trees are scanned in same order mostly, search only if not
+    if (uiPos < oRestored.oCrcs.size() &&
+        oRestored.oCrcs.at(uiPos).getKey() == rFile.getKey())
+    {
+      if (oRestored.oCrcs.at(uiPos).getValue() != rFile.getValue())
+      {
+        CcConsole::writeLine("  Restored file differs: " + rFile.getKey());
+        bSuccess = false;
+      }
+    }
+    else if (oRestored.oCrcs.containsKey(rFile.getKey()) == false)
+    {
+      CcConsole::writeLine("  Missing restored file: " + rFile.getKey());
+      bSuccess = false;
+    }
+    else if (oRestored.oCrcs.getValue(rFile.getKey()) != rFile.getValue())
+    {
+      CcConsole::writeLine("  Restored file differs: " + rFile.getKey());
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+uint32 CSyncBench::getFileCrc(const CcString& sPath)
+{
+  CcCrc32 oCrc;
+  CcFile oFile(sPath);
+  if (oFile.open(EOpenFlags::Read | EOpenFlags::ShareRead))
+  {
+    CcByteArray oBuffer(CSyncBench_ChunkSize);
+    size_t uiRead = oFile.readArray(oBuffer, false);
+    while (uiRead > 0 && uiRead <= oBuffer.size())
+    {
+      oCrc.append(oBuffer.getArray(), uiRead);
+      uiRead = oFile.readArray(oBuffer, false);
+    }
+    oFile.close();
+  }
+  return oCrc.getValueUint32();
+}
+
+bool CSyncBench::writeFile(const CcString& sPath, uint64 uiSize, uint64 uiSeed)
+{
+  bool bSuccess = false;
+  CcFile oFile(sPath);
+  if (oFile.open(EOpenFlags::Write))
+  {
+    bSuccess = true;
+    size_t uiChunkSize = CSyncBench_ChunkSize;
+    if (uiSize < uiChunkSize)
+      uiChunkSize = static_cast<size_t>(uiSize);
+    CcString sChunk;
+    for (size_t uiPos = 0; uiPos < uiChunkSize; uiPos++)
+    {
+      sChunk.append(static_cast<char>('a' + (uiPos + uiSeed) % 26));
+    }
+    uint64 uiWritten = 0;
+    while (uiWritten < uiSize && bSuccess)
+    {
+      size_t uiToWrite = uiChunkSize;
+      if (uiSize - uiWritten < uiToWrite)
+        uiToWrite = static_cast<size_t>(uiSize - uiWritten);
+      bSuccess = oFile.write(sChunk.getCharString(), uiToWrite) == uiToWrite;
+      uiWritten += uiToWrite;
+    }
+    oFile.close();
+  }
+  if (bSuccess == false)
+  {
+    CcConsole::writeLine("  Failed to write file: " + sPath);
+  }
+  return bSuccess;
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncBench
+ * @subpage   CSyncBench
+ *
+ * @page      CSyncBench
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CSyncBench
+ *
+ *  End to end benchmark of CcSyncServer and CcSyncClient.
+ *  For each scenario a local server and two clients are set up like in
+ *  CSyncTest. The first client uploads a generated tree, syncs it again
+ *  without changes and after changing some files, the second client
+ *  restores the tree to an empty directory. Restored files are compared by
+ *  path and CRC with tree of first client. Time of each phase is written
+ *  with file and byte rates to a JSON result file.
+ *  Afterwards TLS clients are connecting to a server in parallel for a
+ *  fixed time to measure accepted connections per second.
+ **/
+#ifndef _CSyncBench_H_
+#define _CSyncBench_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "CcStringList.h"
+#include "CcList.h"
+#include "CcMap.h"
+#include "CcDateTime.h"
+#include "Json/CcJsonObject.h"
+
+class CTestClient;
+
+/**
+ * @brief Shape of generated tree
+ */
+class CSyncBenchScenario
+{
+public:
+  CcString  sName;
+  size_t    uiDepth     = 0; //!< Levels of subdirectories below root
+  size_t    uiDirs      = 0; //!< Subdirectories in each directory
+  size_t    uiFiles     = 0; //!< Files in each directory
+  uint64    uiFileSize  = 0; //!< Bytes of each file
+};
+
+/**
+ * @brief Files and bytes of a generated or restored tree
+ */
+class CSyncBenchTree
+{
+public:
+  uint64        uiFiles = 0;
+  uint64        uiDirs  = 0;
+  uint64        uiBytes = 0;
+  CcStringList  slFiles;
+  //! CRC of each file by relative path, filled by scanTree
+  CcMap<CcString, uint32> oCrcs;
+};
+
+/**
+ * @brief Class impelmentation
+ */
+class CSyncBench
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CSyncBench( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CSyncBench( void );
+
+  /**
+   * @brief Read options from command line
+   * @return false if an option is unknown or incomplete
+   */
+  bool parseArguments(int argc, char **argv);
+  void printHelp();
+
+  /**
+   * @brief Run all selected scenarios and write result file.
+   * @return true if all phases succeeded and restored trees are complete
+   */
+  bool run();
+
+private:
+  bool runScenario(const CSyncBenchScenario& oScenario, size_t uiIndex, CcJsonObject& oResult);
+  bool runAccept(CcJsonObject& oResult);
+  bool measureSync(CTestClient& oClient, const CcString& sPhase, uint64 uiFiles, uint64 uiBytes, CcJsonNode& oPhases);
+  bool createTree(const CcString& sPath, size_t uiLevel, const CSyncBenchScenario& oScenario, CSyncBenchTree& oTree);
+  bool changeTree(const CcString& sPath, const CSyncBenchScenario& oScenario, CSyncBenchTree& oTree, CSyncBenchTree& oChanged);
+  static void scanTree(const CcString& sPath, const CcString& sRelative, CSyncBenchTree& oTree);
+  static bool compareTree(CSyncBenchTree& oExpected, CSyncBenchTree& oRestored);
+  static uint32 getFileCrc(const CcString& sPath);
+  static bool writeFile(const CcString& sPath, uint64 uiSize, uint64 uiSeed);
+
+private:
+  CcString  m_sBinaryDir;
+  CcString  m_sWorkingDir;
+  CcString  m_sOutput;
+  CcString  m_sServerAppPath;
+  CcString  m_sClientAppPath;
+  uint16    m_uiPort;
+  CcDateTime m_oTimeout;
+  uint32    m_uiAcceptTime;
+  uint32    m_uiAcceptClients;
+  bool      m_bKeep = false;
+  CcList<CSyncBenchScenario> m_oScenarios;
+};
+
+#endif /* _CSyncBench_H_ */
@@ -38,6 +38,8 @@
 #include "CcDirectory.h"
 #include "CcGroupList.h"
 #include "CcUserList.h"
+#include "CcSyncTrace.h"
+#include "CcSyncDbProfiler.h"
 
 namespace Strings
 {
@@ -55,6 +57,10 @@ namespace Strings
   static const CcString NewDesc     ("create new account.");
   static const CcString Del         ("del");
   static const CcString DelDesc     ("[Username[@Server]] select an account counfig and delete it");
+  static const CcString Trace       ("trace");
+  static const CcString TraceDesc   ("on|off Write timing of requests, database and file operations to ClientTrace.json");
+  static const CcString Profile     ("profile");
+  static const CcString ProfileDesc ("on|off|report Measure database queries, report shows slowest statements");
 }
 
 CcSyncClientApp::CcSyncClientApp(const CcArguments& oArguments) :
@@ -325,6 +331,45 @@ void CcSyncClientApp::runCli()
             CcSyncConsole::writeLine("Login failed");
           }
         }
+        else if (oArguments[0].compareInsensitve(Strings::Trace))
+        {
+          if (oArguments.size() > 1 &&
+              (oArguments[1].compareInsensitve("on") || oArguments[1].compareInsensitve("off")))
+          {
+            if (m_poSyncClient->setTrace(oArguments[1].compareInsensitve("on")))
+            {
+              CcSyncConsole::writeLine(CcString("Tracing ") + (CcSyncTrace::isEnabled() ? "started" : "stopped"));
+            }
+            else
+            {
+              CcSyncConsole::writeLine("Failed to open trace file");
+            }
+          }
+          else
+          {
+            CcSyncConsole::writeLine(CcString("Tracing is ") + (CcSyncTrace::isEnabled() ? "on" : "off"));
+          }
+        }
+        else if (oArguments[0].compareInsensitve(Strings::Profile))
+        {
+          if (oArguments.size() > 1 &&
+              oArguments[1].compareInsensitve("report"))
+          {
+            CcJsonObject oProfile;
+            CcSyncDbProfiler::getJson(oProfile);
+            CcSyncDbProfiler::printReport(oProfile);
+          }
+          else if (oArguments.size() > 1 &&
+                   (oArguments[1].compareInsensitve("on") || oArguments[1].compareInsensitve("off")))
+          {
+            CcSyncDbProfiler::setEnabled(oArguments[1].compareInsensitve("on"));
+            CcSyncConsole::writeLine(CcString("Profiler ") + (CcSyncDbProfiler::isEnabled() ? "started" : "stopped"));
+          }
+          else
+          {
+            CcSyncConsole::writeLine(CcString("Profiler is ") + (CcSyncDbProfiler::isEnabled() ? "on" : "off"));
+          }
+        }
         else if (oArguments[0].compareInsensitve(Strings::Exit))
         {
           CcSyncConsole::writeLine("Bye :)");
@@ -335,6 +380,8 @@ void CcSyncClientApp::runCli()
           CcSyncConsole::writeLine("Client commands:");
           CcSyncConsole::printHelpLine("  " + Strings::Help, 30, Strings::HelpDesc);
           CcSyncConsole::printHelpLine("  " + Strings::Exit, 30, Strings::ExitDesc);
+          CcSyncConsole::printHelpLine("  " + Strings::Trace, 30, Strings::TraceDesc);
+          CcSyncConsole::printHelpLine("  " + Strings::Profile, 30, Strings::ProfileDesc);
 
           CcSyncConsole::writeLine(CcGlobalStrings::Empty);
           CcSyncConsole::writeLine("Manage Accounts:");
@@ -360,6 +407,7 @@ void CcSyncClientApp::runCli()
     CCDEBUG("Error in Directory Locations, stop progress");
     setExitCode(EStatus::FSFileNotFound);
   }
+  CcSyncTrace::stop();
   CcSyncClient::remove(m_poSyncClient);
   m_poSyncClient = nullptr;
 }
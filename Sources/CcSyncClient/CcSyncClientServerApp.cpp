@@ -31,6 +31,9 @@
 #include "CcKernel.h"
 #include "CcAppKnown.h"
 #include "CcSyncConsole.h"
+#include "CcSyncGlobals.h"
+#include "Json/CcJsonArray.h"
+#include "CcSyncDbProfiler.h"
 
 namespace ServerStrings
 {
@@ -46,6 +49,12 @@ namespace ServerStrings
   static const CcString DelDesc("[Username] delete an account from server");
   static const CcString Stop("stop");
   static const CcString StopDesc("Stop current server");
+  static const CcString Stats("stats");
+  static const CcString StatsDesc("Show request latencies, throughput and connections of server");
+  static const CcString Trace("trace");
+  static const CcString TraceDesc("on|off Write timing of requests on server to ServerTrace.json");
+  static const CcString Profile("profile");
+  static const CcString ProfileDesc("on|off Measure database queries on server, statements are shown by stats");
 }
 
 CcSyncClientServerApp::CcSyncClientServerApp(CcSyncClient* pSyncClient) :
@@ -65,6 +74,9 @@ void CcSyncClientServerApp::help()
   CcSyncConsole::printHelpLine(ServerStrings::New, iSize, ServerStrings::NewDesc);
   CcSyncConsole::printHelpLine(ServerStrings::Del, iSize, ServerStrings::DelDesc);
   CcSyncConsole::printHelpLine(ServerStrings::Stop, iSize, ServerStrings::StopDesc);
+  CcSyncConsole::printHelpLine(ServerStrings::Stats, iSize, ServerStrings::StatsDesc);
+  CcSyncConsole::printHelpLine(ServerStrings::Trace, iSize, ServerStrings::TraceDesc);
+  CcSyncConsole::printHelpLine(ServerStrings::Profile, iSize, ServerStrings::ProfileDesc);
 }
 
 bool CcSyncClientServerApp::createAccount()
@@ -93,6 +105,100 @@ bool CcSyncClientServerApp::createAccount()
   return bSuccess;
 }
 
+static uint64 getStatsValue(CcJsonObject& oObject, const CcString& sName)
+{
+  uint64 uiValue = 0;
+  if (oObject.contains(sName, EJsonDataType::Value))
+    uiValue = oObject[sName].getValue().getUint64();
+  return uiValue;
+}
+
+bool CcSyncClientServerApp::printStats()
+{
+  bool bSuccess = false;
+  CcJsonObject oStats;
+  if (m_poSyncClient != nullptr &&
+      m_poSyncClient->serverGetStats(oStats))
+  {
+    bSuccess = true;
+    CcSyncConsole::writeLine("Uptime:      " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::Uptime)) + "s");
+    CcSyncConsole::writeLine("Connections: " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::ConnectionsActive)) + " active, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::ConnectionsIdle)) + " idle, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::ConnectionsWaiting)) + " waiting, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::RequestsScheduled)) + " scheduled");
+    CcSyncConsole::writeLine("Transfers:   " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::TransfersRunning)) + " running, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::TransfersRejected)) + " rejected");
+    CcSyncConsole::writeLine("Handshakes:  " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::Handshakes)) + ", " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::HandshakesResumed)) + " resumed");
+    CcSyncConsole::writeLine("Accounts:    " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::AccountsLoaded)) + " loaded, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::AccountCacheHits)) + " hits, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::AccountCacheMisses)) + " misses, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::AccountCacheEvictions)) + " evictions");
+    CcSyncConsole::writeLine("Requests:    " + CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::Requests)) + ", " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::BytesSent)) + " bytes sent, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::BytesReceived)) + " bytes received, " +
+                             CcString::fromNumber(getStatsValue(oStats, CcSyncGlobals::Commands::ServerGetStats::DatabaseTime) / 1000) + "ms database");
+    // Header of histogram is built from bounds of server
+    CcString sBuckets;
+    uint64 uiBound = 0;
+    if (oStats.contains(CcSyncGlobals::Commands::ServerGetStats::HistogramBounds, EJsonDataType::Array))
+    {
+      for (CcJsonNode& oBound : oStats[CcSyncGlobals::Commands::ServerGetStats::HistogramBounds].array())
+      {
+        uiBound = oBound.getValue().getUint64();
+        sBuckets << " <" << CcString::fromNumber(uiBound / 1000) << "ms";
+      }
+    }
+    sBuckets << " >=" << CcString::fromNumber(uiBound / 1000) << "ms";
+    if (oStats.contains(CcSyncGlobals::Commands::ServerGetStats::CommandList, EJsonDataType::Array))
+    {
+      CcSyncConsole::writeLine("");
+      CcSyncConsole::writeLine("Command: requests, avg ms, max ms |" + sBuckets);
+      for (CcJsonNode& oNode : oStats[CcSyncGlobals::Commands::ServerGetStats::CommandList].array())
+      {
+        CcJsonObject& oCommand = oNode.object();
+        uint64 uiRequests = getStatsValue(oCommand, CcSyncGlobals::Commands::ServerGetStats::Requests);
+        uint64 uiAverage = 0;
+        if (uiRequests > 0)
+          uiAverage = getStatsValue(oCommand, CcSyncGlobals::Commands::ServerGetStats::Time) / uiRequests / 1000;
+        CcString sLine = "  " + oCommand[CcSyncGlobals::Commands::ServerGetStats::Name].getValue().getString() + ": " +
+                         CcString::fromNumber(uiRequests) + ", " + CcString::fromNumber(uiAverage) + ", " +
+                         CcString::fromNumber(getStatsValue(oCommand, CcSyncGlobals::Commands::ServerGetStats::MaxTime) / 1000) + " |";
+        if (oCommand.contains(CcSyncGlobals::Commands::ServerGetStats::Histogram, EJsonDataType::Array))
+        {
+          for (CcJsonNode& oBucket : oCommand[CcSyncGlobals::Commands::ServerGetStats::Histogram].array())
+          {
+            sLine << " " << CcString::fromNumber(oBucket.getValue().getUint64());
+          }
+        }
+        CcSyncConsole::writeLine(sLine);
+      }
+    }
+    if (oStats.contains(CcSyncGlobals::Commands::ServerGetStats::AccountList, EJsonDataType::Array))
+    {
+      CcSyncConsole::writeLine("");
+      CcSyncConsole::writeLine("Account: requests, bytes sent, bytes received, database ms");
+      for (CcJsonNode& oNode : oStats[CcSyncGlobals::Commands::ServerGetStats::AccountList].array())
+      {
+        CcJsonObject& oAccount = oNode.object();
+        CcString sName = oAccount[CcSyncGlobals::Commands::ServerGetStats::Name].getValue().getString();
+        if (sName.length() == 0)
+          sName = "<no login>";
+        CcSyncConsole::writeLine("  " + sName + ": " +
+                                 CcString::fromNumber(getStatsValue(oAccount, CcSyncGlobals::Commands::ServerGetStats::Requests)) + ", " +
+                                 CcString::fromNumber(getStatsValue(oAccount, CcSyncGlobals::Commands::ServerGetStats::BytesSent)) + ", " +
+                                 CcString::fromNumber(getStatsValue(oAccount, CcSyncGlobals::Commands::ServerGetStats::BytesReceived)) + ", " +
+                                 CcString::fromNumber(getStatsValue(oAccount, CcSyncGlobals::Commands::ServerGetStats::DatabaseTime) / 1000));
+      }
+    }
+    if (oStats.contains(CcSyncGlobals::Commands::ServerGetStats::QueryList, EJsonDataType::Array))
+    {
+      CcSyncDbProfiler::printReport(oStats);
+    }
+  }
+  return bSuccess;
+}
+
 void CcSyncClientServerApp::run()
 {
   CcString sSavePrepende = CcSyncConsole::getPrepend();
@@ -157,6 +263,51 @@ void CcSyncClientServerApp::run()
           bCommandlineLoop = false;
         }
       }
+      else if (oArguments[0].compareInsensitve(ServerStrings::Stats))
+      {
+        if (printStats() == false)
+        {
+          CcSyncConsole::writeLine("Failed to get statistics of server");
+        }
+      }
+      else if (oArguments[0].compareInsensitve(ServerStrings::Trace))
+      {
+        if (oArguments.size() > 1 &&
+            (oArguments[1].compareInsensitve("on") || oArguments[1].compareInsensitve("off")))
+        {
+          if (m_poSyncClient->serverSetTrace(oArguments[1].compareInsensitve("on")))
+          {
+            CcSyncConsole::writeLine("Tracing on server changed");
+          }
+          else
+          {
+            CcSyncConsole::writeLine("Failed to change tracing on server");
+          }
+        }
+        else
+        {
+          CcSyncConsole::writeLine("on or off required, please type \"help\"");
+        }
+      }
+      else if (oArguments[0].compareInsensitve(ServerStrings::Profile))
+      {
+        if (oArguments.size() > 1 &&
+            (oArguments[1].compareInsensitve("on") || oArguments[1].compareInsensitve("off")))
+        {
+          if (m_poSyncClient->serverSetProfiler(oArguments[1].compareInsensitve("on")))
+          {
+            CcSyncConsole::writeLine("Profiler on server changed");
+          }
+          else
+          {
+            CcSyncConsole::writeLine("Failed to change profiler on server");
+          }
+        }
+        else
+        {
+          CcSyncConsole::writeLine("on or off required, please type \"help\"");
+        }
+      }
       else if (oArguments[0].compareInsensitve(ServerStrings::Help))
       {
         help();
@@ -45,6 +45,7 @@ public:
 
   void help();
   bool createAccount();
+  bool printStats();
 
   virtual void run() override;
 
@@ -27,13 +27,18 @@
 
 #include "CcBase.h"
 #include "CcKernel.h"
+#include "CcSyncLog.h"
 #include "CcSyncClientApp.h"
 
 int main(int argc, char **argv)
 {
+  CcSyncLog::start();
   CcArguments oArguments;
   oArguments.parse(argc, argv);
   
   CcSyncClientApp oSyncClient(oArguments);
-  return oSyncClient.exec().getErrorInt();
+  int iReturn = oSyncClient.exec().getErrorInt();
+  // Write messages wich are still queued
+  CcSyncLog::stop();
+  return iReturn;
 }
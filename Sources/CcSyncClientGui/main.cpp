@@ -27,17 +27,22 @@
 
 #include "CcBase.h"
 #include "CcKernel.h"
+#include "CcSyncLog.h"
 #include "CcArguments.h"
 #include "CcSyncClientGui.h"
 #include "CcMemoryMonitor.h"
 
 int main(int argc, char **argv)
 {
+  CcSyncLog::start();
   CcArguments oArguments;
   oArguments.parse(argc, argv);
   CcKernel::initCLI();
   CcKernel::initGUI();
 
   CcSyncClientGui oApplication(oArguments);
-  return oApplication.exec().getErrorInt();
+  int iReturn = oApplication.exec().getErrorInt();
+  // Write messages wich are still queued
+  CcSyncLog::stop();
+  return iReturn;
 }
@@ -0,0 +1,306 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CSyncLoad
+ */
+#include "CSyncLoad.h"
+#include "CcKernel.h"
+#include "CcConsole.h"
+#include "CcFile.h"
+#include "CcArguments.h"
+#include "CcStringList.h"
+#include "CcSyncGlobals.h"
+#include "Json/CcJsonDocument.h"
+
+#define CSyncLoad_DefaultSessions   8
+#define CSyncLoad_DefaultDuration   30
+#define CSyncLoad_DefaultSeedFiles  20
+#define CSyncLoad_DefaultMinSize    1024
+#define CSyncLoad_DefaultMaxSize    (1024 * 1024)
+//! Default weights of list, info, upload, download, mkdir and rmdir
+#define CSyncLoad_DefaultMix        "list=40,info=20,upload=15,download=15,mkdir=5,rmdir=5"
+
+CSyncLoad::CSyncLoad( void ) :
+  m_uiSessions(CSyncLoad_DefaultSessions),
+  m_uiSeedFiles(CSyncLoad_DefaultSeedFiles),
+  m_oDuration(CcDateTimeFromSeconds(CSyncLoad_DefaultDuration)),
+  m_sOutput("CcSyncLoad.json")
+{
+  m_oConfig.oServer.setHostname("127.0.0.1");
+  m_oConfig.oServer.setPort(CcSyncGlobals::DefaultPort);
+  m_oConfig.sDirectory = "LoadTest";
+  m_oConfig.uiMinSize = CSyncLoad_DefaultMinSize;
+  m_oConfig.uiMaxSize = CSyncLoad_DefaultMaxSize;
+  m_oConfig.uiSeed = 1;
+  parseMix(CSyncLoad_DefaultMix);
+}
+
+CSyncLoad::~CSyncLoad( void )
+{
+  for (CSyncLoadSession* pSession : m_oSessions)
+  {
+    CCDELETE(pSession);
+  }
+  m_oSessions.clear();
+}
+
+bool CSyncLoad::parseArguments(int argc, char **argv)
+{
+  bool bSuccess = true;
+  CcArguments oArguments;
+  oArguments.parse(argc, argv);
+  for (size_t uiArg = 1; uiArg < oArguments.size() && bSuccess; uiArg++)
+  {
+    const CcString& sArgument = oArguments[uiArg];
+    if (uiArg + 1 >= oArguments.size())
+    {
+      CcConsole::writeLine("Unknown or incomplete option: " + sArgument);
+      bSuccess = false;
+    }
+    else
+    {
+      const CcString& sValue = oArguments[++uiArg];
+      bool bOk = true;
+      if (sArgument == "--server")
+        m_oConfig.oServer.setHostname(sValue);
+      else if (sArgument == "--port")
+        m_oConfig.oServer.setPort(sValue.toUint16(&bOk));
+      else if (sArgument == "--user")
+        m_oConfig.sUsername = sValue;
+      else if (sArgument == "--password")
+        m_oConfig.sPassword = sValue;
+      else if (sArgument == "--directory")
+        m_oConfig.sDirectory = sValue;
+      else if (sArgument == "--sessions")
+        m_uiSessions = sValue.toUint32(&bOk);
+      else if (sArgument == "--duration")
+        m_oDuration = CcDateTimeFromSeconds(sValue.toUint32(&bOk));
+      else if (sArgument == "--requests")
+        m_oConfig.uiRequests = sValue.toUint64(&bOk);
+      else if (sArgument == "--min-size")
+        m_oConfig.uiMinSize = sValue.toUint64(&bOk);
+      else if (sArgument == "--max-size")
+        m_oConfig.uiMaxSize = sValue.toUint64(&bOk);
+      else if (sArgument == "--seed-files")
+        m_uiSeedFiles = sValue.toUint32(&bOk);
+      else if (sArgument == "--seed")
+        m_oConfig.uiSeed = sValue.toUint64(&bOk);
+      else if (sArgument == "--mix")
+        bOk = parseMix(sValue);
+      else if (sArgument == "--output")
+        m_sOutput = sValue;
+      else
+        bOk = false;
+      if (bOk == false)
+      {
+        CcConsole::writeLine("Unknown option or invalid value: " + sArgument + " " + sValue);
+        bSuccess = false;
+      }
+    }
+  }
+  if (bSuccess)
+  {
+    if (m_oConfig.sUsername.length() == 0)
+    {
+      CcConsole::writeLine("Username is required");
+      bSuccess = false;
+    }
+    else if (m_uiSessions == 0)
+    {
+      CcConsole::writeLine("At least one session is required");
+      bSuccess = false;
+    }
+    else if (m_oConfig.uiMaxSize < m_oConfig.uiMinSize)
+    {
+      CcConsole::writeLine("Maximum size must not be lower than minimum size");
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+void CSyncLoad::printHelp()
+{
+  CcConsole::writeLine("Usage: CcSyncLoad --user NAME --password PW [options]");
+  CcConsole::writeLine("  --server HOST     default 127.0.0.1");
+  CcConsole::writeLine("  --port N          default " + CcSyncGlobals::DefaultPortStr);
+  CcConsole::writeLine("  --directory NAME  synced directory of account, created if missing, default LoadTest");
+  CcConsole::writeLine("  --sessions N      concurrent sessions, default " + CcString::fromNumber(CSyncLoad_DefaultSessions));
+  CcConsole::writeLine("  --duration S      seconds to run, default " + CcString::fromNumber(CSyncLoad_DefaultDuration));
+  CcConsole::writeLine("  --requests N      stop each session after N requests instead of duration");
+  CcConsole::writeLine("  --mix LIST        weights of commands, default " CSyncLoad_DefaultMix);
+  CcConsole::writeLine("  --min-size BYTES  minimum size of uploaded files, default " + CcString::fromNumber(CSyncLoad_DefaultMinSize));
+  CcConsole::writeLine("  --max-size BYTES  maximum size of uploaded files, default " + CcString::fromNumber(CSyncLoad_DefaultMaxSize));
+  CcConsole::writeLine("  --seed-files N    files uploaded before run for download and info, default " + CcString::fromNumber(CSyncLoad_DefaultSeedFiles));
+  CcConsole::writeLine("  --seed N          seed of random command sequences, default 1");
+  CcConsole::writeLine("  --output FILE     result file, default CcSyncLoad.json");
+}
+
+bool CSyncLoad::run()
+{
+  bool bSuccess = setup();
+  if (bSuccess)
+  {
+    CcConsole::writeLine("Running " + CcString::fromNumber(m_oSessions.size()) + " sessions");
+    CcDateTime oStart = CcKernel::getUpTime();
+    for (CSyncLoadSession* pSession : m_oSessions)
+    {
+      pSession->start();
+    }
+    bool bRunning = true;
+    while (bRunning)
+    {
+      CcKernel::sleep(10);
+      bRunning = false;
+      for (CSyncLoadSession* pSession : m_oSessions)
+      {
+        bRunning |= pSession->isInProgress();
+      }
+      if (m_oConfig.uiRequests == 0 &&
+          CcKernel::getUpTime() - oStart >= m_oDuration)
+      {
+        bRunning = false;
+      }
+    }
+    for (CSyncLoadSession* pSession : m_oSessions)
+    {
+      pSession->stop();
+    }
+    // Wait for running requests, they are part of stats
+    for (CSyncLoadSession* pSession : m_oSessions)
+    {
+      while (pSession->isInProgress())
+      {
+        CcKernel::sleep(10);
+      }
+    }
+    CcDateTime oDuration = CcKernel::getUpTime() - oStart;
+
+    CSyncLoadStats oStats;
+    size_t uiFailed = 0;
+    for (CSyncLoadSession* pSession : m_oSessions)
+    {
+      oStats.merge(pSession->getStats());
+      if (pSession->hasFailed())
+        uiFailed++;
+    }
+    oStats.print(oDuration);
+    if (uiFailed > 0)
+    {
+      CcConsole::writeLine(CcString::fromNumber(uiFailed) + " sessions lost connection");
+      bSuccess = false;
+    }
+
+    CcJsonObject oResult;
+    oResult.add(CcJsonNode("Server", m_oConfig.oServer.getHostname() + ":" + m_oConfig.oServer.getPortString()));
+    oResult.add(CcJsonNode("Sessions", static_cast<uint64>(m_oSessions.size())));
+    oResult.add(CcJsonNode("FailedSessions", static_cast<uint64>(uiFailed)));
+    oResult.add(CcJsonNode("MinSize", m_oConfig.uiMinSize));
+    oResult.add(CcJsonNode("MaxSize", m_oConfig.uiMaxSize));
+    oResult.add(CcJsonNode("Seed", m_oConfig.uiSeed));
+    oStats.getJson(oDuration, oResult);
+    bSuccess &= writeResult(oResult);
+  }
+  return bSuccess;
+}
+
+bool CSyncLoad::parseMix(const CcString& sMix)
+{
+  bool bSuccess = true;
+  uint32 auiWeights[static_cast<size_t>(ELoadCommand::Count)] = {0};
+  CcStringList slEntries = sMix.split(",");
+  for (const CcString& sEntry : slEntries)
+  {
+    CcStringList slEntry = sEntry.split("=");
+    bool bFound = false;
+    if (slEntry.size() == 2)
+    {
+      for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+      {
+        if (slEntry[0].trim() == CSyncLoadStats::getCommandName(static_cast<ELoadCommand>(uiCommand)))
+        {
+          auiWeights[uiCommand] = slEntry[1].trim().toUint32(&bFound);
+          break;
+        }
+      }
+    }
+    if (bFound == false)
+    {
+      CcConsole::writeLine("Invalid mix entry: " + sEntry);
+      bSuccess = false;
+    }
+  }
+  if (bSuccess)
+  {
+    for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+    {
+      m_oConfig.auiWeights[uiCommand] = auiWeights[uiCommand];
+    }
+  }
+  return bSuccess;
+}
+
+bool CSyncLoad::setup()
+{
+  bool bSuccess = false;
+  // Setup session is not started, it is only used to prepare directory
+  CSyncLoadSession oSetup(m_oConfig, "Seed", m_uiSessions, m_oSharedFiles);
+  if (oSetup.login() &&
+      oSetup.createAccountDirectory() &&
+      oSetup.createSessionDirectory())
+  {
+    CcConsole::writeLine("Upload " + CcString::fromNumber(m_uiSeedFiles) + " seed files");
+    bSuccess = oSetup.createSeedFiles(m_uiSeedFiles, m_oSharedFiles);
+    oSetup.logout();
+  }
+  for (size_t uiSession = 0; uiSession < m_uiSessions && bSuccess; uiSession++)
+  {
+    CCNEWTYPE(pSession, CSyncLoadSession, m_oConfig, "Session" + CcString::fromNumber(uiSession), uiSession, m_oSharedFiles);
+    m_oSessions.append(pSession);
+    bSuccess = pSession->login() &&
+               pSession->createSessionDirectory();
+  }
+  if (bSuccess == false)
+  {
+    CcConsole::writeLine("Setup failed on " + m_oConfig.oServer.getHostname() + ":" + m_oConfig.oServer.getPortString() +
+                         ", see CcSync log for details");
+  }
+  return bSuccess;
+}
+
+bool CSyncLoad::writeResult(CcJsonObject& oResult)
+{
+  bool bSuccess = false;
+  CcJsonDocument oDocument(oResult);
+  CcString sDocument = oDocument.getDocument();
+  CcFile oFile(m_sOutput);
+  if (oFile.open(EOpenFlags::Write))
+  {
+    bSuccess = oFile.writeString(sDocument);
+    oFile.close();
+  }
+  if (bSuccess)
+    CcConsole::writeLine("Result written to " + m_sOutput);
+  else
+    CcConsole::writeLine("Failed to write result to " + m_sOutput);
+  return bSuccess;
+}
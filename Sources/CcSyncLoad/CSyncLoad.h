@@ -0,0 +1,89 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncLoad
+ * @subpage   CSyncLoad
+ *
+ * @page      CSyncLoad
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CSyncLoad
+ *
+ *  Load generator for CcSyncServer.
+ *  A setup session creates the synced directory and uploads seed files,
+ *  then all sessions are logged in and started at once. Each session
+ *  replays the weighted command mix until the duration or its number of
+ *  requests is reached. Throughput and latency percentiles of each
+ *  command are printed and written to a JSON result file.
+ **/
+#ifndef _CSyncLoad_H_
+#define _CSyncLoad_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcDateTime.h"
+#include "CcSyncFileInfo.h"
+#include "CSyncLoadSession.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CSyncLoad
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CSyncLoad( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CSyncLoad( void );
+
+  /**
+   * @brief Read options from command line
+   * @return false if an option is unknown or incomplete
+   */
+  bool parseArguments(int argc, char **argv);
+  void printHelp();
+
+  /**
+   * @brief Setup directory, run all sessions and write result.
+   * @return true if all sessions were running until end
+   */
+  bool run();
+
+private:
+  bool parseMix(const CcString& sMix);
+  bool setup();
+  bool writeResult(CcJsonObject& oResult);
+
+private:
+  CSyncLoadConfig                 m_oConfig;
+  size_t                          m_uiSessions;
+  size_t                          m_uiSeedFiles;
+  CcDateTime                      m_oDuration;
+  CcString                        m_sOutput;
+  CcList<CcSyncFileInfo>          m_oSharedFiles;
+  CcList<CSyncLoadSession*>       m_oSessions;
+};
+
+#endif /* _CSyncLoad_H_ */
@@ -0,0 +1,482 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CSyncLoadSession
+ */
+#include "CSyncLoadSession.h"
+#include "CcKernel.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncFileInfoList.h"
+
+//! Wait in ms after server rejected a request because it is busy
+#define CSyncLoadSession_BusyWait 100
+
+CSyncLoadSession::CSyncLoadSession(const CSyncLoadConfig& oConfig, const CcString& sName, size_t uiIndex, const CcList<CcSyncFileInfo>& oSharedFiles) :
+  m_oConfig(oConfig),
+  m_sName(sName),
+  m_oSharedFiles(oSharedFiles)
+{
+  // Random generator must not start with 0
+  m_uiRandom = (oConfig.uiSeed + uiIndex + 1) * 0x9E3779B97F4A7C15ULL;
+  for (uint32 uiWeight : m_oConfig.auiWeights)
+  {
+    m_uiWeightSum += uiWeight;
+  }
+  m_oCom.setUrl(m_oConfig.oServer);
+}
+
+CSyncLoadSession::~CSyncLoadSession( void )
+{
+  stop();
+  while (isInProgress())
+  {
+    CcKernel::sleep(10);
+  }
+  m_oCom.close();
+}
+
+bool CSyncLoadSession::login()
+{
+  bool bRet = false;
+  m_oCom.close();
+  m_oCom.getRequest().setAccountLogin(m_oConfig.sUsername, m_oConfig.sUsername, m_oConfig.sPassword);
+  if (m_oCom.sendRequestGetResponse() &&
+      m_oCom.getResponse().hasError() == false)
+  {
+    m_oCom.getSession() = m_oCom.getResponse().getSession();
+    bRet = true;
+  }
+  else
+  {
+    CcSyncLog::writeError("Login of session " + m_sName + " failed: " + m_oCom.getResponse().getErrorMsg());
+  }
+  return bRet;
+}
+
+void CSyncLoadSession::logout()
+{
+  if (m_oCom.isConnected())
+  {
+    m_oCom.getRequest().init(ESyncCommandType::Close);
+    m_oCom.sendRequestGetResponse();
+  }
+  m_oCom.close();
+}
+
+bool CSyncLoadSession::createAccountDirectory()
+{
+  m_oCom.getRequest().setAccountCreateDirectory(m_oConfig.sDirectory);
+  bool bRet = m_oCom.sendRequestGetResponse() &&
+              m_oCom.getResponse().hasError() == false;
+  if (bRet == false)
+  {
+    CcSyncLog::writeError("Create directory " + m_oConfig.sDirectory + " failed: " + m_oCom.getResponse().getErrorMsg());
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::createSessionDirectory()
+{
+  CcSyncFileInfo oDirInfo;
+  oDirInfo.dirId() = 1;
+  oDirInfo.name() = m_sName;
+  oDirInfo.isFile() = false;
+  oDirInfo.modified() = CcKernel::getDateTime().getTimestampS();
+  m_oCom.getRequest().setDirectoryCreateDirectory(m_oConfig.sDirectory, oDirInfo);
+  // Existing directory of an earlier run is returned too
+  if (m_oCom.sendRequestGetResponse() &&
+      m_oCom.getResponse().hasError() == false)
+  {
+    m_uiDirId = m_oCom.getResponse().getFileInfo().getId();
+  }
+  else
+  {
+    CcSyncLog::writeError("Create directory of session " + m_sName + " failed: " + m_oCom.getResponse().getErrorMsg());
+  }
+  return m_uiDirId != 0;
+}
+
+bool CSyncLoadSession::createSeedFiles(size_t uiCount, CcList<CcSyncFileInfo>& oFiles)
+{
+  bool bRet = true;
+  for (size_t uiFile = 0; uiFile < uiCount && bRet; uiFile++)
+  {
+    bRet = doUpload();
+    if (bRet)
+    {
+      oFiles.append(m_oFiles.last());
+    }
+  }
+  return bRet;
+}
+
+void CSyncLoadSession::run()
+{
+  uint64 uiDone = 0;
+  while (getThreadState() == EThreadState::Running &&
+         (m_oConfig.uiRequests == 0 || uiDone < m_oConfig.uiRequests))
+  {
+    ELoadCommand eCommand = nextCommand();
+    size_t uiCommand = static_cast<size_t>(eCommand);
+    m_bBusy = false;
+    CcDateTime oStart = CcKernel::getUpTime();
+    bool bSuccess = execute(eCommand);
+    uint64 uiTime = static_cast<uint64>((CcKernel::getUpTime() - oStart).getTimestampUs());
+    uiDone++;
+    if (m_bBusy)
+    {
+      // Rejected requests are not part of latencies
+      m_oStats.auiBusy[uiCommand]++;
+      CcKernel::sleep(CSyncLoadSession_BusyWait);
+    }
+    else
+    {
+      m_oStats.aoLatency[uiCommand].add(uiTime);
+      if (bSuccess == false)
+      {
+        m_oStats.auiErrors[uiCommand]++;
+        // Connection can be in the middle of a transfer, start with a new one
+        if (eCommand == ELoadCommand::Upload ||
+            eCommand == ELoadCommand::Download ||
+            m_oCom.isConnected() == false)
+        {
+          if (login() == false)
+          {
+            m_bFailed = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+  logout();
+}
+
+uint64 CSyncLoadSession::nextRandom()
+{
+  // xorshift64*, same sequence on each run with same seed
+  m_uiRandom ^= m_uiRandom >> 12;
+  m_uiRandom ^= m_uiRandom << 25;
+  m_uiRandom ^= m_uiRandom >> 27;
+  return m_uiRandom * 2685821657736338717ULL;
+}
+
+ELoadCommand CSyncLoadSession::nextCommand()
+{
+  ELoadCommand eCommand = ELoadCommand::List;
+  if (m_uiWeightSum > 0)
+  {
+    uint32 uiValue = static_cast<uint32>(nextRandom() % m_uiWeightSum);
+    for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+    {
+      if (uiValue < m_oConfig.auiWeights[uiCommand])
+      {
+        eCommand = static_cast<ELoadCommand>(uiCommand);
+        break;
+      }
+      uiValue -= m_oConfig.auiWeights[uiCommand];
+    }
+  }
+  // Commands without target are replaced by the command wich creates one
+  if (eCommand == ELoadCommand::RemoveDir &&
+      m_oDirectories.size() == 0)
+  {
+    eCommand = ELoadCommand::CreateDir;
+  }
+  else if ((eCommand == ELoadCommand::Download ||
+            eCommand == ELoadCommand::Info) &&
+           m_oFiles.size() + m_oSharedFiles.size() == 0)
+  {
+    eCommand = ELoadCommand::Upload;
+  }
+  return eCommand;
+}
+
+bool CSyncLoadSession::execute(ELoadCommand eCommand)
+{
+  bool bRet = false;
+  switch (eCommand)
+  {
+    case ELoadCommand::List:
+      bRet = doList();
+      break;
+    case ELoadCommand::Info:
+      bRet = doInfo();
+      break;
+    case ELoadCommand::Upload:
+      bRet = doUpload();
+      break;
+    case ELoadCommand::Download:
+      bRet = doDownload();
+      break;
+    case ELoadCommand::CreateDir:
+      bRet = doCreateDir();
+      break;
+    case ELoadCommand::RemoveDir:
+      bRet = doRemoveDir();
+      break;
+    default:
+      break;
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doList()
+{
+  bool bRet = false;
+  uint64 uiDirId = m_uiDirId;
+  // Alternate between own growing directory and shared seed directory
+  if (m_oSharedFiles.size() > 0 &&
+      (nextRandom() & 1) != 0)
+  {
+    uiDirId = m_oSharedFiles[0].getDirId();
+  }
+  m_oCom.getRequest().setDirectoryGetFileList(m_oConfig.sDirectory, uiDirId);
+  if (m_oCom.sendRequestGetResponse())
+  {
+    // Decode list like CcSyncClient does
+    CcSyncFileInfoList oDirectories;
+    CcSyncFileInfoList oFiles;
+    m_oCom.getResponse().getDirectoryDirectoryInfoList(oDirectories, oFiles);
+    bRet = true;
+  }
+  else
+  {
+    m_bBusy = m_oCom.getResponse().isBusy();
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doInfo()
+{
+  bool bRet = false;
+  const CcSyncFileInfo* pFileInfo = getRandomFile();
+  if (pFileInfo != nullptr)
+  {
+    m_oCom.getRequest().setDirectoryGetFileInfo(m_oConfig.sDirectory, pFileInfo->getId());
+    if (m_oCom.sendRequestGetResponse())
+    {
+      bRet = m_oCom.getResponse().getFileInfo().getId() == pFileInfo->getId();
+    }
+    else
+    {
+      m_bBusy = m_oCom.getResponse().isBusy();
+    }
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doUpload()
+{
+  bool bRet = false;
+  CcSyncFileInfo oFileInfo;
+  oFileInfo.dirId() = m_uiDirId;
+  oFileInfo.name() = m_sName + "_" + CcString::fromNumber(m_uiCounter++) + ".bin";
+  oFileInfo.isFile() = true;
+  oFileInfo.modified() = CcKernel::getDateTime().getTimestampS();
+  oFileInfo.fileSize() = m_oConfig.uiMinSize;
+  if (m_oConfig.uiMaxSize > m_oConfig.uiMinSize)
+  {
+    oFileInfo.fileSize() += nextRandom() % (m_oConfig.uiMaxSize - m_oConfig.uiMinSize + 1);
+  }
+  m_oCom.getRequest().setDirectoryUploadFile(m_oConfig.sDirectory, oFileInfo);
+  if (m_oCom.sendRequestGetResponse())
+  {
+    CcCrc32 oCrc;
+    if (sendData(oFileInfo.getFileSize(), oCrc))
+    {
+      m_oCom.getRequest().setCrc(oCrc);
+      if (m_oCom.sendRequestGetResponse())
+      {
+        m_oFiles.append(m_oCom.getResponse().getFileInfo());
+        bRet = true;
+      }
+    }
+  }
+  else
+  {
+    m_bBusy = m_oCom.getResponse().isBusy();
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doDownload()
+{
+  bool bRet = false;
+  const CcSyncFileInfo* pFileInfo = getRandomFile();
+  if (pFileInfo != nullptr)
+  {
+    m_oCom.getRequest().setDirectoryDownloadFile(m_oConfig.sDirectory, pFileInfo->getId());
+    if (m_oCom.sendRequestGetResponse())
+    {
+      CcCrc32 oCrc;
+      if (receiveData(m_oCom.getResponse().getFileInfo().getFileSize(), oCrc))
+      {
+        m_oCom.getRequest().setCrc(oCrc);
+        bRet = m_oCom.sendRequestGetResponse();
+      }
+    }
+    else
+    {
+      m_bBusy = m_oCom.getResponse().isBusy();
+    }
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doCreateDir()
+{
+  bool bRet = false;
+  CcSyncFileInfo oDirInfo;
+  oDirInfo.dirId() = m_uiDirId;
+  oDirInfo.name() = m_sName + "_Dir_" + CcString::fromNumber(m_uiCounter++);
+  oDirInfo.isFile() = false;
+  oDirInfo.modified() = CcKernel::getDateTime().getTimestampS();
+  m_oCom.getRequest().setDirectoryCreateDirectory(m_oConfig.sDirectory, oDirInfo);
+  if (m_oCom.sendRequestGetResponse())
+  {
+    m_oDirectories.append(m_oCom.getResponse().getFileInfo());
+    bRet = true;
+  }
+  else
+  {
+    m_bBusy = m_oCom.getResponse().isBusy();
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::doRemoveDir()
+{
+  bool bRet = false;
+  if (m_oDirectories.size() > 0)
+  {
+    CcSyncFileInfo oDirInfo = m_oDirectories.last();
+    m_oCom.getRequest().setDirectoryRemoveDirectory(m_oConfig.sDirectory, oDirInfo);
+    bRet = m_oCom.sendRequestGetResponse();
+    m_bBusy = m_oCom.getResponse().isBusy();
+    if (m_bBusy == false)
+    {
+      // Not retried on error, following commands would fail on same directory
+      m_oDirectories.remove(m_oDirectories.size() - 1);
+    }
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::sendData(uint64 uiSize, CcCrc32& oCrc)
+{
+  bool bRet = true;
+  size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
+  if (uiSize < uiBufferSize)
+  {
+    uiBufferSize = static_cast<size_t>(uiSize);
+  }
+  CcSyncBuffer oBuffer;
+  if (uiBufferSize > 0 &&
+      oBuffer.acquire(uiBufferSize) == false)
+  {
+    // Server is waiting for data, stream can only be dropped with connection
+    m_oCom.reconnect();
+    bRet = false;
+  }
+  else if (uiBufferSize > 0)
+  {
+    char* pBuffer = oBuffer.data().getArray();
+    for (size_t uiPos = 0; uiPos < uiBufferSize; uiPos++)
+    {
+      pBuffer[uiPos] = static_cast<char>('a' + (uiPos + m_uiCounter) % 26);
+    }
+    uint64 uiSent = 0;
+    while (uiSent < uiSize && bRet)
+    {
+      size_t uiToSend = uiBufferSize;
+      if (uiSize - uiSent < uiToSend)
+        uiToSend = static_cast<size_t>(uiSize - uiSent);
+      oCrc.append(pBuffer, uiToSend);
+      if (m_oCom.getSocket().write(pBuffer, uiToSend) == uiToSend)
+      {
+        uiSent += uiToSend;
+        m_oStats.uiBytesUp += uiToSend;
+      }
+      else
+      {
+        bRet = false;
+      }
+    }
+  }
+  return bRet;
+}
+
+bool CSyncLoadSession::receiveData(uint64 uiSize, CcCrc32& oCrc)
+{
+  bool bRet = true;
+  size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
+  if (uiSize < uiBufferSize)
+  {
+    uiBufferSize = static_cast<size_t>(uiSize);
+  }
+  CcSyncBuffer oBuffer;
+  if (uiBufferSize > 0 &&
+      oBuffer.acquire(uiBufferSize) == false)
+  {
+    // Server is already sending, stream can only be dropped with connection
+    m_oCom.reconnect();
+    bRet = false;
+  }
+  else if (uiBufferSize > 0)
+  {
+    CcByteArray& oByteArray = oBuffer.data();
+    uint64 uiReceived = 0;
+    while (uiReceived < uiSize && bRet)
+    {
+      size_t uiReadSize = m_oCom.getSocket().readArray(oByteArray, false);
+      if (uiReadSize > 0 && uiReadSize <= oByteArray.size())
+      {
+        oCrc.append(oByteArray.getArray(), uiReadSize);
+        uiReceived += uiReadSize;
+        m_oStats.uiBytesDown += uiReadSize;
+      }
+      else
+      {
+        bRet = false;
+      }
+    }
+  }
+  return bRet;
+}
+
+const CcSyncFileInfo* CSyncLoadSession::getRandomFile()
+{
+  const CcSyncFileInfo* pFileInfo = nullptr;
+  size_t uiCount = m_oFiles.size() + m_oSharedFiles.size();
+  if (uiCount > 0)
+  {
+    size_t uiIndex = static_cast<size_t>(nextRandom() % uiCount);
+    if (uiIndex < m_oFiles.size())
+      pFileInfo = &m_oFiles[uiIndex];
+    else
+      pFileInfo = &m_oSharedFiles[uiIndex - m_oFiles.size()];
+  }
+  return pFileInfo;
+}
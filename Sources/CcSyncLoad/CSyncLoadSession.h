@@ -0,0 +1,148 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncLoad
+ * @subpage   CSyncLoadSession
+ *
+ * @page      CSyncLoadSession
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CSyncLoadSession
+ *
+ *  One authenticated connection to CcSyncServer, it is using the same
+ *  CcSyncClientCom and CcSyncRequest as CcSyncClient.
+ *  Each session works in its own directory below root of the synced
+ *  directory, so sessions are not conflicting. Files for download and
+ *  info are taken from own uploads and from the shared seed files.
+ **/
+#ifndef _CSyncLoadSession_H_
+#define _CSyncLoadSession_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcUrl.h"
+#include "IThread.h"
+#include "CcSyncClientCom.h"
+#include "CcSyncFileInfo.h"
+#include "Hash/CcCrc32.h"
+#include "CSyncLoadStats.h"
+
+/**
+ * @brief Settings of a load run, shared by all sessions
+ */
+class CSyncLoadConfig
+{
+public:
+  CcUrl     oServer;
+  CcString  sUsername;
+  CcString  sPassword;
+  CcString  sDirectory;
+  uint64    uiMinSize = 0;
+  uint64    uiMaxSize = 0;
+  //! Requests of each session, 0 if run is limited by duration
+  uint64    uiRequests = 0;
+  //! Seed of random generators, each session adds its index
+  uint64    uiSeed = 0;
+  //! Relative weight of each command in mix
+  uint32    auiWeights[static_cast<size_t>(ELoadCommand::Count)] = {0};
+};
+
+/**
+ * @brief Class impelmentation
+ */
+class CSyncLoadSession : public IThread
+{
+public:
+  /**
+   * @brief Constructor
+   * @param oConfig:      Settings of run, must exist until session is deleted
+   * @param sName:        Name of directory of this session
+   * @param uiIndex:      Index to make random sequence of session unique
+   * @param oSharedFiles: Seed files, must not change while session is running
+   */
+  CSyncLoadSession(const CSyncLoadConfig& oConfig, const CcString& sName, size_t uiIndex, const CcList<CcSyncFileInfo>& oSharedFiles);
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~CSyncLoadSession( void );
+
+  /**
+   * @brief Connect and login, it is used to reconnect after errors too.
+   */
+  bool login();
+  void logout();
+
+  /**
+   * @brief Create directory of session below root of synced directory.
+   */
+  bool createSessionDirectory();
+
+  /**
+   * @brief Create synced directory of account if it is not existing.
+   */
+  bool createAccountDirectory();
+
+  /**
+   * @brief Upload uiCount files to directory of session.
+   * @param oFiles: Uploaded files are appended
+   */
+  bool createSeedFiles(size_t uiCount, CcList<CcSyncFileInfo>& oFiles);
+
+  /**
+   * @brief Stats are only complete after thread has stopped.
+   */
+  const CSyncLoadStats& getStats() const
+    { return m_oStats; }
+  bool hasFailed() const
+    { return m_bFailed; }
+
+private:
+  void run() override;
+  uint64 nextRandom();
+  ELoadCommand nextCommand();
+  bool execute(ELoadCommand eCommand);
+  bool doList();
+  bool doInfo();
+  bool doUpload();
+  bool doDownload();
+  bool doCreateDir();
+  bool doRemoveDir();
+  bool sendData(uint64 uiSize, CcCrc32& oCrc);
+  bool receiveData(uint64 uiSize, CcCrc32& oCrc);
+  const CcSyncFileInfo* getRandomFile();
+
+private:
+  const CSyncLoadConfig&          m_oConfig;
+  CcString                        m_sName;
+  const CcList<CcSyncFileInfo>&   m_oSharedFiles;
+  CcSyncClientCom                 m_oCom;
+  CSyncLoadStats                  m_oStats;
+  CcList<CcSyncFileInfo>          m_oFiles;
+  CcList<CcSyncFileInfo>          m_oDirectories;
+  uint64                          m_uiRandom;
+  uint64                          m_uiDirId = 0;
+  uint64                          m_uiCounter = 0;
+  uint32                          m_uiWeightSum = 0;
+  bool                            m_bBusy = false;
+  bool                            m_bFailed = false;
+};
+
+#endif /* _CSyncLoadSession_H_ */
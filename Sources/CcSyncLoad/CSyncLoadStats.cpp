@@ -0,0 +1,208 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CSyncLoadStats
+ */
+#include "CSyncLoadStats.h"
+#include "CcConsole.h"
+#include "CcDateTime.h"
+#include "Json/CcJsonArray.h"
+
+void CSyncLoadHistogram::add(uint64 uiValue)
+{
+  m_auiBuckets[getBucket(uiValue)]++;
+  m_uiCount++;
+  m_uiSum += uiValue;
+  if (uiValue > m_uiMax)
+    m_uiMax = uiValue;
+}
+
+void CSyncLoadHistogram::merge(const CSyncLoadHistogram& oHistogram)
+{
+  for (size_t uiBucket = 0; uiBucket < CSyncLoadHistogram_Buckets; uiBucket++)
+  {
+    m_auiBuckets[uiBucket] += oHistogram.m_auiBuckets[uiBucket];
+  }
+  m_uiCount += oHistogram.m_uiCount;
+  m_uiSum += oHistogram.m_uiSum;
+  if (oHistogram.m_uiMax > m_uiMax)
+    m_uiMax = oHistogram.m_uiMax;
+}
+
+uint64 CSyncLoadHistogram::getPercentile(uint32 uiPerMille) const
+{
+  uint64 uiValue = 0;
+  if (m_uiCount > 0)
+  {
+    // Rank of value, rounded up so p100 is the last value
+    uint64 uiRank = (m_uiCount * uiPerMille + 999) / 1000;
+    if (uiRank == 0)
+      uiRank = 1;
+    uint64 uiSeen = 0;
+    for (size_t uiBucket = 0; uiBucket < CSyncLoadHistogram_Buckets; uiBucket++)
+    {
+      uiSeen += m_auiBuckets[uiBucket];
+      if (uiSeen >= uiRank)
+      {
+        uiValue = getBucketValue(uiBucket);
+        break;
+      }
+    }
+    // Upper bound of bucket can be above all values
+    if (uiValue > m_uiMax)
+      uiValue = m_uiMax;
+  }
+  return uiValue;
+}
+
+size_t CSyncLoadHistogram::getBucket(uint64 uiValue)
+{
+  size_t uiBucket = 0;
+  if (uiValue < CSyncLoadHistogram_SubBuckets)
+  {
+    uiBucket = static_cast<size_t>(uiValue);
+  }
+  else
+  {
+    size_t uiBits = 0;
+    while ((uiValue >> uiBits) > 1)
+      uiBits++;
+    if (uiBits >= CSyncLoadHistogram_MaxBits)
+    {
+      uiBucket = CSyncLoadHistogram_Buckets - 1;
+    }
+    else
+    {
+      // 6 bits below highest bit are selecting the linear bucket
+      size_t uiSub = static_cast<size_t>(uiValue >> (uiBits - 6)) & (CSyncLoadHistogram_SubBuckets - 1);
+      uiBucket = CSyncLoadHistogram_SubBuckets * (uiBits - 5) + uiSub;
+    }
+  }
+  return uiBucket;
+}
+
+uint64 CSyncLoadHistogram::getBucketValue(size_t uiBucket)
+{
+  uint64 uiValue = 0;
+  if (uiBucket < CSyncLoadHistogram_SubBuckets)
+  {
+    uiValue = uiBucket;
+  }
+  else
+  {
+    size_t uiBits = uiBucket / CSyncLoadHistogram_SubBuckets + 5;
+    uint64 uiSub = uiBucket % CSyncLoadHistogram_SubBuckets;
+    // Highest value of bucket
+    uiValue = ((CSyncLoadHistogram_SubBuckets + uiSub + 1) << (uiBits - 6)) - 1;
+  }
+  return uiValue;
+}
+
+void CSyncLoadStats::merge(const CSyncLoadStats& oStats)
+{
+  for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+  {
+    aoLatency[uiCommand].merge(oStats.aoLatency[uiCommand]);
+    auiErrors[uiCommand] += oStats.auiErrors[uiCommand];
+    auiBusy[uiCommand] += oStats.auiBusy[uiCommand];
+  }
+  uiBytesUp += oStats.uiBytesUp;
+  uiBytesDown += oStats.uiBytesDown;
+}
+
+const char* CSyncLoadStats::getCommandName(ELoadCommand eCommand)
+{
+  switch (eCommand)
+  {
+    case ELoadCommand::List:      return "list";
+    case ELoadCommand::Info:      return "info";
+    case ELoadCommand::Upload:    return "upload";
+    case ELoadCommand::Download:  return "download";
+    case ELoadCommand::CreateDir: return "mkdir";
+    case ELoadCommand::RemoveDir: return "rmdir";
+    default:                      return "unknown";
+  }
+}
+
+void CSyncLoadStats::print(const CcDateTime& oDuration) const
+{
+  uint64 uiDurationMs = static_cast<uint64>(oDuration.getTimestampMs());
+  if (uiDurationMs == 0)
+    uiDurationMs = 1;
+  uint64 uiTotal = 0;
+  CcConsole::writeLine("Command    Requests  Errors  Busy   Req/s    p50 ms   p90 ms   p99 ms   max ms");
+  for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+  {
+    const CSyncLoadHistogram& oLatency = aoLatency[uiCommand];
+    uiTotal += oLatency.getCount();
+    CcString sLine(getCommandName(static_cast<ELoadCommand>(uiCommand)));
+    sLine << "  " << CcString::fromNumber(oLatency.getCount());
+    sLine << "  " << CcString::fromNumber(auiErrors[uiCommand]);
+    sLine << "  " << CcString::fromNumber(auiBusy[uiCommand]);
+    sLine << "  " << CcString::fromNumber(oLatency.getCount() * 1000 / uiDurationMs);
+    sLine << "  " << CcString::fromNumber(oLatency.getPercentile(500) / 1000.0, 2, true);
+    sLine << "  " << CcString::fromNumber(oLatency.getPercentile(900) / 1000.0, 2, true);
+    sLine << "  " << CcString::fromNumber(oLatency.getPercentile(990) / 1000.0, 2, true);
+    sLine << "  " << CcString::fromNumber(oLatency.getMax() / 1000.0, 2, true);
+    CcConsole::writeLine(sLine);
+  }
+  CcConsole::writeLine("Total: " + CcString::fromNumber(uiTotal) + " requests, " +
+                       CcString::fromNumber(uiTotal * 1000 / uiDurationMs) + " req/s, " +
+                       CcString::fromNumber(uiBytesUp * 1000 / uiDurationMs / 1024) + " KiB/s up, " +
+                       CcString::fromNumber(uiBytesDown * 1000 / uiDurationMs / 1024) + " KiB/s down");
+}
+
+void CSyncLoadStats::getJson(const CcDateTime& oDuration, CcJsonObject& oResult) const
+{
+  uint64 uiDurationMs = static_cast<uint64>(oDuration.getTimestampMs());
+  if (uiDurationMs == 0)
+    uiDurationMs = 1;
+  uint64 uiTotal = 0;
+  CcJsonNode oCommands(EJsonDataType::Array);
+  oCommands.setName("Commands");
+  for (size_t uiCommand = 0; uiCommand < static_cast<size_t>(ELoadCommand::Count); uiCommand++)
+  {
+    const CSyncLoadHistogram& oLatency = aoLatency[uiCommand];
+    uiTotal += oLatency.getCount();
+    CcJsonObject oCommand;
+    oCommand.add(CcJsonNode("Name", CcString(getCommandName(static_cast<ELoadCommand>(uiCommand)))));
+    oCommand.add(CcJsonNode("Requests", oLatency.getCount()));
+    oCommand.add(CcJsonNode("Errors", auiErrors[uiCommand]));
+    oCommand.add(CcJsonNode("Busy", auiBusy[uiCommand]));
+    oCommand.add(CcJsonNode("RequestsPerSecond", oLatency.getCount() * 1000 / uiDurationMs));
+    oCommand.add(CcJsonNode("MeanUs", oLatency.getMean()));
+    oCommand.add(CcJsonNode("P50Us", oLatency.getPercentile(500)));
+    oCommand.add(CcJsonNode("P90Us", oLatency.getPercentile(900)));
+    oCommand.add(CcJsonNode("P99Us", oLatency.getPercentile(990)));
+    oCommand.add(CcJsonNode("P999Us", oLatency.getPercentile(999)));
+    oCommand.add(CcJsonNode("MaxUs", oLatency.getMax()));
+    oCommands.array().add(CcJsonNode(oCommand, ""));
+  }
+  oResult.add(CcJsonNode("DurationMs", uiDurationMs));
+  oResult.add(CcJsonNode("Requests", uiTotal));
+  oResult.add(CcJsonNode("RequestsPerSecond", uiTotal * 1000 / uiDurationMs));
+  oResult.add(CcJsonNode("BytesUp", uiBytesUp));
+  oResult.add(CcJsonNode("BytesDown", uiBytesDown));
+  oResult.add(CcJsonNode("BytesUpPerSecond", uiBytesUp * 1000 / uiDurationMs));
+  oResult.add(CcJsonNode("BytesDownPerSecond", uiBytesDown * 1000 / uiDurationMs));
+  oResult.append(std::move(oCommands));
+}
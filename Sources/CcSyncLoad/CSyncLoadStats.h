@@ -0,0 +1,121 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncLoad
+ * @subpage   CSyncLoadStats
+ *
+ * @page      CSyncLoadStats
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CSyncLoadStats
+ *
+ *  Latencies are counted in a histogram with 64 linear buckets for each
+ *  power of two, so percentiles are exact to about 2 percent with fixed
+ *  memory. Each session keeps its own stats, they are merged after all
+ *  sessions are stopped.
+ **/
+#ifndef _CSyncLoadStats_H_
+#define _CSyncLoadStats_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "CcDateTime.h"
+#include "Json/CcJsonObject.h"
+
+//! Linear buckets for each power of two
+#define CSyncLoadHistogram_SubBuckets  64
+//! Bits of a value wich are covered by histogram, longer latencies are counted to last bucket
+#define CSyncLoadHistogram_MaxBits     40
+#define CSyncLoadHistogram_Buckets     (CSyncLoadHistogram_SubBuckets * (CSyncLoadHistogram_MaxBits - 5))
+
+/**
+ * @brief Commands wich are replayed by sessions
+ */
+enum class ELoadCommand
+{
+  List = 0,
+  Info,
+  Upload,
+  Download,
+  CreateDir,
+  RemoveDir,
+  Count
+};
+
+/**
+ * @brief Histogram of latencies in us
+ */
+class CSyncLoadHistogram
+{
+public:
+  void add(uint64 uiValue);
+  void merge(const CSyncLoadHistogram& oHistogram);
+
+  /**
+   * @brief Get value wich is not exceeded by uiPerMille of all values.
+   */
+  uint64 getPercentile(uint32 uiPerMille) const;
+  uint64 getCount() const
+    { return m_uiCount; }
+  uint64 getMax() const
+    { return m_uiMax; }
+  uint64 getMean() const
+    { return m_uiCount > 0 ? m_uiSum / m_uiCount : 0; }
+
+private:
+  static size_t getBucket(uint64 uiValue);
+  static uint64 getBucketValue(size_t uiBucket);
+
+private:
+  uint64  m_auiBuckets[CSyncLoadHistogram_Buckets] = {0};
+  uint64  m_uiCount = 0;
+  uint64  m_uiSum   = 0;
+  uint64  m_uiMax   = 0;
+};
+
+/**
+ * @brief Results of one session or of all sessions
+ */
+class CSyncLoadStats
+{
+public:
+  void merge(const CSyncLoadStats& oStats);
+  static const char* getCommandName(ELoadCommand eCommand);
+
+  /**
+   * @brief Print a table of all commands to console.
+   * @param oDuration: Time of run for throughput
+   */
+  void print(const CcDateTime& oDuration) const;
+
+  /**
+   * @brief Write all values to oResult.
+   * @param oDuration: Time of run for throughput
+   */
+  void getJson(const CcDateTime& oDuration, CcJsonObject& oResult) const;
+
+  CSyncLoadHistogram  aoLatency[static_cast<size_t>(ELoadCommand::Count)];
+  uint64              auiErrors[static_cast<size_t>(ELoadCommand::Count)] = {0};
+  //! Requests rejected by server because of too many transfers
+  uint64              auiBusy[static_cast<size_t>(ELoadCommand::Count)] = {0};
+  uint64              uiBytesUp   = 0;
+  uint64              uiBytesDown = 0;
+};
+
+#endif /* _CSyncLoadStats_H_ */
@@ -0,0 +1,55 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Load generator for CcSyncServer
+ */
+
+#include "CcBase.h"
+#include "CcKernel.h"
+#include "CcConsole.h"
+#include "CcSyncLog.h"
+#include "CSyncLoad.h"
+
+// Application entry point.
+int main(int argc, char **argv)
+{
+  int iReturn = 1;
+  CcSyncLog::start();
+  {
+    CSyncLoad oLoad;
+    if (oLoad.parseArguments(argc, argv))
+    {
+      CcConsole::writeLine("Start: CcSyncLoad");
+      if (oLoad.run())
+      {
+        iReturn = 0;
+      }
+    }
+    else
+    {
+      oLoad.printHelp();
+    }
+  }
+  // Write messages wich are still queued
+  CcSyncLog::stop();
+  return iReturn;
+}
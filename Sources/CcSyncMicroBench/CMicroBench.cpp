@@ -0,0 +1,562 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CMicroBench
+ */
+#include "CMicroBench.h"
+#include "CBenchResult.h"
+#include "CcKernel.h"
+#include "CcConsole.h"
+#include "CcFile.h"
+#include "CcDirectory.h"
+#include "CcArguments.h"
+#include "CcSyncResponse.h"
+#include "CcSyncGlobals.h"
+#include "Json/CcJsonDocument.h"
+#include "Json/CcJsonArray.h"
+
+//! Default number of files in fixture, a tenth of it is created as directories
+#define CMicroBench_DefaultEntries    10000
+//! Default levels of directory chain for getInnerPathById
+#define CMicroBench_DefaultDepth      32
+//! Default repetitions of each case
+#define CMicroBench_DefaultRepeat     5
+//! Default percent a case can be slower than baseline
+#define CMicroBench_DefaultTolerance  10
+//! Lookups in lists, they are linear so not each entry is searched
+#define CMicroBench_Probes            1000
+//! Prime to spread probes over the list
+#define CMicroBench_ProbeStep         7919
+//! Name of synced directory in database
+#define CMicroBench_DirName           "Bench"
+
+void CMicroBenchRun::start()
+{
+  m_oStart = CcKernel::getUpTime();
+}
+
+void CMicroBenchRun::stop()
+{
+  uiTimeUs = static_cast<uint64>((CcKernel::getUpTime() - m_oStart).getTimestampUs());
+}
+
+CMicroBench::CMicroBench( void ) :
+  m_sOutput("CcSyncMicroBench.json"),
+  m_uiEntries(CMicroBench_DefaultEntries),
+  m_uiDepth(CMicroBench_DefaultDepth),
+  m_uiRepeat(CMicroBench_DefaultRepeat),
+  m_uiTolerance(CMicroBench_DefaultTolerance)
+{
+  m_sWorkingDir = CcKernel::getUserDataDir();
+  m_sWorkingDir.appendPath("CcSyncMicroBench");
+  appendCase("FileInfoListFindName",            &CMicroBench::benchFileInfoListFindName);
+  appendCase("FileInfoListFindId",              &CMicroBench::benchFileInfoListFindId);
+  appendCase("FileInfoJsonEncode",              &CMicroBench::benchFileInfoJsonEncode);
+  appendCase("FileInfoJsonDecode",              &CMicroBench::benchFileInfoJsonDecode);
+  appendCase("ResponseAddDirectoryInfoList",    &CMicroBench::benchResponseAddDirectoryInfoList);
+  appendCase("ResponseGetDirectoryInfoList",    &CMicroBench::benchResponseGetDirectoryInfoList);
+  appendCase("DbFileListInsert",                &CMicroBench::benchDbFileListInsert);
+  appendCase("DbGetFileInfoList",               &CMicroBench::benchDbGetFileInfoList);
+  appendCase("DbDirectoryListUpdateChanged",    &CMicroBench::benchDbDirectoryListUpdateChanged);
+  appendCase("DbGetInnerPathById",              &CMicroBench::benchDbGetInnerPathById);
+}
+
+CMicroBench::~CMicroBench( void )
+{
+  removeFixtures();
+}
+
+bool CMicroBench::parseArguments(int argc, char **argv)
+{
+  bool bSuccess = true;
+  CcArguments oArguments;
+  oArguments.parse(argc, argv);
+  for (size_t uiArg = 1; uiArg < oArguments.size() && bSuccess; uiArg++)
+  {
+    const CcString& sArgument = oArguments[uiArg];
+    if (uiArg + 1 >= oArguments.size())
+    {
+      CcConsole::writeLine("Unknown or incomplete option: " + sArgument);
+      bSuccess = false;
+    }
+    else
+    {
+      const CcString& sValue = oArguments[++uiArg];
+      bool bOk = true;
+      if (sArgument == "--dir")
+        m_sWorkingDir = sValue;
+      else if (sArgument == "--output")
+        m_sOutput = sValue;
+      else if (sArgument == "--baseline")
+        m_sBaseline = sValue;
+      else if (sArgument == "--case")
+        m_slFilter.append(sValue);
+      else if (sArgument == "--entries")
+        m_uiEntries = sValue.toUint32(&bOk);
+      else if (sArgument == "--depth")
+        m_uiDepth = sValue.toUint32(&bOk);
+      else if (sArgument == "--repeat")
+        m_uiRepeat = sValue.toUint32(&bOk);
+      else if (sArgument == "--tolerance")
+        m_uiTolerance = sValue.toUint32(&bOk);
+      else
+        bOk = false;
+      if (bOk == false)
+      {
+        CcConsole::writeLine("Unknown option or invalid value: " + sArgument + " " + sValue);
+        bSuccess = false;
+      }
+    }
+  }
+  if (bSuccess &&
+      (m_uiEntries == 0 || m_uiRepeat == 0))
+  {
+    CcConsole::writeLine("Entries and repeat must not be 0");
+    bSuccess = false;
+  }
+  return bSuccess;
+}
+
+void CMicroBench::printHelp()
+{
+  CcConsole::writeLine("Usage: CcSyncMicroBench [options]");
+  CcConsole::writeLine("  --case NAME      run only this case, can be repeated, default all");
+  CcConsole::writeLine("  --entries N      files in fixture, default " + CcString::fromNumber(CMicroBench_DefaultEntries));
+  CcConsole::writeLine("  --depth N        levels of directory chain, default " + CcString::fromNumber(CMicroBench_DefaultDepth));
+  CcConsole::writeLine("  --repeat N       repetitions of each case, default " + CcString::fromNumber(CMicroBench_DefaultRepeat));
+  CcConsole::writeLine("  --baseline FILE  compare median times with an earlier result");
+  CcConsole::writeLine("  --tolerance P    percent a case can be slower than baseline, default " + CcString::fromNumber(CMicroBench_DefaultTolerance));
+  CcConsole::writeLine("  --dir PATH       working directory for database, default CcSyncMicroBench in user data");
+  CcConsole::writeLine("  --output FILE    result file, default CcSyncMicroBench.json");
+  CcConsole::writeLine("Cases:");
+  for (CMicroBenchCase& oCase : m_oCases)
+  {
+    CcConsole::writeLine("  " + oCase.sName);
+  }
+}
+
+bool CMicroBench::run()
+{
+  bool bSuccess = createFixtures();
+  if (bSuccess)
+  {
+    CcJsonObject oResult;
+    oResult.add(CcJsonNode("Benchmark", CcString("CcSyncMicroBench")));
+    oResult.add(CcJsonNode("Entries", static_cast<uint64>(m_uiEntries)));
+    oResult.add(CcJsonNode("Depth", static_cast<uint64>(m_uiDepth)));
+    oResult.add(CcJsonNode("Repeat", static_cast<uint64>(m_uiRepeat)));
+    CcJsonNode oCases(EJsonDataType::Array);
+    oCases.setName("Cases");
+    for (CMicroBenchCase& oCase : m_oCases)
+    {
+      if (m_slFilter.size() == 0 ||
+          m_slFilter.contains(oCase.sName))
+      {
+        bSuccess &= runCase(oCase, oCases);
+      }
+    }
+    oResult.append(std::move(oCases));
+    if (m_sBaseline.length() > 0)
+    {
+      bSuccess &= compareBaseline(oResult);
+    }
+    bSuccess &= CBenchResult::write(m_sOutput, oResult);
+  }
+  else
+  {
+    CcConsole::writeLine("Failed to create fixtures in " + m_sWorkingDir);
+  }
+  removeFixtures();
+  return bSuccess;
+}
+
+void CMicroBench::appendCase(const CcString& sName, FMicroBenchCase pMethod)
+{
+  CMicroBenchCase oCase;
+  oCase.sName = sName;
+  oCase.pMethod = pMethod;
+  m_oCases.append(oCase);
+}
+
+bool CMicroBench::createFixtures()
+{
+  bool bSuccess = true;
+  size_t uiDirectories = m_uiEntries / 10;
+  if (uiDirectories == 0)
+    uiDirectories = 1;
+  // Id 1 is root of database, directories are following
+  for (size_t uiIndex = 0; uiIndex < uiDirectories; uiIndex++)
+  {
+    m_oDirectoryList.append(createFileInfo(uiIndex + 2, false));
+  }
+  for (size_t uiIndex = 0; uiIndex < m_uiEntries; uiIndex++)
+  {
+    m_oFileList.append(createFileInfo(uiIndex + 1, true));
+    m_oFileJsonList.append(m_oFileList.last().getJsonObject());
+  }
+  CcSyncResponse oResponse;
+  oResponse.init(ESyncCommandType::DirectoryGetFileList);
+  oResponse.addDirectoryDirectoryInfoList(m_oDirectoryList, m_oFileList);
+  m_sResponseData = CcString(oResponse.getBinary());
+
+  m_sDatabaseFile = m_sWorkingDir;
+  m_sDatabaseFile.appendPath("CcSyncMicroBench.sqlite");
+  if (CcFile::exists(m_sDatabaseFile))
+  {
+    CcFile::remove(m_sDatabaseFile);
+  }
+  CCNEW(m_pDatabase, CcSyncDbClient);
+  if (CcDirectory::create(m_sWorkingDir, true) &&
+      m_pDatabase->openDatabase(m_sDatabaseFile) &&
+      m_pDatabase->enableWriteAheadLog() &&
+      m_pDatabase->setupDirectory(CMicroBench_DirName))
+  {
+    m_pDatabase->beginTransaction();
+    for (CcSyncFileInfo oDirectory : m_oDirectoryList)
+    {
+      bSuccess &= m_pDatabase->directoryListInsert(CMicroBench_DirName, oDirectory, false);
+    }
+    for (CcSyncFileInfo oFile : m_oFileList)
+    {
+      bSuccess &= m_pDatabase->fileListInsert(CMicroBench_DirName, oFile, false);
+    }
+    // Chain of directories below first directory
+    m_uiLeafDirId = m_oDirectoryList[0].getId();
+    for (size_t uiLevel = 0; uiLevel < m_uiDepth && bSuccess; uiLevel++)
+    {
+      CcSyncFileInfo oDirectory = createFileInfo(uiDirectories + uiLevel + 2, false);
+      oDirectory.dirId() = m_uiLeafDirId;
+      bSuccess = m_pDatabase->directoryListInsert(CMicroBench_DirName, oDirectory, false);
+      m_uiLeafDirId = oDirectory.getId();
+    }
+    m_pDatabase->endTransaction();
+  }
+  else
+  {
+    bSuccess = false;
+  }
+  return bSuccess;
+}
+
+void CMicroBench::removeFixtures()
+{
+  if (m_pDatabase != nullptr)
+  {
+    m_pDatabase = nullptr;
+    CcFile::remove(m_sDatabaseFile);
+    // Remove write ahead log and shared memory too
+    CcFile::remove(m_sDatabaseFile + "-wal");
+    CcFile::remove(m_sDatabaseFile + "-shm");
+  }
+  m_oDirectoryList.clear();
+  m_oFileList.clear();
+  m_oFileJsonList.clear();
+  m_sResponseData.clear();
+}
+
+bool CMicroBench::runCase(const CMicroBenchCase& oCase, CcJsonNode& oCases)
+{
+  bool bSuccess = true;
+  uint64 uiOperations = 0;
+  CcList<uint64> oTimes;
+  for (size_t uiRun = 0; uiRun < m_uiRepeat && bSuccess; uiRun++)
+  {
+    CMicroBenchRun oRun;
+    bSuccess = (this->*oCase.pMethod)(oRun) &&
+               oRun.uiOperations > 0;
+    if (bSuccess)
+    {
+      // Keep times sorted for median
+      uint64 uiTimeNs = oRun.uiTimeUs * 1000 / oRun.uiOperations;
+      size_t uiPos = 0;
+      while (uiPos < oTimes.size() &&
+             oTimes[uiPos] < uiTimeNs)
+      {
+        uiPos++;
+      }
+      oTimes.insert(uiPos, uiTimeNs);
+      uiOperations = oRun.uiOperations;
+    }
+  }
+  CcJsonObject oCaseResult;
+  oCaseResult.add(CcJsonNode("Name", oCase.sName));
+  oCaseResult.add(CcJsonNode("Success", bSuccess));
+  if (bSuccess)
+  {
+    uint64 uiBestNs = oTimes[0];
+    uint64 uiMedianNs = oTimes[oTimes.size() / 2];
+    oCaseResult.add(CcJsonNode("Operations", uiOperations));
+    oCaseResult.add(CcJsonNode("BestNs", uiBestNs));
+    oCaseResult.add(CcJsonNode("MedianNs", uiMedianNs));
+    CcConsole::writeLine(oCase.sName + ": " + CcString::fromNumber(uiMedianNs) + "ns median, " +
+                         CcString::fromNumber(uiBestNs) + "ns best, " +
+                         CcString::fromNumber(uiOperations) + " operations");
+  }
+  else
+  {
+    CcConsole::writeLine(oCase.sName + ": failed");
+  }
+  oCases.array().add(CcJsonNode(oCaseResult, ""));
+  return bSuccess;
+}
+
+bool CMicroBench::compareBaseline(CcJsonObject& oResult)
+{
+  bool bSuccess = false;
+  CcFile oFile(m_sBaseline);
+  CcJsonDocument oDocument;
+  if (oFile.open(EOpenFlags::Read))
+  {
+    CcString sBaseline(oFile.readAll());
+    oFile.close();
+    bSuccess = oDocument.parseDocument(sBaseline);
+  }
+  if (bSuccess == false)
+  {
+    CcConsole::writeLine("Failed to read baseline: " + m_sBaseline);
+  }
+  else
+  {
+    CcJsonObject& oBaseline = oDocument.getJsonData().getJsonObject();
+    if (oBaseline.contains("Entries", EJsonDataType::Value) &&
+        oBaseline["Entries"].getValue().getUint64() != m_uiEntries)
+    {
+      CcConsole::writeLine("Warning: baseline was created with " +
+                           CcString::fromNumber(oBaseline["Entries"].getValue().getUint64()) + " entries");
+    }
+    if (oBaseline.contains("Cases", EJsonDataType::Array) &&
+        oResult.contains("Cases", EJsonDataType::Array))
+    {
+      size_t uiRegressions = 0;
+      CcConsole::writeLine("Baseline: " + m_sBaseline);
+      for (CcJsonNode& oCaseNode : oResult["Cases"].array())
+      {
+        CcJsonObject& oCase = oCaseNode.object();
+        if (oCase.contains("MedianNs", EJsonDataType::Value) == false)
+          continue;
+        const CcString& sName = oCase["Name"].getValue().getString();
+        for (CcJsonNode& oBaseNode : oBaseline["Cases"].array())
+        {
+          CcJsonObject& oBaseCase = oBaseNode.object();
+          if (oBaseCase.contains("MedianNs", EJsonDataType::Value) &&
+              oBaseCase["Name"].getValue().getString() == sName)
+          {
+            int64 iBaseNs = static_cast<int64>(oBaseCase["MedianNs"].getValue().getUint64());
+            int64 iCurrentNs = static_cast<int64>(oCase["MedianNs"].getValue().getUint64());
+            int64 iChange = 0;
+            if (iBaseNs > 0)
+              iChange = (iCurrentNs - iBaseNs) * 100 / iBaseNs;
+            bool bRegression = iChange > static_cast<int64>(m_uiTolerance);
+            if (bRegression)
+              uiRegressions++;
+            oCase.add(CcJsonNode("BaselineNs", static_cast<uint64>(iBaseNs)));
+            oCase.add(CcJsonNode("ChangePercent", iChange));
+            oCase.add(CcJsonNode("Regression", bRegression));
+            CcConsole::writeLine("  " + sName + ": " + CcString::fromNumber(iCurrentNs) + "ns, baseline " +
+                                 CcString::fromNumber(iBaseNs) + "ns, " +
+                                 (iChange > 0 ? "+" : "") + CcString::fromNumber(iChange) + "%" +
+                                 (bRegression ? " REGRESSION" : ""));
+            break;
+          }
+        }
+      }
+      oResult.add(CcJsonNode("Baseline", m_sBaseline));
+      oResult.add(CcJsonNode("Regressions", static_cast<uint64>(uiRegressions)));
+      bSuccess = uiRegressions == 0;
+    }
+    else
+    {
+      CcConsole::writeLine("Baseline contains no cases: " + m_sBaseline);
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+CcSyncFileInfo CMicroBench::createFileInfo(uint64 uiIndex, bool bIsFile)
+{
+  CcSyncFileInfo oFileInfo;
+  oFileInfo.id() = uiIndex;
+  oFileInfo.dirId() = 1;
+  oFileInfo.isFile() = bIsFile;
+  if (bIsFile)
+    oFileInfo.name() = "File_" + CcString::fromNumber(uiIndex) + ".dat";
+  else
+    oFileInfo.name() = "Directory_" + CcString::fromNumber(uiIndex);
+  oFileInfo.modified() = 1500000000 + static_cast<int64>(uiIndex);
+  oFileInfo.changed() = 1500000000 + static_cast<int64>(uiIndex);
+  if (bIsFile)
+  {
+    oFileInfo.fileSize() = uiIndex * 1024;
+    oFileInfo.crc() = static_cast<uint32>(uiIndex * 2654435761u);
+  }
+  for (uint64 uiByte = 0; uiByte < 16; uiByte++)
+  {
+    oFileInfo.md5().append(static_cast<char>((uiIndex + uiByte) & 0xff));
+  }
+  return oFileInfo;
+}
+
+bool CMicroBench::benchFileInfoListFindName(CMicroBenchRun& oRun)
+{
+  bool bSuccess = true;
+  CcStringList slNames;
+  for (size_t uiProbe = 0; uiProbe < CMicroBench_Probes; uiProbe++)
+  {
+    slNames.append(m_oFileList[(uiProbe * CMicroBench_ProbeStep) % m_oFileList.size()].getName());
+  }
+  oRun.start();
+  for (const CcString& sName : slNames)
+  {
+    bSuccess &= m_oFileList.containsFile(sName);
+  }
+  oRun.stop();
+  oRun.uiOperations = slNames.size();
+  return bSuccess;
+}
+
+bool CMicroBench::benchFileInfoListFindId(CMicroBenchRun& oRun)
+{
+  bool bSuccess = true;
+  CcList<uint64> oIds;
+  for (size_t uiProbe = 0; uiProbe < CMicroBench_Probes; uiProbe++)
+  {
+    oIds.append(m_oFileList[(uiProbe * CMicroBench_ProbeStep) % m_oFileList.size()].getId());
+  }
+  oRun.start();
+  for (uint64 uiId : oIds)
+  {
+    bSuccess &= m_oFileList.containsFile(uiId);
+  }
+  oRun.stop();
+  oRun.uiOperations = oIds.size();
+  return bSuccess;
+}
+
+bool CMicroBench::benchFileInfoJsonEncode(CMicroBenchRun& oRun)
+{
+  size_t uiNodes = 0;
+  oRun.start();
+  for (const CcSyncFileInfo& oFileInfo : m_oFileList)
+  {
+    uiNodes += oFileInfo.getJsonObject().size();
+  }
+  oRun.stop();
+  oRun.uiOperations = m_oFileList.size();
+  return uiNodes > 0;
+}
+
+bool CMicroBench::benchFileInfoJsonDecode(CMicroBenchRun& oRun)
+{
+  bool bSuccess = true;
+  oRun.start();
+  for (const CcJsonObject& oJsonObject : m_oFileJsonList)
+  {
+    CcSyncFileInfo oFileInfo;
+    oFileInfo.fromJsonObject(oJsonObject);
+    bSuccess &= oFileInfo.getId() != 0;
+  }
+  oRun.stop();
+  oRun.uiOperations = m_oFileJsonList.size();
+  return bSuccess;
+}
+
+bool CMicroBench::benchResponseAddDirectoryInfoList(CMicroBenchRun& oRun)
+{
+  CcSyncResponse oResponse;
+  oRun.start();
+  oResponse.init(ESyncCommandType::DirectoryGetFileList);
+  oResponse.addDirectoryDirectoryInfoList(m_oDirectoryList, m_oFileList);
+  CcByteArray oData = oResponse.getBinary();
+  oRun.stop();
+  oRun.uiOperations = m_oDirectoryList.size() + m_oFileList.size();
+  return oData.size() == m_sResponseData.length();
+}
+
+bool CMicroBench::benchResponseGetDirectoryInfoList(CMicroBenchRun& oRun)
+{
+  CcSyncResponse oResponse;
+  CcSyncFileInfoList oDirectoryList;
+  CcSyncFileInfoList oFileList;
+  oRun.start();
+  bool bSuccess = oResponse.parseData(m_sResponseData);
+  oResponse.getDirectoryDirectoryInfoList(oDirectoryList, oFileList);
+  oRun.stop();
+  oRun.uiOperations = m_oDirectoryList.size() + m_oFileList.size();
+  return bSuccess &&
+         oDirectoryList.size() == m_oDirectoryList.size() &&
+         oFileList.size() == m_oFileList.size();
+}
+
+bool CMicroBench::benchDbFileListInsert(CMicroBenchRun& oRun)
+{
+  bool bSuccess = true;
+  // Each run writes to new tables, so all runs are starting with empty tables
+  CcString sDirName = "Insert" + CcString::fromNumber(m_uiInsertTables++);
+  bSuccess = m_pDatabase->setupDirectory(sDirName);
+  oRun.start();
+  m_pDatabase->beginTransaction();
+  for (CcSyncFileInfo oFileInfo : m_oFileList)
+  {
+    bSuccess &= m_pDatabase->fileListInsert(sDirName, oFileInfo, false);
+  }
+  m_pDatabase->endTransaction();
+  oRun.stop();
+  oRun.uiOperations = m_oFileList.size();
+  return bSuccess;
+}
+
+bool CMicroBench::benchDbGetFileInfoList(CMicroBenchRun& oRun)
+{
+  oRun.start();
+  CcSyncFileInfoList oDirectoryList = m_pDatabase->getDirectoryInfoListById(CMicroBench_DirName, 1);
+  CcSyncFileInfoList oFileList = m_pDatabase->getFileInfoListById(CMicroBench_DirName, 1);
+  oRun.stop();
+  oRun.uiOperations = oDirectoryList.size() + oFileList.size();
+  return oDirectoryList.size() == m_oDirectoryList.size() &&
+         oFileList.size() == m_oFileList.size();
+}
+
+bool CMicroBench::benchDbDirectoryListUpdateChanged(CMicroBenchRun& oRun)
+{
+  oRun.start();
+  m_pDatabase->beginTransaction();
+  m_pDatabase->directoryListUpdateChanged(CMicroBench_DirName, 1);
+  m_pDatabase->endTransaction();
+  oRun.stop();
+  // Root with all files and directories is hashed once
+  oRun.uiOperations = 1;
+  return true;
+}
+
+bool CMicroBench::benchDbGetInnerPathById(CMicroBenchRun& oRun)
+{
+  bool bSuccess = true;
+  oRun.start();
+  for (size_t uiProbe = 0; uiProbe < CMicroBench_Probes && bSuccess; uiProbe++)
+  {
+    bSuccess = m_pDatabase->getInnerPathById(CMicroBench_DirName, m_uiLeafDirId).length() > 0;
+  }
+  oRun.stop();
+  oRun.uiOperations = CMicroBench_Probes;
+  return bSuccess;
+}
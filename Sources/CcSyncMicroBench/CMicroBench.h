@@ -0,0 +1,156 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncMicroBench
+ * @subpage   CMicroBench
+ *
+ * @page      CMicroBench
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CMicroBench
+ *
+ *  Microbenchmarks of the metadata paths wich are scaling with the size of
+ *  a synced tree: file info lists, JSON encoding of file infos and
+ *  directory listings, and the client database.
+ *  All fixtures are generated from their index, so each run is working on
+ *  the same data. Each case is repeated and best and median time per
+ *  operation are written to a JSON result file. A stored result can be
+ *  passed as baseline, cases wich are slower than the tolerance are
+ *  reported as regression.
+ **/
+#ifndef _CMicroBench_H_
+#define _CMicroBench_H_
+
+#include "CcBase.h"
+#include "CcString.h"
+#include "CcStringList.h"
+#include "CcList.h"
+#include "CcDateTime.h"
+#include "CcSyncFileInfoList.h"
+#include "CcSyncDbClient.h"
+#include "Json/CcJsonObject.h"
+
+/**
+ * @brief Time and operations of one repetition of a case
+ */
+class CMicroBenchRun
+{
+public:
+  /**
+   * @brief Start time measurement, call it after preparations of case.
+   */
+  void start();
+  /**
+   * @brief Stop time measurement, call it before cleanup of case.
+   */
+  void stop();
+
+  uint64      uiOperations = 0;
+  uint64      uiTimeUs = 0;
+private:
+  CcDateTime  m_oStart;
+};
+
+class CMicroBench;
+
+//! Method of a case, it has to set operations of run and returns false on error
+typedef bool (CMicroBench::*FMicroBenchCase)(CMicroBenchRun& oRun);
+
+/**
+ * @brief Name and method of a case
+ */
+class CMicroBenchCase
+{
+public:
+  CcString        sName;
+  FMicroBenchCase pMethod = nullptr;
+};
+
+/**
+ * @brief Class impelmentation
+ */
+class CMicroBench
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CMicroBench( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CMicroBench( void );
+
+  /**
+   * @brief Read options from command line
+   * @return false if an option is unknown or incomplete
+   */
+  bool parseArguments(int argc, char **argv);
+  void printHelp();
+
+  /**
+   * @brief Create fixtures, run all selected cases, write result file and
+   *        compare with baseline if set.
+   * @return true if all cases succeeded and no regression was found
+   */
+  bool run();
+
+private:
+  void appendCase(const CcString& sName, FMicroBenchCase pMethod);
+  bool createFixtures();
+  void removeFixtures();
+  bool runCase(const CMicroBenchCase& oCase, CcJsonNode& oCases);
+  bool compareBaseline(CcJsonObject& oResult);
+  static CcSyncFileInfo createFileInfo(uint64 uiIndex, bool bIsFile);
+
+  bool benchFileInfoListFindName(CMicroBenchRun& oRun);
+  bool benchFileInfoListFindId(CMicroBenchRun& oRun);
+  bool benchFileInfoJsonEncode(CMicroBenchRun& oRun);
+  bool benchFileInfoJsonDecode(CMicroBenchRun& oRun);
+  bool benchResponseAddDirectoryInfoList(CMicroBenchRun& oRun);
+  bool benchResponseGetDirectoryInfoList(CMicroBenchRun& oRun);
+  bool benchDbFileListInsert(CMicroBenchRun& oRun);
+  bool benchDbGetFileInfoList(CMicroBenchRun& oRun);
+  bool benchDbDirectoryListUpdateChanged(CMicroBenchRun& oRun);
+  bool benchDbGetInnerPathById(CMicroBenchRun& oRun);
+
+private:
+  CcString  m_sWorkingDir;
+  CcString  m_sDatabaseFile;
+  CcString  m_sOutput;
+  CcString  m_sBaseline;
+  size_t    m_uiEntries;
+  size_t    m_uiDepth;
+  size_t    m_uiRepeat;
+  size_t    m_uiTolerance;
+  CcStringList              m_slFilter;
+  CcList<CMicroBenchCase>   m_oCases;
+
+  // Fixtures
+  CcSyncFileInfoList    m_oDirectoryList;
+  CcSyncFileInfoList    m_oFileList;
+  CcList<CcJsonObject>  m_oFileJsonList;
+  CcString              m_sResponseData;
+  CcSyncDbClientPointer m_pDatabase;
+  uint64                m_uiLeafDirId = 0;
+  size_t                m_uiInsertTables = 0;
+};
+
+#endif /* _CMicroBench_H_ */
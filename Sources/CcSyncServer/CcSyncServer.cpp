@@ -40,6 +40,8 @@
 #include "CcSyncVersion.h"
 #include "CcVersion.h"
 #include "CcConsole.h"
+#include "CcSyncTrace.h"
+#include "CcSyncDbProfiler.h"
 
 CcSyncServer::CcSyncServer(int pArgc, char **ppArgv) : 
   m_oArguments()
@@ -60,12 +62,7 @@ CcSyncServer::CcSyncServer(CcSyncServer&& oToMove)
 
 CcSyncServer::~CcSyncServer(void)
 {
-  m_oWorkerListLock.lock();
-  for (CcSyncServerWorker* pWorker : m_oWorkerList)
-  {
-    pWorker->stop();
-  }
-  m_oWorkerListLock.unlock();
+  m_oWorkerPool.stop();
 }
 
 void CcSyncServer::run()
@@ -162,7 +159,7 @@ void CcSyncServer::runServer()
   sConfigFile.appendPath(CcSyncGlobals::ConfigDirName);
   if (!CcDirectory::exists(sConfigFile))
   {
-    CcSyncLog::writeInfo("No configuration Directory on default config-directory");
+    CCSYNC_INFO("No configuration Directory on default config-directory");
     CcDirectory::create(sConfigFile, true);
   }
   else
@@ -183,6 +180,13 @@ void CcSyncServer::runServer()
   CCNEWTYPE(pSocket, CcSslSocket);
   m_oSocket = pSocket;
   static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->initServer();
+#ifdef CCSYNC_SSL_SESSION
+  // Accept only the TCP connection, handshake is done by CcSyncServerWorker
+  static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->setFinalizeAccept(false);
+  // Reconnecting clients are resuming their session instead of a full handshake
+  static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->setSessionCache(CcSyncGlobals::Server::SslSessionCacheSize,
+                                                                       CcSyncGlobals::Server::SslSessionTimeout);
+#endif
   int iTrue = 1;
 
   CcSocketAddressInfo oAddrInfo;
@@ -195,8 +199,11 @@ void CcSyncServer::runServer()
       static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->loadKeyFile(m_oConfig.getSslKeyFile()) &&
       static_cast<CcSslSocket*>(m_oSocket.getRawSocket())->loadCertificateFile(m_oConfig.getSslCertFile()))
   {
-    CcSyncLog::writeDebug("Server is listening on: " + CcString::fromNumber(m_oConfig.getPort()));
+    CCSYNC_DEBUG("Server is listening on: " + CcString::fromNumber(m_oConfig.getPort()));
     CcSyncLog::writeMessage(CcSyncGlobals::Server::Output::Started);
+    m_oBandwidth.setRate(m_oConfig.getBandwidth());
+    m_oWorkerPool.start(m_oConfig.getWorkers(), m_oConfig.getConnectionQueue());
+    m_oAccountCache.start();
     while (getThreadState() == EThreadState::Running)
     {
       if (m_oSocket.listen())
@@ -204,12 +211,14 @@ void CcSyncServer::runServer()
         ISocket* oTemp = m_oSocket.accept();
         if (oTemp != nullptr)
         {
-          CcSyncLog::writeDebug("Server recognized an incomming connection, starting thread");
-          CCNEWTYPE(oNewWorker, CcSyncServerWorker, this, oTemp);
-          m_oWorkerListLock.lock();
-          m_oWorkerList.append(oNewWorker);
-          m_oWorkerListLock.unlock();
-          oNewWorker->start();
+          CCSYNC_DEBUG("Server recognized an incomming connection, add to worker queue");
+          CCNEWTYPE(pConnection, CcSyncServerWorker, this, oTemp);
+          if (!m_oWorkerPool.append(pConnection))
+          {
+            CcSyncLog::writeWarning("Connection queue is full, connection closed", ESyncLogTarget::Server);
+            pConnection->close();
+            CCDELETE(pConnection);
+          }
         }
       }
       else
@@ -217,8 +226,23 @@ void CcSyncServer::runServer()
         CcSyncLog::writeError("Error on listening");
       }
     }
-    CcSyncLog::writeDebug("Server is going down");
+    CCSYNC_DEBUG("Server is going down");
+    m_oHandshakeLock.lock();
+    if (m_uiHandshakes > 0)
+    {
+      CCSYNC_INFO("TLS sessions resumed: " + CcString::fromNumber(m_uiResumed) + " of " + CcString::fromNumber(m_uiHandshakes) +
+                           " (" + CcString::fromNumber(m_uiResumed * 100 / m_uiHandshakes) + "%)");
+    }
+    m_oHandshakeLock.unlock();
     m_oSocket.close();
+    m_oWorkerPool.stop();
+    m_oAccountCache.stop();
+    CcSyncTrace::stop();
+    CCSYNC_DEBUG("Account cache hits: " + CcString::fromNumber(m_oAccountCache.getHits()) +
+                          ", misses: " + CcString::fromNumber(m_oAccountCache.getMisses()) +
+                          ", evictions: " + CcString::fromNumber(m_oAccountCache.getEvictions()));
+    CCSYNC_DEBUG("Transfers rejected by admission control: " + CcString::fromNumber(m_oAdmission.getRejected()));
+    CCSYNC_DEBUG("Requests processed: " + CcString::fromNumber(m_oStats.getRequests()));
   }
   else
   {
@@ -226,10 +250,62 @@ void CcSyncServer::runServer()
   }
 }
 
+void CcSyncServer::countHandshake(bool bResumed)
+{
+  m_oHandshakeLock.lock();
+  m_uiHandshakes++;
+  if (bResumed)
+  {
+    m_uiResumed++;
+  }
+  m_oHandshakeLock.unlock();
+}
+
+bool CcSyncServer::setTrace(bool bEnable)
+{
+  bool bRet = true;
+  if (bEnable)
+  {
+    CcString sTraceFile = m_sConfigDir;
+    sTraceFile.appendPath(CcSyncGlobals::ConfigDirName);
+    sTraceFile.appendPath(CcSyncGlobals::Server::TraceFileName);
+    bRet = CcSyncTrace::start(sTraceFile, "CcSyncServer");
+  }
+  else
+  {
+    CcSyncTrace::stop();
+  }
+  return bRet;
+}
+
+CcJsonObject CcSyncServer::getStats()
+{
+  CcJsonObject oStats;
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Uptime, static_cast<uint64>(CcKernel::getUpTime().getTimestampS())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::ConnectionsActive, static_cast<uint64>(m_oWorkerPool.getActiveCount())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::ConnectionsIdle, static_cast<uint64>(m_oWorkerPool.getIdleCount())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::ConnectionsWaiting, static_cast<uint64>(m_oWorkerPool.getWaitingCount())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::RequestsScheduled, static_cast<uint64>(m_oWorkerPool.getScheduledCount())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::TransfersRunning, static_cast<uint64>(m_oAdmission.getRunning())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::TransfersRejected, m_oAdmission.getRejected()));
+  m_oHandshakeLock.lock();
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Handshakes, m_uiHandshakes));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::HandshakesResumed, m_uiResumed));
+  m_oHandshakeLock.unlock();
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::AccountsLoaded, static_cast<uint64>(m_oAccountCache.getLoadedCount())));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::AccountCacheHits, m_oAccountCache.getHits()));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::AccountCacheMisses, m_oAccountCache.getMisses()));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::AccountCacheEvictions, m_oAccountCache.getEvictions()));
+  m_oStats.getJson(oStats);
+  // Statements are only available if profiler was enabled once
+  CcSyncDbProfiler::getJson(oStats);
+  return oStats;
+}
+
 void CcSyncServer::onStop()
 {
   m_oSocket.close();
-  CcSyncLog::writeDebug("Stop received");
+  CCSYNC_DEBUG("Stop received");
 }
 
 CcSyncServer& CcSyncServer::operator=(const CcSyncServer& oToCopy)
@@ -250,42 +326,32 @@ CcSyncServer& CcSyncServer::operator=(CcSyncServer&& oToMove)
 CcSyncUser CcSyncServer::loginUser(const CcString& sAccount, const CcString & sUserName, const CcString & sPassword)
 {
   CcString sToken;
-  for (const CcSyncServerAccount& rAccount : m_oConfig.getAccountList())
+  CcSyncServerAccountPointer pAccount = m_oConfig.findAccount(sAccount);
+  // @todo: Check for Additional Users
+  if (pAccount != nullptr &&
+      pAccount->getPassword().getString() == sPassword)
   {
-    if (rAccount.getName().compareInsensitve(sAccount))
+    sToken << pAccount->getName() << CcString::fromNumber(CcKernel::getDateTime().getTimestampUs());
+    CcMd5 oTokenGenerator;
+    oTokenGenerator.generate(sToken);
+    sToken = oTokenGenerator.getHexString();
+    if (m_oDatabase.userExistsInDatabase(sAccount, sUserName))
     {
-      // @todo: Check for Additional Users
-      if (rAccount.getPassword().getString() == sPassword )
+      if (false == m_oDatabase.updateUser(pAccount->getName(), pAccount->getName(), sToken))
       {
-        sToken << rAccount.getName() << CcString::fromNumber(CcKernel::getDateTime().getTimestampUs());
-        CcMd5 oTokenGenerator;
-        oTokenGenerator.generate(sToken);
-        sToken = oTokenGenerator.getHexString();
-        if (m_oDatabase.userExistsInDatabase(sAccount, sUserName))
-        {
-          if (false == m_oDatabase.updateUser(rAccount.getName(), rAccount.getName(), sToken))
-          {
-            sToken = "";
-          }
-          else
-          {
-            break;
-          }
-        }
-        else
-        {
-          if (false == m_oDatabase.insertUser(rAccount.getName(), rAccount.getName(), sToken))
-          {
-            sToken = "";
-          }
-          else
-          {
-            break;
-          }
-        }
+        sToken = "";
+      }
+    }
+    else
+    {
+      if (false == m_oDatabase.insertUser(pAccount->getName(), pAccount->getName(), sToken))
+      {
+        sToken = "";
       }
     }
   }
+  // Previous token of account was replaced in database
+  m_oSessions.removeAccount(sAccount);
   return getUserByToken(sToken);
 }
 
@@ -294,14 +360,20 @@ CcSyncUser CcSyncServer::getUserByToken(const CcString& sToken)
   CcSyncUser oUser;
   CcString sUsername;
   CcString sAccount;
-  if (m_oDatabase.getUserByToken(sToken, sAccount, sUsername))
+  // Cached session skips database of server, account is always opened by
+  // cache, so it stays in order of use and can be unloaded if idle.
+  bool bCached = m_oSessions.find(sToken, sAccount, sUsername);
+  if (bCached ||
+      m_oDatabase.getUserByToken(sToken, sAccount, sUsername))
   {
-    CcSyncServerAccount* pAccount = m_oConfig.findAccount(sUsername);
+    CcSyncServerAccountPointer pAccount = m_oConfig.findAccount(sUsername);
     if (pAccount != nullptr)
     {
       CcString sClientPath = m_oConfig.getLocation().getPath();
       sClientPath.appendPath(pAccount->getName());
-      CcSyncClientConfigPointer pClientConfig = pAccount->clientConfig(sClientPath);
+      CcSyncClientConfigPointer pClientConfig;
+      CcSyncDbClientPointer pClientDatabase;
+      m_oAccountCache.open(pAccount, sClientPath, pClientConfig, pClientDatabase);
       if (pClientConfig != nullptr)
       {
         CcSyncAccountConfigHandle pAccountConfig = pClientConfig->getAccountConfig(sAccount);
@@ -312,29 +384,32 @@ CcSyncUser CcSyncServer::getUserByToken(const CcString& sToken)
           {
             eRights = ESyncRights::Admin;
           }
-          CcSyncDbClientPointer pClientDatabase = pAccount->database(sClientPath);
           if (pClientDatabase != nullptr)
           {
             oUser = CcSyncUser(sToken, pClientConfig, pAccountConfig, pClientDatabase, eRights);
+            if (bCached == false)
+            {
+              m_oSessions.insert(sToken, sAccount, sUsername);
+            }
           }
           else
           {
-            CcSyncLog::writeDebug("User Database not found at " + sClientPath);
+            CCSYNC_DEBUG("User Database not found at " + sClientPath);
           }
         }
         else
         {
-          CcSyncLog::writeDebug("User not found in config " + sClientPath);
+          CCSYNC_DEBUG("User not found in config " + sClientPath);
         }
       }
       else
       {
-        CcSyncLog::writeDebug("User config not found at " + sClientPath);
+        CCSYNC_DEBUG("User config not found at " + sClientPath);
       }
     }
     else
     {
-      CcSyncLog::writeDebug("User not found in Database " + sAccount);
+      CCSYNC_DEBUG("User not found in Database " + sAccount);
     }
   }
   return oUser;
@@ -343,12 +418,14 @@ CcSyncUser CcSyncServer::getUserByToken(const CcString& sToken)
 CcSyncUser CcSyncServer::getUserByName(const CcString& sName)
 {
   CcSyncUser oUser;
-  CcSyncServerAccount* pAccount = m_oConfig.findAccount(sName);
+  CcSyncServerAccountPointer pAccount = m_oConfig.findAccount(sName);
   if (pAccount != nullptr)
   {
     CcString sClientPath = m_oConfig.getLocation().getPath();
     sClientPath.appendPath(pAccount->getName());
-    CcSyncClientConfigPointer pClientConfig = pAccount->clientConfig(sClientPath);
+    CcSyncClientConfigPointer pClientConfig;
+    CcSyncDbClientPointer pClientDatabase;
+    m_oAccountCache.open(pAccount, sClientPath, pClientConfig, pClientDatabase);
     if (pClientConfig != nullptr)
     {
       CcSyncAccountConfigHandle pAccountConfig = pClientConfig->getAccountConfig(sName);
@@ -359,24 +436,23 @@ CcSyncUser CcSyncServer::getUserByName(const CcString& sName)
         {
           eRights = ESyncRights::Admin;
         }
-        CcSyncDbClientPointer pClientDatabase = pAccount->database(sClientPath);
         if (pClientDatabase != nullptr)
         {
           oUser = CcSyncUser("", pClientConfig, pAccountConfig, pClientDatabase, eRights);
         }
         else
         {
-          CcSyncLog::writeDebug("User Database not found at " + sClientPath);
+          CCSYNC_DEBUG("User Database not found at " + sClientPath);
         }
       }
       else
       {
-        CcSyncLog::writeDebug("User not found in config " + sClientPath);
+        CCSYNC_DEBUG("User not found in config " + sClientPath);
       }
     }
     else
     {
-      CcSyncLog::writeDebug("User config not found at " + sClientPath);
+      CCSYNC_DEBUG("User config not found at " + sClientPath);
     }
   }
   return oUser;
@@ -387,16 +463,9 @@ CcVersion CcSyncServer::getVersion() const
   return CcSyncGlobals::Version;
 }
 
-void CcSyncServer::workerDone(CcSyncServerWorker* pWorker)
-{
-  m_oWorkerListLock.lock();
-  m_oWorkerList.removeItem(pWorker);
-  m_oWorkerListLock.unlock();
-}
-
 void CcSyncServer::shutdown()
 {
-  CcSyncLog::writeDebug("CcSyncServer shutdown received");
+  CCSYNC_DEBUG("CcSyncServer shutdown received");
   stop();
 }
 
@@ -412,7 +481,7 @@ bool CcSyncServer::createConfig()
   sConfigFile.appendPath(CcSyncGlobals::ConfigDirName);
   if (!CcDirectory::exists(sConfigFile))
   {
-    CcSyncLog::writeInfo("No configuration Directory on default location");
+    CCSYNC_INFO("No configuration Directory on default location");
     if (!CcDirectory::create(sConfigFile, true))
     {
       CcSyncConsole::writeLine("Configuration Directory could not be created");
@@ -591,17 +660,23 @@ bool CcSyncServer::setupDatabase()
 bool CcSyncServer::createAccount(const CcString& sUsername, const CcString& sPassword, bool bAdmin)
 {
   bool bRet = true;
+  bool bAdded;
   if(bAdmin)
-    m_oConfig.addAdminAccount(sUsername, sPassword);
+    bAdded = m_oConfig.addAdminAccount(sUsername, sPassword);
   else
-    m_oConfig.addAccount(sUsername, sPassword);
+    bAdded = m_oConfig.addAccount(sUsername, sPassword);
+  if (bAdded == false)
+  {
+    CcSyncLog::writeWarning("Account already exists: " + sUsername, ESyncLogTarget::Server);
+    return false;
+  }
   const CcSyncServerLocationConfig& oLocation = m_oConfig.getLocation();
   CcString sPath = oLocation.getPath();
   sPath.appendPath(sUsername);
   if (CcDirectory::exists(sPath) ||
       CcDirectory::create(sPath, true))
   {
-    CcSyncLog::writeInfo("Accountpath created " + sPath);
+    CCSYNC_INFO("Accountpath created " + sPath);
   }
   else
   {
@@ -612,5 +687,11 @@ bool CcSyncServer::createAccount(const CcString& sUsername, const CcString& sPas
 
 bool CcSyncServer::removeAccount(const CcString& sUsername)
 {
-  return m_oConfig.removeAccount(sUsername);;
+  m_oSessions.removeAccount(sUsername);
+  CcSyncServerAccountPointer pAccount = m_oConfig.findAccount(sUsername);
+  if (pAccount != nullptr)
+  {
+    m_oAccountCache.remove(pAccount);
+  }
+  return m_oConfig.removeAccount(sUsername);
 }
@@ -37,14 +37,18 @@
 #include "CcApp.h"
 #include "CcSyncDbServer.h"
 #include "CcSyncServerAccount.h"
+#include "CcSyncUser.h"
 #include "CcSslSocket.h"
 #include "Network/CcSocket.h"
 #include "CcArguments.h"
-#include "CcList.h"
+#include "CcSyncServerWorkerPool.h"
+#include "CcSyncServerSessions.h"
+#include "CcSyncServerAccountCache.h"
+#include "CcSyncServerAdmission.h"
+#include "CcSyncServerBandwidth.h"
+#include "CcSyncServerStats.h"
 #include "CcMutex.h"
 
-class CcSyncServerWorker;
-
 /**
  * @brief Class impelmentation
  */
@@ -83,10 +87,28 @@ public:
   CcSyncDbServer& database()
     { return m_oDatabase; }
 
+  CcSyncServerAdmission& admission()
+    { return m_oAdmission; }
+
+  CcSyncServerBandwidth& bandwidth()
+    { return m_oBandwidth; }
+
+  CcSyncServerStats& stats()
+    { return m_oStats; }
+
+  /**
+   * @brief Get counters of requests together with current state of
+   *        connections and transfers, reported by ServerGetStats.
+   */
+  CcJsonObject getStats();
+
   CcSyncServer& operator=(const CcSyncServer& oToCopy);
   CcSyncServer& operator=(CcSyncServer&& oToMove);
   CcSyncUser loginUser(const CcString& sAccount, const CcString& sUserName, const CcString& sPassword);
 
+  /**
+   * @brief Resolve user of session, resolved sessions are cached.
+   */
   CcSyncUser getUserByToken(const CcString& sToken);
   CcSyncUser getUserByName(const CcString& sName);
 
@@ -95,9 +117,21 @@ public:
 
   virtual CcVersion getVersion() const override;
 
-  void workerDone(CcSyncServerWorker* pWorker);
   void shutdown();
 
+  /**
+   * @brief Count finished TLS handshake for resumption hit rate.
+   * @param bResumed: true if session was resumed from cache
+   */
+  void countHandshake(bool bResumed);
+
+  /**
+   * @brief Start or stop tracing, trace is written to Server::TraceFileName
+   *        in config directory.
+   * @return false if trace file could not be opened
+   */
+  bool setTrace(bool bEnable);
+
   bool createConfig();
   bool createAccount(const CcString& sUsername, const CcString& sPassword, bool bAdmin);
   bool removeAccount(const CcString& sUsername);
@@ -113,8 +147,15 @@ private:
   CcSyncServerConfig          m_oConfig;
   CcSyncDbServer              m_oDatabase;
   CcSocket                    m_oSocket;
-  CcList<CcSyncServerWorker*> m_oWorkerList;
-  CcMutex                     m_oWorkerListLock;
+  CcSyncServerWorkerPool      m_oWorkerPool;
+  CcSyncServerSessions        m_oSessions;
+  CcSyncServerAccountCache    m_oAccountCache;
+  CcSyncServerAdmission       m_oAdmission;
+  CcSyncServerBandwidth       m_oBandwidth;
+  CcSyncServerStats           m_oStats;
+  CcMutex                     m_oHandshakeLock;
+  uint64                      m_uiHandshakes = 0;
+  uint64                      m_uiResumed = 0;
 };
 
 #endif /* _CcSyncServer_H_ */
@@ -38,6 +38,8 @@
 #include "CcSyncLog.h"
 #include "CcSyncDbClient.h"
 #include "CcSyncConsole.h"
+#include "CcSyncServerReaderPool.h"
+#include "CcSyncDirectory.h"
 
 CcSyncServerAccount::CcSyncServerAccount(const CcString& sName, const CcString& sPassword, bool bAdmin) :
   m_bIsAdmin(bAdmin),
@@ -59,6 +61,22 @@ CcSyncServerAccount::CcSyncServerAccount(CcXmlNode& pAccountNode)
     {
       m_bIsAdmin = CcXmlUtil::getBoolFromNodeValue(pAdmin, false);
     }
+    CcXmlNode& pBandwidth = pAccountNode.getNode(CcSyncGlobals::Server::ConfigTags::AccountBandwidth);
+    if (pBandwidth.isNotNull())
+    {
+      bool bOk = false;
+      uint64 uiBandwidth = pBandwidth.innerText().toUint64(&bOk);
+      if (bOk)
+        m_uiBandwidth = uiBandwidth;
+    }
+    CcXmlNode& pWeight = pAccountNode.getNode(CcSyncGlobals::Server::ConfigTags::AccountWeight);
+    if (pWeight.isNotNull())
+    {
+      bool bOk = false;
+      uint32 uiWeight = pWeight.innerText().toUint32(&bOk);
+      if (bOk && uiWeight > 0)
+        m_uiWeight = uiWeight;
+    }
     CcXmlNode pPasswordNode = pAccountNode.getNode(CcSyncGlobals::Server::ConfigTags::AccountPassword);
     if (pPasswordNode.isNotNull())
     {
@@ -87,7 +105,10 @@ CcSyncServerAccount& CcSyncServerAccount::operator=(const CcSyncServerAccount& o
   m_sName = oToCopy.m_sName;
   m_oPassword = oToCopy.m_oPassword;
   m_pDatabase = oToCopy.m_pDatabase;
+  m_pReaders = oToCopy.m_pReaders;
   m_pClientConfig = oToCopy.m_pClientConfig;
+  m_uiBandwidth = oToCopy.m_uiBandwidth;
+  m_uiWeight = oToCopy.m_uiWeight;
   m_bIsAdmin = oToCopy.m_bIsAdmin;
   m_bIsValid = oToCopy.m_bIsValid;
   return *this;
@@ -101,6 +122,9 @@ CcSyncServerAccount& CcSyncServerAccount::operator=(CcSyncServerAccount&& oToMov
     m_oPassword = std::move(oToMove.m_oPassword);
     m_pClientConfig = oToMove.m_pClientConfig;
     m_pDatabase = oToMove.m_pDatabase;
+    m_pReaders = oToMove.m_pReaders;
+    m_uiBandwidth = oToMove.m_uiBandwidth;
+    m_uiWeight = oToMove.m_uiWeight;
     m_bIsAdmin = oToMove.m_bIsAdmin;
     m_bIsValid = oToMove.m_bIsValid;
   }
@@ -108,6 +132,46 @@ CcSyncServerAccount& CcSyncServerAccount::operator=(CcSyncServerAccount&& oToMov
 }
 
 CcSyncClientConfigPointer CcSyncServerAccount::clientConfig(const CcString& sClientLocation)
+{
+  m_oLock.lock();
+  CcSyncClientConfigPointer pClientConfig = loadClientConfig(sClientLocation);
+  m_oLock.unlock();
+  return pClientConfig;
+}
+
+CcSyncDbClientPointer CcSyncServerAccount::database(const CcString& sClientLocation)
+{
+  m_oLock.lock();
+  CcSyncDbClientPointer pDatabase = loadDatabase(sClientLocation);
+  m_oLock.unlock();
+  return pDatabase;
+}
+
+CcSyncDbClientPointer CcSyncServerAccount::acquireReader(const CcString& sClientLocation)
+{
+  CcSyncDbClientPointer pReader;
+  m_oLock.lock();
+  if (loadDatabase(sClientLocation) != nullptr &&
+      m_pReaders != nullptr)
+  {
+    pReader = m_pReaders->acquire();
+  }
+  m_oLock.unlock();
+  return pReader;
+}
+
+void CcSyncServerAccount::releaseReader(CcSyncDbClientPointer& pReader)
+{
+  m_oLock.lock();
+  if (m_pReaders != nullptr)
+  {
+    m_pReaders->release(pReader);
+  }
+  m_oLock.unlock();
+  pReader = nullptr;
+}
+
+CcSyncClientConfigPointer CcSyncServerAccount::loadClientConfig(const CcString& sClientLocation)
 {
   if (m_pClientConfig == nullptr)
   {
@@ -134,17 +198,17 @@ CcSyncClientConfigPointer CcSyncServerAccount::clientConfig(const CcString& sCli
     }
     else
     {
-      CcSyncLog::writeDebug("Client config dir not found and not created.", ESyncLogTarget::Server);
+      CCSYNC_DEBUG("Client config dir not found and not created.", ESyncLogTarget::Server);
     }
   }
   return m_pClientConfig;
 }
 
-CcSyncDbClientPointer CcSyncServerAccount::database(const CcString& sClientLocation)
+CcSyncDbClientPointer CcSyncServerAccount::loadDatabase(const CcString& sClientLocation)
 {
   if (m_pDatabase == nullptr)
   {
-    if (clientConfig(sClientLocation) != nullptr)
+    if (loadClientConfig(sClientLocation) != nullptr)
     {
       CCNEW(m_pDatabase, CcSyncDbClient);
       m_pDatabase->historyEnable();
@@ -152,6 +216,11 @@ CcSyncDbClientPointer CcSyncServerAccount::database(const CcString& sClientLocat
       sConfigFilePath.appendPath(CcSyncGlobals::Client::DatabaseFileName);
       if (m_pDatabase->openDatabase(sConfigFilePath))
       {
+        if (m_pDatabase->enableWriteAheadLog())
+        {
+          CCNEW(m_pReaders, CcSyncServerReaderPool, sConfigFilePath);
+        }
+        reconcileJournal();
         return m_pDatabase;
       }
     }
@@ -159,6 +228,40 @@ CcSyncDbClientPointer CcSyncServerAccount::database(const CcString& sClientLocat
   return m_pDatabase;
 }
 
+void CcSyncServerAccount::reconcileJournal()
+{
+  CcSyncAccountConfigHandle pAccountConfig = m_pClientConfig->getAccountConfig(m_sName);
+  if (pAccountConfig != nullptr)
+  {
+    m_pDatabase->lock();
+    for (CcSyncDirectoryConfig& oDirectoryConfig : pAccountConfig->directoryList())
+    {
+      CcSyncDirectory oDirectory;
+      oDirectory.init(m_pDatabase, &oDirectoryConfig);
+      oDirectory.journalReconcile();
+    }
+    m_pDatabase->unlock();
+  }
+}
+
+bool CcSyncServerAccount::unload()
+{
+  bool bRet = false;
+  m_oLock.lock();
+  // No user is holding config or database if account is the only owner
+  if ((m_pDatabase == nullptr || m_pDatabase.getReferenceCount() == 1) &&
+      (m_pClientConfig == nullptr || m_pClientConfig.getReferenceCount() == 1) &&
+      (m_pReaders == nullptr || m_pReaders->isIdle()))
+  {
+    m_pReaders = nullptr;
+    m_pDatabase = nullptr;
+    m_pClientConfig = nullptr;
+    bRet = true;
+  }
+  m_oLock.unlock();
+  return bRet;
+}
+
 bool CcSyncServerAccount::writeConfig(CcXmlNode& oNode)
 {
   CcXmlNode oAccountNode(CcSyncGlobals::Server::ConfigTags::Account);
@@ -171,6 +274,18 @@ bool CcSyncServerAccount::writeConfig(CcXmlNode& oNode)
   oAccountNode.append(std::move(oAccountNodeName));
   oAccountNode.append(std::move(oAccountNodePassword));
   oAccountNode.append(std::move(oAccountNodeAdmin));
+  if (m_uiBandwidth > 0)
+  {
+    CcXmlNode oAccountNodeBandwidth(CcSyncGlobals::Server::ConfigTags::AccountBandwidth);
+    oAccountNodeBandwidth.setInnerText(CcString::fromNumber(m_uiBandwidth));
+    oAccountNode.append(std::move(oAccountNodeBandwidth));
+  }
+  if (m_uiWeight != 1)
+  {
+    CcXmlNode oAccountNodeWeight(CcSyncGlobals::Server::ConfigTags::AccountWeight);
+    oAccountNodeWeight.setInnerText(CcString::fromNumber(m_uiWeight));
+    oAccountNode.append(std::move(oAccountNodeWeight));
+  }
   oNode.append(std::move(oAccountNode));
   return true;
 }
@@ -37,6 +37,10 @@
 #include "CcPassword.h"
 #include "CcSyncDbClient.h"
 #include "CcSyncClientConfig.h"
+#include "CcSharedPointer.h"
+#include "CcMutex.h"
+
+class CcSyncServerReaderPool;
 
 class CcXmlNode;
 class CcSyncServerAccount;
@@ -72,21 +76,63 @@ public:
     { return m_bIsAdmin; }
 
   CcSyncClientConfigPointer clientConfig(const CcString& sClientLocation);
+  /**
+   * @brief Get writing connection to database of account.
+   *        Loading and readers are guarded by lock of account, because
+   *        all workers of account are sharing this object.
+   */
   CcSyncDbClientPointer database(const CcString& sClientLocation);
+  /**
+   * @brief Get read only connection to database of account.
+   * @return Reader or nullptr if no reader is available, use database then.
+   */
+  CcSyncDbClientPointer acquireReader(const CcString& sClientLocation);
+  void releaseReader(CcSyncDbClientPointer& pReader);
+  /**
+   * @brief Close client config and database if they are not used anymore,
+   *        no user holds them and all readers are returned.
+   * @return true if account is unloaded
+   */
+  bool unload();
   bool writeConfig(CcXmlNode& oParent);
 
   inline const CcString& getName() const
     { return m_sName; }
   inline const CcPassword& getPassword() const
     { return m_oPassword; }
+  /**
+   * @brief Get rate limit of all transfers of account in bytes per second,
+   *        0 if only limited by global rate.
+   */
+  inline uint64 getBandwidth() const
+    { return m_uiBandwidth; }
+  /**
+   * @brief Get share of global rate compared to other active accounts.
+   */
+  inline uint32 getWeight() const
+    { return m_uiWeight; }
+
+private:
+  CcSyncClientConfigPointer loadClientConfig(const CcString& sClientLocation);
+  CcSyncDbClientPointer loadDatabase(const CcString& sClientLocation);
+  /**
+   * @brief Complete changes of all directories wich were interrupted,
+   *        called after database is opened before any worker is using it.
+   */
+  void reconcileJournal();
 
 private:
   bool                  m_bIsAdmin = false;
   CcString              m_sName;
   CcPassword            m_oPassword;
+  uint64                m_uiBandwidth = 0;
+  uint32                m_uiWeight = 1;
   CcSyncClientConfigPointer   m_pClientConfig = nullptr;
   CcSyncDbClientPointer       m_pDatabase = nullptr;
+  CcSharedPointer<CcSyncServerReaderPool> m_pReaders = nullptr;
   bool                        m_bIsValid = false;
+  //! Not copied, each object guards its own pointers
+  CcMutex                     m_oLock;
 };
 
 #endif /* _CcSyncServerAccount_H_ */
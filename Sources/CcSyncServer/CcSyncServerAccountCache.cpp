@@ -0,0 +1,233 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerAccountCache
+ */
+#include "CcSyncServerAccountCache.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+#include "CcKernel.h"
+
+//! Time in ms between two checks for idle accounts
+#define CcSyncServerAccountCache_CheckTime 1000
+
+CcSyncServerAccountCache::CcSyncServerAccountCache(void)
+{
+}
+
+CcSyncServerAccountCache::~CcSyncServerAccountCache(void)
+{
+  stop();
+  while (isInProgress())
+  {
+    CcKernel::sleep(10);
+  }
+  while (m_pOldest != nullptr)
+  {
+    CEntry* pEntry = m_pOldest;
+    unlink(pEntry);
+    CCDELETE(pEntry);
+  }
+}
+
+bool CcSyncServerAccountCache::open(CcSyncServerAccountPointer& pAccount, const CcString& sClientPath,
+                                    CcSyncClientConfigPointer& pClientConfig, CcSyncDbClientPointer& pDatabase)
+{
+  // Load without lock of cache, account is locking itself. Returned
+  // pointers are keeping account in use, so it can not be evicted until
+  // entry is updated.
+  pClientConfig = pAccount->clientConfig(sClientPath);
+  pDatabase = pAccount->database(sClientPath);
+  uint64 uiKey = getKey(pAccount);
+  m_oLock.lock();
+  CEntry** ppEntry = m_oEntries.find(uiKey);
+  CEntry* pEntry;
+  if (ppEntry != nullptr)
+  {
+    m_uiHits++;
+    pEntry = *ppEntry;
+    unlink(pEntry);
+  }
+  else
+  {
+    m_uiMisses++;
+    CCNEW(pEntry, CEntry);
+    pEntry->pAccount = pAccount;
+    m_oEntries.set(uiKey, pEntry);
+  }
+  pEntry->oLastUsed = CcKernel::getUpTime();
+  link(pEntry);
+  bool bEvict = m_oEntries.size() > CcSyncGlobals::Server::AccountCacheSize;
+  m_oLock.unlock();
+  if (bEvict)
+  {
+    evict(CcSyncGlobals::Server::AccountCacheSize, false);
+  }
+  return pClientConfig != nullptr && pDatabase != nullptr;
+}
+
+void CcSyncServerAccountCache::remove(const CcSyncServerAccountPointer& pAccount)
+{
+  CEntry* pEntry = nullptr;
+  m_oLock.lock();
+  if (m_oEntries.take(getKey(pAccount), pEntry))
+  {
+    unlink(pEntry);
+  }
+  m_oLock.unlock();
+  CCDELETE(pEntry);
+}
+
+size_t CcSyncServerAccountCache::getLoadedCount()
+{
+  m_oLock.lock();
+  size_t uiCount = m_oEntries.size();
+  m_oLock.unlock();
+  return uiCount;
+}
+
+uint64 CcSyncServerAccountCache::getHits()
+{
+  m_oLock.lock();
+  uint64 uiCount = m_uiHits;
+  m_oLock.unlock();
+  return uiCount;
+}
+
+uint64 CcSyncServerAccountCache::getMisses()
+{
+  m_oLock.lock();
+  uint64 uiCount = m_uiMisses;
+  m_oLock.unlock();
+  return uiCount;
+}
+
+uint64 CcSyncServerAccountCache::getEvictions()
+{
+  m_oLock.lock();
+  uint64 uiCount = m_uiEvictions;
+  m_oLock.unlock();
+  return uiCount;
+}
+
+void CcSyncServerAccountCache::run()
+{
+  while (getThreadState() == EThreadState::Running)
+  {
+    evict(0, true);
+    CcKernel::sleep(CcSyncServerAccountCache_CheckTime);
+  }
+}
+
+void CcSyncServerAccountCache::evict(size_t uiMaxLoaded, bool bIdleOnly)
+{
+  // Take candidates out of list, so they are unloaded without lock
+  CcList<CEntry*> oCandidates;
+  CcDateTime oNow = CcKernel::getUpTime();
+  m_oLock.lock();
+  while (m_pOldest != nullptr &&
+         m_oEntries.size() > uiMaxLoaded)
+  {
+    if (bIdleOnly &&
+        (oNow - m_pOldest->oLastUsed).getTimestampS() < static_cast<int64>(CcSyncGlobals::Server::AccountIdleTime))
+    {
+      // Following entries were used even later
+      break;
+    }
+    CEntry* pEntry = m_pOldest;
+    unlink(pEntry);
+    m_oEntries.remove(getKey(pEntry->pAccount));
+    oCandidates.append(pEntry);
+  }
+  m_oLock.unlock();
+  CcList<CEntry*> oInUse;
+  for (CEntry* pEntry : oCandidates)
+  {
+    if (pEntry->pAccount->unload())
+    {
+      CCSYNC_DEBUG("Account unloaded: " + pEntry->pAccount->getName(), ESyncLogTarget::Server);
+      CCDELETE(pEntry);
+    }
+    else
+    {
+      // Still in use by a connection
+      oInUse.append(pEntry);
+    }
+  }
+  m_oLock.lock();
+  m_uiEvictions += oCandidates.size() - oInUse.size();
+  // Return entries in use as least recently used, keep their order
+  for (size_t uiPos = oInUse.size(); uiPos > 0; uiPos--)
+  {
+    CEntry* pEntry = oInUse[uiPos - 1];
+    uint64 uiKey = getKey(pEntry->pAccount);
+    if (m_oEntries.contains(uiKey))
+    {
+      // Opened again meanwhile with a new entry
+      CCDELETE(pEntry);
+    }
+    else
+    {
+      m_oEntries.set(uiKey, pEntry);
+      pEntry->pNext = m_pOldest;
+      if (m_pOldest != nullptr)
+        m_pOldest->pPrevious = pEntry;
+      else
+        m_pNewest = pEntry;
+      m_pOldest = pEntry;
+    }
+  }
+  m_oLock.unlock();
+}
+
+void CcSyncServerAccountCache::link(CEntry* pEntry)
+{
+  // Most recently used entry is last
+  pEntry->pPrevious = m_pNewest;
+  pEntry->pNext = nullptr;
+  if (m_pNewest != nullptr)
+    m_pNewest->pNext = pEntry;
+  else
+    m_pOldest = pEntry;
+  m_pNewest = pEntry;
+}
+
+void CcSyncServerAccountCache::unlink(CEntry* pEntry)
+{
+  if (pEntry->pPrevious != nullptr)
+    pEntry->pPrevious->pNext = pEntry->pNext;
+  else
+    m_pOldest = pEntry->pNext;
+  if (pEntry->pNext != nullptr)
+    pEntry->pNext->pPrevious = pEntry->pPrevious;
+  else
+    m_pNewest = pEntry->pPrevious;
+  pEntry->pPrevious = nullptr;
+  pEntry->pNext = nullptr;
+}
+
+uint64 CcSyncServerAccountCache::getKey(const CcSyncServerAccountPointer& pAccount)
+{
+  return static_cast<uint64>(reinterpret_cast<uintptr_t>(pAccount.ptr()));
+}
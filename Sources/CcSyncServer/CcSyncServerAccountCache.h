@@ -0,0 +1,121 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerAccountCache
+ *
+ * @page      CcSyncServerAccountCache
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerAccountCache
+ *
+ *  Least recently used list of accounts with opened client config and
+ *  database. Accounts are unloaded if they were not used for
+ *  Server::AccountIdleTime seconds or if more than Server::AccountCacheSize
+ *  accounts are loaded. Accounts wich are still referenced by a user are
+ *  never unloaded, so a database is never opened twice. Cached sessions
+ *  are not holding a user, idle connections are dropping it after
+ *  Server::AccountIdleTime seconds, see CcSyncServerReactor.
+ *  Entries are found by hash of account and linked in order of use, so
+ *  open does not search. Loading and unloading is done without lock of
+ *  cache, only the account itself is locked meanwhile.
+ **/
+#ifndef _CcSyncServerAccountCache_H_
+#define _CcSyncServerAccountCache_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "IThread.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcDateTime.h"
+#include "CcSyncServerAccountRegistry.h"
+#include "CcSyncHashMap.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerAccountCache : public IThread
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerAccountCache( void );
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~CcSyncServerAccountCache( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerAccountCache)
+
+  /**
+   * @brief Get client config and database of account, load them if required.
+   * @param pAccount:      Account to open
+   * @param sClientPath:   Location of client config and database
+   * @param pClientConfig: Target for client config
+   * @param pDatabase:     Target for database
+   * @return true if both are available
+   */
+  bool open(CcSyncServerAccountPointer& pAccount, const CcString& sClientPath,
+            CcSyncClientConfigPointer& pClientConfig, CcSyncDbClientPointer& pDatabase);
+
+  /**
+   * @brief Remove account from cache, it will be unloaded if unused.
+   */
+  void remove(const CcSyncServerAccountPointer& pAccount);
+
+  size_t getLoadedCount();
+  uint64 getHits();
+  uint64 getMisses();
+  uint64 getEvictions();
+
+private:
+  /**
+   * @brief Loaded account with time of last use,
+   *        linked from least to most recently used.
+   */
+  class CEntry
+  {
+  public:
+    CcSyncServerAccountPointer pAccount;
+    CcDateTime                 oLastUsed;
+    CEntry*                    pPrevious = nullptr;
+    CEntry*                    pNext = nullptr;
+  };
+
+  void run() override;
+  void evict(size_t uiMaxLoaded, bool bIdleOnly);
+  void link(CEntry* pEntry);
+  void unlink(CEntry* pEntry);
+  static uint64 getKey(const CcSyncServerAccountPointer& pAccount);
+
+private:
+  CcSyncHashMap<uint64, CEntry*> m_oEntries;
+  CEntry*         m_pOldest = nullptr;
+  CEntry*         m_pNewest = nullptr;
+  CcMutex         m_oLock;
+  uint64          m_uiHits = 0;
+  uint64          m_uiMisses = 0;
+  uint64          m_uiEvictions = 0;
+};
+
+#endif /* _CcSyncServerAccountCache_H_ */
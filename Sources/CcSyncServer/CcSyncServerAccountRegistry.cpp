@@ -0,0 +1,110 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerAccountRegistry
+ */
+#include "CcSyncServerAccountRegistry.h"
+
+CcSyncServerAccountRegistry::CcSyncServerAccountRegistry(void)
+{
+}
+
+CcSyncServerAccountRegistry::~CcSyncServerAccountRegistry(void)
+{
+}
+
+bool CcSyncServerAccountRegistry::append(const CcSyncServerAccount& oAccount)
+{
+  bool bRet = false;
+  CcString sKey = getKey(oAccount.getName());
+  m_oLock.lock();
+  if (m_oIndex.contains(sKey) == false)
+  {
+    CCNEWTYPE(pNewAccount, CcSyncServerAccount, oAccount);
+    CcSyncServerAccountPointer pAccount = pNewAccount;
+    m_oIndex.set(sKey, pAccount);
+    m_oAccounts.append(pAccount);
+    bRet = true;
+  }
+  m_oLock.unlock();
+  return bRet;
+}
+
+CcSyncServerAccountPointer CcSyncServerAccountRegistry::find(const CcString& sName)
+{
+  CcSyncServerAccountPointer pFound;
+  CcString sKey = getKey(sName);
+  m_oLock.lock();
+  CcSyncServerAccountPointer* pAccount = m_oIndex.find(sKey);
+  if (pAccount != nullptr)
+  {
+    pFound = *pAccount;
+  }
+  m_oLock.unlock();
+  return pFound;
+}
+
+bool CcSyncServerAccountRegistry::remove(const CcString& sName)
+{
+  bool bRet = false;
+  CcString sKey = getKey(sName);
+  CcSyncServerAccountPointer pAccount;
+  m_oLock.lock();
+  if (m_oIndex.take(sKey, pAccount))
+  {
+    m_oAccounts.removeItem(pAccount);
+    bRet = true;
+  }
+  m_oLock.unlock();
+  return bRet;
+}
+
+CcSyncServerAccountPointerList CcSyncServerAccountRegistry::getList()
+{
+  m_oLock.lock();
+  CcSyncServerAccountPointerList oList = m_oAccounts;
+  m_oLock.unlock();
+  return oList;
+}
+
+size_t CcSyncServerAccountRegistry::size()
+{
+  m_oLock.lock();
+  size_t uiSize = m_oAccounts.size();
+  m_oLock.unlock();
+  return uiSize;
+}
+
+void CcSyncServerAccountRegistry::clear()
+{
+  m_oLock.lock();
+  m_oAccounts.clear();
+  m_oIndex.clear();
+  m_oLock.unlock();
+}
+
+CcString CcSyncServerAccountRegistry::getKey(const CcString& sName)
+{
+  return sName.getLower();
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerAccountRegistry
+ *
+ * @page      CcSyncServerAccountRegistry
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerAccountRegistry
+ *
+ *  Accounts of server indexed by a hash of their lower case name.
+ *  All methods are locked, so accounts can be added and removed while
+ *  workers are looking them up. Found accounts are shared pointers and
+ *  stay valid for the caller even if they get removed meanwhile.
+ **/
+#ifndef _CcSyncServerAccountRegistry_H_
+#define _CcSyncServerAccountRegistry_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcSharedPointer.h"
+#include "CcSyncServerAccount.h"
+#include "CcSyncHashMap.h"
+
+typedef CcSharedPointer<CcSyncServerAccount> CcSyncServerAccountPointer;
+typedef CcList<CcSyncServerAccountPointer> CcSyncServerAccountPointerList;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerAccountRegistry
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerAccountRegistry( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerAccountRegistry( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerAccountRegistry)
+
+  /**
+   * @brief Add account to registry.
+   * @return false if an account with same name, ignoring case, exists
+   */
+  bool append(const CcSyncServerAccount& oAccount);
+
+  /**
+   * @brief Find account by name, case is ignored.
+   * @return Found account or nullptr
+   */
+  CcSyncServerAccountPointer find(const CcString& sName);
+
+  /**
+   * @brief Remove account by name, case is ignored.
+   * @return true if account was found
+   */
+  bool remove(const CcString& sName);
+
+  /**
+   * @brief Get all accounts in order of insertion.
+   */
+  CcSyncServerAccountPointerList getList();
+
+  size_t size();
+  void clear();
+
+private:
+  static CcString getKey(const CcString& sName);
+
+private:
+  CcSyncHashMap<CcString, CcSyncServerAccountPointer> m_oIndex;
+  CcSyncServerAccountPointerList                      m_oAccounts;
+  CcMutex                                             m_oLock;
+};
+
+#endif /* _CcSyncServerAccountRegistry_H_ */
@@ -0,0 +1,113 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerAdmission
+ */
+#include "CcSyncServerAdmission.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+
+CcSyncServerAdmission::CcSyncServerAdmission(void)
+{
+}
+
+CcSyncServerAdmission::~CcSyncServerAdmission(void)
+{
+}
+
+bool CcSyncServerAdmission::acquire(const CcString& sAccount)
+{
+  bool bRet = false;
+  CcString sKey = sAccount.getLower();
+  m_oLock.lock();
+  size_t uiAccountRunning = 0;
+  if (m_oAccounts.containsKey(sKey))
+    uiAccountRunning = m_oAccounts.getValue(sKey);
+  if (m_uiRunning < CcSyncGlobals::Server::MaxTransfers &&
+      uiAccountRunning < CcSyncGlobals::Server::MaxAccountTransfers)
+  {
+    m_uiRunning++;
+    if (uiAccountRunning == 0)
+      m_oAccounts.append(sKey, 1);
+    else
+      m_oAccounts.getValue(sKey)++;
+    m_uiRejectedInRow = 0;
+    bRet = true;
+  }
+  else
+  {
+    m_uiRejected++;
+    m_uiRejectedInRow++;
+  }
+  m_oLock.unlock();
+  if (bRet == false)
+  {
+    CCSYNC_DEBUG("Transfer of " + sAccount + " rejected, server busy", ESyncLogTarget::Server);
+  }
+  return bRet;
+}
+
+void CcSyncServerAdmission::release(const CcString& sAccount)
+{
+  CcString sKey = sAccount.getLower();
+  m_oLock.lock();
+  if (m_oAccounts.containsKey(sKey))
+  {
+    size_t& uiAccountRunning = m_oAccounts.getValue(sKey);
+    if (uiAccountRunning > 1)
+      uiAccountRunning--;
+    else
+      m_oAccounts.removeKey(sKey);
+    m_uiRunning--;
+  }
+  m_oLock.unlock();
+}
+
+uint64 CcSyncServerAdmission::getRetryAfter()
+{
+  m_oLock.lock();
+  // Spread retries of many waiting clients, but keep them near to the limit
+  uint64 uiRetryAfter = CcSyncGlobals::Server::TransferRetryAfter +
+                        m_uiRejectedInRow / CcSyncGlobals::Server::MaxTransfers;
+  m_oLock.unlock();
+  if (uiRetryAfter > CcSyncGlobals::Server::TransferRetryAfterMax)
+    uiRetryAfter = CcSyncGlobals::Server::TransferRetryAfterMax;
+  return uiRetryAfter;
+}
+
+size_t CcSyncServerAdmission::getRunning()
+{
+  m_oLock.lock();
+  size_t uiRunning = m_uiRunning;
+  m_oLock.unlock();
+  return uiRunning;
+}
+
+uint64 CcSyncServerAdmission::getRejected()
+{
+  m_oLock.lock();
+  uint64 uiRejected = m_uiRejected;
+  m_oLock.unlock();
+  return uiRejected;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerAdmission
+ *
+ * @page      CcSyncServerAdmission
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerAdmission
+ *
+ *  Limits number of file transfers running at the same time, over all
+ *  accounts by Server::MaxTransfers and for each account by
+ *  Server::MaxAccountTransfers. Rejected transfers are answered with a
+ *  busy response, so metadata requests of other accounts are still served.
+ **/
+#ifndef _CcSyncServerAdmission_H_
+#define _CcSyncServerAdmission_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcMap.h"
+#include "CcMutex.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerAdmission
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerAdmission( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerAdmission( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerAdmission)
+
+  /**
+   * @brief Reserve place for a transfer of account.
+   * @param sAccount: Name of account
+   * @return true if transfer can start, it has to be released afterwards
+   */
+  bool acquire(const CcString& sAccount);
+
+  /**
+   * @brief Release place from a successfull acquire.
+   * @param sAccount: Name of account
+   */
+  void release(const CcString& sAccount);
+
+  /**
+   * @brief Get seconds a rejected client should wait before next try.
+   *        Hint is growing with number of transfers rejected in a row.
+   */
+  uint64 getRetryAfter();
+
+  size_t getRunning();
+  uint64 getRejected();
+
+private:
+  CcMap<CcString, size_t> m_oAccounts;
+  size_t                  m_uiRunning = 0;
+  uint64                  m_uiRejected = 0;
+  uint64                  m_uiRejectedInRow = 0;
+  CcMutex                 m_oLock;
+};
+
+#endif /* _CcSyncServerAdmission_H_ */
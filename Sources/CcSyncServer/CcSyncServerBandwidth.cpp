@@ -0,0 +1,129 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerBandwidth
+ */
+#include "CcSyncServerBandwidth.h"
+
+CcSyncServerBandwidth::CcSyncServerBandwidth(void)
+{
+}
+
+CcSyncServerBandwidth::~CcSyncServerBandwidth(void)
+{
+}
+
+void CcSyncServerBandwidth::setRate(uint64 uiRate)
+{
+  m_oLock.lock();
+  m_uiRate = uiRate;
+  update();
+  m_oLock.unlock();
+}
+
+CcSyncTokenBucketPointer CcSyncServerBandwidth::begin(const CcString& sAccount, uint64 uiRate, uint32 uiWeight)
+{
+  CcString sKey = sAccount.getLower();
+  m_oLock.lock();
+  if (m_oAccounts.containsKey(sKey) == false)
+  {
+    CEntry oEntry;
+    CCNEW(oEntry.pBucket, CcSyncTokenBucket);
+    m_oAccounts.append(sKey, oEntry);
+  }
+  CEntry& rEntry = m_oAccounts.getValue(sKey);
+  rEntry.uiRate = uiRate;
+  rEntry.uiWeight = (uiWeight > 0) ? uiWeight : 1;
+  rEntry.uiTransfers++;
+  CcSyncTokenBucketPointer pBucket = rEntry.pBucket;
+  update();
+  m_oLock.unlock();
+  return pBucket;
+}
+
+void CcSyncServerBandwidth::end(const CcString& sAccount)
+{
+  CcString sKey = sAccount.getLower();
+  m_oLock.lock();
+  if (m_oAccounts.containsKey(sKey))
+  {
+    CEntry& rEntry = m_oAccounts.getValue(sKey);
+    if (rEntry.uiTransfers > 1)
+    {
+      rEntry.uiTransfers--;
+    }
+    else
+    {
+      m_oAccounts.removeKey(sKey);
+      update();
+    }
+  }
+  m_oLock.unlock();
+}
+
+void CcSyncServerBandwidth::update()
+{
+  uint64 uiRemaining = m_uiRate;
+  uint64 uiWeights = 0;
+  for (size_t uiPos = 0; uiPos < m_oAccounts.size(); uiPos++)
+  {
+    CEntry& rEntry = m_oAccounts.at(uiPos).getValue();
+    rEntry.bFixed = false;
+    uiWeights += rEntry.uiWeight;
+  }
+  // Accounts with own limit below their share are keeping their limit,
+  // repeat until remaining rate is shared by unlimited accounts only.
+  bool bChanged = m_uiRate > 0;
+  while (bChanged && uiWeights > 0)
+  {
+    bChanged = false;
+    for (size_t uiPos = 0; uiPos < m_oAccounts.size(); uiPos++)
+    {
+      CEntry& rEntry = m_oAccounts.at(uiPos).getValue();
+      if (rEntry.bFixed == false &&
+          rEntry.uiRate > 0 &&
+          rEntry.uiRate <= (uiRemaining * rEntry.uiWeight) / uiWeights)
+      {
+        rEntry.bFixed = true;
+        uiRemaining -= rEntry.uiRate;
+        uiWeights -= rEntry.uiWeight;
+        bChanged = true;
+      }
+    }
+  }
+  for (size_t uiPos = 0; uiPos < m_oAccounts.size(); uiPos++)
+  {
+    CEntry& rEntry = m_oAccounts.at(uiPos).getValue();
+    uint64 uiRate = rEntry.uiRate;
+    if (m_uiRate > 0 &&
+        rEntry.bFixed == false)
+    {
+      uiRate = (uiRemaining * rEntry.uiWeight) / uiWeights;
+      // Never stop a transfer completely
+      if (uiRate == 0)
+        uiRate = 1;
+    }
+    rEntry.pBucket->setRate(uiRate);
+  }
+}
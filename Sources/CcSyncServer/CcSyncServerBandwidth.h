@@ -0,0 +1,108 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerBandwidth
+ *
+ * @page      CcSyncServerBandwidth
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerBandwidth
+ *
+ *  Bandwidth shaping of transfers. Each account with running transfers
+ *  gets one CcSyncTokenBucket, shared by all of its transfers.
+ *  The global rate is split between active accounts by their weight,
+ *  rate wich is not used by accounts with a lower own limit is given to
+ *  the others. Rates are updated on each start and end of a transfer.
+ **/
+#ifndef _CcSyncServerBandwidth_H_
+#define _CcSyncServerBandwidth_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcMap.h"
+#include "CcMutex.h"
+#include "CcSharedPointer.h"
+#include "CcSyncTokenBucket.h"
+
+typedef CcSharedPointer<CcSyncTokenBucket> CcSyncTokenBucketPointer;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerBandwidth
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerBandwidth( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerBandwidth( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerBandwidth)
+
+  /**
+   * @brief Set rate of all transfers together.
+   * @param uiRate: Bytes per second, 0 for unlimited
+   */
+  void setRate(uint64 uiRate);
+
+  /**
+   * @brief Register starting transfer of account.
+   * @param sAccount: Name of account
+   * @param uiRate:   Limit of account in bytes per second, 0 for unlimited
+   * @param uiWeight: Share of global rate compared to other accounts
+   * @return Bucket to consume transfered bytes from
+   */
+  CcSyncTokenBucketPointer begin(const CcString& sAccount, uint64 uiRate, uint32 uiWeight);
+
+  /**
+   * @brief Unregister transfer from begin.
+   */
+  void end(const CcString& sAccount);
+
+private:
+  void update();
+
+private:
+  /**
+   * @brief Limits of one active account
+   */
+  class CEntry
+  {
+  public:
+    CcSyncTokenBucketPointer pBucket;
+    uint64  uiRate      = 0;
+    uint32  uiWeight    = 1;
+    size_t  uiTransfers = 0;
+    bool    bFixed      = false;
+  };
+
+  CcMap<CcString, CEntry> m_oAccounts;
+  uint64                  m_uiRate = 0;
+  CcMutex                 m_oLock;
+};
+
+#endif /* _CcSyncServerBandwidth_H_ */
@@ -37,6 +37,8 @@
 
 CcSyncServerConfig::CcSyncServerConfig() :
   m_uiPort(CcSyncGlobals::DefaultPort),
+  m_uiWorkers(CcSyncGlobals::Server::DefaultWorkers),
+  m_uiConnectionQueue(CcSyncGlobals::Server::DefaultConnectionQueue),
   m_oLocation(this)
 {
   // preinit members
@@ -55,16 +57,20 @@ void CcSyncServerConfig::setConfigDir(const CcString& sConfigDir)
   m_sSslCertFile.appendPath(CcSyncGlobals::DefaultCertFile);
 }
 
-void CcSyncServerConfig::addAdminAccount(const CcString& sName, const CcString& sPassword)
+bool CcSyncServerConfig::addAdminAccount(const CcString& sName, const CcString& sPassword)
 {
   CcSyncServerAccount oAccount(sName, sPassword, true);
-  m_oAccountList.append(oAccount);
+  return m_oAccounts.append(oAccount);
 }
 
-void CcSyncServerConfig::addAccount(const CcString& sName, const CcString& sPassword)
+bool CcSyncServerConfig::addAccount(const CcString& sName, const CcString& sPassword)
 {
   CcSyncServerAccount oAccount(sName, sPassword, false);
-  m_oAccountList.append(oAccount);
+  if (m_oAccounts.append(oAccount) == false)
+  {
+    return false;
+  }
+  m_oXmlLock.lock();
   CcXmlNode& oRootNode = m_oXmlFile.rootNode()[CcSyncGlobals::Server::ConfigTags::Root];
   if (oRootNode.isNotNull())
   {
@@ -77,7 +83,9 @@ void CcSyncServerConfig::addAccount(const CcString& sName, const CcString& sPass
     oAccountNode.append(oAccountPasswordNode);
     oRootNode.append(oAccountNode);
   }
-  writeConfigFile();
+  bool bRet = writeConfigFile();
+  m_oXmlLock.unlock();
+  return bRet;
 }
 
 void CcSyncServerConfig::setLocation(const CcString& sPath)
@@ -108,12 +116,12 @@ bool CcSyncServerConfig::readConfig(const CcString& sConfigFile)
     }
     else
     {
-      CcSyncLog::writeDebug("Error in configuration", ESyncLogTarget::Server);
+      CCSYNC_DEBUG("Error in configuration", ESyncLogTarget::Server);
     }
   }
   else
   {
-    CcSyncLog::writeDebug("No valid config file found", ESyncLogTarget::Server);
+    CCSYNC_DEBUG("No valid config file found", ESyncLogTarget::Server);
   }
   return m_bValid;
 }
@@ -138,9 +146,21 @@ bool CcSyncServerConfig::writeConfig(const CcString& sConfigFile)
     oSslNode.setInnerText(CcGlobalStrings::True);
     oRootNode.append(std::move(oSslNode));
   }
-  for (CcSyncServerAccount& oAccountConfig : m_oAccountList)
+  CcXmlNode oWorkersNode(CcSyncGlobals::Server::ConfigTags::Workers);
+  oWorkersNode.setInnerText(CcString::fromSize(m_uiWorkers));
+  oRootNode.append(std::move(oWorkersNode));
+  CcXmlNode oConnectionQueueNode(CcSyncGlobals::Server::ConfigTags::ConnectionQueue);
+  oConnectionQueueNode.setInnerText(CcString::fromSize(m_uiConnectionQueue));
+  oRootNode.append(std::move(oConnectionQueueNode));
+  if (m_uiBandwidth > 0)
+  {
+    CcXmlNode oBandwidthNode(CcSyncGlobals::Server::ConfigTags::Bandwidth);
+    oBandwidthNode.setInnerText(CcString::fromNumber(m_uiBandwidth));
+    oRootNode.append(std::move(oBandwidthNode));
+  }
+  for (CcSyncServerAccountPointer& pAccountConfig : m_oAccounts.getList())
   {
-    oAccountConfig.writeConfig(oRootNode);
+    pAccountConfig->writeConfig(oRootNode);
   }
   m_oLocation.writeConfig(oRootNode);
 
@@ -153,33 +173,16 @@ bool CcSyncServerConfig::writeConfigFile()
   return m_oXmlFile.writeData(true);
 }
 
-CcSyncServerAccount* CcSyncServerConfig::findAccount(const CcString& sAccountName) const
-{
-  for (CcSyncServerAccount& rAccount : m_oAccountList)
-  {
-    if (rAccount.getName() == sAccountName)
-      return &rAccount;
-  }
-  return nullptr;
-}
-
 bool CcSyncServerConfig::removeAccount(const CcString& sAccountName)
 {
   bool bRet = false;
-  size_t uiIndex = 0;
-  for (CcSyncServerAccount& rAccount : m_oAccountList)
-  {
-    if (rAccount.getName() == sAccountName)
-      break;
-    uiIndex++;
-  }
-  if (uiIndex < m_oAccountList.size())
+  if (m_oAccounts.remove(sAccountName))
   {
-    m_oAccountList.remove(uiIndex);
+    m_oXmlLock.lock();
+    size_t uiIndex = 0;
     CcXmlNode& oRootNode = m_oXmlFile.rootNode()[CcSyncGlobals::Server::ConfigTags::Root];
     if (oRootNode.isNotNull())
     {
-      uiIndex = 0;
       for (CcXmlNode& rAccountNode : oRootNode)
       {
         if (rAccountNode.getName() == CcSyncGlobals::Server::ConfigTags::Account)
@@ -199,6 +202,7 @@ bool CcSyncServerConfig::removeAccount(const CcString& sAccountName)
         bRet = writeConfigFile();
       }
     }
+    m_oXmlLock.unlock();
   }
   return bRet;
 }
@@ -209,6 +213,9 @@ CcSyncServerConfig& CcSyncServerConfig::operator=(const CcSyncServerConfig& oToC
   m_bValid = oToCopy.m_bValid;
   m_bSsl = oToCopy.m_bSsl;
   m_bSslRequired = oToCopy.m_bSslRequired;
+  m_uiWorkers = oToCopy.m_uiWorkers;
+  m_uiConnectionQueue = oToCopy.m_uiConnectionQueue;
+  m_uiBandwidth = oToCopy.m_uiBandwidth;
   m_oXmlFile = oToCopy.m_oXmlFile;
   return *this;
 }
@@ -220,6 +227,9 @@ CcSyncServerConfig& CcSyncServerConfig::operator=(CcSyncServerConfig&& oToMove)
     m_bValid = oToMove.m_bValid;
     m_bSsl = oToMove.m_bSsl;
     m_bSslRequired = oToMove.m_bSslRequired;
+    m_uiWorkers = oToMove.m_uiWorkers;
+    m_uiConnectionQueue = oToMove.m_uiConnectionQueue;
+    m_uiBandwidth = oToMove.m_uiBandwidth;
     m_oXmlFile = std::move(oToMove.m_oXmlFile);
   }
   return *this;
@@ -252,6 +262,30 @@ bool CcSyncServerConfig::findServerConfig(CcXmlNode& pNode)
     {
       m_sSslKeyFile = pTempNode4.innerText();
     }
+    CcXmlNode& pTempNode5 = pNode.getNode(CcSyncGlobals::Server::ConfigTags::Workers);
+    if (pTempNode5.isNotNull())
+    {
+      bool bOk = false;
+      uint32 uiWorkers = pTempNode5.innerText().toUint32(&bOk);
+      if (bOk && uiWorkers > 0)
+        m_uiWorkers = uiWorkers;
+    }
+    CcXmlNode& pTempNode6 = pNode.getNode(CcSyncGlobals::Server::ConfigTags::ConnectionQueue);
+    if (pTempNode6.isNotNull())
+    {
+      bool bOk = false;
+      uint32 uiConnectionQueue = pTempNode6.innerText().toUint32(&bOk);
+      if (bOk)
+        m_uiConnectionQueue = uiConnectionQueue;
+    }
+    CcXmlNode& pTempNode7 = pNode.getNode(CcSyncGlobals::Server::ConfigTags::Bandwidth);
+    if (pTempNode7.isNotNull())
+    {
+      bool bOk = false;
+      uint64 uiBandwidth = pTempNode7.innerText().toUint64(&bOk);
+      if (bOk)
+        m_uiBandwidth = uiBandwidth;
+    }
   }
   else
   {
@@ -273,7 +307,7 @@ bool CcSyncServerConfig::findAccountConfigs(CcXmlNode& pNode)
       {
         CcString sUserPath = m_oLocation.getPath();
         sUserPath.appendPath(oAccountConfig.getName());
-        m_oAccountList.append(oAccountConfig);
+        m_oAccounts.append(oAccountConfig);
       }
     }
   }
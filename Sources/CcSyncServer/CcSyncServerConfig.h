@@ -34,8 +34,10 @@
 #include "CcSync.h"
 #include "CcString.h"
 #include "CcSyncServerAccount.h"
+#include "CcSyncServerAccountRegistry.h"
 #include "CcSyncServerLocationConfig.h"
 #include "CcSyncUser.h"
+#include "CcMutex.h"
 #include "Xml/CcXmlFile.h"
 
 class CcXmlNode;
@@ -57,10 +59,27 @@ public:
     { return m_sSslCertFile; }
   const CcString& getSslKeyFile() const
     { return m_sSslKeyFile; }
-  const CcSyncServerAccountList& getAccountList() const
-    {return m_oAccountList; }
+  CcSyncServerAccountPointerList getAccountList()
+    {return m_oAccounts.getList(); }
   const CcSyncServerLocationConfig& getLocation() const
     {return m_oLocation; }
+  /**
+   * @brief Get number of threads wich are processing connections
+   */
+  size_t getWorkers() const
+    { return m_uiWorkers; }
+  /**
+   * @brief Get number of accepted connections wich can wait for a free
+   *        worker, further connections will be closed.
+   */
+  size_t getConnectionQueue() const
+    { return m_uiConnectionQueue; }
+  /**
+   * @brief Get rate of all transfers together in bytes per second,
+   *        0 if unlimited.
+   */
+  uint64 getBandwidth() const
+    { return m_uiBandwidth; }
   
   void setConfigDir(const CcString& sConfigDir);
   void setPort(uint16 uiPort)
@@ -69,13 +88,21 @@ public:
     { m_sSslCertFile = sSslCertFile; }
   void setSslKeyFile(const CcString& sSslKeyFile)
     { m_sSslKeyFile = sSslKeyFile; }
-  void addAccount(const CcString& sName, const CcString&sPassword);
-  void addAdminAccount(const CcString& sName, const CcString&sPassword);
+  /**
+   * @brief Add account and write it to config file.
+   * @return false if account already exists
+   */
+  bool addAccount(const CcString& sName, const CcString&sPassword);
+  bool addAdminAccount(const CcString& sName, const CcString&sPassword);
   void setLocation(const CcString& sPath);
 
   bool readConfig(const CcString& sConfigFile);
   bool writeConfig(const CcString& sConfigFile);
-  CcSyncServerAccount* findAccount(const CcString& sAccountName) const;
+  /**
+   * @brief Find account by name, case is ignored.
+   */
+  CcSyncServerAccountPointer findAccount(const CcString& sAccountName)
+    { return m_oAccounts.find(sAccountName); }
   bool removeAccount(const CcString& sAccountName);
 
   bool writeConfigFile();
@@ -96,13 +123,17 @@ private:
   uint16   m_uiPort;
   bool     m_bSsl = true;
   bool     m_bSslRequired = true;
+  size_t   m_uiWorkers;
+  size_t   m_uiConnectionQueue;
+  uint64   m_uiBandwidth = 0;
   CcString m_sConfigDir;
   CcString m_sSslCertFile;
   CcString m_sSslKeyFile;
   CcPassword m_oRootPassword;
   CcSyncServerLocationConfig m_oLocation;
-  CcSyncServerAccountList  m_oAccountList;
+  CcSyncServerAccountRegistry m_oAccounts;
   CcXmlFile m_oXmlFile;
+  CcMutex   m_oXmlLock;
 };
 
 #endif /* _CcSyncServerConfig_H_ */
@@ -69,9 +69,11 @@ void CcSyncServerDirectory::rescanDirs(bool bDeep)
   {
     CcSyncDirectory m_oDirectory;
     m_oDirectory.init(m_oUser.getDatabase(), &oDirectoryConfig);
+    m_oUser.getDatabase()->lock();
     m_oUser.getDatabase()->directoryListUpdateChangedAll(m_oDirectory.getName());
     m_oDirectory.scan(bDeep);
     doQueue(m_oDirectory);
+    m_oUser.getDatabase()->unlock();
   }
 }
 
@@ -79,6 +81,7 @@ void CcSyncServerDirectory::doQueue(CcSyncDirectory& oCurrentDir)
 {
   m_oUser.getDatabase()->beginTransaction();
   oCurrentDir.queueResetAttempts();
+  oCurrentDir.queueCoalesce();
   while (oCurrentDir.queueHasItems())
   {
     CcSyncFileInfo oFileInfo;
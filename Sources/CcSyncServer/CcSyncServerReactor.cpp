@@ -0,0 +1,290 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerReactor
+ */
+#include "CcSyncServerReactor.h"
+#include "CcSyncServerWorkerPool.h"
+#include "CcSyncServerWorker.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+#include "CcKernel.h"
+
+#ifdef LINUX
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+//! Number of events read by one call of epoll_wait
+#define CcSyncServerReactor_EventCount 64
+//! Time in ms to wait for events, stop of thread is checked after it
+#define CcSyncServerReactor_WaitTime   100
+//! Time in s between two checks for connections wich can release their account
+#define CcSyncServerReactor_ReleaseTime 1
+
+CcSyncServerReactor::CcSyncServerReactor(CcSyncServerWorkerPool* pPool) :
+  m_pPool(pPool)
+{
+}
+
+CcSyncServerReactor::~CcSyncServerReactor(void)
+{
+  close();
+}
+
+bool CcSyncServerReactor::init()
+{
+#ifdef LINUX
+  if (m_iPoll < 0)
+  {
+    m_iPoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_iPoll >= 0)
+    {
+      start();
+    }
+    else
+    {
+      CcSyncLog::writeWarning("Unable to create epoll instance, connections will keep their worker", ESyncLogTarget::Server);
+    }
+  }
+#endif
+  return isAvailable();
+}
+
+void CcSyncServerReactor::close()
+{
+  if (isAvailable())
+  {
+    stop();
+    while (isInProgress())
+    {
+      CcKernel::sleep(10);
+    }
+    for (CDeferred& rDeferred : m_oDeferred)
+    {
+      closeConnection(rDeferred.pConnection);
+    }
+    m_oDeferred.clear();
+    m_oLock.lock();
+    for (CcSyncServerWorker* pConnection : m_oIdle)
+    {
+      if (pConnection != nullptr)
+        closeConnection(pConnection);
+    }
+    m_oIdle.clear();
+    m_uiIdleCount = 0;
+#ifdef LINUX
+    ::close(m_iPoll);
+#endif
+    m_iPoll = -1;
+    m_oLock.unlock();
+  }
+}
+
+bool CcSyncServerReactor::add(CcSyncServerWorker* pConnection)
+{
+  bool bRet = false;
+#ifdef LINUX
+  int iHandle = getSocketHandle(pConnection);
+  if (iHandle >= 0 && isAvailable())
+  {
+    m_oLock.lock();
+    CcSyncServerWorker* pEmpty = nullptr;
+    while (m_oIdle.size() <= static_cast<size_t>(iHandle))
+    {
+      m_oIdle.append(pEmpty);
+    }
+    m_oIdle[iHandle] = pConnection;
+    m_uiIdleCount++;
+    // Oneshot, connection is owned by exactly one worker after an event
+    struct epoll_event oEvent;
+    oEvent.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    oEvent.data.fd = iHandle;
+    if (epoll_ctl(m_iPoll, EPOLL_CTL_MOD, iHandle, &oEvent) == 0 ||
+        (errno == ENOENT && epoll_ctl(m_iPoll, EPOLL_CTL_ADD, iHandle, &oEvent) == 0))
+    {
+      bRet = true;
+    }
+    else
+    {
+      m_oIdle[iHandle] = nullptr;
+      m_uiIdleCount--;
+    }
+    m_oLock.unlock();
+  }
+#else
+  CCUNUSED(pConnection);
+#endif
+  return bRet;
+}
+
+size_t CcSyncServerReactor::getIdleCount()
+{
+  m_oLock.lock();
+  size_t uiCount = m_uiIdleCount;
+  m_oLock.unlock();
+  return uiCount;
+}
+
+void CcSyncServerReactor::run()
+{
+#ifdef LINUX
+  struct epoll_event pEvents[CcSyncServerReactor_EventCount];
+  while (getThreadState() == EThreadState::Running)
+  {
+    int iEvents = epoll_wait(m_iPoll, pEvents, CcSyncServerReactor_EventCount, CcSyncServerReactor_WaitTime);
+    // Retry before new requests, so deferred ones are queued first
+    retryDeferred();
+    for (int iEvent = 0; iEvent < iEvents; iEvent++)
+    {
+      CcSyncServerWorker* pConnection = takeIdle(pEvents[iEvent].data.fd);
+      if (pConnection != nullptr)
+      {
+        handleReadable(pConnection);
+      }
+    }
+    if (iEvents < 0 && errno != EINTR)
+    {
+      CcSyncLog::writeError("Waiting for connections failed", ESyncLogTarget::Server);
+      CcKernel::sleep(CcSyncServerReactor_WaitTime);
+    }
+    releaseIdleAccounts();
+  }
+#endif
+}
+
+CcSyncServerWorker* CcSyncServerReactor::takeIdle(int iHandle)
+{
+  CcSyncServerWorker* pConnection = nullptr;
+  m_oLock.lock();
+  if (iHandle >= 0 &&
+      static_cast<size_t>(iHandle) < m_oIdle.size())
+  {
+    pConnection = m_oIdle[iHandle];
+    if (pConnection != nullptr)
+    {
+      m_oIdle[iHandle] = nullptr;
+      m_uiIdleCount--;
+    }
+  }
+  m_oLock.unlock();
+  return pConnection;
+}
+
+void CcSyncServerReactor::handleReadable(CcSyncServerWorker* pConnection)
+{
+  // Reading TLS may block, it is done by thread of pool
+  if (!m_pPool->appendReady(pConnection))
+  {
+    // Queue is full, socket is not armed again, it would report the
+    // available data immediately.
+    CDeferred oDeferred;
+    oDeferred.pConnection = pConnection;
+    oDeferred.oSince = CcKernel::getUpTime();
+    m_oDeferred.append(oDeferred);
+  }
+}
+
+void CcSyncServerReactor::retryDeferred()
+{
+  while (m_oDeferred.size() > 0)
+  {
+    CDeferred& rDeferred = m_oDeferred[0];
+    if (m_pPool->appendReady(rDeferred.pConnection))
+    {
+      m_oDeferred.remove(0);
+    }
+    else
+    {
+      // Queue is still full, drop connections wich are waiting too long
+      CcDateTime oNow = CcKernel::getUpTime();
+      for (size_t uiPos = 0; uiPos < m_oDeferred.size();)
+      {
+        if ((oNow - m_oDeferred[uiPos].oSince).getTimestampS() >= static_cast<int64>(CcSyncGlobals::Server::RequestTimeout))
+        {
+          CcSyncLog::writeWarning("No free worker in time, connection closed", ESyncLogTarget::Server);
+          closeConnection(m_oDeferred[uiPos].pConnection);
+          m_oDeferred.remove(uiPos);
+        }
+        else
+        {
+          uiPos++;
+        }
+      }
+      break;
+    }
+  }
+}
+
+void CcSyncServerReactor::releaseIdleAccounts()
+{
+  CcDateTime oNow = CcKernel::getUpTime();
+  if (oNow >= m_oNextRelease)
+  {
+    m_oNextRelease = oNow;
+    m_oNextRelease.addSeconds(CcSyncServerReactor_ReleaseTime);
+    size_t uiHandle = 0;
+    bool bNext = true;
+    while (bNext)
+    {
+      CcSyncServerWorker* pConnection = nullptr;
+      m_oLock.lock();
+      bNext = uiHandle < m_oIdle.size();
+      if (bNext &&
+          m_oIdle[uiHandle] != nullptr &&
+          m_oIdle[uiHandle]->hasAccount() &&
+          (oNow - m_oIdle[uiHandle]->getLastRequest()).getTimestampS() >= static_cast<int64>(CcSyncGlobals::Server::AccountIdleTime))
+      {
+        pConnection = m_oIdle[uiHandle];
+        m_oIdle[uiHandle] = nullptr;
+        m_uiIdleCount--;
+      }
+      m_oLock.unlock();
+      if (pConnection != nullptr)
+      {
+        // An event in meantime is lost, but add arms socket again and
+        // reports data wich is still available.
+        pConnection->releaseAccount();
+        if (!add(pConnection))
+          closeConnection(pConnection);
+      }
+      uiHandle++;
+    }
+  }
+}
+
+void CcSyncServerReactor::closeConnection(CcSyncServerWorker* pConnection)
+{
+  pConnection->close();
+  CCDELETE(pConnection);
+}
+
+int CcSyncServerReactor::getSocketHandle(CcSyncServerWorker* pConnection)
+{
+  ISocket* pSocket = pConnection->getSocket().getRawSocket();
+  if (pSocket != nullptr)
+    return static_cast<int>(pSocket->getSocketFd());
+  return -1;
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerReactor
+ *
+ * @page      CcSyncServerReactor
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerReactor
+ *
+ *  Owns all idle connections of server and waits with epoll for incoming
+ *  data. Readable connections are handed to the queue of
+ *  CcSyncServerWorkerPool, a thread reads the available data and returns
+ *  connection until request is complete, so idle and slow clients are not
+ *  holding a thread and reactor never waits for a TLS read.
+ *  Connections are indexed by their socket handle.
+ *  If queue of pool is full, ready connections are deferred and retried
+ *  after next wait, they are closed if no thread was free for
+ *  Server::RequestTimeout seconds.
+ *  Connections without request for Server::AccountIdleTime seconds are
+ *  releasing their account, so it can be unloaded by account cache.
+ *  On systems without epoll the reactor is not available and connections
+ *  stay on their pool thread.
+ **/
+#ifndef _CcSyncServerReactor_H_
+#define _CcSyncServerReactor_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "IThread.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcDateTime.h"
+
+class CcSyncServerWorker;
+class CcSyncServerWorkerPool;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerReactor : public IThread
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerReactor(CcSyncServerWorkerPool* pPool);
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~CcSyncServerReactor( void );
+
+  /**
+   * @brief Create epoll instance and start waiting thread.
+   * @return true if reactor is available on this system
+   */
+  bool init();
+
+  /**
+   * @brief Stop thread and close all idle connections.
+   */
+  void close();
+
+  bool isAvailable() const
+    { return m_iPoll >= 0; }
+
+  /**
+   * @brief Take ownership of an idle connection until next request arrives.
+   * @return false if connection could not be registered
+   */
+  bool add(CcSyncServerWorker* pConnection);
+
+  size_t getIdleCount();
+
+private:
+  void run() override;
+  CcSyncServerWorker* takeIdle(int iHandle);
+  void handleReadable(CcSyncServerWorker* pConnection);
+  void retryDeferred();
+  void releaseIdleAccounts();
+  static void closeConnection(CcSyncServerWorker* pConnection);
+  static int getSocketHandle(CcSyncServerWorker* pConnection);
+
+private:
+  /**
+   * @brief Connection with complete request wich is waiting for space in
+   *        queue of pool.
+   */
+  class CDeferred
+  {
+  public:
+    CcSyncServerWorker* pConnection = nullptr;
+    CcDateTime          oSince;
+    bool operator==(const CDeferred& oToCompare) const
+      { return pConnection == oToCompare.pConnection; }
+  };
+
+  CcSyncServerWorkerPool* m_pPool;
+  //! Idle connections at index of their socket handle
+  CcList<CcSyncServerWorker*> m_oIdle;
+  size_t m_uiIdleCount = 0;
+  //! Used by thread of reactor only
+  CcList<CDeferred> m_oDeferred;
+  CcDateTime m_oNextRelease;
+  CcMutex m_oLock;
+  int m_iPoll = -1;
+};
+
+#endif /* _CcSyncServerReactor_H_ */
@@ -0,0 +1,89 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerReaderPool
+ */
+#include "CcSyncServerReaderPool.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncLog.h"
+
+CcSyncServerReaderPool::CcSyncServerReaderPool(const CcString& sPath) :
+  m_sPath(sPath)
+{
+}
+
+CcSyncServerReaderPool::~CcSyncServerReaderPool(void)
+{
+  m_oFree.clear();
+}
+
+CcSyncDbClientPointer CcSyncServerReaderPool::acquire()
+{
+  CcSyncDbClientPointer pReader;
+  m_oLock.lock();
+  if (m_oFree.size() > 0)
+  {
+    pReader = m_oFree[m_oFree.size() - 1];
+    m_oFree.remove(m_oFree.size() - 1);
+  }
+  else if (m_uiOpened < CcSyncGlobals::Server::DatabaseReaders)
+  {
+    // Count before opening, so limit is kept while lock is released
+    m_uiOpened++;
+    m_oLock.unlock();
+    CCNEW(pReader, CcSyncDbClient);
+    if (pReader->openDatabase(m_sPath) == false ||
+        pReader->setReadOnly() == false)
+    {
+      CcSyncLog::writeError("Unable to open database reader: " + m_sPath, ESyncLogTarget::Server);
+      pReader = nullptr;
+    }
+    m_oLock.lock();
+    if (pReader == nullptr)
+    {
+      m_uiOpened--;
+    }
+  }
+  m_oLock.unlock();
+  return pReader;
+}
+
+void CcSyncServerReaderPool::release(CcSyncDbClientPointer& pReader)
+{
+  if (pReader != nullptr)
+  {
+    m_oLock.lock();
+    m_oFree.append(pReader);
+    m_oLock.unlock();
+    pReader = nullptr;
+  }
+}
+
+bool CcSyncServerReaderPool::isIdle()
+{
+  m_oLock.lock();
+  bool bIdle = m_oFree.size() == m_uiOpened;
+  m_oLock.unlock();
+  return bIdle;
+}
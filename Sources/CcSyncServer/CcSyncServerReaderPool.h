@@ -0,0 +1,86 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerReaderPool
+ *
+ * @page      CcSyncServerReaderPool
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerReaderPool
+ *
+ *  Read only connections to database of one account. Together with the
+ *  write ahead log of the writing connection, read requests are not
+ *  waiting for running write transactions.
+ *  Connections are opened on demand up to Server::DatabaseReaders.
+ **/
+#ifndef _CcSyncServerReaderPool_H_
+#define _CcSyncServerReaderPool_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcSyncDbClient.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerReaderPool
+{
+public:
+  /**
+   * @brief Constructor
+   * @param sPath: Path to database file
+   */
+  CcSyncServerReaderPool(const CcString& sPath);
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerReaderPool( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerReaderPool)
+
+  /**
+   * @brief Get unused reader, ownership stays in pool.
+   * @return Reader or nullptr if all readers are in use
+   */
+  CcSyncDbClientPointer acquire();
+
+  /**
+   * @brief Return reader from acquire to pool.
+   */
+  void release(CcSyncDbClientPointer& pReader);
+
+  /**
+   * @brief Check if all opened readers are returned to pool.
+   */
+  bool isIdle();
+
+private:
+  CcString              m_sPath;
+  CcList<CcSyncDbClientPointer> m_oFree;
+  size_t                m_uiOpened = 0;
+  CcMutex               m_oLock;
+};
+
+#endif /* _CcSyncServerReaderPool_H_ */
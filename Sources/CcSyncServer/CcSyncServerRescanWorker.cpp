@@ -50,9 +50,9 @@ bool CcSyncServerRescanWorker::start(bool bDeep)
 
 void CcSyncServerRescanWorker::run()
 {
-  for (const CcSyncServerAccount& oAccount : m_oServer->config().getAccountList())
+  for (const CcSyncServerAccountPointer& pAccount : m_oServer->config().getAccountList())
   {
-    CcSyncUser oUser = m_oServer->getUserByName(oAccount.getName());
+    CcSyncUser oUser = m_oServer->getUserByName(pAccount->getName());
     CcSyncServerDirectory oServerDir(oUser);
     oServerDir.rescanDirs(m_bDeep);
   }
@@ -0,0 +1,180 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerScheduler
+ */
+#include "CcSyncServerScheduler.h"
+#include "CcSyncGlobals.h"
+
+CcSyncServerScheduler::CcSyncServerScheduler(void)
+{
+}
+
+CcSyncServerScheduler::~CcSyncServerScheduler(void)
+{
+}
+
+void CcSyncServerScheduler::push(CcSyncServerWorker* pConnection, const CcString& sAccount, uint32 uiWeight, bool bBulk)
+{
+  size_t uiPos = findAccount(sAccount.getLower());
+  if (uiPos >= m_oAccounts.size())
+  {
+    CAccount oAccount;
+    oAccount.sAccount = sAccount.getLower();
+    m_oAccounts.append(oAccount);
+  }
+  CAccount& rAccount = m_oAccounts[uiPos];
+  rAccount.uiWeight = (uiWeight > 0) ? uiWeight : 1;
+  if (bBulk)
+    rAccount.oBulk.append(pConnection);
+  else
+    rAccount.oMetadata.append(pConnection);
+  m_uiSize++;
+}
+
+CcSyncServerWorker* CcSyncServerScheduler::pop()
+{
+  CcSyncServerWorker* pConnection = nullptr;
+  if (m_uiMetadataInRow < CcSyncGlobals::Server::SchedulerMetadataBurst)
+  {
+    pConnection = popMetadata();
+    if (pConnection != nullptr)
+      m_uiMetadataInRow++;
+  }
+  if (pConnection == nullptr)
+  {
+    m_uiMetadataInRow = 0;
+    pConnection = popBulk();
+    if (pConnection == nullptr)
+      pConnection = popMetadata();
+  }
+  if (pConnection != nullptr)
+  {
+    m_uiSize--;
+    // Drop accounts without requests, so rounds are over active accounts only
+    for (size_t uiPos = 0; uiPos < m_oAccounts.size();)
+    {
+      if (m_oAccounts[uiPos].oMetadata.size() == 0 &&
+          m_oAccounts[uiPos].oBulk.size() == 0)
+      {
+        m_oAccounts.remove(uiPos);
+        if (m_uiMetadataPos > uiPos)
+          m_uiMetadataPos--;
+        if (m_uiBulkPos > uiPos)
+          m_uiBulkPos--;
+      }
+      else
+      {
+        uiPos++;
+      }
+    }
+  }
+  return pConnection;
+}
+
+CcList<CcSyncServerWorker*> CcSyncServerScheduler::takeAll()
+{
+  CcList<CcSyncServerWorker*> oConnections;
+  for (CAccount& rAccount : m_oAccounts)
+  {
+    for (CcSyncServerWorker* pConnection : rAccount.oMetadata)
+      oConnections.append(pConnection);
+    for (CcSyncServerWorker* pConnection : rAccount.oBulk)
+      oConnections.append(pConnection);
+  }
+  m_oAccounts.clear();
+  m_uiMetadataPos = 0;
+  m_uiBulkPos = 0;
+  m_uiSize = 0;
+  return oConnections;
+}
+
+CcSyncServerWorker* CcSyncServerScheduler::popMetadata()
+{
+  CcSyncServerWorker* pConnection = nullptr;
+  for (size_t uiCount = 0; uiCount < m_oAccounts.size() && pConnection == nullptr; uiCount++)
+  {
+    if (m_uiMetadataPos >= m_oAccounts.size())
+      m_uiMetadataPos = 0;
+    CAccount& rAccount = m_oAccounts[m_uiMetadataPos];
+    m_uiMetadataPos++;
+    if (rAccount.oMetadata.size() > 0)
+    {
+      pConnection = rAccount.oMetadata[0];
+      rAccount.oMetadata.remove(0);
+    }
+  }
+  return pConnection;
+}
+
+CcSyncServerWorker* CcSyncServerScheduler::popBulk()
+{
+  CcSyncServerWorker* pConnection = nullptr;
+  bool bWaiting = false;
+  for (CAccount& rAccount : m_oAccounts)
+  {
+    if (rAccount.oBulk.size() > 0)
+    {
+      bWaiting = true;
+      break;
+    }
+  }
+  // Each visit of an account adds its weight, a transfer costs one
+  while (bWaiting && pConnection == nullptr)
+  {
+    if (m_uiBulkPos >= m_oAccounts.size())
+      m_uiBulkPos = 0;
+    CAccount& rAccount = m_oAccounts[m_uiBulkPos];
+    if (rAccount.oBulk.size() == 0)
+    {
+      rAccount.iDeficit = 0;
+      m_uiBulkPos++;
+    }
+    else if (rAccount.iDeficit > 0)
+    {
+      rAccount.iDeficit--;
+      pConnection = rAccount.oBulk[0];
+      rAccount.oBulk.remove(0);
+      if (rAccount.oBulk.size() == 0)
+        rAccount.iDeficit = 0;
+    }
+    else
+    {
+      rAccount.iDeficit += rAccount.uiWeight;
+      m_uiBulkPos++;
+    }
+  }
+  return pConnection;
+}
+
+size_t CcSyncServerScheduler::findAccount(const CcString& sAccount)
+{
+  size_t uiPos = 0;
+  for (; uiPos < m_oAccounts.size(); uiPos++)
+  {
+    if (m_oAccounts[uiPos].sAccount == sAccount)
+      break;
+  }
+  return uiPos;
+}
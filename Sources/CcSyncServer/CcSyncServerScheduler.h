@@ -0,0 +1,119 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerScheduler
+ *
+ * @page      CcSyncServerScheduler
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerScheduler
+ *
+ *  Order of received requests before they are executed by threads of
+ *  CcSyncServerWorkerPool. Requests are queued per account, so many
+ *  connections of one account are not delaying all others.
+ *  Metadata requests are executed before file transfers, accounts are
+ *  served round robin for them. File transfers are served by deficit
+ *  round robin with the weight of the account as quantum.
+ *  After Server::SchedulerMetadataBurst metadata requests in a row, a
+ *  waiting transfer is taken, so transfers are not starving.
+ *  Class is not locked, it is used with lock of pool.
+ **/
+#ifndef _CcSyncServerScheduler_H_
+#define _CcSyncServerScheduler_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+
+class CcSyncServerWorker;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerScheduler
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerScheduler( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerScheduler( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerScheduler)
+
+  /**
+   * @brief Queue connection with received request.
+   * @param pConnection: Connection to execute
+   * @param sAccount:    Account of connection, empty if not logged in
+   * @param uiWeight:    Share of account on file transfers
+   * @param bBulk:       true if request is a file transfer
+   */
+  void push(CcSyncServerWorker* pConnection, const CcString& sAccount, uint32 uiWeight, bool bBulk);
+
+  /**
+   * @brief Take next connection to execute.
+   * @return Connection or nullptr if nothing is queued
+   */
+  CcSyncServerWorker* pop();
+
+  /**
+   * @brief Remove and return all queued connections, used on shutdown.
+   */
+  CcList<CcSyncServerWorker*> takeAll();
+
+  size_t size() const
+    { return m_uiSize; }
+
+private:
+  CcSyncServerWorker* popMetadata();
+  CcSyncServerWorker* popBulk();
+  size_t findAccount(const CcString& sAccount);
+
+private:
+  /**
+   * @brief Queued requests of one account
+   */
+  class CAccount
+  {
+  public:
+    CcString  sAccount;
+    uint32    uiWeight = 1;
+    int64     iDeficit = 0;
+    CcList<CcSyncServerWorker*> oMetadata;
+    CcList<CcSyncServerWorker*> oBulk;
+
+    bool operator==(const CAccount& oToCompare) const
+      { return sAccount == oToCompare.sAccount; }
+  };
+
+  CcList<CAccount>  m_oAccounts;
+  size_t            m_uiMetadataPos = 0;
+  size_t            m_uiBulkPos = 0;
+  size_t            m_uiMetadataInRow = 0;
+  size_t            m_uiSize = 0;
+};
+
+#endif /* _CcSyncServerScheduler_H_ */
@@ -0,0 +1,149 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerSessions
+ */
+#include "CcSyncServerSessions.h"
+#include "CcSyncGlobals.h"
+#include "CcKernel.h"
+
+CcSyncServerSessions::CcSyncServerSessions(void)
+{
+}
+
+CcSyncServerSessions::~CcSyncServerSessions(void)
+{
+  clear();
+}
+
+bool CcSyncServerSessions::find(const CcString& sToken, CcString& sAccount, CcString& sUsername)
+{
+  bool bRet = false;
+  CcDateTime oNow = CcKernel::getUpTime();
+  m_oLock.lock();
+  CEntry* pEntry = m_oSessions.find(sToken);
+  if (pEntry != nullptr)
+  {
+    if (pEntry->oExpires > oNow)
+    {
+      sAccount = pEntry->sAccount;
+      sUsername = pEntry->sUsername;
+      bRet = true;
+    }
+    else
+    {
+      removeToken(pEntry->sAccountKey, sToken);
+      m_oSessions.remove(sToken);
+    }
+  }
+  m_oLock.unlock();
+  return bRet;
+}
+
+void CcSyncServerSessions::insert(const CcString& sToken, const CcString& sAccount, const CcString& sUsername)
+{
+  CcDateTime oNow = CcKernel::getUpTime();
+  CEntry oEntry;
+  oEntry.sAccount = sAccount;
+  oEntry.sAccountKey = sAccount.getLower();
+  oEntry.sUsername = sUsername;
+  oEntry.oExpires = oNow;
+  oEntry.oExpires.addSeconds(static_cast<int32>(CcSyncGlobals::Server::SessionCacheTime));
+  m_oLock.lock();
+  removeExpired(oNow);
+  CEntry* pEntry = m_oSessions.find(sToken);
+  if (pEntry == nullptr)
+  {
+    m_oAccounts.get(oEntry.sAccountKey).append(sToken);
+  }
+  else if (pEntry->sAccountKey != oEntry.sAccountKey)
+  {
+    removeToken(pEntry->sAccountKey, sToken);
+    m_oAccounts.get(oEntry.sAccountKey).append(sToken);
+  }
+  m_oSessions.set(sToken, oEntry);
+  m_oLock.unlock();
+}
+
+void CcSyncServerSessions::removeAccount(const CcString& sAccount)
+{
+  CcList<CcString> oTokens;
+  m_oLock.lock();
+  if (m_oAccounts.take(sAccount.getLower(), oTokens))
+  {
+    for (const CcString& sToken : oTokens)
+    {
+      m_oSessions.remove(sToken);
+    }
+  }
+  m_oLock.unlock();
+}
+
+void CcSyncServerSessions::clear()
+{
+  m_oLock.lock();
+  m_oSessions.clear();
+  m_oAccounts.clear();
+  m_oLock.unlock();
+}
+
+size_t CcSyncServerSessions::size()
+{
+  m_oLock.lock();
+  size_t uiSize = m_oSessions.size();
+  m_oLock.unlock();
+  return uiSize;
+}
+
+void CcSyncServerSessions::removeExpired(const CcDateTime& oNow)
+{
+  // Walk table only once per cache time, lookups are removing single entries
+  if (oNow >= m_oNextPurge)
+  {
+    m_oSessions.removeIf([this, &oNow](const CcString& sToken, CEntry& rEntry)
+    {
+      if (rEntry.oExpires <= oNow)
+      {
+        removeToken(rEntry.sAccountKey, sToken);
+        return true;
+      }
+      return false;
+    });
+    m_oNextPurge = oNow;
+    m_oNextPurge.addSeconds(static_cast<int32>(CcSyncGlobals::Server::SessionCacheTime));
+  }
+}
+
+void CcSyncServerSessions::removeToken(const CcString& sAccount, const CcString& sToken)
+{
+  CcList<CcString>* pTokens = m_oAccounts.find(sAccount);
+  if (pTokens != nullptr)
+  {
+    pTokens->removeItem(sToken);
+    if (pTokens->size() == 0)
+    {
+      m_oAccounts.remove(sAccount);
+    }
+  }
+}
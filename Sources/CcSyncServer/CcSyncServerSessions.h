@@ -0,0 +1,114 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerSessions
+ *
+ * @page      CcSyncServerSessions
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerSessions
+ *
+ *  Table of resolved sessions by token, shared by all workers of server.
+ *  Entries are expiring after Server::SessionCacheTime seconds, so a
+ *  session is validated against database at least once in this time.
+ *  Sessions are hashed by token, an index of tokens per account is hashed
+ *  by lower case account name to remove sessions of one account directly.
+ *  Only names are cached, not the user with config and database, so a
+ *  cached session does not keep an account loaded.
+ **/
+#ifndef _CcSyncServerSessions_H_
+#define _CcSyncServerSessions_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcDateTime.h"
+#include "CcSyncHashMap.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerSessions
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerSessions( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerSessions( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerSessions)
+
+  /**
+   * @brief Get account of a cached session.
+   * @param sToken:    Token of session
+   * @param sAccount:  Target for name of account
+   * @param sUsername: Target for name of user
+   * @return true if session was found and is not expired
+   */
+  bool find(const CcString& sToken, CcString& sAccount, CcString& sUsername);
+
+  /**
+   * @brief Store resolved session, expired entries are removed on same call.
+   */
+  void insert(const CcString& sToken, const CcString& sAccount, const CcString& sUsername);
+
+  /**
+   * @brief Remove all sessions of an account, required if token was
+   *        replaced by a new login or account was removed.
+   */
+  void removeAccount(const CcString& sAccount);
+
+  void clear();
+  size_t size();
+
+private:
+  /**
+   * @brief One resolved session
+   */
+  class CEntry
+  {
+  public:
+    CcString   sAccount;
+    //! Lower case account for index of tokens
+    CcString   sAccountKey;
+    CcString   sUsername;
+    CcDateTime oExpires;
+  };
+
+  void removeExpired(const CcDateTime& oNow);
+  void removeToken(const CcString& sAccount, const CcString& sToken);
+
+private:
+  CcSyncHashMap<CcString, CEntry>           m_oSessions;
+  //! Tokens of all sessions by lower case account
+  CcSyncHashMap<CcString, CcList<CcString>> m_oAccounts;
+  CcMutex                                   m_oLock;
+  CcDateTime                                m_oNextPurge;
+};
+
+#endif /* _CcSyncServerSessions_H_ */
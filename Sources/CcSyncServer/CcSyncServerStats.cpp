@@ -0,0 +1,272 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerStats
+ */
+#include "CcSyncServerStats.h"
+#include "CcSyncGlobals.h"
+#include "CcSyncHashMap.h"
+#include "Json/CcJsonArray.h"
+
+//! Upper bounds of latency histogram in us, last bucket is open
+static const uint64 c_aHistogramBounds[] = { 1000, 5000, 10000, 50000, 100000, 500000, 1000000, 5000000 };
+static const size_t c_uiHistogramBounds = sizeof(c_aHistogramBounds) / sizeof(c_aHistogramBounds[0]);
+
+/**
+ * @brief Counters of one command
+ */
+class CcSyncServerStatsCommand
+{
+public:
+  uint64 uiRequests = 0;
+  uint64 uiTime     = 0;
+  uint64 uiMaxTime  = 0;
+  uint64 aHistogram[c_uiHistogramBounds + 1] = {};
+};
+
+/**
+ * @brief Counters of one account
+ */
+class CcSyncServerStatsAccount
+{
+public:
+  uint64 uiRequests     = 0;
+  uint64 uiSent         = 0;
+  uint64 uiReceived     = 0;
+  uint64 uiDatabaseTime = 0;
+};
+
+/**
+ * @brief Counters written by one thread, lock is only contended while
+ *        statistics are summed up.
+ */
+class CcSyncServerStatsThread
+{
+public:
+  CcMutex oLock;
+  CcSyncHashMap<uint64, CcSyncServerStatsCommand> oCommands;
+  CcSyncHashMap<CcString, CcSyncServerStatsAccount> oAccounts;
+};
+
+//! Stats object and block of counters current thread is writing to
+static thread_local CcSyncServerStats* s_pThreadOwner = nullptr;
+static thread_local CcSyncServerStatsThread* s_pThread = nullptr;
+
+CcSyncServerStats::CcSyncServerStats(void)
+{
+}
+
+CcSyncServerStats::~CcSyncServerStats(void)
+{
+  m_oLock.lock();
+  for (CcSyncServerStatsThread* pThread : m_oThreads)
+  {
+    CCDELETE(pThread);
+  }
+  m_oThreads.clear();
+  m_oLock.unlock();
+}
+
+void CcSyncServerStats::record(ESyncCommandType eCommandType, const CcString& sAccount, uint64 uiTime, uint64 uiDatabaseTime,
+                               uint64 uiSent, uint64 uiReceived)
+{
+  CcSyncServerStatsThread* pThread = getThread();
+  size_t uiBucket = 0;
+  while (uiBucket < c_uiHistogramBounds &&
+         uiTime >= c_aHistogramBounds[uiBucket])
+  {
+    uiBucket++;
+  }
+  uint64 uiCommand = static_cast<uint64>(eCommandType);
+  pThread->oLock.lock();
+  CcSyncServerStatsCommand& rCommand = pThread->oCommands.get(uiCommand);
+  rCommand.uiRequests++;
+  rCommand.uiTime += uiTime;
+  if (uiTime > rCommand.uiMaxTime)
+    rCommand.uiMaxTime = uiTime;
+  rCommand.aHistogram[uiBucket]++;
+  CcSyncServerStatsAccount& rAccount = pThread->oAccounts.get(sAccount);
+  rAccount.uiRequests++;
+  rAccount.uiSent += uiSent;
+  rAccount.uiReceived += uiReceived;
+  rAccount.uiDatabaseTime += uiDatabaseTime;
+  pThread->oLock.unlock();
+}
+
+void CcSyncServerStats::getJson(CcJsonObject& oStats)
+{
+  CcSyncHashMap<uint64, CcSyncServerStatsCommand> oCommands;
+  CcSyncHashMap<CcString, CcSyncServerStatsAccount> oAccounts;
+  m_oLock.lock();
+  for (CcSyncServerStatsThread* pThread : m_oThreads)
+  {
+    pThread->oLock.lock();
+    pThread->oCommands.forEach([&oCommands](const uint64& uiCommand, const CcSyncServerStatsCommand& rThreadCommand)
+    {
+      CcSyncServerStatsCommand& rCommand = oCommands.get(uiCommand);
+      rCommand.uiRequests += rThreadCommand.uiRequests;
+      rCommand.uiTime += rThreadCommand.uiTime;
+      if (rThreadCommand.uiMaxTime > rCommand.uiMaxTime)
+        rCommand.uiMaxTime = rThreadCommand.uiMaxTime;
+      for (size_t uiBucket = 0; uiBucket <= c_uiHistogramBounds; uiBucket++)
+        rCommand.aHistogram[uiBucket] += rThreadCommand.aHistogram[uiBucket];
+    });
+    pThread->oAccounts.forEach([&oAccounts](const CcString& sAccount, const CcSyncServerStatsAccount& rThreadAccount)
+    {
+      CcSyncServerStatsAccount& rAccount = oAccounts.get(sAccount);
+      rAccount.uiRequests += rThreadAccount.uiRequests;
+      rAccount.uiSent += rThreadAccount.uiSent;
+      rAccount.uiReceived += rThreadAccount.uiReceived;
+      rAccount.uiDatabaseTime += rThreadAccount.uiDatabaseTime;
+    });
+    pThread->oLock.unlock();
+  }
+  m_oLock.unlock();
+
+  uint64 uiRequests = 0;
+  uint64 uiSent = 0;
+  uint64 uiReceived = 0;
+  uint64 uiDatabaseTime = 0;
+  CcJsonNode oAccountList(EJsonDataType::Array);
+  oAccountList.setName(CcSyncGlobals::Commands::ServerGetStats::AccountList);
+  oAccounts.forEach([&](const CcString& sAccount, const CcSyncServerStatsAccount& rAccount)
+  {
+    uiRequests += rAccount.uiRequests;
+    uiSent += rAccount.uiSent;
+    uiReceived += rAccount.uiReceived;
+    uiDatabaseTime += rAccount.uiDatabaseTime;
+    CcJsonObject oAccount;
+    oAccount.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Name, sAccount));
+    oAccount.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Requests, rAccount.uiRequests));
+    oAccount.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::BytesSent, rAccount.uiSent));
+    oAccount.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::BytesReceived, rAccount.uiReceived));
+    oAccount.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::DatabaseTime, rAccount.uiDatabaseTime));
+    oAccountList.array().add(CcJsonNode(oAccount, ""));
+  });
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Requests, uiRequests));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::BytesSent, uiSent));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::BytesReceived, uiReceived));
+  oStats.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::DatabaseTime, uiDatabaseTime));
+
+  CcJsonNode oBounds(EJsonDataType::Array);
+  oBounds.setName(CcSyncGlobals::Commands::ServerGetStats::HistogramBounds);
+  for (size_t uiBucket = 0; uiBucket < c_uiHistogramBounds; uiBucket++)
+  {
+    oBounds.array().add(CcJsonNode("", c_aHistogramBounds[uiBucket]));
+  }
+  oStats.append(std::move(oBounds));
+
+  CcJsonNode oCommandList(EJsonDataType::Array);
+  oCommandList.setName(CcSyncGlobals::Commands::ServerGetStats::CommandList);
+  oCommands.forEach([&oCommandList](const uint64& uiCommand, const CcSyncServerStatsCommand& rCommand)
+  {
+    ESyncCommandType eCommandType = static_cast<ESyncCommandType>(uiCommand);
+    CcJsonObject oCommand;
+    oCommand.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Id, uiCommand));
+    oCommand.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Name, getCommandName(eCommandType)));
+    oCommand.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Requests, rCommand.uiRequests));
+    oCommand.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::Time, rCommand.uiTime));
+    oCommand.add(CcJsonNode(CcSyncGlobals::Commands::ServerGetStats::MaxTime, rCommand.uiMaxTime));
+    CcJsonNode oHistogram(EJsonDataType::Array);
+    oHistogram.setName(CcSyncGlobals::Commands::ServerGetStats::Histogram);
+    for (size_t uiBucket = 0; uiBucket <= c_uiHistogramBounds; uiBucket++)
+    {
+      oHistogram.array().add(CcJsonNode("", rCommand.aHistogram[uiBucket]));
+    }
+    oCommand.append(std::move(oHistogram));
+    oCommandList.array().add(CcJsonNode(oCommand, ""));
+  });
+  oStats.append(std::move(oCommandList));
+  oStats.append(std::move(oAccountList));
+}
+
+uint64 CcSyncServerStats::getRequests()
+{
+  uint64 uiRequests = 0;
+  m_oLock.lock();
+  for (CcSyncServerStatsThread* pThread : m_oThreads)
+  {
+    pThread->oLock.lock();
+    pThread->oCommands.forEach([&uiRequests](const uint64&, const CcSyncServerStatsCommand& rCommand)
+    {
+      uiRequests += rCommand.uiRequests;
+    });
+    pThread->oLock.unlock();
+  }
+  m_oLock.unlock();
+  return uiRequests;
+}
+
+CcString CcSyncServerStats::getCommandName(ESyncCommandType eCommandType)
+{
+  switch (eCommandType)
+  {
+    case ESyncCommandType::AllOk:                         return "AllOk";
+    case ESyncCommandType::Crc:                           return "Crc";
+    case ESyncCommandType::Close:                         return "Close";
+    case ESyncCommandType::ServerGetInfo:                 return "ServerGetInfo";
+    case ESyncCommandType::ServerAccountCreate:           return "ServerAccountCreate";
+    case ESyncCommandType::ServerAccountRescan:           return "ServerAccountRescan";
+    case ESyncCommandType::ServerAccountRemove:           return "ServerAccountRemove";
+    case ESyncCommandType::ServerStop:                    return "ServerStop";
+    case ESyncCommandType::ServerGetStats:                return "ServerGetStats";
+    case ESyncCommandType::ServerSetTrace:                return "ServerSetTrace";
+    case ESyncCommandType::ServerSetProfiler:             return "ServerSetProfiler";
+    case ESyncCommandType::AccountCreate:                 return "AccountCreate";
+    case ESyncCommandType::AccountLogin:                  return "AccountLogin";
+    case ESyncCommandType::AccountGetData:                return "AccountGetData";
+    case ESyncCommandType::AccountSetData:                return "AccountSetData";
+    case ESyncCommandType::AccountGetDirectoryList:       return "AccountGetDirectoryList";
+    case ESyncCommandType::AccountGetCommandList:         return "AccountGetCommandList";
+    case ESyncCommandType::AccountCreateDirectory:        return "AccountCreateDirectory";
+    case ESyncCommandType::AccountRights:                 return "AccountRights";
+    case ESyncCommandType::AccountDatabaseUpdateChanged:  return "AccountDatabaseUpdateChanged";
+    case ESyncCommandType::AccountRemoveDirectory:        return "AccountRemoveDirectory";
+    case ESyncCommandType::DirectoryGetFileList:          return "DirectoryGetFileList";
+    case ESyncCommandType::DirectoryGetFileInfo:          return "DirectoryGetFileInfo";
+    case ESyncCommandType::DirectoryGetDirectoryInfo:     return "DirectoryGetDirectoryInfo";
+    case ESyncCommandType::DirectoryCreateDirectory:      return "DirectoryCreateDirectory";
+    case ESyncCommandType::DirectoryRemoveDirectory:      return "DirectoryRemoveDirectory";
+    case ESyncCommandType::DirectoryUploadFile:           return "DirectoryUploadFile";
+    case ESyncCommandType::DirectoryDownloadFile:         return "DirectoryDownloadFile";
+    case ESyncCommandType::DirectoryRemoveFile:           return "DirectoryRemoveFile";
+    case ESyncCommandType::DirectoryUpdateFileInfo:       return "DirectoryUpdateFileInfo";
+    default:                                              return "Unknown";
+  }
+}
+
+CcSyncServerStatsThread* CcSyncServerStats::getThread()
+{
+  if (s_pThreadOwner != this)
+  {
+    // First request of this thread, block is kept until stats are deleted
+    CCNEWTYPE(pThread, CcSyncServerStatsThread);
+    m_oLock.lock();
+    m_oThreads.append(pThread);
+    m_oLock.unlock();
+    s_pThread = pThread;
+    s_pThreadOwner = this;
+  }
+  return s_pThread;
+}
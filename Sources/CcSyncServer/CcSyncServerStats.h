@@ -0,0 +1,98 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerStats
+ *
+ * @page      CcSyncServerStats
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerStats
+ *
+ *  Counters of executed requests, reported by ServerGetStats command.
+ *  Each thread of CcSyncServerWorkerPool is writing to its own block of
+ *  counters, so recording a request does not wait for other threads.
+ *  Blocks are summed up only if statistics are requested.
+ **/
+#ifndef _CcSyncServerStats_H_
+#define _CcSyncServerStats_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcString.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "ESyncCommandType.h"
+#include "Json/CcJsonObject.h"
+
+class CcSyncServerStatsThread;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerStats
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerStats( void );
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerStats( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerStats)
+
+  /**
+   * @brief Add executed request to counters of current thread.
+   * @param eCommandType:   Command of request
+   * @param sAccount:       Account of connection, empty if not logged in
+   * @param uiTime:         Time of execution in us
+   * @param uiDatabaseTime: Time waiting for and committing database in us
+   * @param uiSent:         Bytes sent for request
+   * @param uiReceived:     Bytes received for request
+   */
+  void record(ESyncCommandType eCommandType, const CcString& sAccount, uint64 uiTime, uint64 uiDatabaseTime,
+              uint64 uiSent, uint64 uiReceived);
+
+  /**
+   * @brief Sum up counters of all threads.
+   * @param oStats: Object to append totals, commands and accounts to
+   */
+  void getJson(CcJsonObject& oStats);
+
+  uint64 getRequests();
+
+  /**
+   * @brief Get printable name of command for reports.
+   */
+  static CcString getCommandName(ESyncCommandType eCommandType);
+
+private:
+  CcSyncServerStatsThread* getThread();
+
+private:
+  CcList<CcSyncServerStatsThread*> m_oThreads;
+  CcMutex                          m_oLock;
+};
+
+#endif /* _CcSyncServerStats_H_ */
@@ -37,6 +37,10 @@
 #include "CcSqlite.h"
 #include "Hash/CcCrc32.h"
 #include "CcSyncServerRescanWorker.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncTrace.h"
+#include "CcSyncDbProfiler.h"
+#include "Json/CcJsonDocument.h"
 
 class CcSyncServerWorkerPrivate
 {
@@ -52,6 +56,8 @@ CcSyncServerWorker::CcSyncServerWorker(CcSyncServer* oServer, CcSocket oSocket)
   m_oSocket(oSocket)
 {
   CCNEW(m_pPrivate, CcSyncServerWorkerPrivate, oServer);
+  // A request wich is not completed in time must not block a thread of pool
+  m_oSocket.setTimeout(CcDateTimeFromSeconds(CcSyncGlobals::Server::RequestTimeout));
 }
 
 CcSyncServerWorker::~CcSyncServerWorker(void)
@@ -59,164 +65,604 @@ CcSyncServerWorker::~CcSyncServerWorker(void)
   CCDELETE(m_pPrivate);
 }
 
-void CcSyncServerWorker::run()
+bool CcSyncServerWorker::processRequest()
 {
-  while (getThreadState() == EThreadState::Running)
+  if (receiveRequest() &&
+      m_bRequestPending)
   {
-    if (getRequest())
+    executeRequest();
+    // Thread is waiting for next request of this connection now
+    commitGroup();
+  }
+  return m_bActive;
+}
+
+bool CcSyncServerWorker::receiveRequest()
+{
+  if (m_bActive)
+  {
+    if (m_bHandshakeDone == false)
+    {
+      m_bHandshakeDone = acceptHandshake();
+      if (m_bHandshakeDone == false)
+      {
+        CCSYNC_DEBUG("TLS handshake failed or timed out, connection closed", ESyncLogTarget::Server);
+        m_oSocket.close();
+        m_bActive = false;
+      }
+    }
+    else if (getRequest())
+    {
+      m_bRequestPending = true;
+    }
+    else
+    {
+      if (m_oResponse.isBusy() == false)
+        m_oResponse.setError(EStatus::CommandError, "Request malformed. Connection will get closed.");
+      sendResponse();
+      m_bActive = false;
+    }
+  }
+  return m_bActive;
+}
+
+bool CcSyncServerWorker::receiveAvailableRequest()
+{
+  if (m_bActive)
+  {
+    if (readRequestData() == false)
+    {
+      // Closed by client or request too large
+      m_bActive = false;
+    }
+    else if (isRequestReady())
     {
-      if (m_oUser.isValid())
-        m_oUser.getDatabase()->beginTransaction();
-      ESyncCommandType eCommandType = m_oRequest.getCommandType();
-      switch (eCommandType)
+      receiveRequest();
+    }
+  }
+  return m_bActive;
+}
+
+bool CcSyncServerWorker::executeRequest()
+{
+  if (m_bActive &&
+      m_bRequestPending)
+  {
+    m_bRequestPending = false;
+    CcDateTime oStart = CcKernel::getUpTime();
+    resolveSessionRequest();
+    // Database of user will be committed in groups, see CcSyncDbClient::beginGroupTransaction.
+    // Group is committed at latest if connection waits for next request, see commitGroup.
+    if (m_oUser.isValid() &&
+        m_pGroupDatabase != m_oUser.getDatabase())
+    {
+      if (m_pGroupDatabase != nullptr)
       {
-        case ESyncCommandType::Close:
-          m_oSocket.close();
-          enterState(EThreadState::Stopping);
-          break;
-        case ESyncCommandType::ServerGetInfo:
-          m_oResponse.init(eCommandType);
-          doServerGetInfo();
-          break;
-        case ESyncCommandType::ServerAccountCreate:
-          m_oResponse.init(eCommandType);
-          doServerAccountCreate();
-          break;
-        case ESyncCommandType::ServerAccountRescan:
-          m_oResponse.init(eCommandType);
-          doServerRescan();
-          break;
-        case ESyncCommandType::ServerAccountRemove:
-          m_oResponse.init(eCommandType);
-          doServerAccountRemove();
-          break;
-        case ESyncCommandType::ServerStop:
-          m_oResponse.init(eCommandType);
-          doServerStop();
-          enterState(EThreadState::Stopping);
-          break;
-        case ESyncCommandType::AccountCreate:
-          m_oResponse.init(eCommandType);
-          doAccountCreate();
-          break;
-        case ESyncCommandType::AccountLogin:
-          m_oResponse.init(eCommandType);
-          doAccountLogin();
-          break;
-        case ESyncCommandType::AccountGetData:
-          m_oResponse.init(eCommandType);
-          doAccountGetData();
-          break;
-        case ESyncCommandType::AccountSetData:
-          m_oResponse.init(eCommandType);
-          doAccountSetData();
-          break;
-        case ESyncCommandType::AccountGetDirectoryList:
-          m_oResponse.init(eCommandType);
-          doAccountGetDirectoryList();
-          break;
-        case ESyncCommandType::AccountGetCommandList:
-          m_oResponse.init(eCommandType);
-          doUserGetCommandList();
-          break;
-        case ESyncCommandType::AccountCreateDirectory:
-          m_oResponse.init(eCommandType);
-          doAccountCreateDirectory();
-          break;
-        case ESyncCommandType::AccountRemoveDirectory:
-          m_oResponse.init(eCommandType);
-          doAccountRemoveDirectory();
-          break;
-        case ESyncCommandType::AccountRights:
-          m_oResponse.init(eCommandType);
-          doAccountRights();
-          break;
-        case ESyncCommandType::AccountDatabaseUpdateChanged:
-          m_oResponse.init(eCommandType);
-          doAccountDatabaseUpdateChanged();
-          break;
-        case ESyncCommandType::DirectoryGetFileList:
-          m_oResponse.init(eCommandType);
-          doDirectoryGetFileList();
-          break;
-        case ESyncCommandType::DirectoryGetFileInfo:
-          m_oResponse.init(eCommandType);
-          doDirectoryGetFileInfo();
-          break;
-        case ESyncCommandType::DirectoryGetDirectoryInfo:
-          m_oResponse.init(eCommandType);
-          doDirectoryGetDirectoryInfo();
-          break;
-        case ESyncCommandType::DirectoryCreateDirectory:
-          m_oResponse.init(eCommandType);
-          doDirectoryCreateDirectory();
-          break;
-        case ESyncCommandType::DirectoryRemoveDirectory:
-          m_oResponse.init(eCommandType);
-          doDirectoryRemoveDirectory();
-          break;
-        case ESyncCommandType::DirectoryUploadFile:
-          m_oResponse.init(eCommandType);
+        lockDatabase(m_pGroupDatabase);
+        m_pGroupDatabase->endGroupTransaction();
+        m_pGroupDatabase->unlock();
+      }
+      m_pGroupDatabase = m_oUser.getDatabase();
+      lockDatabase(m_pGroupDatabase);
+      m_pGroupDatabase->beginGroupTransaction();
+      m_pGroupDatabase->unlock();
+    }
+    ESyncCommandType eCommandType = m_oRequest.getCommandType();
+    CcSyncTraceSpan oSpan("Execute", "Handler");
+    if (oSpan.isActive())
+      oSpan.setDetail(CcSyncServerStats::getCommandName(eCommandType));
+    // Read commands are using a reader and are not waiting for writers
+    if (isReadCommand(eCommandType) == false ||
+        acquireReader() == false)
+    {
+      // Database is shared with other workers of same user, keep it locked
+      // while request is processed, transfers are releasing it.
+      m_pLockedDatabase = m_pGroupDatabase;
+      if (m_pLockedDatabase != nullptr)
+        lockDatabase(m_pLockedDatabase);
+    }
+    switch (eCommandType)
+    {
+      case ESyncCommandType::Close:
+        m_oSocket.close();
+        m_bActive = false;
+        break;
+      case ESyncCommandType::ServerGetInfo:
+        m_oResponse.init(eCommandType);
+        doServerGetInfo();
+        break;
+      case ESyncCommandType::ServerAccountCreate:
+        m_oResponse.init(eCommandType);
+        doServerAccountCreate();
+        break;
+      case ESyncCommandType::ServerAccountRescan:
+        m_oResponse.init(eCommandType);
+        doServerRescan();
+        break;
+      case ESyncCommandType::ServerAccountRemove:
+        m_oResponse.init(eCommandType);
+        doServerAccountRemove();
+        break;
+      case ESyncCommandType::ServerStop:
+        m_oResponse.init(eCommandType);
+        doServerStop();
+        m_bActive = false;
+        break;
+      case ESyncCommandType::ServerGetStats:
+        m_oResponse.init(eCommandType);
+        doServerGetStats();
+        break;
+      case ESyncCommandType::ServerSetTrace:
+        m_oResponse.init(eCommandType);
+        doServerSetTrace();
+        break;
+      case ESyncCommandType::ServerSetProfiler:
+        m_oResponse.init(eCommandType);
+        doServerSetProfiler();
+        break;
+      case ESyncCommandType::AccountCreate:
+        m_oResponse.init(eCommandType);
+        doAccountCreate();
+        break;
+      case ESyncCommandType::AccountLogin:
+        m_oResponse.init(eCommandType);
+        doAccountLogin();
+        break;
+      case ESyncCommandType::AccountGetData:
+        m_oResponse.init(eCommandType);
+        doAccountGetData();
+        break;
+      case ESyncCommandType::AccountSetData:
+        m_oResponse.init(eCommandType);
+        doAccountSetData();
+        break;
+      case ESyncCommandType::AccountGetDirectoryList:
+        m_oResponse.init(eCommandType);
+        doAccountGetDirectoryList();
+        break;
+      case ESyncCommandType::AccountGetCommandList:
+        m_oResponse.init(eCommandType);
+        doUserGetCommandList();
+        break;
+      case ESyncCommandType::AccountCreateDirectory:
+        m_oResponse.init(eCommandType);
+        doAccountCreateDirectory();
+        break;
+      case ESyncCommandType::AccountRemoveDirectory:
+        m_oResponse.init(eCommandType);
+        doAccountRemoveDirectory();
+        break;
+      case ESyncCommandType::AccountRights:
+        m_oResponse.init(eCommandType);
+        doAccountRights();
+        break;
+      case ESyncCommandType::AccountDatabaseUpdateChanged:
+        m_oResponse.init(eCommandType);
+        doAccountDatabaseUpdateChanged();
+        break;
+      case ESyncCommandType::DirectoryGetFileList:
+        m_oResponse.init(eCommandType);
+        doDirectoryGetFileList();
+        break;
+      case ESyncCommandType::DirectoryGetFileInfo:
+        m_oResponse.init(eCommandType);
+        doDirectoryGetFileInfo();
+        break;
+      case ESyncCommandType::DirectoryGetDirectoryInfo:
+        m_oResponse.init(eCommandType);
+        doDirectoryGetDirectoryInfo();
+        break;
+      case ESyncCommandType::DirectoryCreateDirectory:
+        m_oResponse.init(eCommandType);
+        doDirectoryCreateDirectory();
+        break;
+      case ESyncCommandType::DirectoryRemoveDirectory:
+        m_oResponse.init(eCommandType);
+        doDirectoryRemoveDirectory();
+        break;
+      case ESyncCommandType::DirectoryUploadFile:
+        m_oResponse.init(eCommandType);
+        if (acquireTransfer())
+        {
           doDirectoryUploadFile();
-          break;
-        case ESyncCommandType::DirectoryRemoveFile:
-          m_oResponse.init(eCommandType);
-          doDirectoryRemoveFile();
-          break;
-        case ESyncCommandType::DirectoryDownloadFile:
-          m_oResponse.init(eCommandType);
+          releaseTransfer();
+        }
+        break;
+      case ESyncCommandType::DirectoryRemoveFile:
+        m_oResponse.init(eCommandType);
+        doDirectoryRemoveFile();
+        break;
+      case ESyncCommandType::DirectoryDownloadFile:
+        m_oResponse.init(eCommandType);
+        if (acquireTransfer())
+        {
           doDirectoryDownloadFile();
-          break;
-        default:
-          m_oResponse.init(ESyncCommandType::Unknown);
-          m_oResponse.setResult(false);
-          m_oResponse.setError(EStatus::CommandUnknown, "Unknown Command");
-          sendResponse();
+          releaseTransfer();
+        }
+        break;
+      default:
+        m_oResponse.init(ESyncCommandType::Unknown);
+        m_oResponse.setResult(false);
+        m_oResponse.setError(EStatus::CommandUnknown, "Unknown Command");
+        sendResponse();
+    }
+    if (m_pLockedDatabase != nullptr)
+    {
+      CcDateTime oCommitStart = CcKernel::getUpTime();
+      CcSyncTraceSpan oCommitSpan("Next group", "Database");
+      // Read commands through writer have nothing to commit
+      if (isReadCommand(eCommandType) == false)
+        m_pLockedDatabase->nextGroupTransaction();
+      oCommitSpan.end();
+      m_uiDatabaseTime += static_cast<uint64>((CcKernel::getUpTime() - oCommitStart).getTimestampUs());
+      m_pLockedDatabase->unlock();
+      m_pLockedDatabase = nullptr;
+    }
+    if (m_pReader != nullptr)
+    {
+      m_pReaderAccount->releaseReader(m_pReader);
+      m_pReaderAccount = nullptr;
+    }
+    oSpan.end();
+    uint64 uiTime = static_cast<uint64>((CcKernel::getUpTime() - oStart).getTimestampUs());
+    m_pServer->stats().record(eCommandType, getAccountName(), uiTime, m_uiDatabaseTime, m_uiBytesSent, m_uiBytesReceived);
+    m_uiBytesSent = 0;
+    m_uiBytesReceived = 0;
+    m_uiDatabaseTime = 0;
+    m_oLastRequest = CcKernel::getUpTime();
+  }
+  return m_bActive;
+}
+
+CcString CcSyncServerWorker::getAccountName()
+{
+  CcString sAccount;
+  if (m_oUser.isValid())
+  {
+    sAccount = m_oUser.getAccountConfig()->getName();
+  }
+  return sAccount;
+}
+
+uint32 CcSyncServerWorker::getAccountWeight()
+{
+  uint32 uiWeight = 1;
+  if (m_oUser.isValid())
+  {
+    CcSyncServerAccountPointer pAccount = m_pServer->config().findAccount(m_oUser.getAccountConfig()->getName());
+    if (pAccount != nullptr)
+      uiWeight = pAccount->getWeight();
+  }
+  return uiWeight;
+}
+
+bool CcSyncServerWorker::isBulkRequest()
+{
+  return m_oRequest.getCommandType() == ESyncCommandType::DirectoryUploadFile ||
+         m_oRequest.getCommandType() == ESyncCommandType::DirectoryDownloadFile;
+}
+
+void CcSyncServerWorker::commitGroup()
+{
+  if (m_pGroupDatabase != nullptr &&
+      m_pGroupDatabase->hasPendingGroupTransaction())
+  {
+    m_pGroupDatabase->lock();
+    m_pGroupDatabase->commitPendingGroupTransaction();
+    m_pGroupDatabase->unlock();
+  }
+}
+
+void CcSyncServerWorker::close()
+{
+  m_bActive = false;
+  if (m_pGroupDatabase != nullptr)
+  {
+    m_pGroupDatabase->lock();
+    m_pGroupDatabase->endGroupTransaction();
+    m_pGroupDatabase->unlock();
+    m_pGroupDatabase = nullptr;
+  }
+  m_oSocket.close();
+}
+
+void CcSyncServerWorker::releaseAccount()
+{
+  if (m_pGroupDatabase != nullptr)
+  {
+    m_pGroupDatabase->lock();
+    m_pGroupDatabase->endGroupTransaction();
+    m_pGroupDatabase->unlock();
+    m_pGroupDatabase = nullptr;
+  }
+  m_oDirectory = CcSyncDirectory();
+  if (m_oUser.isValid())
+  {
+    m_sReleasedToken = m_oUser.getToken();
+    m_oUser = CcSyncUser();
+  }
+}
+
+void CcSyncServerWorker::abort()
+{
+  m_bActive = false;
+  m_oSocket.close();
+}
+
+bool CcSyncServerWorker::acceptHandshake()
+{
+  bool bRet = false;
+  CcSslSocket* pSslSocket = static_cast<CcSslSocket*>(m_oSocket.getRawSocket());
+  if (pSslSocket != nullptr)
+  {
+#ifdef CCSYNC_SSL_SESSION
+    // Client has to finish handshake in time, otherwise it would keep a thread
+    m_oSocket.setTimeout(CcDateTimeFromSeconds(CcSyncGlobals::Server::HandshakeTimeout));
+    bRet = pSslSocket->finalizeAccept();
+    if (bRet)
+    {
+      m_pServer->countHandshake(pSslSocket->isSessionReused());
+    }
+    m_oSocket.setTimeout(CcDateTimeFromSeconds(CcSyncGlobals::Server::RequestTimeout));
+#else
+    // Full handshake was already done by accept of server
+    m_pServer->countHandshake(false);
+    bRet = true;
+#endif
+  }
+  return bRet;
+}
+
+bool CcSyncServerWorker::isReadCommand(ESyncCommandType eCommandType)
+{
+  switch (eCommandType)
+  {
+    case ESyncCommandType::DirectoryGetFileList:
+    case ESyncCommandType::DirectoryGetFileInfo:
+    case ESyncCommandType::DirectoryGetDirectoryInfo:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool CcSyncServerWorker::acquireReader()
+{
+  // Readers are seeing only committed changes, if the group has uncommitted
+  // items, request is read through writer instead of committing early.
+  if (m_oUser.isValid() &&
+      m_pGroupDatabase != nullptr &&
+      m_pGroupDatabase->hasPendingGroupTransaction() == false)
+  {
+    CcSyncServerAccountPointer pAccount = m_pServer->config().findAccount(m_oUser.getAccountConfig()->getName());
+    if (pAccount != nullptr)
+    {
+      CcString sClientPath = m_pServer->config().getLocation().getPath();
+      sClientPath.appendPath(pAccount->getName());
+      m_pReader = pAccount->acquireReader(sClientPath);
+      if (m_pReader != nullptr)
+      {
+        m_pReaderAccount = pAccount;
       }
-      if (m_oUser.isValid())
-        m_oUser.getDatabase()->endTransaction();
+    }
+  }
+  return m_pReader != nullptr;
+}
+
+void CcSyncServerWorker::lockDatabase(CcSyncDbClientPointer& pDatabase)
+{
+  CcDateTime oLockStart = CcKernel::getUpTime();
+  CcSyncTraceSpan oSpan("Lock", "Database");
+  pDatabase->lock();
+  m_uiDatabaseTime += static_cast<uint64>((CcKernel::getUpTime() - oLockStart).getTimestampUs());
+}
+
+bool CcSyncServerWorker::acquireTransfer()
+{
+  bool bRet = true;
+  // Requests without valid user are rejected by command itself
+  if (m_oUser.isValid())
+  {
+    CcString sAccount = m_oUser.getAccountConfig()->getName();
+    if (m_pServer->admission().acquire(sAccount))
+    {
+      m_sTransferAccount = sAccount;
+      CcSyncServerAccountPointer pAccount = m_pServer->config().findAccount(sAccount);
+      if (pAccount != nullptr)
+        m_pTransferLimit = m_pServer->bandwidth().begin(sAccount, pAccount->getBandwidth(), pAccount->getWeight());
+      else
+        m_pTransferLimit = m_pServer->bandwidth().begin(sAccount, 0, 1);
     }
     else
     {
-      m_oResponse.setError(EStatus::CommandError, "Request malformed. Connection will get closed.");
+      m_oResponse.setBusy(m_pServer->admission().getRetryAfter());
       sendResponse();
-      stop();
+      bRet = false;
     }
   }
+  return bRet;
+}
+
+void CcSyncServerWorker::releaseTransfer()
+{
+  if (m_sTransferAccount.length() > 0)
+  {
+    m_pTransferLimit = nullptr;
+    m_pServer->bandwidth().end(m_sTransferAccount);
+    m_pServer->admission().release(m_sTransferAccount);
+    m_sTransferAccount.clear();
+  }
+}
+
+bool CcSyncServerWorker::readRequestData()
+{
+  bool bRet = true;
+  CcSyncBuffer oData;
+  if (m_bHandshakeDone &&
+      oData.acquire(CcSyncGlobals::Server::ReactorReadSize, 0) == false)
+  {
+    // Do not wait for pool here, getRequest waits and can answer busy
+    m_bReadDeferred = true;
+  }
+  else if (m_bHandshakeDone)
+  {
+    // Socket is readable, short timeout avoids that a stalled client holds thread
+    m_oSocket.setTimeout(CcDateTimeFromSeconds(CcSyncGlobals::Server::ReactorReadTimeout));
+    size_t uiRead = m_oSocket.readArray(oData.data(), false);
+    m_oSocket.setTimeout(CcDateTimeFromSeconds(CcSyncGlobals::Server::RequestTimeout));
+    if (uiRead > 0 && uiRead <= oData.data().size())
+    {
+      m_uiBytesReceived += uiRead;
+      m_sRequestData.append(oData.data(), 0, uiRead);
+      bRet = m_sRequestData.length() <= CcSyncGlobals::MaxRequestSize;
+    }
+    else
+    {
+      bRet = false;
+    }
+  }
+  return bRet;
+}
+
+bool CcSyncServerWorker::isRequestReady()
+{
+  return m_bHandshakeDone == false ||
+         m_bReadDeferred ||
+         scanRequestData();
+}
+
+bool CcSyncServerWorker::scanRequestData()
+{
+  while (m_bRequestComplete == false &&
+         m_uiRequestScanned < m_sRequestData.length())
+  {
+    char cSign = m_sRequestData[m_uiRequestScanned];
+    m_uiRequestScanned++;
+    if (m_bRequestString)
+    {
+      if (m_bRequestEscape)
+        m_bRequestEscape = false;
+      else if (cSign == '\\')
+        m_bRequestEscape = true;
+      else if (cSign == '"')
+        m_bRequestString = false;
+    }
+    else if (cSign == '"')
+    {
+      m_bRequestString = true;
+    }
+    else if (cSign == '{' || cSign == '[')
+    {
+      m_uiRequestDepth++;
+    }
+    else if (cSign == '}' || cSign == ']')
+    {
+      // Unbalanced data is complete too, parser will reject it
+      if (m_uiRequestDepth > 0)
+        m_uiRequestDepth--;
+      m_bRequestComplete = m_uiRequestDepth == 0;
+    }
+  }
+  return m_bRequestComplete;
 }
 
 bool CcSyncServerWorker::getRequest()
 {
   bool bRet = false;
-  CcByteArray oData(static_cast<size_t>(CcSyncGlobals::MaxRequestSize));
-  m_oSocket.readArray(oData);
-  if (m_oRequest.parseData(oData))
+  bool bBuffer = true;
+  m_bReadDeferred = false;
+  // Request may be read by readRequestData already, completely or in parts
+  if (scanRequestData() == false)
+  {
+    CcSyncBuffer oData;
+    bBuffer = oData.acquire(static_cast<size_t>(CcSyncGlobals::MaxRequestSize));
+    size_t uiRead = 0;
+    while (bBuffer)
+    {
+      uiRead = m_oSocket.readArray(oData.data(), false);
+      if (uiRead > 0 && uiRead <= oData.data().size())
+      {
+        m_uiBytesReceived += uiRead;
+        m_sRequestData.append(oData.data(), 0, uiRead);
+      }
+      if (uiRead == 0 || uiRead > oData.data().size() ||
+          m_sRequestData.length() > CcSyncGlobals::MaxRequestSize ||
+          scanRequestData())
+      {
+        break;
+      }
+    }
+  }
+  CcSyncTraceSpan oSpan("Parse request", "Json");
+  if (bBuffer == false)
+  {
+    // Rest of request can not be read, connection has to be closed
+    m_oResponse.init(ESyncCommandType::Unknown);
+    m_oResponse.setBusy(m_pServer->admission().getRetryAfter());
+  }
+  else if (m_sRequestData.length() <= CcSyncGlobals::MaxRequestSize &&
+           m_oRequest.parseData(m_sRequestData))
   {
     bRet = true;
   }
   else
   {
+    m_oResponse.init(ESyncCommandType::Unknown);
     m_oResponse.setError(EStatus::CommandError, "Message malformed");
   }
+  m_sRequestData.clear();
+  m_uiRequestScanned = 0;
+  m_uiRequestDepth = 0;
+  m_bRequestString = false;
+  m_bRequestEscape = false;
+  m_bRequestComplete = false;
   return bRet;
 }
 
 bool CcSyncServerWorker::sendResponse()
 {
-  return m_oSocket.writeArray(m_oResponse.getBinary());
+  CcSyncTraceSpan oSerializeSpan("Serialize response", "Json");
+  CcByteArray oData = m_oResponse.getBinary();
+  oSerializeSpan.end();
+  m_uiBytesSent += oData.size();
+  CcSyncTraceSpan oWriteSpan("Write response", "Socket");
+  return m_oSocket.writeArray(oData);
+}
+
+void CcSyncServerWorker::resolveSessionRequest()
+{
+  if (m_oRequest.data().contains(CcSyncGlobals::Commands::Session, EJsonDataType::Value))
+  {
+    const CcString& sSession = m_oRequest.data()[CcSyncGlobals::Commands::Session].getValue().getString();
+    if (m_oUser.isValid() == false ||
+        m_oUser.getToken() != sSession)
+    {
+      m_oUser = m_pServer->getUserByToken(sSession);
+    }
+  }
+  else if (m_oUser.isValid() == false &&
+           m_sReleasedToken.length() > 0)
+  {
+    // Login of connection is kept over releaseAccount
+    m_oUser = m_pServer->getUserByToken(m_sReleasedToken);
+  }
+  m_sReleasedToken.clear();
 }
 
 bool CcSyncServerWorker::loadConfigsBySessionRequest()
 {
   bool bRet = false;
   // Check all required data
-  if (m_oUser.isValid() )
-  { 
-    bRet = true;
-  }
-  else if (m_oRequest.data().contains(CcSyncGlobals::Commands::Session, EJsonDataType::Value))
+  if (m_oRequest.data().contains(CcSyncGlobals::Commands::Session, EJsonDataType::Value))
   {
-    if (loadConfigsBySession(m_oRequest.data()[CcSyncGlobals::Commands::Session].getValue().getString()))
+    const CcString& sSession = m_oRequest.data()[CcSyncGlobals::Commands::Session].getValue().getString();
+    // Session is resolved once per connection until token changes
+    if (m_oUser.isValid() &&
+        m_oUser.getToken() == sSession)
+    {
+      bRet = true;
+    }
+    else if (loadConfigsBySession(sSession))
     {
       bRet = true;
     }
@@ -226,6 +672,10 @@ bool CcSyncServerWorker::loadConfigsBySessionRequest()
       bRet = false;
     }
   }
+  else if (m_oUser.isValid())
+  {
+    bRet = true;
+  }
   else
   {
     m_oResponse.setError(EStatus::LoginFailed, "Error: No login data not available");
@@ -249,24 +699,43 @@ bool CcSyncServerWorker::loadConfigsBySession(const CcString& sSession)
   return bRet;
 }
 
-bool CcSyncServerWorker::receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo)
+bool CcSyncServerWorker::acquireTransferBuffer(CcSyncBuffer& oBuffer, uint64 uiFileSize)
+{
+  size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
+  if (uiFileSize < CcSyncGlobals::TransferSize)
+  {
+    uiBufferSize = static_cast<size_t>(uiFileSize);
+  }
+  // Never wait for a buffer while other workers of account are waiting for database
+  if (m_pLockedDatabase != nullptr)
+    m_pLockedDatabase->unlock();
+  bool bRet = oBuffer.acquire(uiBufferSize);
+  if (m_pLockedDatabase != nullptr)
+    lockDatabase(m_pLockedDatabase);
+  if (bRet == false)
+  {
+    m_oResponse.setBusy(m_pServer->admission().getRetryAfter());
+  }
+  return bRet;
+}
+
+bool CcSyncServerWorker::receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo, CcSyncBuffer& oBuffer)
 {
   bool bRet = false;
   bool bTransfer = true;
   CcCrc32 oCrc;
   uint64 uiReceived = 0;
-  size_t uiBufferSize = static_cast<size_t>(CcSyncGlobals::TransferSize);
-  if (oFileInfo.getFileSize() < CcSyncGlobals::TransferSize)
-  {
-    uiBufferSize = static_cast<size_t>(oFileInfo.getFileSize());
-  }
-  CcByteArray oByteArray(uiBufferSize);
+  if (m_pLockedDatabase != nullptr)
+    m_pLockedDatabase->unlock();
+  CcByteArray& oByteArray = oBuffer.data();
   size_t uiLastReceived;
   while (bTransfer)
   {
     if (uiReceived < oFileInfo.getFileSize())
     {
+      CcSyncTraceSpan oReadSpan("Read block", "Socket");
       uiLastReceived = m_oSocket.readArray(oByteArray, false);
+      oReadSpan.end();
       if(oByteArray.size() < uiLastReceived)
       {
         bRet = false;
@@ -276,6 +745,11 @@ bool CcSyncServerWorker::receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo)
       {
         oCrc.append(oByteArray.getArray(), uiLastReceived);
         uiReceived += uiLastReceived;
+        m_uiBytesReceived += uiLastReceived;
+        // Delay next read, so client is slowed down by flow control
+        if (m_pTransferLimit != nullptr)
+          m_pTransferLimit->consume(uiLastReceived);
+        CcSyncTraceSpan oWriteSpan("Write block", "File");
         if (pFile->write(oByteArray.getArray(), uiLastReceived) != uiLastReceived)
         {
           bRet = false;
@@ -291,9 +765,10 @@ bool CcSyncServerWorker::receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo)
     {
       oFileInfo.crc() = oCrc.getValueUint32();
       bTransfer = false;
-      CcByteArray oResponseByteArray(static_cast<size_t>(CcSyncGlobals::TransferSize));
-      m_oSocket.readArray(oResponseByteArray);
-      m_oRequest.parseData(oResponseByteArray);
+      // Buffer is reused for response, capacity is large enough for it
+      oByteArray.resize(oBuffer.getCapacity());
+      m_oSocket.readArray(oByteArray);
+      m_oRequest.parseData(oByteArray);
       if (m_oRequest.getCommandType() == ESyncCommandType::Crc)
       {
         if (m_oRequest.getCrc() == oCrc)
@@ -311,29 +786,43 @@ bool CcSyncServerWorker::receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo)
       }
     }
   }
+  oBuffer.release();
+  if (m_pLockedDatabase != nullptr)
+    lockDatabase(m_pLockedDatabase);
   return bRet;
 }
 
-bool CcSyncServerWorker::sendFile(const CcString& sPath)
+bool CcSyncServerWorker::sendFile(const CcString& sPath, CcSyncBuffer& oPoolBuffer)
 {
   bool bRet = false;
   CcFile oFile(sPath);
   CcCrc32 oCrc;
+  if (m_pLockedDatabase != nullptr)
+    m_pLockedDatabase->unlock();
   if (oFile.open(EOpenFlags::Read | EOpenFlags::ShareRead))
   {
     bool bTransfer = true;
-    CcByteArray oBuffer(static_cast<size_t>(CcSyncGlobals::TransferSize));
+    CcByteArray& oBuffer = oPoolBuffer.data();
     size_t uiLastTransferSize;
     while (bTransfer)
     {
+      CcSyncTraceSpan oReadSpan("Read block", "File");
       uiLastTransferSize = oFile.readArray(oBuffer, false);
+      oReadSpan.end();
       if (uiLastTransferSize > 0 && uiLastTransferSize <= oBuffer.size() )
       {
         oCrc.append(oBuffer.getArray(), uiLastTransferSize);
+        if (m_pTransferLimit != nullptr)
+          m_pTransferLimit->consume(uiLastTransferSize);
+        CcSyncTraceSpan oWriteSpan("Write block", "Socket");
         if (m_oSocket.write(oBuffer.getArray(), uiLastTransferSize) != uiLastTransferSize)
         {
           bTransfer = false;
         }
+        else
+        {
+          m_uiBytesSent += uiLastTransferSize;
+        }
       }
       else
       {
@@ -345,9 +834,11 @@ bool CcSyncServerWorker::sendFile(const CcString& sPath)
   }
   if (bRet == true)
   {
-    CcByteArray oByteArray(static_cast<size_t>(CcSyncGlobals::TransferSize));
-    m_oSocket.readArray(oByteArray);
-    m_oRequest.parseData(oByteArray);
+    // Buffer is reused for response, capacity is large enough for it
+    CcByteArray& oResponse = oPoolBuffer.data();
+    oResponse.resize(oPoolBuffer.getCapacity());
+    m_oSocket.readArray(oResponse);
+    m_oRequest.parseData(oResponse);
     if (m_oRequest.getCommandType() == ESyncCommandType::Crc)
     {
       if (m_oRequest.getCrc() == oCrc)
@@ -364,6 +855,8 @@ bool CcSyncServerWorker::sendFile(const CcString& sPath)
       bRet = false;
     }
   }
+  if (m_pLockedDatabase != nullptr)
+    lockDatabase(m_pLockedDatabase);
   return bRet;
 }
 
@@ -399,12 +892,90 @@ bool CcSyncServerWorker::loadDirectory()
   return bRet;
 }
 
+bool CcSyncServerWorker::loadReadDirectory(CcSyncDbClientPointer& pDatabase, CcString& sDirectoryName)
+{
+  bool bRet = false;
+  if (m_pReader == nullptr)
+  {
+    if (loadDirectory())
+    {
+      pDatabase = m_oUser.getDatabase();
+      sDirectoryName = m_oDirectory.getName();
+      bRet = true;
+    }
+  }
+  else if (m_oRequest.data().contains(CcSyncGlobals::Commands::DirectoryGetFileList::DirectoryName, EJsonDataType::Value))
+  {
+    // Reader does not need a CcSyncDirectory, it would setup tables on writer
+    sDirectoryName = m_oRequest.data()[CcSyncGlobals::Commands::DirectoryGetFileList::DirectoryName].getValue().getString();
+    if (m_oUser.getAccountConfig()->directoryList().getDirectoryByName(sDirectoryName) != nullptr)
+    {
+      pDatabase = m_pReader;
+      bRet = true;
+    }
+    else
+    {
+      m_oResponse.setError(EStatus::ConfigFolderNotFound, "Requested Directory not found.");
+    }
+  }
+  else
+  {
+    m_oResponse.setError(EStatus::CommandRequiredParameter, "No Directory specified.");
+  }
+  return bRet;
+}
+
 void CcSyncServerWorker::doServerGetInfo()
 {
   m_oResponse.setError(EStatus::CommandNotImplemented, "Not yet implemented");
   sendResponse();
 }
 
+void CcSyncServerWorker::doServerGetStats()
+{
+  if (loadConfigsBySessionRequest() &&
+      m_oUser.getRights() >= ESyncRights::Admin)
+  {
+    m_oResponse.setServerStats(m_pServer->getStats());
+  }
+  else
+  {
+    m_oResponse.setError(EStatus::UserAccessDenied, "No permission to get statistics");
+  }
+  sendResponse();
+}
+
+void CcSyncServerWorker::doServerSetTrace()
+{
+  if (loadConfigsBySessionRequest() &&
+      m_oUser.getRights() >= ESyncRights::Admin)
+  {
+    if (!m_pServer->setTrace(m_oRequest.getServerSetTrace()))
+    {
+      m_oResponse.setError(EStatus::FSFileCreateFailed, "Failed to open trace file");
+    }
+  }
+  else
+  {
+    m_oResponse.setError(EStatus::UserAccessDenied, "No permission to change tracing");
+  }
+  sendResponse();
+}
+
+void CcSyncServerWorker::doServerSetProfiler()
+{
+  if (loadConfigsBySessionRequest() &&
+      m_oUser.getRights() >= ESyncRights::Admin)
+  {
+    CcSyncDbProfiler::setEnabled(m_oRequest.getServerSetProfiler());
+  }
+  else
+  {
+    m_oResponse.setError(EStatus::UserAccessDenied, "No permission to change profiler");
+  }
+  sendResponse();
+}
+
 void CcSyncServerWorker::doServerRescan()
 {
   if (loadConfigsBySessionRequest() &&
@@ -484,7 +1055,7 @@ void CcSyncServerWorker::doServerStop()
     m_oSocket.close();
 
     m_pServer->shutdown();
-    stop();
+    m_bActive = false;
   }
   else
   {
@@ -517,7 +1088,7 @@ void CcSyncServerWorker::doAccountLogin()
     }
     else
     {
-      CcSyncLog::writeDebug("AccountLogin failed: " + sUserName);
+      CCSYNC_DEBUG("AccountLogin failed: " + sUserName);
       m_oResponse.setError(EStatus::LoginFailed, "Login Failed");
     }
   }
@@ -532,13 +1103,13 @@ void CcSyncServerWorker::doAccountLogin()
     }
     else
     {
-      CcSyncLog::writeDebug("AccountLogin with session failed");
+      CCSYNC_DEBUG("AccountLogin with session failed");
       m_oResponse.setError(EStatus::LoginFailed, "Login Failed");
     }
   }
   else
   {
-    CcSyncLog::writeDebug("AccountLogin failed due to wrong parameters");
+    CCSYNC_DEBUG("AccountLogin failed due to wrong parameters");
     m_oResponse.setError(EStatus::CommandRequiredParameter, "User login data missing.");
   }
   sendResponse();
@@ -552,7 +1123,7 @@ void CcSyncServerWorker::doAccountGetData()
   }
   else
   {
-    CcSyncLog::writeDebug("AccountLogin failed due to wrong parameters");
+    CCSYNC_DEBUG("AccountLogin failed due to wrong parameters");
     m_oResponse.setError(EStatus::CommandRequiredParameter, "User login data missing.");
   }
   sendResponse();
@@ -733,16 +1304,18 @@ void CcSyncServerWorker::doUserGetCommandList()
 
 void CcSyncServerWorker::doDirectoryGetFileList()
 {
+  CcSyncDbClientPointer pDatabase;
+  CcString sDirectoryName;
   // Check all required data
   if (loadConfigsBySessionRequest() &&
-      loadDirectory())
+      loadReadDirectory(pDatabase, sDirectoryName))
   {
     if (m_oRequest.data().contains(CcSyncGlobals::Commands::DirectoryGetFileList::Id, EJsonDataType::Value))
     {
       size_t uiId = m_oRequest.data()[CcSyncGlobals::Commands::DirectoryGetFileList::Id].getValue().getSize();
-      CcSyncFileInfoList oDirectoryInfos = m_oDirectory.getDirectoryInfoListById(uiId);
-      CcSyncFileInfoList oFileInfos      = m_oDirectory.getFileInfoListById(uiId);
-      //CcSyncLog::writeDebug("DirId: " + CcString::fromNumber(uiId) + " Dirs: " + CcString::fromNumber(oDirectoryInfos.size()) + " Files: " + CcString::fromNumber(oFileInfos.size()));
+      CcSyncFileInfoList oDirectoryInfos = pDatabase->getDirectoryInfoListById(sDirectoryName, uiId);
+      CcSyncFileInfoList oFileInfos      = pDatabase->getFileInfoListById(sDirectoryName, uiId);
+      //CCSYNC_DEBUG("DirId: " + CcString::fromNumber(uiId) + " Dirs: " + CcString::fromNumber(oDirectoryInfos.size()) + " Files: " + CcString::fromNumber(oFileInfos.size()));
       m_oResponse.addDirectoryDirectoryInfoList(oDirectoryInfos, oFileInfos);
     }
     else
@@ -762,14 +1335,16 @@ void CcSyncServerWorker::doDirectoryGetFileList()
 
 void CcSyncServerWorker::doDirectoryGetFileInfo()
 {
+  CcSyncDbClientPointer pDatabase;
+  CcString sDirectoryName;
   // Check all required data
   if (loadConfigsBySessionRequest() &&
-      loadDirectory())
+      loadReadDirectory(pDatabase, sDirectoryName))
   {
     if (m_oRequest.data().contains(CcSyncGlobals::Commands::DirectoryGetFileList::Id, EJsonDataType::Value))
     {
       uint64 uiFileId = m_oRequest.data()[CcSyncGlobals::Commands::DirectoryGetFileInfo::Id].getValue().getUint64();
-      CcSyncFileInfo oDirInfo = m_oDirectory.getFileInfoById(uiFileId);
+      CcSyncFileInfo oDirInfo = pDatabase->getFileInfoById(sDirectoryName, uiFileId);
       m_oResponse.addFileInfo(oDirInfo);
     }
     else
@@ -782,13 +1357,15 @@ void CcSyncServerWorker::doDirectoryGetFileInfo()
 
 void CcSyncServerWorker::doDirectoryGetDirectoryInfo()
 {
+  CcSyncDbClientPointer pDatabase;
+  CcString sDirectoryName;
   if (loadConfigsBySessionRequest() &&
-    loadDirectory())
+    loadReadDirectory(pDatabase, sDirectoryName))
   {
     if (m_oRequest.data().contains(CcSyncGlobals::Commands::DirectoryGetDirectoryInfo::Id, EJsonDataType::Value))
     {
       uint64 uiDirId = m_oRequest.data()[CcSyncGlobals::Commands::DirectoryGetDirectoryInfo::Id].getValue().getUint64();
-      CcSyncDirInfo oDirInfo = m_oDirectory.getDirectoryInfoById(uiDirId);
+      CcSyncDirInfo oDirInfo = pDatabase->getDirectoryInfoById(sDirectoryName, uiDirId);
       m_oResponse.addFileInfo(oDirInfo);
     }
     else
@@ -915,12 +1492,21 @@ void CcSyncServerWorker::doDirectoryUploadFile()
         CcString sTempFilePath = oFileInfo.getSystemFullPath();
         sTempFilePath.append(CcSyncGlobals::TemporaryExtension);
         CcFile oFile(sTempFilePath);
-        if (oFile.open(EOpenFlags::Overwrite))
+        CcSyncBuffer oBuffer;
+        if (acquireTransferBuffer(oBuffer, oFileInfo.getFileSize()) == false)
+        {
+          CCSYNC_DEBUG("DirectoryUploadFile rejected, no transfer buffer available");
+        }
+        else if (oFile.open(EOpenFlags::Overwrite))
         {
+          // Intent is written before transfer, commits of other requests meanwhile are making it durable
+          CcSyncJournalEntry oJournal;
+          m_oDirectory.journalInsert(EBackupQueueType::AddFile, oFileInfo, oJournal);
           sendResponse();
-          if (receiveFile(&oFile, oFileInfo))
+          if (receiveFile(&oFile, oFileInfo, oBuffer))
           {
             oFile.close();
+            m_oDirectory.journalSync(oJournal);
             bool bSuccess = true;
             if (m_oDirectory.fileNameInDirExists(oFileInfo.getDirId(), oFileInfo))
             {
@@ -934,7 +1520,7 @@ void CcSyncServerWorker::doDirectoryUploadFile()
                 bSuccess = CcFile::remove(sTempFilePath);
                 if(bSuccess == false)
                 {
-                  CcSyncLog::writeDebug("Failed to remove original File: " + oFileInfo.getSystemFullPath());
+                  CCSYNC_DEBUG("Failed to remove original File: " + oFileInfo.getSystemFullPath());
                 }
               }
             }
@@ -945,8 +1531,8 @@ void CcSyncServerWorker::doDirectoryUploadFile()
               {
                 m_oResponse.init(ESyncCommandType::Crc);
                 m_oResponse.setError(EStatus::FSFileCreateFailed, "Failed to move temporary File");
-                CcSyncLog::writeDebug("Failed to move temporary File: ");
-                CcSyncLog::writeDebug("  " + sTempFilePath + " -> " + oFileInfo.getSystemFullPath());
+                CCSYNC_DEBUG("Failed to move temporary File: ");
+                CCSYNC_DEBUG("  " + sTempFilePath + " -> " + oFileInfo.getSystemFullPath());
               }
             }
             if (bSuccess)
@@ -971,6 +1557,8 @@ void CcSyncServerWorker::doDirectoryUploadFile()
             m_oResponse.init(ESyncCommandType::Crc);
             m_oResponse.setError(EStatus::FileTransferFailed, "Crc comparision failed");
           }
+          // Removed with list update, both are committed together
+          m_oDirectory.journalRemove(oJournal);
         }
         else
         {
@@ -1048,23 +1636,29 @@ void CcSyncServerWorker::doDirectoryDownloadFile()
           bSuccess = m_oDirectory.fileListCreate(oFileInfo, true);
           if(bSuccess == false)
           {
-            CcSyncLog::writeDebug("DirectoryDownloadFile send File failed:");
-            CcSyncLog::writeDebug("    " + oFileInfo.getSystemFullPath());
+            CCSYNC_DEBUG("DirectoryDownloadFile send File failed:");
+            CCSYNC_DEBUG("    " + oFileInfo.getSystemFullPath());
             m_oResponse.setError(EStatus::FSFileError, "File in database differ with local");
           }
         }
-        if(bSuccess == true)
+        CcSyncBuffer oBuffer;
+        if (bSuccess == true &&
+            acquireTransferBuffer(oBuffer, CcSyncGlobals::TransferSize) == false)
+        {
+          CCSYNC_DEBUG("DirectoryDownloadFile rejected, no transfer buffer available");
+        }
+        else if(bSuccess == true)
         {
           m_oResponse.addFileInfo(oFileInfo);
           sendResponse();
-          if (sendFile(oFileInfo.getSystemFullPath()))
+          if (sendFile(oFileInfo.getSystemFullPath(), oBuffer))
           {
             m_oResponse.init(ESyncCommandType::Crc);
           }
           else
           {
-            CcSyncLog::writeDebug("DirectoryDownloadFile send File failed:");
-            CcSyncLog::writeDebug("    " + oFileInfo.getSystemFullPath());
+            CCSYNC_DEBUG("DirectoryDownloadFile send File failed:");
+            CCSYNC_DEBUG("    " + oFileInfo.getSystemFullPath());
             m_oResponse.setError(EStatus::FSFileCrcFailed, "FileTransfer failed");
           }
         }
@@ -1083,11 +1677,3 @@ void CcSyncServerWorker::doDirectoryDownloadFile()
   sendResponse();
 }
 
-void CcSyncServerWorker::onStop()
-{
-  m_oSocket.close();
-  if (m_pServer != nullptr)
-  {
-    m_pServer->workerDone(this);
-  }
-}
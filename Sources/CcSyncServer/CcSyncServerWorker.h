@@ -32,12 +32,14 @@
 
 #include "CcBase.h"
 #include "CcSync.h"
-#include "IWorker.h"
 #include "CcSyncRequest.h"
 #include "CcSyncResponse.h"
 #include "CcSyncUser.h"
+#include "CcDateTime.h"
 #include "CcSyncDirectory.h"
 #include "Network/CcSocket.h"
+#include "CcSyncServerAccountRegistry.h"
+#include "CcSyncServerBandwidth.h"
 
 class CcSyncDirectoryConfig;
 class CcSyncClientConfig;
@@ -45,12 +47,15 @@ class CcSyncServer;
 class CcSyncAccount;
 class CcSqlite;
 class CcFile;
+class CcSyncBuffer;
 class CcSyncServerWorkerPrivate;
 
 /**
  * @brief Class impelmentation
+ *        Handles requests of one connection, it is executed by threads of
+ *        CcSyncServerWorkerPool.
  */
-class CcSyncServerWorker : public IWorker
+class CcSyncServerWorker
 {
 public:
   /**
@@ -62,21 +67,149 @@ public:
    * @brief Destructor
    */
   virtual ~CcSyncServerWorker( void );
+  CCDEFINE_COPY_DENIED(CcSyncServerWorker)
+
+  /**
+   * @brief Read next request from connection and execute it.
+   *        First call finishes the TLS handshake of the accepted connection.
+   * @return true if connection is still active
+   */
+  bool processRequest();
+
+  /**
+   * @brief First step of processRequest, read next request from connection.
+   *        First call finishes the TLS handshake of the accepted connection
+   *        and reads no request.
+   * @return true if connection is still active, check hasPendingRequest
+   */
+  bool receiveRequest();
+
+  /**
+   * @brief Second step of processRequest, execute request from receiveRequest.
+   * @return true if connection is still active
+   */
+  bool executeRequest();
+
+  /**
+   * @brief Replacement of receiveRequest for connections reported readable
+   *        by reactor. Only data wich is available is read, request is
+   *        received if it is complete, otherwise connection has to be
+   *        returned to reactor until more data arrives.
+   * @return true if connection is still active, check hasPendingRequest
+   */
+  bool receiveAvailableRequest();
+
+  bool hasPendingRequest() const
+    { return m_bRequestPending; }
+
+  /**
+   * @brief Commit items of group wich are not yet committed, called if
+   *        connection waits for its next request, so changes are not kept
+   *        open while client is idle.
+   */
+  void commitGroup();
+
+  /**
+   * @brief Get name of account wich is logged in on this connection,
+   *        requests without login are scheduled with an empty name.
+   */
+  CcString getAccountName();
+  /**
+   * @brief Get weight of logged in account, see CcSyncServerAccount::getWeight
+   */
+  uint32 getAccountWeight();
+
+  /**
+   * @brief Check if pending request is a file transfer wich is scheduled
+   *        after metadata requests.
+   */
+  bool isBulkRequest();
+
+  /**
+   * @brief Finish pending database transactions and close connection.
+   */
+  void close();
+
+  /**
+   * @brief Finish pending database transactions and drop user of idle
+   *        connection, so account can be unloaded by cache. User is
+   *        resolved again by its token on next request.
+   */
+  void releaseAccount();
+
+  /**
+   * @brief Check if connection holds config or database of an account.
+   */
+  bool hasAccount() const
+    { return m_oUser.isValid() || m_pGroupDatabase != nullptr; }
+  const CcDateTime& getLastRequest() const
+    { return m_oLastRequest; }
+
+  /**
+   * @brief Close connection from other thread to interrupt a pending read.
+   */
+  void abort();
+
+  bool isActive() const
+    { return m_bActive; }
+  CcSocket& getSocket()
+    { return m_oSocket; }
 
 private:
-  void run() override;
+  bool acceptHandshake();
+  static bool isReadCommand(ESyncCommandType eCommandType);
+  bool acquireReader();
+  void lockDatabase(CcSyncDbClientPointer& pDatabase);
+  /**
+   * @brief Read data of next request wich is already available on socket.
+   *        Nothing is read before TLS handshake is done.
+   * @return false if connection was closed or request exceeds maximum size
+   */
+  bool readRequestData();
+
+  /**
+   * @brief Check if request can be received, a complete request is
+   *        buffered, handshake has to be done or no buffer was available
+   *        and reading is left to getRequest.
+   */
+  bool isRequestReady();
+
+  /**
+   * @brief Continue search for end of request at position of last call,
+   *        so buffered data is scanned only once.
+   * @return true if a complete json object or array is buffered
+   */
+  bool scanRequestData();
+
+  bool acquireTransfer();
+  void releaseTransfer();
+  /**
+   * @brief Get buffer for file transfer without holding database lock,
+   *        client is told to retry if pool has no buffer left.
+   * @return false if busy was set to response
+   */
+  bool acquireTransferBuffer(CcSyncBuffer& oBuffer, uint64 uiFileSize);
   bool getRequest();
   bool sendResponse();
+  /**
+   * @brief Switch user to session of current request before database lock and
+   *        transfer admission are selected, errors are reported by command.
+   */
+  void resolveSessionRequest();
   bool loadConfigsBySessionRequest();
   bool loadConfigsBySession(const CcString& sSession);
   bool loadDirectory();
-  bool sendFile(const CcString& sPath);
-  bool receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo);
+  bool loadReadDirectory(CcSyncDbClientPointer& pDatabase, CcString& sDirectoryName);
+  bool sendFile(const CcString& sPath, CcSyncBuffer& oBuffer);
+  bool receiveFile(CcFile* pFile, CcSyncFileInfo& oFileInfo, CcSyncBuffer& oBuffer);
   void doServerGetInfo(); 
   void doServerAccountCreate();
   void doServerAccountRemove();
   void doServerStop();
   void doServerRescan();
+  void doServerGetStats();
+  void doServerSetTrace();
+  void doServerSetProfiler();
   void doAccountCreate();
   void doAccountLogin();
   void doAccountGetData();
@@ -95,8 +228,6 @@ private:
   void doDirectoryUploadFile();
   void doDirectoryRemoveFile();
   void doDirectoryDownloadFile();
-private:
-  void onStop() override;
 private:
   CcSyncServerWorkerPrivate* m_pPrivate;
   CcSyncServer*   m_pServer   = nullptr;
@@ -105,6 +236,36 @@ private:
   CcSyncRequest   m_oRequest;
   CcSyncResponse  m_oResponse;
   CcSyncDirectory m_oDirectory;
+  CcSyncDbClientPointer m_pLockedDatabase;
+  CcSyncDbClientPointer m_pGroupDatabase;
+  //! Reader of current request, see CcSyncServerReaderPool
+  CcSyncDbClientPointer m_pReader;
+  CcSyncServerAccountPointer m_pReaderAccount;
+  //! Account of admitted transfer, see CcSyncServerAdmission
+  CcString        m_sTransferAccount;
+  //! Data of next request, filled by readRequestData or getRequest until complete
+  CcString        m_sRequestData;
+  //! State of scanRequestData within m_sRequestData
+  size_t          m_uiRequestScanned = 0;
+  size_t          m_uiRequestDepth = 0;
+  bool            m_bRequestString = false;
+  bool            m_bRequestEscape = false;
+  bool            m_bRequestComplete = false;
+  //! Token of user dropped by releaseAccount
+  CcString        m_sReleasedToken;
+  //! End of last executed request
+  CcDateTime      m_oLastRequest;
+  //! Rate limit of admitted transfer, see CcSyncServerBandwidth
+  CcSyncTokenBucketPointer m_pTransferLimit;
+  //! Counters of current request, see CcSyncServerStats
+  uint64          m_uiBytesSent = 0;
+  uint64          m_uiBytesReceived = 0;
+  uint64          m_uiDatabaseTime = 0;
+  bool            m_bActive   = true;
+  bool            m_bHandshakeDone = false;
+  bool            m_bRequestPending = false;
+  //! readRequestData had no buffer, request is read by getRequest
+  bool            m_bReadDeferred = false;
 };
 
 #endif /* _CcSyncServerWorker_H_ */
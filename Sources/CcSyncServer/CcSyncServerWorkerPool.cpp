@@ -0,0 +1,284 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Implemtation of class CcSyncServerWorkerPool
+ */
+#include "CcSyncServerWorkerPool.h"
+#include "CcSyncServerWorker.h"
+#include "CcSyncGlobals.h"
+#include "CcKernel.h"
+#include "IThread.h"
+
+/**
+ * @brief Thread of pool, processes one connection after another.
+ */
+class CcSyncServerWorkerPoolThread : public IThread
+{
+public:
+  CcSyncServerWorkerPoolThread(CcSyncServerWorkerPool* pPool) :
+    m_pPool(pPool)
+  { }
+
+private:
+  void run() override
+  {
+    while (getThreadState() == EThreadState::Running)
+    {
+      // Read before queues are checked, so a new item is not missed
+      uint64 uiSignal = m_pPool->getSignalCount();
+      bool bIdle = true;
+      CcSyncServerWorker* pConnection = m_pPool->getNext();
+      if (pConnection != nullptr)
+      {
+        bIdle = false;
+        if (m_pPool->isReactorAvailable())
+        {
+          if (pConnection->receiveAvailableRequest() &&
+              getThreadState() == EThreadState::Running)
+          {
+            // Without pending request reactor waits for rest of it
+            if (pConnection->hasPendingRequest())
+              m_pPool->schedule(pConnection);
+            else
+              m_pPool->release(pConnection);
+            pConnection = nullptr;
+          }
+        }
+        else
+        {
+          while (getThreadState() == EThreadState::Running &&
+                 pConnection->processRequest());
+        }
+        if (pConnection != nullptr)
+        {
+          closeConnection(pConnection);
+        }
+      }
+      // Execute request selected by scheduler, it can be from another connection
+      CcSyncServerWorker* pScheduled = m_pPool->getScheduled();
+      if (pScheduled != nullptr)
+      {
+        bIdle = false;
+        if (pScheduled->executeRequest() &&
+            getThreadState() == EThreadState::Running)
+        {
+          // Not kept pending while connection is waiting in reactor
+          pScheduled->commitGroup();
+          m_pPool->release(pScheduled);
+        }
+        else
+        {
+          closeConnection(pScheduled);
+        }
+      }
+      if (bIdle)
+      {
+        m_pPool->waitForWork(uiSignal);
+      }
+    }
+  }
+
+  void closeConnection(CcSyncServerWorker* pConnection)
+  {
+    m_pPool->remove(pConnection);
+    pConnection->close();
+    CCDELETE(pConnection);
+  }
+
+private:
+  CcSyncServerWorkerPool* m_pPool;
+};
+
+CcSyncServerWorkerPool::CcSyncServerWorkerPool() :
+  m_oReactor(this)
+{
+}
+
+CcSyncServerWorkerPool::~CcSyncServerWorkerPool()
+{
+  stop();
+}
+
+void CcSyncServerWorkerPool::start(size_t uiWorkers, size_t uiQueueSize)
+{
+  m_uiQueueSize = uiQueueSize;
+  m_oReactor.init();
+  while (m_oThreads.size() < uiWorkers)
+  {
+    CCNEWTYPE(pThread, CcSyncServerWorkerPoolThread, this);
+    m_oThreads.append(pThread);
+    pThread->start();
+  }
+}
+
+void CcSyncServerWorkerPool::stop()
+{
+  for (CcSyncServerWorkerPoolThread* pThread : m_oThreads)
+  {
+    pThread->stop();
+  }
+  m_oSignal.signalAll();
+  // Interrupt pending reads of active connections
+  m_oLock.lock();
+  for (CcSyncServerWorker* pConnection : m_oActive)
+  {
+    pConnection->abort();
+  }
+  m_oLock.unlock();
+  for (CcSyncServerWorkerPoolThread* pThread : m_oThreads)
+  {
+    while (pThread->isInProgress())
+    {
+      CcKernel::sleep(10);
+    }
+    CCDELETE(pThread);
+  }
+  m_oThreads.clear();
+  m_oReactor.close();
+  m_oLock.lock();
+  for (CcSyncServerWorker* pConnection : m_oScheduler.takeAll())
+  {
+    m_oActive.removeItem(pConnection);
+    pConnection->close();
+    CCDELETE(pConnection);
+  }
+  for (CcSyncServerWorker* pConnection : m_oWaiting)
+  {
+    pConnection->close();
+    CCDELETE(pConnection);
+  }
+  m_oWaiting.clear();
+  m_oLock.unlock();
+}
+
+bool CcSyncServerWorkerPool::append(CcSyncServerWorker* pConnection)
+{
+  bool bRet = false;
+  if (m_oReactor.isAvailable())
+  {
+    // First request will be received by reactor
+    bRet = m_oReactor.add(pConnection);
+  }
+  if (bRet == false)
+  {
+    bRet = appendReady(pConnection);
+  }
+  return bRet;
+}
+
+bool CcSyncServerWorkerPool::appendReady(CcSyncServerWorker* pConnection)
+{
+  bool bRet = false;
+  m_oLock.lock();
+  if (m_oWaiting.size() < m_uiQueueSize)
+  {
+    m_oWaiting.append(pConnection);
+    bRet = true;
+  }
+  m_oLock.unlock();
+  if (bRet)
+    m_oSignal.signal();
+  return bRet;
+}
+
+CcSyncServerWorker* CcSyncServerWorkerPool::getNext()
+{
+  CcSyncServerWorker* pConnection = nullptr;
+  m_oLock.lock();
+  if (m_oWaiting.size() > 0)
+  {
+    pConnection = m_oWaiting[0];
+    m_oWaiting.remove(0);
+    m_oActive.append(pConnection);
+  }
+  m_oLock.unlock();
+  return pConnection;
+}
+
+void CcSyncServerWorkerPool::schedule(CcSyncServerWorker* pConnection)
+{
+  // Get properties before lock, they may require config of server
+  CcString sAccount = pConnection->getAccountName();
+  uint32 uiWeight = pConnection->getAccountWeight();
+  bool bBulk = pConnection->isBulkRequest();
+  m_oLock.lock();
+  m_oScheduler.push(pConnection, sAccount, uiWeight, bBulk);
+  m_oLock.unlock();
+  m_oSignal.signal();
+}
+
+void CcSyncServerWorkerPool::waitForWork(uint64 uiSignalCount)
+{
+  // Timeout is only a fallback, appendReady, schedule and stop are signalling
+  m_oSignal.wait(uiSignalCount, CcSyncGlobals::Server::WorkerIdleWait);
+}
+
+CcSyncServerWorker* CcSyncServerWorkerPool::getScheduled()
+{
+  m_oLock.lock();
+  CcSyncServerWorker* pConnection = m_oScheduler.pop();
+  m_oLock.unlock();
+  return pConnection;
+}
+
+void CcSyncServerWorkerPool::remove(CcSyncServerWorker* pConnection)
+{
+  m_oLock.lock();
+  m_oActive.removeItem(pConnection);
+  m_oLock.unlock();
+}
+
+void CcSyncServerWorkerPool::release(CcSyncServerWorker* pConnection)
+{
+  remove(pConnection);
+  if (!m_oReactor.add(pConnection))
+  {
+    pConnection->close();
+    CCDELETE(pConnection);
+  }
+}
+
+size_t CcSyncServerWorkerPool::getWaitingCount()
+{
+  m_oLock.lock();
+  size_t uiCount = m_oWaiting.size();
+  m_oLock.unlock();
+  return uiCount;
+}
+
+size_t CcSyncServerWorkerPool::getScheduledCount()
+{
+  m_oLock.lock();
+  size_t uiCount = m_oScheduler.size();
+  m_oLock.unlock();
+  return uiCount;
+}
+
+size_t CcSyncServerWorkerPool::getActiveCount()
+{
+  m_oLock.lock();
+  size_t uiCount = m_oActive.size();
+  m_oLock.unlock();
+  return uiCount;
+}
@@ -0,0 +1,155 @@
+/*
+ * This file is part of CcSync.
+ *
+ * CcSync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcSync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcSync.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSync
+ * @subpage   CcSyncServerWorkerPool
+ *
+ * @page      CcSyncServerWorkerPool
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web: http://coolcow.de
+ * @version   0.01
+ * @date      2016-04
+ * @par       Language   C++ ANSI V3
+ * @brief     Class CcSyncServerWorkerPool
+ *
+ *  Fixed number of threads wich are processing accepted connections.
+ *  Idle connections are owned by CcSyncServerReactor, it appends them to
+ *  the ready queue if data arrives. A thread reads the available data,
+ *  an incomplete request is returned to reactor, a complete one is queued
+ *  in CcSyncServerScheduler. Then the thread executes the next request
+ *  selected by scheduler and returns that connection to the reactor
+ *  afterwards.
+ *  Without reactor a thread keeps its connection until it is closed.
+ **/
+#ifndef _CcSyncServerWorkerPool_H_
+#define _CcSyncServerWorkerPool_H_
+
+#include "CcBase.h"
+#include "CcSync.h"
+#include "CcList.h"
+#include "CcMutex.h"
+#include "CcSyncServerReactor.h"
+#include "CcSyncServerScheduler.h"
+#include "CcSyncSignal.h"
+
+class CcSyncServerWorker;
+class CcSyncServerWorkerPoolThread;
+
+/**
+ * @brief Class impelmentation
+ */
+class CcSyncServerWorkerPool
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CcSyncServerWorkerPool();
+
+  /**
+   * @brief Destructor
+   */
+  ~CcSyncServerWorkerPool();
+  CCDEFINE_COPY_DENIED(CcSyncServerWorkerPool)
+
+  /**
+   * @brief Start threads of pool.
+   * @param uiWorkers:   Number of threads
+   * @param uiQueueSize: Maximum number of connections waiting for a thread
+   */
+  void start(size_t uiWorkers, size_t uiQueueSize);
+
+  /**
+   * @brief Stop all threads, active and waiting connections will be closed.
+   */
+  void stop();
+
+  /**
+   * @brief Add new connection to pool, ownership is taken on success.
+   * @param pConnection: Connection to process
+   * @return false if connection can not be handled
+   */
+  bool append(CcSyncServerWorker* pConnection);
+
+  /**
+   * @brief Add connection with pending request to queue.
+   * @param pConnection: Connection to process
+   * @return false if queue is full
+   */
+  bool appendReady(CcSyncServerWorker* pConnection);
+
+  /**
+   * @brief Take next waiting connection, called by threads of pool.
+   * @return Next connection or nullptr if queue is empty
+   */
+  CcSyncServerWorker* getNext();
+
+  /**
+   * @brief Queue connection with received request in scheduler.
+   */
+  void schedule(CcSyncServerWorker* pConnection);
+
+  /**
+   * @brief Take next received request selected by scheduler.
+   * @return Connection or nullptr if no request is waiting
+   */
+  CcSyncServerWorker* getScheduled();
+
+  /**
+   * @brief Get counter of signal, has to be read before queues are checked.
+   */
+  uint64 getSignalCount()
+    { return m_oSignal.getCount(); }
+
+  /**
+   * @brief Block idle thread until a connection or request was added.
+   * @param uiSignalCount: Value of getSignalCount before queues were checked
+   */
+  void waitForWork(uint64 uiSignalCount);
+
+  /**
+   * @brief Connection was closed by thread of pool and will be deleted.
+   */
+  void remove(CcSyncServerWorker* pConnection);
+
+  /**
+   * @brief Request of connection is done, return it to reactor.
+   */
+  void release(CcSyncServerWorker* pConnection);
+
+  bool isReactorAvailable() const
+    { return m_oReactor.isAvailable(); }
+
+  size_t getWaitingCount();
+  size_t getActiveCount();
+  size_t getScheduledCount();
+  size_t getIdleCount()
+    { return m_oReactor.getIdleCount(); }
+
+private:
+  CcList<CcSyncServerWorkerPoolThread*> m_oThreads;
+  CcList<CcSyncServerWorker*> m_oWaiting;
+  CcList<CcSyncServerWorker*> m_oActive;
+  CcMutex m_oLock;
+  CcSyncSignal m_oSignal;
+  CcSyncServerReactor m_oReactor;
+  CcSyncServerScheduler m_oScheduler;
+  size_t m_uiQueueSize = 0;
+};
+
+#endif /* _CcSyncServerWorkerPool_H_ */
@@ -27,10 +27,15 @@
 
 #include "CcBase.h"
 #include "CcKernel.h"
+#include "CcSyncLog.h"
 #include "CcSyncServer.h"
 
 int main(int argc, char **argv)
 {
+  CcSyncLog::start();
   CcSyncServer oServer(argc, argv);
-  return oServer.exec().getErrorInt();
+  int iReturn = oServer.exec().getErrorInt();
+  // Write messages wich are still queued
+  CcSyncLog::stop();
+  return iReturn;
 }
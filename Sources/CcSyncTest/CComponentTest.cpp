@@ -0,0 +1,769 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @file
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Implemtation of class CComponentTest
+ */
+#include "CComponentTest.h"
+#include "CcKernel.h"
+#include "CcSyncHashMap.h"
+#include "CcSyncBufferPool.h"
+#include "CcSyncQueue.h"
+#include "CcSyncFileInfo.h"
+#include "CcSyncGlobals.h"
+#include "CcFile.h"
+#include "CcSyncTokenBucket.h"
+#include "CcSyncLogWriter.h"
+#include "CcGlobalStrings.h"
+#include "CcSyncServerSessions.h"
+#include "CcSyncServerAccountRegistry.h"
+#include "CcSyncServerBandwidth.h"
+#include "CcSyncServerScheduler.h"
+#include "CcSyncServerAdmission.h"
+
+CComponentTest::CComponentTest( void ) :
+  CcTest("CComponentTest")
+{
+  appendTestMethod("Test hash map with growing buckets", &CComponentTest::testHashMap);
+  appendTestMethod("Test session table and account index", &CComponentTest::testSessions);
+  appendTestMethod("Test account registry ignoring case", &CComponentTest::testAccountRegistry);
+  appendTestMethod("Test buffer pool reuse and limit", &CComponentTest::testBufferPool);
+  appendTestMethod("Test queue with coalescing, dependencies and paths", &CComponentTest::testQueue);
+  appendTestMethod("Test queue with SmallFirst and starvation", &CComponentTest::testQueueSmallFirst);
+  appendTestMethod("Test queue while transfers are deferred", &CComponentTest::testQueueWithoutTransfers);
+  appendTestMethod("Test journal committed before change on disk", &CComponentTest::testJournal);
+  appendTestMethod("Test token bucket rate", &CComponentTest::testTokenBucket);
+  appendTestMethod("Test bandwidth shared by weight", &CComponentTest::testBandwidth);
+  appendTestMethod("Test scheduler with deficit round robin", &CComponentTest::testScheduler);
+  appendTestMethod("Test admission limits of transfers", &CComponentTest::testAdmission);
+  appendTestMethod("Test log writer keeps all messages", &CComponentTest::testLogWriter);
+}
+
+CComponentTest::~CComponentTest( void )
+{
+}
+
+bool CComponentTest::testHashMap()
+{
+  bool bSuccess = true;
+  CcSyncHashMap<uint64, uint64> oNumbers;
+  for (uint64 uiKey = 0; uiKey < 1000; uiKey++)
+  {
+    oNumbers.set(uiKey * 4096, uiKey);
+  }
+  if (oNumbers.size() != 1000 ||
+      oNumbers.getBucketCount() < 500)
+  {
+    CcTestFramework::writeError("Hash map did not grow with items");
+    bSuccess = false;
+  }
+  for (uint64 uiKey = 0; uiKey < 1000 && bSuccess; uiKey++)
+  {
+    uint64* pValue = oNumbers.find(uiKey * 4096);
+    if (pValue == nullptr ||
+        *pValue != uiKey)
+    {
+      CcTestFramework::writeError("Hash map lost key " + CcString::fromNumber(uiKey * 4096));
+      bSuccess = false;
+    }
+  }
+  if (bSuccess)
+  {
+    size_t uiRemoved = oNumbers.removeIf([](const uint64&, uint64& uiValue) { return (uiValue % 2) == 1; });
+    uint64 uiValue = 0;
+    if (uiRemoved != 500 ||
+        oNumbers.size() != 500 ||
+        oNumbers.contains(4096) ||
+        oNumbers.take(8192, uiValue) == false ||
+        uiValue != 2 ||
+        oNumbers.remove(8192) ||
+        oNumbers.size() != 499)
+    {
+      CcTestFramework::writeError("Hash map removed wrong items");
+      bSuccess = false;
+    }
+  }
+  if (bSuccess)
+  {
+    CcSyncHashMap<CcString, CcString> oStrings;
+    oStrings.set("Key", "Value1");
+    oStrings.set("Key", "Value2");
+    oStrings.get("Other").append("Value3");
+    if (oStrings.size() != 2 ||
+        oStrings.find("key") != nullptr ||
+        *oStrings.find("Key") != "Value2" ||
+        *oStrings.find("Other") != "Value3")
+    {
+      CcTestFramework::writeError("Hash map with string keys failed");
+      bSuccess = false;
+    }
+    oStrings.clear();
+    if (oStrings.size() != 0 ||
+        oStrings.contains("Key"))
+    {
+      CcTestFramework::writeError("Hash map not empty after clear");
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testSessions()
+{
+  bool bSuccess = true;
+  CcSyncServerSessions oSessions;
+  for (size_t uiToken = 0; uiToken < 200; uiToken++)
+  {
+    oSessions.insert("Token" + CcString::fromNumber(uiToken), (uiToken % 2) ? "Account" : "Other", "User");
+  }
+  CcString sAccount;
+  CcString sUsername;
+  if (oSessions.size() != 200 ||
+      oSessions.find("Token1", sAccount, sUsername) == false ||
+      sAccount != "Account" ||
+      sUsername != "User")
+  {
+    CcTestFramework::writeError("Session not found after insert");
+    bSuccess = false;
+  }
+  // Same token for another account moves it in index of accounts
+  oSessions.insert("Token3", "Third", "User");
+  oSessions.removeAccount("ACCOUNT");
+  if (bSuccess &&
+      (oSessions.size() != 101 ||
+       oSessions.find("Token1", sAccount, sUsername) ||
+       oSessions.find("Token0", sAccount, sUsername) == false ||
+       oSessions.find("Token3", sAccount, sUsername) == false ||
+       sAccount != "Third"))
+  {
+    CcTestFramework::writeError("Sessions of account not removed ignoring case");
+    bSuccess = false;
+  }
+  oSessions.removeAccount("Third");
+  if (bSuccess &&
+      oSessions.find("Token3", sAccount, sUsername))
+  {
+    CcTestFramework::writeError("Moved session not removed with new account");
+    bSuccess = false;
+  }
+  oSessions.clear();
+  if (bSuccess &&
+      oSessions.size() != 0)
+  {
+    CcTestFramework::writeError("Sessions not empty after clear");
+    bSuccess = false;
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testAccountRegistry()
+{
+  bool bSuccess = true;
+  CcSyncServerAccountRegistry oRegistry;
+  for (size_t uiAccount = 0; uiAccount < 300; uiAccount++)
+  {
+    if (oRegistry.append(CcSyncServerAccount("Account" + CcString::fromNumber(uiAccount), "Password", false)) == false)
+    {
+      CcTestFramework::writeError("Failed to append account " + CcString::fromNumber(uiAccount));
+      bSuccess = false;
+      break;
+    }
+  }
+  if (bSuccess &&
+      oRegistry.append(CcSyncServerAccount("ACCOUNT7", "Password", false)))
+  {
+    CcTestFramework::writeError("Account with same name in other case was appended");
+    bSuccess = false;
+  }
+  if (bSuccess)
+  {
+    CcSyncServerAccountPointer pAccount = oRegistry.find("aCcOuNt42");
+    if (pAccount == nullptr ||
+        pAccount->getName() != "Account42")
+    {
+      CcTestFramework::writeError("Account not found ignoring case");
+      bSuccess = false;
+    }
+  }
+  if (bSuccess)
+  {
+    if (oRegistry.remove("account0") == false ||
+        oRegistry.remove("account0") ||
+        oRegistry.find("Account0") != nullptr ||
+        oRegistry.size() != 299)
+    {
+      CcTestFramework::writeError("Account not removed");
+      bSuccess = false;
+    }
+    else
+    {
+      // List keeps order of insertion
+      CcSyncServerAccountPointerList oList = oRegistry.getList();
+      if (oList.size() != 299 ||
+          oList[0]->getName() != "Account1" ||
+          oList[298]->getName() != "Account299")
+      {
+        CcTestFramework::writeError("Order of accounts changed");
+        bSuccess = false;
+      }
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testBufferPool()
+{
+  bool bSuccess = true;
+  CcSyncBuffer oBuffer;
+  if (oBuffer.isValid() ||
+      oBuffer.acquire(1000) == false ||
+      oBuffer.data().size() != 1000 ||
+      oBuffer.getCapacity() < 1000)
+  {
+    CcTestFramework::writeError("Buffer not acquired with requested size");
+    bSuccess = false;
+  }
+  if (bSuccess)
+  {
+    // Released buffer has to be reused for same size class
+    oBuffer.release();
+    uint64 uiAllocated = CcSyncBufferPool::getAllocated();
+    if (oBuffer.isValid() ||
+        oBuffer.acquire(2000) == false ||
+        CcSyncBufferPool::getAllocated() != uiAllocated)
+    {
+      CcTestFramework::writeError("Released buffer was not reused");
+      bSuccess = false;
+    }
+    oBuffer.release();
+  }
+  if (bSuccess)
+  {
+    // Requests above limit fail without waiting
+    uint64 uiFailed = CcSyncBufferPool::getFailed();
+    CcDateTime oStart = CcKernel::getUpTime();
+    CcSyncBuffer oLarge;
+    if (oLarge.acquire(static_cast<size_t>(CcSyncGlobals::BufferPoolLimit) + 1) ||
+        oLarge.isValid() ||
+        CcSyncBufferPool::getFailed() != uiFailed + 1 ||
+        (CcKernel::getUpTime() - oStart).getTimestampMs() >= static_cast<int64>(CcSyncGlobals::BufferPoolWait))
+    {
+      CcTestFramework::writeError("Buffer above pool limit was not rejected");
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testQueue()
+{
+  bool bSuccess = false;
+  CcString sDatabase = CcTestFramework::getTemporaryDir();
+  sDatabase.appendPath("CComponentTestQueue.sqlite");
+  CcFile::remove(sDatabase);
+  CcSyncDbClientPointer pDatabase;
+  CCNEW(pDatabase, CcSyncDbClient, sDatabase);
+  CcSyncFileInfo oSubDir;
+  oSubDir.id() = 2;
+  oSubDir.dirId() = 1;
+  oSubDir.name() = "Sub";
+  if (pDatabase->setupDirectory("Queue") &&
+      pDatabase->directoryListInsert("Queue", oSubDir, false))
+  {
+    uint64 uiRemoveDir = pDatabase->queueInsert("Queue", 0, EBackupQueueType::RemoveDir, 2, 1, "Sub");
+    uint64 uiInSubDir  = pDatabase->queueInsert("Queue", 0, EBackupQueueType::AddFile, 0, 2, "File", 100);
+    uint64 uiAdd       = pDatabase->queueInsert("Queue", 0, EBackupQueueType::AddFile, 0, 1, "File", 10);
+    uint64 uiAddAgain  = pDatabase->queueInsert("Queue", 0, EBackupQueueType::AddFile, 0, 1, "File", 10);
+    uint64 uiRemove    = pDatabase->queueInsert("Queue", 0, EBackupQueueType::RemoveFile, 0, 1, "File");
+    uint64 uiDependent = pDatabase->queueInsert("Queue", uiRemove, EBackupQueueType::AddFile, 0, 1, "Other", 5);
+    CcSyncQueue oQueue(pDatabase, "Queue");
+    CcSyncFileInfo oFileInfo;
+    uint64 uiFirst = 0;
+    uint64 uiSecond = 0;
+    uint64 uiThird = 0;
+    if (uiAdd != uiAddAgain)
+    {
+      CcTestFramework::writeError("Equal queue items were not coalesced");
+    }
+    else if (oQueue.getNext(oFileInfo, uiFirst) == EBackupQueueType::Unknown ||
+             uiFirst != uiRemoveDir ||
+             oQueue.getNext(oFileInfo, uiSecond) == EBackupQueueType::Unknown ||
+             uiSecond != uiRemove ||
+             oQueue.getNext(oFileInfo, uiThird) != EBackupQueueType::Unknown)
+    {
+      // Item in Sub waits for RemoveDir, AddFile is superseded by RemoveFile
+      // and dependent item waits for RemoveFile
+      CcTestFramework::writeError("Queue did not block child path or dependent item");
+    }
+    else
+    {
+      oQueue.finalizeFile(uiRemove);
+      if (oQueue.getNext(oFileInfo, uiThird) == EBackupQueueType::Unknown ||
+          uiThird != uiDependent)
+      {
+        CcTestFramework::writeError("Dependent item not released");
+      }
+      else
+      {
+        oQueue.finalizeFile(uiDependent);
+        oQueue.retryItem(uiRemoveDir);
+        // Retried item is ready again, item below it must wait for it
+        if (oQueue.getNext(oFileInfo, uiFirst) == EBackupQueueType::Unknown ||
+            uiFirst != uiRemoveDir ||
+            oQueue.getNext(oFileInfo, uiSecond) != EBackupQueueType::Unknown)
+        {
+          CcTestFramework::writeError("Items of parent and child path were started together");
+        }
+        else
+        {
+          oQueue.finalizeFile(uiFirst);
+          if (oQueue.getNext(oFileInfo, uiSecond) == EBackupQueueType::Unknown ||
+              uiSecond != uiInSubDir)
+          {
+            CcTestFramework::writeError("Item on child path not released");
+          }
+          else
+          {
+            oQueue.finalizeFile(uiSecond);
+            bSuccess = oQueue.hasItems() == false &&
+                       oQueue.isFinished(uiInSubDir);
+            if (bSuccess == false)
+              CcTestFramework::writeError("Queue not finished");
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    CcTestFramework::writeError("Failed to setup database for queue");
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testQueueSmallFirst()
+{
+  bool bSuccess = false;
+  CcString sDatabase = CcTestFramework::getTemporaryDir();
+  sDatabase.appendPath("CComponentTestQueueSmallFirst.sqlite");
+  CcFile::remove(sDatabase);
+  CcSyncDbClientPointer pDatabase;
+  CCNEW(pDatabase, CcSyncDbClient, sDatabase);
+  if (pDatabase->setupDirectory("Queue"))
+  {
+    uint64 uiLarge  = pDatabase->queueInsert("Queue", 0, EBackupQueueType::DownloadFile, 1, 1, "Large", 1000000);
+    uint64 uiSmall  = pDatabase->queueInsert("Queue", 0, EBackupQueueType::DownloadFile, 2, 1, "Small", 10);
+    uint64 uiMedium = pDatabase->queueInsert("Queue", 0, EBackupQueueType::DownloadFile, 3, 1, "Medium", 1000);
+    CcSyncFileInfo oFileInfo;
+    uint64 uiFirst = 0;
+    uint64 uiSecond = 0;
+    uint64 uiThird = 0;
+    {
+      CcSyncQueue oQueue(pDatabase, "Queue");
+      oQueue.setSchedule(ESyncSchedule::SmallFirst, 3600);
+      oQueue.getNext(oFileInfo, uiFirst);
+      oQueue.getNext(oFileInfo, uiSecond);
+      oQueue.getNext(oFileInfo, uiThird);
+      bSuccess = uiFirst == uiSmall &&
+                 uiSecond == uiMedium &&
+                 uiThird == uiLarge;
+      if (bSuccess == false)
+        CcTestFramework::writeError("Items not ordered by size");
+      // Not finalized, items are loaded again by next queue
+    }
+    if (bSuccess)
+    {
+      // Without starvation time every item is starving, oldest is first
+      CcSyncQueue oQueue(pDatabase, "Queue");
+      oQueue.setSchedule(ESyncSchedule::SmallFirst, 0);
+      oQueue.getNext(oFileInfo, uiFirst);
+      oQueue.getNext(oFileInfo, uiSecond);
+      bSuccess = uiFirst == uiLarge &&
+                 uiSecond == uiSmall;
+      if (bSuccess == false)
+        CcTestFramework::writeError("Starving item not taken first");
+    }
+  }
+  else
+  {
+    CcTestFramework::writeError("Failed to setup database for queue");
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testQueueWithoutTransfers()
+{
+  bool bSuccess = false;
+  CcString sDatabase = CcTestFramework::getTemporaryDir();
+  sDatabase.appendPath("CComponentTestQueueWithoutTransfers.sqlite");
+  CcFile::remove(sDatabase);
+  CcSyncDbClientPointer pDatabase;
+  CCNEW(pDatabase, CcSyncDbClient, sDatabase);
+  if (pDatabase->setupDirectory("Queue"))
+  {
+    uint64 uiUpload   = pDatabase->queueInsert("Queue", 0, EBackupQueueType::AddFile, 0, 1, "Upload", 10);
+    uint64 uiCreate   = pDatabase->queueInsert("Queue", 0, EBackupQueueType::CreateDir, 0, 1, "Create");
+    uint64 uiDownload = pDatabase->queueInsert("Queue", 0, EBackupQueueType::DownloadFile, 2, 1, "Download", 10);
+    uint64 uiRemove   = pDatabase->queueInsert("Queue", 0, EBackupQueueType::RemoveFile, 3, 1, "Remove");
+    CcSyncQueue oQueue(pDatabase, "Queue");
+    CcSyncFileInfo oFileInfo;
+    uint64 uiFirst = 0;
+    uint64 uiSecond = 0;
+    // Items on main connection are not waiting for deferred transfers
+    if (oQueue.getNext(oFileInfo, uiFirst, false) != EBackupQueueType::CreateDir ||
+        uiFirst != uiCreate ||
+        oQueue.getNext(oFileInfo, uiSecond, false) != EBackupQueueType::RemoveFile ||
+        uiSecond != uiRemove ||
+        oQueue.hasItems(false))
+    {
+      CcTestFramework::writeError("Items without transfer not taken");
+    }
+    else if (oQueue.getNext(oFileInfo, uiFirst) != EBackupQueueType::AddFile ||
+             uiFirst != uiUpload ||
+             oQueue.getNext(oFileInfo, uiSecond) != EBackupQueueType::DownloadFile ||
+             uiSecond != uiDownload)
+    {
+      CcTestFramework::writeError("Transfers not taken after deferred");
+    }
+    else
+    {
+      bSuccess = true;
+    }
+  }
+  else
+  {
+    CcTestFramework::writeError("Failed to setup database for queue");
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testJournal()
+{
+  bool bSuccess = false;
+  CcString sDatabase = CcTestFramework::getTemporaryDir();
+  sDatabase.appendPath("CComponentTestJournal.sqlite");
+  CcFile::remove(sDatabase);
+  CcSyncDbClientPointer pDatabase;
+  CCNEW(pDatabase, CcSyncDbClient, sDatabase);
+  // Second connection sees only committed rows
+  CcSyncDbClientPointer pObserver;
+  CCNEW(pObserver, CcSyncDbClient, sDatabase);
+  if (pDatabase->setupDirectory("Journal"))
+  {
+    pDatabase->beginGroupTransaction();
+    CcSyncJournalEntry oFirst;
+    oFirst.eType = EBackupQueueType::DownloadFile;
+    oFirst.oFileInfo.id() = 2;
+    oFirst.oFileInfo.dirId() = 1;
+    oFirst.oFileInfo.name() = "First";
+    oFirst.oFileInfo.fileSize() = 10;
+    CcSyncJournalEntry oSecond = oFirst;
+    oSecond.oFileInfo.id() = 3;
+    oSecond.oFileInfo.name() = "Second";
+    pDatabase->journalInsert("Journal", oFirst);
+    pDatabase->journalInsert("Journal", oSecond);
+    if (pObserver->journalLoad("Journal").size() != 0)
+    {
+      CcTestFramework::writeError("Journal visible before sync");
+    }
+    else
+    {
+      pDatabase->journalSync(oFirst);
+      CcList<CcSyncJournalEntry> oLoaded = pObserver->journalLoad("Journal");
+      if (oLoaded.size() != 2 ||
+          oLoaded[0].eType != EBackupQueueType::DownloadFile ||
+          oLoaded[0].oFileInfo.getId() != 2 ||
+          oLoaded[0].oFileInfo.getFileSize() != 10 ||
+          oLoaded[1].oFileInfo.getName() != "Second")
+      {
+        CcTestFramework::writeError("Journal not committed by sync");
+      }
+      else
+      {
+        // Second entry was committed with first one, no additional commit
+        pDatabase->journalRemove("Journal", oFirst);
+        pDatabase->journalSync(oSecond);
+        if (pObserver->journalLoad("Journal").size() != 2)
+        {
+          CcTestFramework::writeError("Journal synced twice");
+        }
+        else
+        {
+          pDatabase->journalRemove("Journal", oSecond);
+          pDatabase->endGroupTransaction();
+          if (pObserver->journalLoad("Journal").size() != 0)
+          {
+            CcTestFramework::writeError("Journal not removed with group");
+          }
+          else
+          {
+            bSuccess = true;
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    CcTestFramework::writeError("Failed to setup database for journal");
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testTokenBucket()
+{
+  bool bSuccess = false;
+  CcSyncTokenBucket oUnlimited;
+  CcDateTime oStart = CcKernel::getUpTime();
+  oUnlimited.consume(1024 * 1024 * 1024);
+  if ((CcKernel::getUpTime() - oStart).getTimestampMs() > 100)
+  {
+    CcTestFramework::writeError("Unlimited bucket is waiting");
+  }
+  else
+  {
+    // Bucket starts full with one second of data
+    CcSyncTokenBucket oBucket(1000);
+    oStart = CcKernel::getUpTime();
+    oBucket.consume(1000);
+    int64 iFirstMs = (CcKernel::getUpTime() - oStart).getTimestampMs();
+    oBucket.consume(500);
+    int64 iSecondMs = (CcKernel::getUpTime() - oStart).getTimestampMs();
+    if (iFirstMs > 100)
+    {
+      CcTestFramework::writeError("Burst of bucket not available");
+    }
+    else if (iSecondMs < 400 ||
+             iSecondMs > 2000)
+    {
+      CcTestFramework::writeError("Bucket not waiting for rate: " + CcString::fromNumber(iSecondMs) + "ms");
+    }
+    else
+    {
+      bSuccess = true;
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testBandwidth()
+{
+  bool bSuccess = false;
+  CcSyncServerBandwidth oBandwidth;
+  oBandwidth.setRate(3000);
+  CcSyncTokenBucketPointer pFirst = oBandwidth.begin("First", 0, 2);
+  CcSyncTokenBucketPointer pSecond = oBandwidth.begin("Second", 0, 1);
+  if (pFirst->getRate() != 2000 ||
+      pSecond->getRate() != 1000)
+  {
+    CcTestFramework::writeError("Rate not shared by weight");
+  }
+  else
+  {
+    // Own limit below share is kept, rest goes to others
+    CcSyncTokenBucketPointer pLimited = oBandwidth.begin("Limited", 200, 1);
+    if (pLimited->getRate() != 200 ||
+        pFirst->getRate() != 1866 ||
+        pSecond->getRate() != 933)
+    {
+      CcTestFramework::writeError("Unused rate of limited account not shared");
+    }
+    else
+    {
+      oBandwidth.end("Limited");
+      oBandwidth.end("second");
+      if (pFirst->getRate() != 3000)
+      {
+        CcTestFramework::writeError("Rate not returned after end");
+      }
+      else
+      {
+        bSuccess = true;
+      }
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testScheduler()
+{
+  bool bSuccess = true;
+  // Connections are not used by scheduler, addresses are enough
+  char aConnections[32];
+  CcSyncServerScheduler oScheduler;
+  for (size_t uiPos = 0; uiPos < 6; uiPos++)
+  {
+    oScheduler.push(reinterpret_cast<CcSyncServerWorker*>(&aConnections[uiPos]), "First", 2, true);
+    oScheduler.push(reinterpret_cast<CcSyncServerWorker*>(&aConnections[6 + uiPos]), "Second", 1, true);
+  }
+  CcSyncServerWorker* pMetadata = reinterpret_cast<CcSyncServerWorker*>(&aConnections[12]);
+  oScheduler.push(pMetadata, "Second", 1, false);
+  if (oScheduler.pop() != pMetadata)
+  {
+    CcTestFramework::writeError("Metadata request not taken before transfers");
+    bSuccess = false;
+  }
+  else
+  {
+    size_t uiFirst = 0;
+    for (size_t uiCount = 0; uiCount < 6; uiCount++)
+    {
+      CcSyncServerWorker* pConnection = oScheduler.pop();
+      if (pConnection < reinterpret_cast<CcSyncServerWorker*>(&aConnections[6]))
+        uiFirst++;
+    }
+    if (uiFirst != 4)
+    {
+      CcTestFramework::writeError("Transfers not shared by weight: " + CcString::fromSize(uiFirst));
+      bSuccess = false;
+    }
+    oScheduler.takeAll();
+  }
+  if (bSuccess)
+  {
+    // Transfer is taken after burst of metadata requests
+    CcSyncServerWorker* pBulk = reinterpret_cast<CcSyncServerWorker*>(&aConnections[20]);
+    oScheduler.push(pBulk, "First", 1, true);
+    for (size_t uiPos = 0; uiPos <= CcSyncGlobals::Server::SchedulerMetadataBurst; uiPos++)
+    {
+      oScheduler.push(reinterpret_cast<CcSyncServerWorker*>(&aConnections[uiPos]), "Second", 1, false);
+    }
+    for (size_t uiPos = 0; uiPos < CcSyncGlobals::Server::SchedulerMetadataBurst; uiPos++)
+    {
+      if (oScheduler.pop() == pBulk)
+        bSuccess = false;
+    }
+    if (bSuccess == false ||
+        oScheduler.pop() != pBulk ||
+        oScheduler.size() != 1)
+    {
+      CcTestFramework::writeError("Transfer starving behind metadata requests");
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testAdmission()
+{
+  bool bSuccess = false;
+  CcSyncServerAdmission oAdmission;
+  size_t uiAccepted = 0;
+  for (size_t uiPos = 0; uiPos < CcSyncGlobals::Server::MaxAccountTransfers; uiPos++)
+  {
+    if (oAdmission.acquire("Account"))
+      uiAccepted++;
+  }
+  if (uiAccepted != CcSyncGlobals::Server::MaxAccountTransfers ||
+      oAdmission.acquire("account") ||
+      oAdmission.getRejected() != 1 ||
+      oAdmission.getRetryAfter() < CcSyncGlobals::Server::TransferRetryAfter)
+  {
+    CcTestFramework::writeError("Account limit not applied");
+  }
+  else
+  {
+    oAdmission.release("ACCOUNT");
+    if (oAdmission.acquire("Account") == false)
+    {
+      CcTestFramework::writeError("Released transfer not available");
+    }
+    else
+    {
+      // Fill global limit with other accounts
+      size_t uiAccount = 0;
+      while (oAdmission.getRunning() < CcSyncGlobals::Server::MaxTransfers)
+      {
+        if (oAdmission.acquire("Other" + CcString::fromSize(uiAccount / CcSyncGlobals::Server::MaxAccountTransfers)) == false)
+          break;
+        uiAccount++;
+      }
+      if (oAdmission.getRunning() != CcSyncGlobals::Server::MaxTransfers ||
+          oAdmission.acquire("New"))
+      {
+        CcTestFramework::writeError("Global limit not applied");
+      }
+      else
+      {
+        bSuccess = true;
+      }
+    }
+  }
+  return bSuccess;
+}
+
+bool CComponentTest::testLogWriter()
+{
+  bool bSuccess = false;
+  CcString sDirectory = CcTestFramework::getTemporaryDir();
+  sDirectory.appendPath("CComponentTestLog");
+  CcString sServer = sDirectory;
+  sServer.appendPath("Server.log");
+  CcString sClient = sDirectory;
+  sClient.appendPath("Client.log");
+  CcString sCommon = sDirectory;
+  sCommon.appendPath("Common.log");
+  CcFile::remove(sServer);
+  CCNEWTYPE(pWriter, CcSync::CcSyncLogWriter);
+  pWriter->setPaths(sDirectory, sClient, sServer, sCommon);
+  if (pWriter->append(ESyncLogTarget::Server, "Before open"))
+  {
+    CcTestFramework::writeError("Message accepted before open");
+  }
+  else
+  {
+    CcString sExpected;
+    pWriter->open();
+    for (size_t uiPos = 0; uiPos < 1000; uiPos++)
+    {
+      CcString sMessage = "Message " + CcString::fromSize(uiPos);
+      if (pWriter->append(ESyncLogTarget::Server, sMessage))
+        sExpected << sMessage << CcGlobalStrings::EolOs;
+    }
+    // All accepted messages are written by close
+    pWriter->close();
+    CcFile oFile(sServer);
+    if (oFile.open(EOpenFlags::Read))
+    {
+      CcString sContent = oFile.readAll();
+      oFile.close();
+      if (sContent != sExpected ||
+          sExpected.length() == 0)
+      {
+        CcTestFramework::writeError("Log messages lost or out of order");
+      }
+      else if (pWriter->append(ESyncLogTarget::Server, "After close"))
+      {
+        CcTestFramework::writeError("Message accepted after close");
+      }
+      else
+      {
+        bSuccess = true;
+      }
+    }
+    else
+    {
+      CcTestFramework::writeError("Log file not written");
+    }
+  }
+  CCDELETE(pWriter);
+  return bSuccess;
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of CcOS.
+ *
+ * CcOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * CcOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with CcOS.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+/**
+ * @page      CcSyncTest
+ * @subpage   CComponentTest
+ *
+ * @page      CComponentTest
+ * @copyright Andreas Dirmeier (C) 2017
+ * @author    Andreas Dirmeier
+ * @par       Web:      http://coolcow.de/projects/CcOS
+ * @par       Language: C++11
+ * @brief     Class CComponentTest
+ *
+ *  Tests of single classes of CcSync and CcSyncServer without starting
+ *  server or client processes.
+ **/
+#ifndef _CComponentTest_H_
+#define _CComponentTest_H_
+
+#include "CcBase.h"
+#include "CcTest.h"
+
+/**
+ * @brief Class impelmentation
+ */
+class CComponentTest : public CcTest<CComponentTest>
+{
+public:
+  /**
+   * @brief Constructor
+   */
+  CComponentTest( void );
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~CComponentTest( void );
+
+private:
+  bool testHashMap();
+  bool testSessions();
+  bool testAccountRegistry();
+  bool testBufferPool();
+  bool testQueue();
+  bool testQueueSmallFirst();
+  bool testQueueWithoutTransfers();
+  bool testJournal();
+  bool testTokenBucket();
+  bool testBandwidth();
+  bool testScheduler();
+  bool testAdmission();
+  bool testLogWriter();
+};
+
+#endif /* _CComponentTest_H_ */
@@ -31,6 +31,10 @@
 #include "CcDirectory.h"
 #include "CTestServer.h"
 #include "CTestClient.h"
+#include "CcFile.h"
+
+//! Number of files for a sync with all transfer slots in use
+#define CSyncTest_ParallelFiles 10
 
 class CSyncTestPrivate
 {
@@ -83,6 +87,11 @@ CSyncTest::CSyncTest( void ) :
   appendTestMethod("Write testdata to client 1", &CSyncTest::testWriteTestDataClient1);
   appendTestMethod("Sync TestClient1", &CSyncTest::testSyncClient1);
   appendTestMethod("Sync TestClient2", &CSyncTest::testSyncClient2);
+  appendTestMethod("Write files for parallel transfers to client 1", &CSyncTest::testWriteParallelDataClient1);
+  appendTestMethod("Sync TestClient1", &CSyncTest::testSyncClient1);
+  appendTestMethod("Sync TestClient2", &CSyncTest::testSyncClient2);
+  appendTestMethod("Check files of parallel transfers on client 2", &CSyncTest::testCheckParallelDataClient2);
+  appendTestMethod("Get statistics of TestServer", &CSyncTest::testServerStats);
   appendTestMethod("Stop TestServer with client", &CSyncTest::testStopServerClient1);
   appendTestMethod("Start TestServer", &CSyncTest::testStartServer);
   appendTestMethod("Stop TestServer", &CSyncTest::testStopServer);
@@ -260,6 +269,50 @@ bool CSyncTest::testWriteTestDataClient1()
   return bSuccess;
 }
 
+bool CSyncTest::testWriteParallelDataClient1()
+{
+  bool bSuccess = true;
+  // More files than transfer slots, so all slots are logged in at same time
+  for (uint16 uiFile = 0; uiFile < CSyncTest_ParallelFiles && bSuccess; uiFile++)
+  {
+    bSuccess = m_pPrivate->pClient1->createFile("Parallel/File" + CcString::fromNumber(uiFile) + ".test",
+                                                "Content" + CcString::fromNumber(uiFile));
+  }
+  return bSuccess;
+}
+
+bool CSyncTest::testCheckParallelDataClient2()
+{
+  bool bSuccess = true;
+  for (uint16 uiFile = 0; uiFile < CSyncTest_ParallelFiles && bSuccess; uiFile++)
+  {
+    CcString sPath = m_pPrivate->pClient2->getSyncDir();
+    sPath.appendPath("Parallel/File" + CcString::fromNumber(uiFile) + ".test");
+    CcFile oFile(sPath);
+    if (oFile.open(EOpenFlags::Read))
+    {
+      CcString sContent = oFile.readAll();
+      oFile.close();
+      if (sContent != "Content" + CcString::fromNumber(uiFile))
+      {
+        CcTestFramework::writeError("Wrong content in " + sPath);
+        bSuccess = false;
+      }
+    }
+    else
+    {
+      CcTestFramework::writeError("File not transferred: " + sPath);
+      bSuccess = false;
+    }
+  }
+  return bSuccess;
+}
+
+bool CSyncTest::testServerStats()
+{
+  return m_pPrivate->pClient1->serverStats();
+}
+
 bool CSyncTest::testStopServerClient1()
 {
   bool bSuccess = true;
@@ -65,6 +65,9 @@ private:
   bool testSyncClient2();
   bool testCreateTestDir();
   bool testWriteTestDataClient1();
+  bool testWriteParallelDataClient1();
+  bool testCheckParallelDataClient2();
+  bool testServerStats();
   bool testStopServerClient1();
 
 private: // Member
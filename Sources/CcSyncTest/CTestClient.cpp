@@ -31,6 +31,9 @@
 #include "CcDirectory.h"
 #include "CcStringUtil.h"
 
+//! Interval in ms for reading output of client, it limits precision of measured sync times
+#define CTestClient_ReadInterval 10
+
 CTestClient::CTestClient(const CcString& sServerExePath, const CcString& sConfigDir) :
   m_sConfigDir(sConfigDir)
 {
@@ -137,12 +140,18 @@ bool CTestClient::logout()
   return m_oClientProc.waitForExit(CcDateTimeFromSeconds(1));
 }
 
-bool CTestClient::sync()
+bool CTestClient::sync(const CcDateTime& oTimeout)
 {
   CcTestFramework::writeInfo("  send sync command");
   m_oClientProc.pipe().writeLine("sync");
   CcTestFramework::writeInfo("  wait for command done");
-  return readUntilSucceeded(m_sUsername + "]:");
+  CcStatus oStatus;
+  readWithTimeout(m_sUsername + "]:", oStatus, oTimeout);
+  if (!oStatus)
+  {
+    CcTestFramework::writeError("Sync timed out");
+  }
+  return oStatus;
 }
 
 bool CTestClient::checkLogin(const CcString& sServerName, const CcString& sUsername)
@@ -159,8 +168,9 @@ bool CTestClient::createSyncDirectory(const CcString& sDirectoryPath)
 {
   bool bSuccess = false;
   m_oClientProc.pipe().writeLine("create");
-  m_oClientProc.pipe().writeLine("TestDir");
-  m_sSyncDirs.append(m_sConfigDir.appendPath("CcSync").appendPath(sDirectoryPath));
+  m_oClientProc.pipe().writeLine(sDirectoryPath);
+  CcString sSyncDir = m_sConfigDir;
+  m_sSyncDirs.append(sSyncDir.appendPath("CcSync").appendPath(sDirectoryPath));
   m_oClientProc.pipe().writeLine(m_sSyncDirs.last());
   if (readUntilSucceeded(m_sUsername + "]:"))
   {
@@ -228,6 +238,40 @@ bool CTestClient::serverShutdown()
   return bSuccess;
 }
 
+bool CTestClient::serverStats()
+{
+  bool bSuccess = false;
+  m_oClientProc.pipe().writeLine("admin");
+  m_oClientProc.pipe().flush();
+  if(readUntilSucceeded("[Admin]:"))
+  {
+    m_oClientProc.pipe().writeLine("stats");
+    m_oClientProc.pipe().flush();
+    CcStatus oStatus;
+    CcString sRead = readWithTimeout("[Admin]:", oStatus);
+    if (sRead.endsWith("[Admin]:") &&
+        sRead.contains("Requests:") &&
+        sRead.contains("Accounts:") &&
+        sRead.contains("AccountLogin"))
+    {
+      bSuccess = true;
+    }
+    else
+    {
+      CcTestFramework::writeError("Statistics not available:");
+      CcTestFramework::writeError(sRead);
+    }
+    m_oClientProc.pipe().writeLine("exit");
+    m_oClientProc.pipe().flush();
+    readUntilSucceeded("/" + m_sUsername + "]:");
+  }
+  else
+  {
+    CcTestFramework::writeError("Failed to login as admin");
+  }
+  return bSuccess;
+}
+
 CcString CTestClient::readWithTimeout(const CcString& sStringEnd, CcStatus& oStatus, const CcDateTime& oTimeout)
 {
   CcString sData;
@@ -237,13 +281,17 @@ CcString CTestClient::readWithTimeout(const CcString& sStringEnd, CcStatus& oSta
   while (oCountDown.timestampUs() > 0 ||
          sWaitForever.length())
   {
-    oCountDown.addSeconds(-1);
-    CcKernel::delayS(1);
-    sData += m_oClientProc.pipe().readAll();
-    sData.trim();
-    if (sData.endsWith(sStringEnd))
+    oCountDown.addMSeconds(-CTestClient_ReadInterval);
+    CcKernel::delayMs(CTestClient_ReadInterval);
+    CcString sRead = m_oClientProc.pipe().readAll();
+    if (sRead.length() > 0)
     {
-      break;
+      sData += sRead;
+      sData.trim();
+      if (sData.endsWith(sStringEnd))
+      {
+        break;
+      }
     }
   }
   if (oCountDown <= 0)
@@ -55,12 +55,19 @@ public:
   bool addNewServer(const CcString& sServerName, const CcString& sServerPort, const CcString& sUsername, const CcString& sPassword);
   bool login(const CcString& sServerName, const CcString& sUsername);
   bool logout();
-  bool sync();
+  bool sync(const CcDateTime& oTimeout = CcSyncTestGlobals::DefaultSyncTimeout);
   bool checkLogin(const CcString& sServerName, const CcString& sUsername);
   bool createSyncDirectory(const CcString & sDirectoryPath);
   bool createDirectory(const CcString & sDirectoryPath);
   bool createFile(const CcString & sPathInDir, const CcString &sContent);
   bool serverShutdown();
+  bool serverStats();
+
+  /**
+   * @brief Get path of last directory created by createSyncDirectory
+   */
+  const CcString& getSyncDir() const
+    { return m_sSyncDirs.last(); }
 
 private:
   CcString readWithTimeout(const CcString& sStringEnd, CcStatus& oStatus, const CcDateTime &oTimeeout = CcSyncTestGlobals::DefaultSyncTimeout);
@@ -31,6 +31,7 @@
 #include "CServerTest.h"
 #include "CClientTest.h"
 #include "CSyncTest.h"
+#include "CComponentTest.h"
 
 #include "CcProcess.h"
 
@@ -45,6 +46,7 @@ int main(int argc, char **argv)
     CcTestFramework::init(argc, argv);
     CcConsole::writeLine("Start: CcSyncTest");
 
+    CcTestFramework_addTest(CComponentTest);
     CcTestFramework_addTest(CServerTest);
     CcTestFramework_addTest(CClientTest);
     CcTestFramework_addTest(CSyncTest);